@@ -24,12 +24,15 @@
 
 #include "qsamplerOptions.h"
 #include "qsamplerMainForm.h"
+#include "qsamplerSessionSnapshot.h"
+#include "qsamplerTrace.h"
 
 #include "qsamplerPaletteForm.h"
 
 #include <QDir>
 
 #include <QStyleFactory>
+#include <QTextStream>
 
 #include <QLibraryInfo>
 #include <QTranslator>
@@ -467,6 +470,83 @@ void stacktrace ( int signo )
 #endif
 
 
+//-------------------------------------------------------------------------
+// checkSessionFiles - Offline session files check (no server needed).
+//
+
+static int checkSessionFiles ( const QStringList& files )
+{
+	QTextStream out(stdout);
+	int iErrors = 0;
+
+	QStringListIterator iter(files);
+	while (iter.hasNext()) {
+		const QString& sFilename = iter.next();
+		QSampler::SessionSnapshot session;
+		session.load(sFilename);
+		QStringListIterator diag_iter(session.diagnostics());
+		while (diag_iter.hasNext())
+			out << sFilename << ':' << diag_iter.next() << '\n';
+		out << sFilename << ": "
+			<< QObject::tr("%1 audio devices, %2 MIDI devices, "
+				"%3 MIDI instrument maps, %4 channels; "
+				"%5 errors, %6 warnings, %7 dead commands.")
+				.arg(session.audioDevices().count())
+				.arg(session.midiDevices().count())
+				.arg(session.instrumentMaps().count())
+				.arg(session.channels().count())
+				.arg(session.errors())
+				.arg(session.warnings())
+				.arg(session.deadCommands()) << '\n';
+		if (session.errors() == 0 && !session.isLossless()) {
+			out << sFilename << ": "
+				<< QObject::tr("can not be compiled losslessly, "
+					"will be sent over verbatim.") << '\n';
+		}
+		iErrors += session.errors();
+	}
+
+	out.flush();
+	return iErrors;
+}
+
+
+//-------------------------------------------------------------------------
+// convertSessionFile - Offline session file conversion (no server needed).
+//
+
+static bool convertSessionFile (
+	const QString& sFilename, const QString& sConvertFile )
+{
+	QTextStream out(stderr);
+
+	QSampler::SessionSnapshot session;
+	const bool bLoaded = session.load(sFilename);
+	QStringListIterator iter(session.diagnostics());
+	while (iter.hasNext())
+		out << sFilename << ':' << iter.next() << '\n';
+	out.flush();
+	if (!bLoaded)
+		return false;
+
+	// Whatever can't be told by the session model, can't be converted...
+	if (!session.isLossless()) {
+		out << sFilename << ": "
+			<< QObject::tr("can not be converted losslessly") << '\n';
+		return false;
+	}
+
+	session.setFilename(sConvertFile);
+	if (!session.save()) {
+		out << sConvertFile << ": "
+			<< QObject::tr("could not write file") << '\n';
+		return false;
+	}
+
+	return true;
+}
+
+
 //-------------------------------------------------------------------------
 // main - The main program trunk.
 //
@@ -511,6 +591,21 @@ int main ( int argc, char **argv )
 		return 1;
 	}
 
+	// Just checking session files offline?
+	if (options.bSessionCheck) {
+		const int iErrors = checkSessionFiles(options.sessionCheckFiles);
+		app.quit();
+		return (iErrors > 0 ? 1 : 0);
+	}
+
+	// Just converting a session file offline?
+	if (!options.sSessionConvertFile.isEmpty()) {
+		const bool bConverted = convertSessionFile(
+			options.sSessionFile, options.sSessionConvertFile);
+		app.quit();
+		return (bConverted ? 0 : 1);
+	}
+
 	// Have another instance running?
 	if (app.setup()) {
 		app.quit();
@@ -533,6 +628,13 @@ int main ( int argc, char **argv )
 	if (options.iBaseFontSize > 0)
 		app.setFont(QFont(app.font().family(), options.iBaseFontSize));
 
+	// Trace the hot paths, if asked to...
+	if (!options.sTraceFile.isEmpty()
+		&& !QSampler::Trace::open(options.sTraceFile)) {
+		QTextStream(stderr) << QObject::tr("Could not open trace file: %1\n")
+			.arg(options.sTraceFile);
+	}
+
 	// Construct, setup and show the main form.
 	QSampler::MainForm w;
 	w.setup(&options);
@@ -544,7 +646,11 @@ int main ( int argc, char **argv )
 	// Register the quit signal/slot.
 	// app.connect(&app, SIGNAL(lastWindowClosed()), &app, SLOT(quit()));
 
-	return app.exec();
+	const int iExitStatus = app.exec();
+
+	QSampler::Trace::close();
+
+	return iExitStatus;
 }
 
 
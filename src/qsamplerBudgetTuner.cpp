@@ -0,0 +1,257 @@
+// qsamplerBudgetTuner.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerBudgetTuner.h"
+
+#include "qsamplerChannel.h"
+#include "qsamplerChannelHistory.h"
+#include "qsamplerOptions.h"
+#include "qsamplerMainForm.h"
+
+#include <QDateTime>
+
+
+namespace QSampler {
+
+// Tuning period (msecs).
+#define QSAMPLER_TUNER_MSECS        60000
+
+// Least number of usage samples to tune upon.
+#define QSAMPLER_TUNER_MIN_SAMPLES  10
+
+
+//-------------------------------------------------------------------------
+// QSampler::BudgetTuner -- Voice/stream budget auto-tuner.
+//
+
+// Constructor.
+BudgetTuner::BudgetTuner ( QObject *pParent ) : QObject(pParent)
+{
+	reset();
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(tune()));
+
+	m_timer.start(QSAMPLER_TUNER_MSECS);
+}
+
+
+// Forget the last recommendations (eg. on client changes).
+void BudgetTuner::reset (void)
+{
+	m_iLastVoices  = -1;
+	m_iLastStreams = -1;
+	m_iSettleTime  = 0;
+}
+
+
+// Look over the observed load and tune.
+void BudgetTuner::tune (void)
+{
+#ifdef CONFIG_MAX_VOICES
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr || pMainForm->client() == nullptr)
+		return;
+
+	Options *pOptions = pMainForm->options();
+	if (pOptions == nullptr || pOptions->iTuneMode < 1)
+		return;
+
+	// Let a whole history window go by after each applied change,
+	// so that it's never tuned again on the very same load...
+	const qint64 iNow = QDateTime::currentMSecsSinceEpoch();
+	if (iNow - m_iSettleTime < QSAMPLER_HISTORY_MSECS)
+		return;
+
+	// Gather the peaks over each channel usage history...
+	const qint64 iSince = iNow - QSAMPLER_HISTORY_MSECS;
+
+	int iSamples     = 0;
+	int iActiveSamples = 0;
+	int iFillSamples = 0;
+	int iPeakVoices  = 0;
+	int iPeakStreams = 0;
+	int iMinFill     = -1;
+	int iBusyChannelID = -1;
+	int iBusyVoices  = 0;
+
+	QListIterator<Channel *> iter(pMainForm->channels());
+	while (iter.hasNext()) {
+		Channel *pChannel = iter.next();
+		const ChannelHistory& history = pChannel->history();
+		int iChannelVoices  = 0;
+		int iChannelStreams = 0;
+		for (int i = history.count() - 1; i >= 0; --i) {
+			const ChannelHistory::Sample& sample = history.at(i);
+			if (sample.iTime < iSince)
+				break;
+			++iSamples;
+			if (sample.iVoiceCount > 0 || sample.iStreamCount > 0)
+				++iActiveSamples;
+			if (iChannelVoices < sample.iVoiceCount)
+				iChannelVoices = sample.iVoiceCount;
+			if (iChannelStreams < sample.iStreamCount)
+				iChannelStreams = sample.iStreamCount;
+			// Fill level is meaningless without any disk streams...
+			if (sample.iStreamCount < 1 || sample.iStreamUsage < 0)
+				continue;
+			++iFillSamples;
+			if (iMinFill < 0 || iMinFill > sample.iStreamUsage)
+				iMinFill = sample.iStreamUsage;
+		}
+		// Channels peak at different times; this is an upper bound.
+		iPeakVoices  += iChannelVoices;
+		iPeakStreams += iChannelStreams;
+		if (iBusyVoices < iChannelVoices) {
+			iBusyVoices = iChannelVoices;
+			iBusyChannelID = pChannel->channelID();
+		}
+	}
+
+	// Nothing to learn from an idle session...
+	if (iSamples < QSAMPLER_TUNER_MIN_SAMPLES
+		|| iActiveSamples < QSAMPLER_TUNER_MIN_SAMPLES)
+		return;
+
+	const int iMaxVoices  = pOptions->getEffectiveMaxVoices();
+	const int iMaxStreams = pOptions->getEffectiveMaxStreams();
+	if (iMaxVoices < 1 || iMaxStreams < 0)
+		return;
+
+	// Voices: grow when saturated, shrink when mostly idle.
+	int iVoices = iMaxVoices;
+	QString sVoicesReason;
+	if (iPeakVoices >= iMaxVoices) {
+		iVoices = iMaxVoices + iMaxVoices / 4;
+		sVoicesReason = tr("voices peaked at the limit");
+	}
+	else
+	if (iPeakVoices + iPeakVoices / 2 < iMaxVoices) {
+		iVoices = iPeakVoices + iPeakVoices / 4;
+		sVoicesReason = tr("voices peaked at %1 only, "
+			"saving memory and CPU").arg(iPeakVoices);
+	}
+	iVoices = qBound(pOptions->iTuneMinVoices, iVoices, pOptions->iTuneMaxVoices);
+	if (iVoices != iMaxVoices && sVoicesReason.isEmpty()) {
+		sVoicesReason = tr("keeping within the %1 to %2 bounds")
+			.arg(pOptions->iTuneMinVoices).arg(pOptions->iTuneMaxVoices);
+	}
+	if (iBusyChannelID >= 0 && !sVoicesReason.isEmpty()) {
+		sVoicesReason += tr("; busiest channel %1 with %2 voices")
+			.arg(iBusyChannelID).arg(iBusyVoices);
+	}
+
+	// Disk streams: fewer concurrent streams when the buffers run low,
+	// grow when saturated with fill to spare, shrink when mostly idle.
+	int iStreams = iMaxStreams;
+	QString sStreamsReason;
+	const bool bEasing = (iPeakStreams > 0
+		&& iFillSamples >= QSAMPLER_TUNER_MIN_SAMPLES
+		&& iMinFill >= 0 && iMinFill < pOptions->iTuneFillTarget);
+	if (bEasing) {
+		// The summed peaks may well be over the actual limit...
+		const int iLoadStreams = qMin(iMaxStreams, iPeakStreams);
+		iStreams = iLoadStreams - iLoadStreams / 4;
+		sStreamsReason = tr("least buffer fill %1% below the %2% target, "
+			"easing the disk load").arg(iMinFill).arg(pOptions->iTuneFillTarget);
+	}
+	else
+	if (iPeakStreams >= iMaxStreams) {
+		iStreams = iMaxStreams + iMaxStreams / 4;
+		sStreamsReason = tr("disk streams peaked at the limit, "
+			"with least buffer fill at %1%").arg(iMinFill);
+	}
+	else
+	if (iPeakStreams + iPeakStreams / 2 < iMaxStreams) {
+		iStreams = iPeakStreams + iPeakStreams / 4;
+		sStreamsReason = tr("disk streams peaked at %1 only, "
+			"saving stream buffer memory").arg(iPeakStreams);
+	}
+	iStreams = qBound(pOptions->iTuneMinStreams, iStreams, pOptions->iTuneMaxStreams);
+	// Starving buffers never get more streams to feed.
+	if (bEasing && iStreams > iMaxStreams)
+		iStreams = iMaxStreams;
+	if (iStreams != iMaxStreams && sStreamsReason.isEmpty()) {
+		sStreamsReason = tr("keeping within the %1 to %2 bounds")
+			.arg(pOptions->iTuneMinStreams).arg(pOptions->iTuneMaxStreams);
+	}
+
+	// Ignore the small changes, to avoid flapping...
+	if (qAbs(iVoices - iMaxVoices) < qMax(1, iMaxVoices / 10))
+		iVoices = iMaxVoices;
+	if (qAbs(iStreams - iMaxStreams) < qMax(1, iMaxStreams / 10))
+		iStreams = iMaxStreams;
+
+	const bool bApply = (pOptions->iTuneMode > 1);
+	bool bChanged = false;
+
+	if (iVoices != iMaxVoices && bApply) {
+		// Only tell about what the sampler actually took...
+		pOptions->setMaxVoices(iVoices);
+		const int iNewVoices = pOptions->getEffectiveMaxVoices();
+		if (iNewVoices >= 0 && iNewVoices != iMaxVoices) {
+			pMainForm->appendMessages(
+				tr("Budget tuner: max. voices %1 -> %2 (%3).")
+				.arg(iMaxVoices).arg(iNewVoices).arg(sVoicesReason));
+			bChanged = true;
+		}
+	}
+	else
+	if (iVoices != iMaxVoices && iVoices != m_iLastVoices) {
+		pMainForm->appendMessages(
+			tr("Budget tuner: recommended max. voices %1 -> %2 (%3).")
+			.arg(iMaxVoices).arg(iVoices).arg(sVoicesReason));
+	}
+
+	if (iStreams != iMaxStreams && bApply) {
+		pOptions->setMaxStreams(iStreams);
+		const int iNewStreams = pOptions->getEffectiveMaxStreams();
+		if (iNewStreams >= 0 && iNewStreams != iMaxStreams) {
+			pMainForm->appendMessages(
+				tr("Budget tuner: max. disk streams %1 -> %2 (%3).")
+				.arg(iMaxStreams).arg(iNewStreams).arg(sStreamsReason));
+			bChanged = true;
+		}
+	}
+	else
+	if (iStreams != iMaxStreams && iStreams != m_iLastStreams) {
+		pMainForm->appendMessages(
+			tr("Budget tuner: recommended max. disk streams %1 -> %2 (%3).")
+			.arg(iMaxStreams).arg(iStreams).arg(sStreamsReason));
+	}
+
+	m_iLastVoices  = iVoices;
+	m_iLastStreams = iStreams;
+
+	if (bChanged) {
+		m_iSettleTime = iNow;
+		emit budgetChanged();
+	}
+
+#endif	// CONFIG_MAX_VOICES
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerBudgetTuner.cpp
@@ -0,0 +1,80 @@
+// qsamplerBudgetTuner.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerBudgetTuner_h
+#define __qsamplerBudgetTuner_h
+
+#include <QObject>
+#include <QTimer>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::BudgetTuner -- Voice/stream budget auto-tuner.
+//
+// Periodically looks over the channel usage histories and recommends,
+// or applies within the user bounds, the maximum number of voices and
+// disk streams that keep the stream buffer fill above target, while
+// not wasting memory and CPU on budget that is never used.
+//
+
+class BudgetTuner : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	BudgetTuner(QObject *pParent = nullptr);
+
+	// Forget the last recommendations (eg. on client changes).
+	void reset();
+
+signals:
+
+	// Sampler limits have been just changed.
+	void budgetChanged();
+
+public slots:
+
+	// Look over the observed load and tune.
+	void tune();
+
+private:
+
+	// Instance variables.
+	QTimer m_timer;
+
+	int m_iLastVoices;
+	int m_iLastStreams;
+
+	// Time of the last applied change (msecs since epoch).
+	qint64 m_iSettleTime;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerBudgetTuner_h
+
+
+// end of qsamplerBudgetTuner.h
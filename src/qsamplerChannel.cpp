@@ -26,9 +26,14 @@
 
 #include "qsamplerMainForm.h"
 #include "qsamplerChannelForm.h"
+#include "qsamplerLscpStats.h"
+#include "qsamplerUnderrun.h"
 
 #include <QFileInfo>
 #include <QComboBox>
+#include <QDateTime>
+#include <QMutex>
+#include <QCache>
 
 #ifdef CONFIG_LIBGIG
 #include "gig.h"
@@ -41,9 +46,20 @@ namespace QSampler {
 
 #define QSAMPLER_INSTRUMENT_MAX 128
 
+// Maximum number of cached instrument names.
+#define QSAMPLER_INSTRUMENT_NAMES_MAX 4096
+
 #define UNICODE_RIGHT_ARROW	QChar(char(0x92), char(0x21))
 
 
+#ifdef CONFIG_LIBGIG
+// Instrument name lookup cache, bounded and least recently used
+// first out (shared with name resolver threads).
+static QMutex g_instrumentNamesMutex;
+static QCache<QString, QString> g_instrumentNames(QSAMPLER_INSTRUMENT_NAMES_MAX);
+#endif
+
+
 //-------------------------------------------------------------------------
 // QSampler::Channel - Sampler channel structure.
 //
@@ -68,6 +84,11 @@ Channel::Channel ( int iChannelID )
 	m_fVolume           = 0.0f;
 	m_bMute             = false;
 	m_bSolo             = false;
+
+	m_iVoiceCount       = 0;
+	m_iStreamCount      = 0;
+	m_iStreamUsage      = 0;
+	m_iUsageTime        = 0;
 }
 
 // Default destructor.
@@ -87,7 +108,7 @@ bool Channel::addChannel (void)
 
 	// Are we a new channel?
 	if (m_iChannelID < 0) {
-		m_iChannelID = ::lscp_add_channel(pMainForm->client());
+		m_iChannelID = QSAMPLER_LSCP(lscp_add_channel, pMainForm->client());
 		if (m_iChannelID < 0) {
 			appendMessagesClient("lscp_add_channel");
 			appendMessagesError(
@@ -112,7 +133,7 @@ bool Channel::removeChannel (void)
 
 	// Are we an existing channel?
 	if (m_iChannelID >= 0) {
-		if (::lscp_remove_channel(pMainForm->client(), m_iChannelID) != LSCP_OK) {
+		if (QSAMPLER_LSCP(lscp_remove_channel, pMainForm->client(), m_iChannelID) != LSCP_OK) {
 			appendMessagesClient("lscp_remove_channel");
 			appendMessagesError(QObject::tr("Could not remove channel.\n\nSorry."));
 		} else {
@@ -162,7 +183,7 @@ bool Channel::loadEngine ( const QString& sEngineName )
 	if (m_iInstrumentStatus == 100 && m_sEngineName == sEngineName)
 		return true;
 
-	if (::lscp_load_engine(pMainForm->client(),
+	if (QSAMPLER_LSCP(lscp_load_engine, pMainForm->client(),
 			sEngineName.toUtf8().constData(), m_iChannelID) != LSCP_OK) {
 		appendMessagesClient("lscp_load_engine");
 		return false;
@@ -214,7 +235,7 @@ bool Channel::loadInstrument ( const QString& sInstrumentFile, int iInstrumentNr
 		&& m_iInstrumentNr == iInstrumentNr)
 		return true;
 
-	if (::lscp_load_instrument_non_modal(
+	if (QSAMPLER_LSCP(lscp_load_instrument_non_modal,
 			pMainForm->client(),
 			qsamplerUtilities::lscpEscapePath(
 				sInstrumentFile).toUtf8().constData(),
@@ -263,7 +284,7 @@ bool Channel::setMidiDriver ( const QString& sMidiDriver )
 	if (m_iInstrumentStatus == 100 && m_sMidiDriver == sMidiDriver)
 		return true;
 
-	if (::lscp_set_channel_midi_type(pMainForm->client(),
+	if (QSAMPLER_LSCP(lscp_set_channel_midi_type, pMainForm->client(),
 			m_iChannelID, sMidiDriver.toUtf8().constData()) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_midi_type");
 		return false;
@@ -292,7 +313,7 @@ bool Channel::setMidiDevice ( int iMidiDevice )
 	if (m_iInstrumentStatus == 100 && m_iMidiDevice == iMidiDevice)
 		return true;
 
-	if (::lscp_set_channel_midi_device(pMainForm->client(), m_iChannelID, iMidiDevice) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_set_channel_midi_device, pMainForm->client(), m_iChannelID, iMidiDevice) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_midi_device");
 		return false;
 	}
@@ -320,7 +341,7 @@ bool Channel::setMidiPort ( int iMidiPort )
 	if (m_iInstrumentStatus == 100 && m_iMidiPort == iMidiPort)
 		return true;
 
-	if (::lscp_set_channel_midi_port(pMainForm->client(), m_iChannelID, iMidiPort) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_set_channel_midi_port, pMainForm->client(), m_iChannelID, iMidiPort) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_midi_port");
 		return false;
 	}
@@ -348,7 +369,7 @@ bool Channel::setMidiChannel ( int iMidiChannel )
 	if (m_iInstrumentStatus == 100 && m_iMidiChannel == iMidiChannel)
 		return true;
 
-	if (::lscp_set_channel_midi_channel(pMainForm->client(), m_iChannelID, iMidiChannel) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_set_channel_midi_channel, pMainForm->client(), m_iChannelID, iMidiChannel) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_midi_channel");
 		return false;
 	}
@@ -376,7 +397,7 @@ bool Channel::setMidiMap ( int iMidiMap )
 	if (m_iInstrumentStatus == 100 && m_iMidiMap == iMidiMap)
 		return true;
 #ifdef CONFIG_MIDI_INSTRUMENT
-	if (::lscp_set_channel_midi_map(pMainForm->client(), m_iChannelID, iMidiMap) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_set_channel_midi_map, pMainForm->client(), m_iChannelID, iMidiMap) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_midi_map");
 		return false;
 	}
@@ -404,7 +425,7 @@ bool Channel::setAudioDevice ( int iAudioDevice )
 	if (m_iInstrumentStatus == 100 && m_iAudioDevice == iAudioDevice)
 		return true;
 
-	if (::lscp_set_channel_audio_device(pMainForm->client(), m_iChannelID, iAudioDevice) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_set_channel_audio_device, pMainForm->client(), m_iChannelID, iAudioDevice) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_audio_device");
 		return false;
 	}
@@ -432,7 +453,7 @@ bool Channel::setAudioDriver ( const QString& sAudioDriver )
 	if (m_iInstrumentStatus == 100 && m_sAudioDriver == sAudioDriver)
 		return true;
 
-	if (::lscp_set_channel_audio_type(pMainForm->client(),
+	if (QSAMPLER_LSCP(lscp_set_channel_audio_type, pMainForm->client(),
 			m_iChannelID, sAudioDriver.toUtf8().constData()) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_audio_type");
 		return false;
@@ -461,12 +482,8 @@ bool Channel::setVolume ( float fVolume )
 	if (m_iInstrumentStatus == 100 && m_fVolume == fVolume)
 		return true;
 
-	if (::lscp_set_channel_volume(pMainForm->client(), m_iChannelID, fVolume) != LSCP_OK) {
-		appendMessagesClient("lscp_set_channel_volume");
-		return false;
-	}
-
-	appendMessages(QObject::tr("Volume: %1.").arg(fVolume));
+	// Coalesced and sent on the side...
+	pMainForm->volumeSender()->setVolume(m_iChannelID, fVolume);
 
 	m_fVolume = fVolume;
 	return true;
@@ -490,7 +507,7 @@ bool Channel::setChannelMute ( bool bMute )
 		return true;
 
 #ifdef CONFIG_MUTE_SOLO
-	if (::lscp_set_channel_mute(pMainForm->client(), m_iChannelID, bMute) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_set_channel_mute, pMainForm->client(), m_iChannelID, bMute) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_mute");
 		return false;
 	}
@@ -520,7 +537,7 @@ bool Channel::setChannelSolo ( bool bSolo )
 		return true;
 
 #ifdef CONFIG_MUTE_SOLO
-	if (::lscp_set_channel_solo(pMainForm->client(), m_iChannelID, bSolo) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_set_channel_solo, pMainForm->client(), m_iChannelID, bSolo) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_solo");
 		return false;
 	}
@@ -550,7 +567,7 @@ bool Channel::setAudioChannel ( int iAudioOut, int iAudioIn )
 			m_audioRouting[iAudioOut] == iAudioIn)
 		return true;
 
-	if (::lscp_set_channel_audio_channel(pMainForm->client(),
+	if (QSAMPLER_LSCP(lscp_set_channel_audio_channel, pMainForm->client(),
 			m_iChannelID, iAudioOut, iAudioIn) != LSCP_OK) {
 		appendMessagesClient("lscp_set_channel_audio_channel");
 		return false;
@@ -590,7 +607,7 @@ bool Channel::updateChannelInfo (void)
 		return false;
 
 	// Read channel information.
-	lscp_channel_info_t *pChannelInfo = ::lscp_get_channel_info(pMainForm->client(), m_iChannelID);
+	lscp_channel_info_t *pChannelInfo = QSAMPLER_LSCP(lscp_get_channel_info, pMainForm->client(), m_iChannelID);
 	if (pChannelInfo == nullptr) {
 		appendMessagesClient("lscp_get_channel_info");
 		appendMessagesError(QObject::tr("Could not get channel information.\n\nSorry."));
@@ -642,7 +659,7 @@ bool Channel::updateChannelInfo (void)
 	lscp_device_info_t *pDeviceInfo;
 	const QString sNone = QObject::tr("(none)");
 	// Audio device driver type.
-	pDeviceInfo = ::lscp_get_audio_device_info(pMainForm->client(), m_iAudioDevice);
+	pDeviceInfo = QSAMPLER_LSCP(lscp_get_audio_device_info, pMainForm->client(), m_iAudioDevice);
 	if (pDeviceInfo == nullptr) {
 		appendMessagesClient("lscp_get_audio_device_info");
 		m_sAudioDriver = sNone;
@@ -650,7 +667,7 @@ bool Channel::updateChannelInfo (void)
 		m_sAudioDriver = pDeviceInfo->driver;
 	}
 	// MIDI device driver type.
-	pDeviceInfo = ::lscp_get_midi_device_info(pMainForm->client(), m_iMidiDevice);
+	pDeviceInfo = QSAMPLER_LSCP(lscp_get_midi_device_info, pMainForm->client(), m_iMidiDevice);
 	if (pDeviceInfo == nullptr) {
 		appendMessagesClient("lscp_get_midi_device_info");
 		m_sMidiDriver = sNone;
@@ -674,6 +691,243 @@ bool Channel::updateChannelInfo (void)
 }
 
 
+// Update channel usage state (voices, streams and buffer fill).
+bool Channel::updateChannelUsage (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+	if (pMainForm->client() == nullptr || m_iChannelID < 0)
+		return false;
+
+	// This only makes sense on fully loaded channels...
+	if (m_iInstrumentStatus < 100)
+		return false;
+
+	// Get current channel voice count.
+	m_iVoiceCount  = QSAMPLER_LSCP(lscp_get_channel_voice_count,
+		pMainForm->client(), m_iChannelID);
+	// Get current stream count.
+	m_iStreamCount = QSAMPLER_LSCP(lscp_get_channel_stream_count,
+		pMainForm->client(), m_iChannelID);
+	// Get current channel buffer fill usage.
+	// As benno has suggested this is the percentage usage
+	// of the least filled buffer stream...
+	m_iStreamUsage = QSAMPLER_LSCP(lscp_get_channel_stream_usage,
+		pMainForm->client(), m_iChannelID);
+	m_iUsageTime   = QDateTime::currentMSecsSinceEpoch();
+
+	// Keep a short history of it all too...
+	m_history.append(m_iUsageTime,
+		m_iVoiceCount, m_iStreamCount, m_iStreamUsage);
+
+	// Watch for stream buffer underruns, once per poll...
+	pMainForm->underrunDetector()->process(this,
+		m_iStreamCount, m_iStreamUsage);
+
+	return true;
+}
+
+
+// Last known channel usage accessors.
+int Channel::voiceCount (void) const
+{
+	return m_iVoiceCount;
+}
+
+int Channel::streamCount (void) const
+{
+	return m_iStreamCount;
+}
+
+int Channel::streamUsage (void) const
+{
+	return m_iStreamUsage;
+}
+
+qint64 Channel::usageTime (void) const
+{
+	return m_iUsageTime;
+}
+
+
+// Channel usage history.
+const ChannelHistory& Channel::history (void) const
+{
+	return m_history;
+}
+
+
+// Batched setup command item.
+struct ChannelSetupCommand
+{
+	QString sCommand;
+	bool    bRequired;
+};
+
+static void appendSetupCommand ( QList<ChannelSetupCommand>& batch,
+	const QString& sCommand, bool bRequired = false )
+{
+	ChannelSetupCommand command;
+	command.sCommand  = sCommand;
+	command.bRequired = bRequired;
+	batch.append(command);
+}
+
+
+// Apply whole channel settings in one batch.
+bool Channel::applySetup ( const ChannelSetup& setup )
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+	if (pMainForm->client() == nullptr)
+		return false;
+
+	// Are we a new channel? It's all or nothing then...
+	const bool bNew = (m_iChannelID < 0);
+	if (bNew && !addChannel())
+		return false;
+
+	// Only what's really changed, unless not fully set yet...
+	const bool bAll = (bNew || m_iInstrumentStatus != 100);
+	const QString sChannelID = QString::number(m_iChannelID);
+
+	// Build the command batch...
+	QList<ChannelSetupCommand> batch;
+
+	if (setup.iAudioDevice < 0) {
+		if (bAll || m_sAudioDriver != setup.sAudioDriver) {
+			appendSetupCommand(batch, "SET CHANNEL AUDIO_OUTPUT_TYPE "
+				+ sChannelID + ' ' + setup.sAudioDriver, true);
+		}
+	} else {
+		if (bAll || m_iAudioDevice != setup.iAudioDevice) {
+			appendSetupCommand(batch, "SET CHANNEL AUDIO_OUTPUT_DEVICE "
+				+ sChannelID + ' ' + QString::number(setup.iAudioDevice), true);
+		}
+		ChannelRoutingMap::ConstIterator iter = setup.audioRouting.constBegin();
+		for ( ; iter != setup.audioRouting.constEnd(); ++iter) {
+			if (bAll || m_audioRouting.value(iter.key(), -1) != iter.value()) {
+				appendSetupCommand(batch, "SET CHANNEL AUDIO_OUTPUT_CHANNEL "
+					+ sChannelID + ' ' + QString::number(iter.key())
+					+ ' ' + QString::number(iter.value()));
+			}
+		}
+	}
+
+	if (setup.iMidiDevice < 0) {
+		if (bAll || m_sMidiDriver != setup.sMidiDriver) {
+			appendSetupCommand(batch, "SET CHANNEL MIDI_INPUT_TYPE "
+				+ sChannelID + ' ' + setup.sMidiDriver, true);
+		}
+	}
+	else
+	if (bAll || m_iMidiDevice != setup.iMidiDevice) {
+		appendSetupCommand(batch, "SET CHANNEL MIDI_INPUT_DEVICE "
+			+ sChannelID + ' ' + QString::number(setup.iMidiDevice), true);
+	}
+
+	if (bAll || m_iMidiPort != setup.iMidiPort) {
+		appendSetupCommand(batch, "SET CHANNEL MIDI_INPUT_PORT "
+			+ sChannelID + ' ' + QString::number(setup.iMidiPort));
+	}
+
+	if (bAll || m_iMidiChannel != setup.iMidiChannel) {
+		appendSetupCommand(batch, "SET CHANNEL MIDI_INPUT_CHANNEL "
+			+ sChannelID + ' ' + (setup.iMidiChannel == LSCP_MIDI_CHANNEL_ALL
+				? QString("ALL") : QString::number(setup.iMidiChannel)));
+	}
+
+	if (bAll || m_sEngineName != setup.sEngineName) {
+		appendSetupCommand(batch, "LOAD ENGINE "
+			+ setup.sEngineName + ' ' + sChannelID, true);
+	}
+
+	const bool bInstrument = (!setup.sInstrumentFile.isEmpty()
+		&& QFileInfo(setup.sInstrumentFile).exists()
+		&& (bAll || m_sInstrumentFile != setup.sInstrumentFile
+			|| m_iInstrumentNr != setup.iInstrumentNr));
+	if (bInstrument) {
+		appendSetupCommand(batch, "LOAD INSTRUMENT NON_MODAL '"
+			+ qsamplerUtilities::lscpEscapePath(setup.sInstrumentFile)
+			+ "' " + QString::number(setup.iInstrumentNr) + ' ' + sChannelID);
+	}
+
+#ifdef CONFIG_MIDI_INSTRUMENT
+	if (bAll || m_iMidiMap != setup.iMidiMap) {
+		appendSetupCommand(batch, "SET CHANNEL MIDI_INSTRUMENT_MAP "
+			+ sChannelID + ' ' + (setup.iMidiMap == LSCP_MIDI_MAP_DEFAULT
+				? QString("DEFAULT") : (setup.iMidiMap < 0 ? QString("NONE")
+				: QString::number(setup.iMidiMap))));
+	}
+#endif
+
+	// Send it all over in one go...
+	int iErrors = 0;
+	bool bFailed = false;
+	QListIterator<ChannelSetupCommand> iter(batch);
+	while (iter.hasNext()) {
+		const ChannelSetupCommand& command = iter.next();
+		// Remember that, no matter what,
+		// all LSCP commands are CR/LF terminated.
+		const QString sCommand = command.sCommand + "\r\n";
+		if (LscpStats::query(pMainForm->client(),
+				sCommand.toUtf8().constData()) != LSCP_OK) {
+			appendMessagesColor(command.sCommand, "#996633");
+			appendMessagesClient("lscp_client_query");
+			++iErrors;
+			// A new channel is useless without this one...
+			if (bNew && command.bRequired) {
+				bFailed = true;
+				break;
+			}
+		}
+	}
+
+	// Roll it all back, if it's half-baked.
+	if (bFailed) {
+		if (QSAMPLER_LSCP(lscp_remove_channel, pMainForm->client(), m_iChannelID) != LSCP_OK)
+			appendMessagesClient("lscp_remove_channel");
+		else
+			appendMessages(QObject::tr("removed."));
+		m_iChannelID = -1;
+		return false;
+	}
+
+	// Cache in the new settings state...
+	if (iErrors == 0) {
+		if (setup.iAudioDevice < 0) {
+			m_sAudioDriver = setup.sAudioDriver;
+		} else {
+			m_iAudioDevice = setup.iAudioDevice;
+			ChannelRoutingMap::ConstIterator iter = setup.audioRouting.constBegin();
+			for ( ; iter != setup.audioRouting.constEnd(); ++iter)
+				m_audioRouting[iter.key()] = iter.value();
+		}
+		if (setup.iMidiDevice < 0)
+			m_sMidiDriver = setup.sMidiDriver;
+		else
+			m_iMidiDevice = setup.iMidiDevice;
+		m_iMidiPort    = setup.iMidiPort;
+		m_iMidiChannel = setup.iMidiChannel;
+		m_sEngineName  = setup.sEngineName;
+	#ifdef CONFIG_MIDI_INSTRUMENT
+		m_iMidiMap     = setup.iMidiMap;
+	#endif
+		if (bInstrument)
+			setInstrument(setup.sInstrumentFile, setup.iInstrumentNr);
+	}
+	// Otherwise just get back whatever's really there.
+	else updateChannelInfo();
+
+	appendMessages(QObject::tr("setup: %1 of %2 settings applied.")
+		.arg(batch.count() - iErrors).arg(batch.count()));
+
+	return (iErrors == 0);
+}
+
+
 // Reset channel method.
 bool Channel::channelReset (void)
 {
@@ -683,7 +937,7 @@ bool Channel::channelReset (void)
 	if (pMainForm->client() == nullptr || m_iChannelID < 0)
 		return false;
 
-	if (::lscp_reset_channel(pMainForm->client(), m_iChannelID) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_reset_channel, pMainForm->client(), m_iChannelID) != LSCP_OK) {
 		appendMessagesClient("lscp_reset_channel");
 		return false;
 	}
@@ -705,7 +959,7 @@ bool Channel::editChannel (void)
 	if (pMainForm->client() == nullptr || m_iChannelID < 0)
 		return false;
 
-	if (::lscp_edit_channel_instrument(pMainForm->client(), m_iChannelID)
+	if (QSAMPLER_LSCP(lscp_edit_channel_instrument, pMainForm->client(), m_iChannelID)
 		!= LSCP_OK) {
 		appendMessagesClient("lscp_edit_channel_instrument");
 		appendMessagesError(QObject::tr(
@@ -919,7 +1173,18 @@ QString Channel::getInstrumentName (
 	QString sInstrumentName;
 
 #ifdef CONFIG_LIBGIG
+	// Cached by file, index and modification time.
+	const QString sKey = fi.absoluteFilePath()
+		+ '|' + QString::number(iInstrumentNr)
+		+ '|' + QString::number(fi.lastModified().toMSecsSinceEpoch());
 	if (bInstrumentNames) {
+		g_instrumentNamesMutex.lock();
+		const QString *pInstrumentName = g_instrumentNames.object(sKey);
+		if (pInstrumentName)
+			sInstrumentName = *pInstrumentName;
+		g_instrumentNamesMutex.unlock();
+		if (!sInstrumentName.isEmpty())
+			return sInstrumentName;
 		if (isDlsInstrumentFile(sInstrumentFile)) {
 			RIFF::File *pRiff
 				= new RIFF::File(sInstrumentFile.toUtf8().constData());
@@ -954,6 +1219,11 @@ QString Channel::getInstrumentName (
 			delete pRiff;
 		}
 	#endif
+		if (!sInstrumentName.isEmpty()) {
+			g_instrumentNamesMutex.lock();
+			g_instrumentNames.insert(sKey, new QString(sInstrumentName));
+			g_instrumentNamesMutex.unlock();
+		}
 	}
 #endif
 
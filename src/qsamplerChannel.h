@@ -30,6 +30,7 @@
 #include <lscp/device.h>
 
 #include "qsamplerOptions.h"
+#include "qsamplerChannelHistory.h"
 
 namespace QSampler {
 
@@ -39,6 +40,37 @@ class Device;
 typedef QMap<int, int> ChannelRoutingMap;
 
 
+//-------------------------------------------------------------------------
+// QSampler::ChannelSetup - Sampler channel settings batch.
+//
+
+struct ChannelSetup
+{
+	// Constructor.
+	ChannelSetup() : iAudioDevice(-1), iMidiDevice(-1),
+		iMidiPort(0), iMidiChannel(0), iInstrumentNr(0), iMidiMap(-1) {}
+
+	// Audio output driver or device (when >= 0).
+	QString sAudioDriver;
+	int     iAudioDevice;
+	ChannelRoutingMap audioRouting;
+
+	// MIDI input driver or device (when >= 0).
+	QString sMidiDriver;
+	int     iMidiDevice;
+	int     iMidiPort;
+	int     iMidiChannel;
+
+	// Engine and instrument (file may be empty).
+	QString sEngineName;
+	QString sInstrumentFile;
+	int     iInstrumentNr;
+
+	// MIDI instrument map.
+	int     iMidiMap;
+};
+
+
 //-------------------------------------------------------------------------
 // QSampler::Channel - Sampler channel structure.
 //
@@ -130,6 +162,22 @@ public:
 	// Channel info structure map executive.
 	bool     updateChannelInfo();
 
+	// Channel usage poll; the one and only, whatever the view.
+	bool     updateChannelUsage();
+
+	// Last known channel usage (as of updateChannelUsage);
+	// usage time is in msecs since epoch, zero if never.
+	int      voiceCount() const;
+	int      streamCount() const;
+	int      streamUsage() const;
+	qint64   usageTime() const;
+
+	// Channel usage history.
+	const ChannelHistory& history() const;
+
+	// Apply whole channel settings in one batch.
+	bool     applySetup(const ChannelSetup& setup);
+
 	// Channel setup dialog form.
 	bool     channelSetup(QWidget *pParent);
 
@@ -188,6 +236,15 @@ private:
 
 	// The audio routing mapping.
 	ChannelRoutingMap m_audioRouting;
+
+	// Last known channel usage.
+	int     m_iVoiceCount;
+	int     m_iStreamCount;
+	int     m_iStreamUsage;
+	qint64  m_iUsageTime;
+
+	// Channel usage history.
+	ChannelHistory m_history;
 };
 
 
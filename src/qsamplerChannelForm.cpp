@@ -27,6 +27,7 @@
 
 #include "qsamplerMainForm.h"
 #include "qsamplerInstrument.h"
+#include "qsamplerLscpStats.h"
 
 #include <QValidator>
 #include <QMessageBox>
@@ -195,7 +196,7 @@ void ChannelForm::setup ( Channel *pChannel )
 	}
 
 	// Populate Engines list.
-	const char **ppszEngines = ::lscp_list_available_engines(pMainForm->client());
+	const char **ppszEngines = QSAMPLER_LSCP(lscp_list_available_engines, pMainForm->client());
 	if (ppszEngines) {
 		m_ui.EngineNameComboBox->clear();
 		for (int iEngine = 0; ppszEngines[iEngine]; iEngine++)
@@ -277,7 +278,7 @@ void ChannelForm::setup ( Channel *pChannel )
 	int iMidiChannel = pChannel->midiChannel();
 	// When new, try to suggest a sensible MIDI channel...
 	if (iMidiChannel < 0)
-		iMidiChannel = (::lscp_get_channels(pMainForm->client()) % 16);
+		iMidiChannel = (QSAMPLER_LSCP(lscp_get_channels, pMainForm->client()) % 16);
 	m_ui.MidiChannelComboBox->setCurrentIndex(iMidiChannel);
 	// MIDI instrument map...
 	int iMidiMap = (bNew ? pOptions->iMidiMap : pChannel->midiMap());
@@ -366,14 +367,11 @@ void ChannelForm::accept (void)
 
 	// We'll go for it!
 	if (m_iDirtyCount > 0) {
-		int iErrors = 0;
-		// Are we a new channel?
-		if (!m_pChannel->addChannel())
-			iErrors++;
+		ChannelSetup setup;
+		bool bValid = true;
 		// Accept Audio driver or device selection...
 		if (m_audioDevices.isEmpty()) {
-			if (!m_pChannel->setAudioDriver(m_ui.AudioDriverComboBox->currentText()))
-				iErrors++;
+			setup.sAudioDriver = m_ui.AudioDriverComboBox->currentText();
 		} else {
 			Device *pDevice = nullptr;
 			const int iAudioItem = m_ui.AudioDeviceComboBox->currentIndex();
@@ -382,25 +380,16 @@ void ChannelForm::accept (void)
 					= m_ui.AudioDeviceComboBox->itemData(iAudioItem).toInt();
 				pDevice = m_audioDevices.value(iAudioDevice, nullptr);
 			}
-			ChannelRoutingMap routingMap = m_routingModel.routingMap();
 			if (pDevice == nullptr)
-				iErrors++;
-			else if (!m_pChannel->setAudioDevice(pDevice->deviceID()))
-				iErrors++;
-			else if (!routingMap.isEmpty()) {
-				// Set the audio route changes...
-				ChannelRoutingMap::ConstIterator iter;
-				for (iter = routingMap.begin();
-						iter != routingMap.end(); ++iter) {
-					if (!m_pChannel->setAudioChannel(iter.key(), iter.value()))
-						iErrors++;
-				}
+				bValid = false;
+			else {
+				setup.iAudioDevice = pDevice->deviceID();
+				setup.audioRouting = m_routingModel.routingMap();
 			}
 		}
 		// Accept MIDI driver or device selection...
 		if (m_midiDevices.isEmpty()) {
-			if (!m_pChannel->setMidiDriver(m_ui.MidiDriverComboBox->currentText()))
-				iErrors++;
+			setup.sMidiDriver = m_ui.MidiDriverComboBox->currentText();
 		} else {
 			Device *pDevice = nullptr;
 			const int iMidiItem = m_ui.MidiDeviceComboBox->currentIndex();
@@ -410,32 +399,26 @@ void ChannelForm::accept (void)
 				pDevice = m_midiDevices.value(iMidiDevice, nullptr);
 			}
 			if (pDevice == nullptr)
-				iErrors++;
-			else if (!m_pChannel->setMidiDevice(pDevice->deviceID()))
-				iErrors++;
-		}
-		// MIDI input port number...
-		if (!m_pChannel->setMidiPort(m_ui.MidiPortSpinBox->value()))
-			iErrors++;
-		// MIDI input channel...
-		if (!m_pChannel->setMidiChannel(m_ui.MidiChannelComboBox->currentIndex()))
-			iErrors++;
-		// Engine name...
-		if (!m_pChannel->loadEngine(m_ui.EngineNameComboBox->currentText()))
-			iErrors++;
-		// Instrument file and index...
-		const QString& sPath = m_ui.InstrumentFileComboBox->currentText();
-		if (!sPath.isEmpty() && QFileInfo(sPath).exists()) {
-			if (!m_pChannel->loadInstrument(sPath, m_ui.InstrumentNrComboBox->currentIndex()))
-				iErrors++;
+				bValid = false;
+			else
+				setup.iMidiDevice = pDevice->deviceID();
 		}
+		// MIDI input port number and channel...
+		setup.iMidiPort    = m_ui.MidiPortSpinBox->value();
+		setup.iMidiChannel = m_ui.MidiChannelComboBox->currentIndex();
+		// Engine name, instrument file and index...
+		setup.sEngineName     = m_ui.EngineNameComboBox->currentText();
+		setup.sInstrumentFile = m_ui.InstrumentFileComboBox->currentText();
+		setup.iInstrumentNr   = m_ui.InstrumentNrComboBox->currentIndex();
 		// MIDI intrument map...
-		if (!m_pChannel->setMidiMap(m_ui.MidiMapComboBox->currentIndex()))
-			iErrors++;
-		// Show error messages?
-		if (iErrors > 0) {
+		setup.iMidiMap = m_ui.MidiMapComboBox->currentIndex();
+		// Apply it all at once, or show error messages.
+		if (!bValid || !m_pChannel->applySetup(setup)) {
 			m_pChannel->appendMessagesError(
 				tr("Some channel settings could not be set.\n\nSorry."));
+			// Rolled back; stay here for another try...
+			if (m_pChannel->channelID() < 0)
+				return;
 		}
 	}
 
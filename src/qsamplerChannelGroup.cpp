@@ -0,0 +1,285 @@
+// qsamplerChannelGroup.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerChannelGroup.h"
+
+#include "qsamplerChannel.h"
+#include "qsamplerUtilities.h"
+#include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
+
+#include <QRegExp>
+
+
+namespace QSampler {
+
+// Session file special comment marker.
+#define QSAMPLER_GROUP_MARKER  "#@GROUP"
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelGroup -- Named set of sampler channels.
+//
+
+// Constructor.
+ChannelGroup::ChannelGroup ( const QString& sName ) : m_sName(sName)
+{
+}
+
+
+// Group name accessors.
+const QString& ChannelGroup::name (void) const
+{
+	return m_sName;
+}
+
+void ChannelGroup::setName ( const QString& sName )
+{
+	m_sName = sName;
+}
+
+
+// Group members (sampler channel ids).
+const QList<int>& ChannelGroup::channelIDs (void) const
+{
+	return m_channelIDs;
+}
+
+void ChannelGroup::addChannel ( int iChannelID )
+{
+	if (iChannelID >= 0 && !m_channelIDs.contains(iChannelID))
+		m_channelIDs.append(iChannelID);
+}
+
+void ChannelGroup::removeChannel ( int iChannelID )
+{
+	m_channelIDs.removeAll(iChannelID);
+}
+
+bool ChannelGroup::contains ( int iChannelID ) const
+{
+	return m_channelIDs.contains(iChannelID);
+}
+
+bool ChannelGroup::isEmpty (void) const
+{
+	return m_channelIDs.isEmpty();
+}
+
+
+// Batched group reset.
+int ChannelGroup::resetChannels (void) const
+{
+	QStringList commands;
+	QListIterator<int> iter(m_channelIDs);
+	while (iter.hasNext())
+		commands.append("RESET CHANNEL " + QString::number(iter.next()));
+
+	return sendBatch(commands, m_channelIDs, QObject::tr("reset"));
+}
+
+
+// Batched group mute.
+int ChannelGroup::setChannelMute ( bool bMute ) const
+{
+#ifdef CONFIG_MUTE_SOLO
+	QStringList commands;
+	QListIterator<int> iter(m_channelIDs);
+	while (iter.hasNext()) {
+		commands.append("SET CHANNEL MUTE " + QString::number(iter.next())
+			+ (bMute ? " 1" : " 0"));
+	}
+
+	return sendBatch(commands, m_channelIDs,
+		QObject::tr("mute: %1").arg(int(bMute)));
+#else
+	return 0;
+#endif
+}
+
+
+// Batched group solo.
+int ChannelGroup::setChannelSolo ( bool bSolo ) const
+{
+#ifdef CONFIG_MUTE_SOLO
+	QStringList commands;
+	QListIterator<int> iter(m_channelIDs);
+	while (iter.hasNext()) {
+		commands.append("SET CHANNEL SOLO " + QString::number(iter.next())
+			+ (bSolo ? " 1" : " 0"));
+	}
+
+	return sendBatch(commands, m_channelIDs,
+		QObject::tr("solo: %1").arg(int(bSolo)));
+#else
+	return 0;
+#endif
+}
+
+
+// Batched group volume scaling (relative to each one's current volume).
+int ChannelGroup::scaleVolume ( float fScale ) const
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return 0;
+
+	float fMaxVolume = 1.0f;
+	Options *pOptions = pMainForm->options();
+	if (pOptions)
+		fMaxVolume = float(pOptions->iMaxVolume) / 100.0f;
+
+	QStringList commands;
+	QList<int> channelIDs;
+	QListIterator<int> iter(m_channelIDs);
+	while (iter.hasNext()) {
+		const int iChannelID = iter.next();
+		Channel *pChannel = pMainForm->channel(iChannelID);
+		if (pChannel == nullptr)
+			continue;
+		float fVolume = fScale * pChannel->volume();
+		if (fVolume > fMaxVolume)
+			fVolume = fMaxVolume;
+		if (fVolume < 0.001f)
+			fVolume = 0.0f;
+		commands.append("SET CHANNEL VOLUME " + QString::number(iChannelID)
+			+ ' ' + QString::number(fVolume));
+		channelIDs.append(iChannelID);
+	}
+
+	return sendBatch(commands, channelIDs,
+		QObject::tr("volume: x%1").arg(fScale));
+}
+
+
+// Batched group MIDI instrument map reassignment.
+int ChannelGroup::setMidiMap ( int iMidiMap ) const
+{
+#ifdef CONFIG_MIDI_INSTRUMENT
+	const QString sMidiMap = (iMidiMap == LSCP_MIDI_MAP_DEFAULT
+		? QString("DEFAULT") : (iMidiMap < 0 ? QString("NONE")
+		: QString::number(iMidiMap)));
+
+	QStringList commands;
+	QListIterator<int> iter(m_channelIDs);
+	while (iter.hasNext()) {
+		commands.append("SET CHANNEL MIDI_INSTRUMENT_MAP "
+			+ QString::number(iter.next()) + ' ' + sMidiMap);
+	}
+
+	return sendBatch(commands, m_channelIDs,
+		QObject::tr("MIDI map: %1").arg(iMidiMap));
+#else
+	return 0;
+#endif
+}
+
+
+// Send a batch of channel commands, one per member channel.
+int ChannelGroup::sendBatch ( const QStringList& commands,
+	const QList<int>& channelIDs, const QString& sText ) const
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr || pMainForm->client() == nullptr)
+		return 0;
+
+	QList<int> changedIDs;
+	int iErrors = 0;
+
+	for (int i = 0; i < commands.count() && i < channelIDs.count(); ++i) {
+		// Skip the ones we don't know of anymore...
+		const int iChannelID = channelIDs.at(i);
+		if (pMainForm->channel(iChannelID) == nullptr)
+			continue;
+		// All LSCP commands are CR/LF terminated; the client
+		// query waits for each reply, no pipelining here...
+		const QString sCommand = commands.at(i) + "\r\n";
+		if (LscpStats::query(pMainForm->client(),
+				sCommand.toUtf8().constData()) != LSCP_OK) {
+			pMainForm->appendMessagesColor(commands.at(i), "#996633");
+			++iErrors;
+		}
+		else changedIDs.append(iChannelID);
+	}
+
+	if (iErrors > 0)
+		pMainForm->appendMessagesClient("lscp_client_query");
+
+	const QString& sName = (m_sName.isEmpty()
+		? QObject::tr("All channels") : m_sName);
+	pMainForm->appendMessages(QObject::tr("%1 %2 (%3 channels).")
+		.arg(sName).arg(sText).arg(changedIDs.count()));
+
+	// One single GUI update for them all...
+	pMainForm->updateChannelStrips(changedIDs);
+
+	return changedIDs.count();
+}
+
+
+// Session file persistence (as a special comment line).
+QString ChannelGroup::toSessionLine ( const QMap<int, int>& channelMap ) const
+{
+	QString sLine = QSAMPLER_GROUP_MARKER " '"
+		+ qsamplerUtilities::lscpEscapeText(m_sName) + '\'';
+
+	QListIterator<int> iter(m_channelIDs);
+	while (iter.hasNext()) {
+		const int iChannelID = iter.next();
+		if (channelMap.contains(iChannelID))
+			sLine += ' ' + QString::number(channelMap.value(iChannelID));
+	}
+
+	return sLine;
+}
+
+bool ChannelGroup::fromSessionLine ( const QString& sLine )
+{
+	QRegExp rx("^" QSAMPLER_GROUP_MARKER "\\s+'(.*)'((\\s+\\d+)*)\\s*$");
+	if (!rx.exactMatch(sLine.trimmed()))
+		return false;
+
+	m_sName = qsamplerUtilities::lscpEscapedTextToRaw(rx.cap(1));
+	m_channelIDs.clear();
+
+	const QStringList& ids = rx.cap(2).simplified().split(' ');
+	QStringListIterator iter(ids);
+	while (iter.hasNext()) {
+		const QString& sID = iter.next();
+		if (!sID.isEmpty())
+			addChannel(sID.toInt());
+	}
+
+	return true;
+}
+
+
+// Session file line marker.
+bool ChannelGroup::isSessionLine ( const QString& sLine )
+{
+	return sLine.startsWith(QSAMPLER_GROUP_MARKER);
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerChannelGroup.cpp
@@ -0,0 +1,88 @@
+// qsamplerChannelGroup.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerChannelGroup_h
+#define __qsamplerChannelGroup_h
+
+#include <QStringList>
+#include <QList>
+#include <QMap>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelGroup -- Named set of sampler channels.
+//
+
+class ChannelGroup
+{
+public:
+
+	// Constructor.
+	ChannelGroup(const QString& sName = QString());
+
+	// Group name accessors.
+	const QString& name() const;
+	void setName(const QString& sName);
+
+	// Group members (sampler channel ids).
+	const QList<int>& channelIDs() const;
+	void addChannel(int iChannelID);
+	void removeChannel(int iChannelID);
+	bool contains(int iChannelID) const;
+	bool isEmpty() const;
+
+	// Batched group operations;
+	// return the number of channels actually affected.
+	int resetChannels() const;
+	int setChannelMute(bool bMute) const;
+	int setChannelSolo(bool bSolo) const;
+	int scaleVolume(float fScale) const;
+	int setMidiMap(int iMidiMap) const;
+
+	// Session file persistence (as a special comment line),
+	// with channel ids remapped as given.
+	QString toSessionLine(const QMap<int, int>& channelMap) const;
+	bool fromSessionLine(const QString& sLine);
+
+	// Session file line marker.
+	static bool isSessionLine(const QString& sLine);
+
+private:
+
+	// Send a batch of channel commands, one per member channel;
+	// still one blocking query each (grouping, not pipelining).
+	int sendBatch(const QStringList& commands,
+		const QList<int>& channelIDs, const QString& sText) const;
+
+	// Instance variables.
+	QString    m_sName;
+	QList<int> m_channelIDs;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerChannelGroup_h
+
+
+// end of qsamplerChannelGroup.h
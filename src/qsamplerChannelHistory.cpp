@@ -0,0 +1,313 @@
+// qsamplerChannelHistory.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerChannelHistory.h"
+
+#include "qsamplerOptions.h"
+#include "qsamplerMainForm.h"
+
+#include <QPainter>
+#include <QPolygonF>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QDateTime>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelHistory -- Fixed-memory channel usage history.
+//
+
+// Constructor.
+ChannelHistory::ChannelHistory (void)
+{
+	clear();
+}
+
+
+// Append a new sample, overwriting the oldest when full.
+void ChannelHistory::append ( qint64 iTime,
+	int iVoiceCount, int iStreamCount, int iStreamUsage )
+{
+	Sample& sample = m_samples[m_iHead];
+	sample.iTime        = iTime;
+	sample.iVoiceCount  = short(iVoiceCount);
+	sample.iStreamCount = short(iStreamCount);
+	sample.iStreamUsage = short(iStreamUsage);
+
+	if (++m_iHead >= QSAMPLER_HISTORY_SIZE)
+		m_iHead = 0;
+	if (m_iCount < QSAMPLER_HISTORY_SIZE)
+		++m_iCount;
+}
+
+
+// Forget all samples.
+void ChannelHistory::clear (void)
+{
+	m_iHead  = 0;
+	m_iCount = 0;
+}
+
+
+// Sample accessors (0 is the oldest).
+int ChannelHistory::count (void) const
+{
+	return m_iCount;
+}
+
+const ChannelHistory::Sample& ChannelHistory::at ( int iIndex ) const
+{
+	int i = m_iHead - m_iCount + iIndex;
+	if (i < 0)
+		i += QSAMPLER_HISTORY_SIZE;
+
+	return m_samples[i];
+}
+
+
+// Value ranges of the samples taken since given time.
+int ChannelHistory::ranges ( qint64 iSince,
+	Range& voices, Range& streams, Range& usage ) const
+{
+	int iSamples = 0;
+	int iUsageSamples = 0;
+
+	qint64 iVoicesSum  = 0;
+	qint64 iStreamsSum = 0;
+	qint64 iUsageSum   = 0;
+
+	// Newest first, until too old...
+	for (int i = m_iCount - 1; i >= 0; --i) {
+		const Sample& sample = at(i);
+		if (sample.iTime < iSince)
+			break;
+		if (iSamples == 0) {
+			voices.iMin  = voices.iMax  = sample.iVoiceCount;
+			streams.iMin = streams.iMax = sample.iStreamCount;
+		} else {
+			voices.iMin  = qMin(voices.iMin,  int(sample.iVoiceCount));
+			voices.iMax  = qMax(voices.iMax,  int(sample.iVoiceCount));
+			streams.iMin = qMin(streams.iMin, int(sample.iStreamCount));
+			streams.iMax = qMax(streams.iMax, int(sample.iStreamCount));
+		}
+		iVoicesSum  += sample.iVoiceCount;
+		iStreamsSum += sample.iStreamCount;
+		++iSamples;
+		// Buffer fill is meaningless without any disk streams...
+		if (sample.iStreamCount < 1 || sample.iStreamUsage < 0)
+			continue;
+		if (iUsageSamples == 0) {
+			usage.iMin = usage.iMax = sample.iStreamUsage;
+		} else {
+			usage.iMin = qMin(usage.iMin, int(sample.iStreamUsage));
+			usage.iMax = qMax(usage.iMax, int(sample.iStreamUsage));
+		}
+		iUsageSum += sample.iStreamUsage;
+		++iUsageSamples;
+	}
+
+	if (iSamples > 0) {
+		voices.fAvg  = float(iVoicesSum)  / float(iSamples);
+		streams.fAvg = float(iStreamsSum) / float(iSamples);
+	}
+
+	if (iUsageSamples > 0)
+		usage.fAvg = float(iUsageSum) / float(iUsageSamples);
+	else {
+		usage.iMin = usage.iMax = -1;
+		usage.fAvg = -1.0f;
+	}
+
+	return iSamples;
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelSparkline -- Channel usage history sparkline.
+//
+
+// Constructor.
+ChannelSparkline::ChannelSparkline ( QWidget *pParent )
+	: QFrame(pParent), m_pHistory(nullptr)
+{
+	QFrame::setFrameShape(QFrame::StyledPanel);
+	QFrame::setFrameShadow(QFrame::Sunken);
+}
+
+
+// History accessors.
+void ChannelSparkline::setHistory ( const ChannelHistory *pHistory )
+{
+	m_pHistory = pHistory;
+
+	QFrame::update();
+}
+
+const ChannelHistory *ChannelSparkline::history (void) const
+{
+	return m_pHistory;
+}
+
+
+// Sparkline renderer: voice count as a filled area (scaled to its
+// own peak) and least stream buffer fill (%) as a line on top.
+void ChannelSparkline::paintEvent ( QPaintEvent *pPaintEvent )
+{
+	QFrame::paintEvent(pPaintEvent);
+
+	if (m_pHistory == nullptr || m_pHistory->count() < 1)
+		return;
+
+	const QRect& rect = QFrame::contentsRect().adjusted(1, 1, -1, -1);
+	const int w = rect.width();
+	const int h = rect.height();
+	if (w < 2 || h < 2)
+		return;
+
+	// Samples further apart than this are a gap (eg. auto-refresh off).
+	int iGapMsecs = 2000;
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm && pMainForm->options())
+		iGapMsecs = 2 * pMainForm->options()->iAutoRefreshTime;
+
+	const qint64 iNow   = QDateTime::currentMSecsSinceEpoch();
+	const qint64 iSince = iNow - QSAMPLER_HISTORY_MSECS;
+
+	ChannelHistory::Range voices, streams, usage;
+	if (m_pHistory->ranges(iSince, voices, streams, usage) < 1)
+		return;
+
+	const int iMaxVoices = qMax(1, voices.iMax);
+
+	QList<QPolygonF> voiceAreas;
+	QList<QPolygonF> usageLines;
+	QPolygonF voiceArea;
+	QPolygonF usageLine;
+	qint64 iLastTime = 0;
+
+	const int iCount = m_pHistory->count();
+	for (int i = 0; i < iCount; ++i) {
+		const ChannelHistory::Sample& sample = m_pHistory->at(i);
+		if (sample.iTime < iSince)
+			continue;
+		if (iLastTime > 0 && sample.iTime - iLastTime > iGapMsecs
+			&& !voiceArea.isEmpty()) {
+			voiceArea.append(QPointF(voiceArea.last().x(), rect.bottom()));
+			voiceAreas.append(voiceArea);
+			voiceArea.clear();
+			if (!usageLine.isEmpty())
+				usageLines.append(usageLine);
+			usageLine.clear();
+		}
+		iLastTime = sample.iTime;
+		const qreal x = rect.left() + qreal(w - 1)
+			* qreal(sample.iTime - iSince) / qreal(QSAMPLER_HISTORY_MSECS);
+		const qreal yv = rect.bottom() - qreal(h - 1)
+			* qreal(qMax(0, int(sample.iVoiceCount))) / qreal(iMaxVoices);
+		if (voiceArea.isEmpty())
+			voiceArea.append(QPointF(x, rect.bottom()));
+		voiceArea.append(QPointF(x, yv));
+		// No disk streams, no buffer fill to draw (not a 0% dip)...
+		if (sample.iStreamCount < 1 || sample.iStreamUsage < 0) {
+			if (!usageLine.isEmpty())
+				usageLines.append(usageLine);
+			usageLine.clear();
+			continue;
+		}
+		const qreal yu = rect.bottom() - qreal(h - 1)
+			* qreal(qBound(0, int(sample.iStreamUsage), 100)) / 100.0;
+		usageLine.append(QPointF(x, yu));
+	}
+
+	if (!voiceArea.isEmpty()) {
+		voiceArea.append(QPointF(voiceArea.last().x(), rect.bottom()));
+		voiceAreas.append(voiceArea);
+	}
+	if (!usageLine.isEmpty())
+		usageLines.append(usageLine);
+
+	const QPalette& pal = QFrame::palette();
+
+	QPainter painter(this);
+	painter.setRenderHint(QPainter::Antialiasing, true);
+
+	QColor color = pal.highlight().color();
+	color.setAlpha(96);
+	painter.setPen(Qt::NoPen);
+	painter.setBrush(color);
+	QListIterator<QPolygonF> area_iter(voiceAreas);
+	while (area_iter.hasNext())
+		painter.drawPolygon(area_iter.next());
+
+	painter.setPen(pal.text().color());
+	painter.setBrush(Qt::NoBrush);
+	QListIterator<QPolygonF> line_iter(usageLines);
+	while (line_iter.hasNext()) {
+		const QPolygonF& line = line_iter.next();
+		if (line.count() > 1)
+			painter.drawPolyline(line);
+		else
+			painter.drawPoint(line.first());
+	}
+}
+
+
+// Min/max/avg tooltip.
+bool ChannelSparkline::event ( QEvent *pEvent )
+{
+	if (pEvent->type() == QEvent::ToolTip) {
+		QHelpEvent *pHelpEvent = static_cast<QHelpEvent *> (pEvent);
+		const qint64 iSince = QDateTime::currentMSecsSinceEpoch()
+			- QSAMPLER_HISTORY_MSECS;
+		ChannelHistory::Range voices, streams, usage;
+		const int iSamples = (m_pHistory
+			? m_pHistory->ranges(iSince, voices, streams, usage) : 0);
+		QString sText;
+		if (iSamples > 0) {
+			const QString sRange("min %1, max %2, avg %3");
+			sText = tr("Last %1 minutes (%2 samples)")
+				.arg(QSAMPLER_HISTORY_MSECS / 60000).arg(iSamples);
+			if (usage.iMin < 0)
+				sText += '\n' + tr("Stream buffer fill (%): n/a");
+			else {
+				sText += '\n' + tr("Stream buffer fill (%): %1").arg(sRange
+					.arg(usage.iMin).arg(usage.iMax).arg(usage.fAvg, 0, 'f', 1));
+			}
+			sText += '\n' + tr("Streams: %1").arg(sRange
+				.arg(streams.iMin).arg(streams.iMax).arg(streams.fAvg, 0, 'f', 1));
+			sText += '\n' + tr("Voices: %1").arg(sRange
+				.arg(voices.iMin).arg(voices.iMax).arg(voices.fAvg, 0, 'f', 1));
+		}
+		else sText = tr("No channel usage history");
+		QToolTip::showText(pHelpEvent->globalPos(), sText, this);
+		return true;
+	}
+
+	return QFrame::event(pEvent);
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerChannelHistory.cpp
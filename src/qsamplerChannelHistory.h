@@ -0,0 +1,130 @@
+// qsamplerChannelHistory.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerChannelHistory_h
+#define __qsamplerChannelHistory_h
+
+#include <QFrame>
+
+
+namespace QSampler {
+
+// Fixed history ring capacity (samples); enough to cover the
+// whole history span at the fastest auto-refresh rate (200 msecs).
+#define QSAMPLER_HISTORY_SIZE   1500
+
+// History span shown on the sparklines (msecs).
+#define QSAMPLER_HISTORY_MSECS  (5 * 60 * 1000)
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelHistory -- Fixed-memory channel usage history.
+//
+
+class ChannelHistory
+{
+public:
+
+	// Channel usage sample.
+	struct Sample
+	{
+		qint64 iTime;	// msecs since epoch.
+		short  iVoiceCount;
+		short  iStreamCount;
+		short  iStreamUsage;
+	};
+
+	// Sample value range.
+	struct Range
+	{
+		int   iMin;
+		int   iMax;
+		float fAvg;
+	};
+
+	// Constructor.
+	ChannelHistory();
+
+	// Append a new sample, overwriting the oldest when full.
+	void append(qint64 iTime,
+		int iVoiceCount, int iStreamCount, int iStreamUsage);
+
+	// Forget all samples.
+	void clear();
+
+	// Sample accessors (0 is the oldest).
+	int count() const;
+	const Sample& at(int iIndex) const;
+
+	// Value ranges of the samples taken since given time, stream
+	// usage only from those with disk streams (all -1 if none);
+	// returns the number of samples accounted for.
+	int ranges(qint64 iSince, Range& voices,
+		Range& streams, Range& usage) const;
+
+private:
+
+	// Instance variables.
+	Sample m_samples[QSAMPLER_HISTORY_SIZE];
+
+	int m_iHead;
+	int m_iCount;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelSparkline -- Channel usage history sparkline.
+//
+
+class ChannelSparkline : public QFrame
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	ChannelSparkline(QWidget *pParent = nullptr);
+
+	// History accessors.
+	void setHistory(const ChannelHistory *pHistory);
+	const ChannelHistory *history() const;
+
+protected:
+
+	// Sparkline renderer.
+	void paintEvent(QPaintEvent *pPaintEvent);
+
+	// Min/max/avg tooltip.
+	bool event(QEvent *pEvent);
+
+private:
+
+	// Instance variables.
+	const ChannelHistory *m_pHistory;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerChannelHistory_h
+
+
+// end of qsamplerChannelHistory.h
@@ -0,0 +1,286 @@
+// qsamplerChannelLoader.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerChannelLoader.h"
+
+#include "qsamplerChannel.h"
+#include "qsamplerChannelStrip.h"
+#include "qsamplerDevice.h"
+#include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
+
+#include <QRunnable>
+#include <QFileInfo>
+#include <QDir>
+
+
+namespace QSampler {
+
+// Staggered instrument loader period (msecs).
+#define QSAMPLER_LOADER_MSECS       250
+
+// Maximum number of instruments loading at once.
+#define QSAMPLER_LOADER_MAX_LOADS   2
+
+// Give up waiting on a single instrument load after this long (msecs).
+#define QSAMPLER_LOADER_TIMEOUT     30000
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelNameTask -- Instrument name resolver (worker thread).
+//
+
+class ChannelNameTask : public QRunnable
+{
+public:
+
+	// Constructor.
+	ChannelNameTask(const QString& sInstrumentFile)
+		: m_sInstrumentFile(sInstrumentFile) {}
+
+	// Just warm up the instrument name cache.
+	void run() { Channel::getInstrumentName(m_sInstrumentFile, 0, true); }
+
+private:
+
+	// Instance variables.
+	QString m_sInstrumentFile;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelLoader -- Bulk channel creation from instrument files.
+//
+
+// Constructor.
+ChannelLoader::ChannelLoader ( QObject *pParent ) : QObject(pParent)
+{
+	m_timer.setInterval(QSAMPLER_LOADER_MSECS);
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(loadSlot()));
+}
+
+
+// Destructor.
+ChannelLoader::~ChannelLoader (void)
+{
+	clear();
+
+	m_threadPool.clear();
+	m_threadPool.waitForDone();
+}
+
+
+// Expand dropped paths (files and folders) into instrument files.
+QStringList ChannelLoader::instrumentFiles ( const QStringList& paths )
+{
+	QStringList files;
+
+	QStringList filters;
+	filters << "*.gig" << "*.dls" << "*.sf2" << "*.sfz";
+
+	QStringListIterator iter(paths);
+	while (iter.hasNext()) {
+		const QFileInfo fi(iter.next());
+		if (fi.isDir()) {
+			// Just the folder contents, sorted by name...
+			const QFileInfoList& list = QDir(fi.absoluteFilePath())
+				.entryInfoList(filters, QDir::Files | QDir::Readable, QDir::Name);
+			QListIterator<QFileInfo> fiter(list);
+			while (fiter.hasNext())
+				files.append(fiter.next().absoluteFilePath());
+		}
+		else
+		if (fi.exists())
+			files.append(fi.absoluteFilePath());
+	}
+
+	return files;
+}
+
+
+// Create one channel per instrument file, all with default settings.
+int ChannelLoader::addChannels ( const QStringList& files )
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return 0;
+
+	lscp_client_t *pClient = pMainForm->client();
+	if (pClient == nullptr)
+		return 0;
+
+	Options *pOptions = pMainForm->options();
+	if (pOptions == nullptr)
+		return 0;
+
+#if defined(CONFIG_LIBGIG) && !defined(CONFIG_INSTRUMENT_NAME)
+	// Resolve the instrument names on the side, in order...
+	QStringListIterator name_iter(files);
+	while (name_iter.hasNext())
+		m_threadPool.start(new ChannelNameTask(name_iter.next()));
+#endif
+
+	// Default settings, common to all...
+	ChannelSetup setup;
+
+	setup.sEngineName = pOptions->sEngineName;
+	if (setup.sEngineName.isEmpty()) {
+		const char **ppszEngines = QSAMPLER_LSCP(lscp_list_available_engines, pClient);
+		if (ppszEngines && ppszEngines[0])
+			setup.sEngineName = ppszEngines[0];
+	}
+
+	// Prefer an existing device of the default driver, if any,
+	// otherwise a new one of that same driver type...
+	setup.sAudioDriver = pOptions->sAudioDriver.toUpper();
+	const std::set<int>& audioDevices
+		= Device::getDeviceIDs(pClient, Device::Audio);
+	std::set<int>::const_iterator audio_iter = audioDevices.begin();
+	for ( ; audio_iter != audioDevices.end(); ++audio_iter) {
+		lscp_device_info_t *pDeviceInfo
+			= QSAMPLER_LSCP(lscp_get_audio_device_info, pClient, *audio_iter);
+		if (pDeviceInfo && setup.sAudioDriver == pDeviceInfo->driver) {
+			setup.iAudioDevice = *audio_iter;
+			break;
+		}
+	}
+
+	setup.sMidiDriver = pOptions->sMidiDriver.toUpper();
+	const std::set<int>& midiDevices
+		= Device::getDeviceIDs(pClient, Device::Midi);
+	std::set<int>::const_iterator midi_iter = midiDevices.begin();
+	for ( ; midi_iter != midiDevices.end(); ++midi_iter) {
+		lscp_device_info_t *pDeviceInfo
+			= QSAMPLER_LSCP(lscp_get_midi_device_info, pClient, *midi_iter);
+		if (pDeviceInfo && setup.sMidiDriver == pDeviceInfo->driver) {
+			setup.iMidiDevice = *midi_iter;
+			break;
+		}
+	}
+
+	setup.iMidiMap = pOptions->iMidiMap;
+
+	// Same MIDI channel suggestion as the channel form does...
+	int iMidiChannel = QSAMPLER_LSCP(lscp_get_channels, pClient);
+	if (iMidiChannel < 0)
+		iMidiChannel = 0;
+
+	// Go for it...
+	int iChannels = 0;
+	QStringListIterator iter(files);
+	while (iter.hasNext()) {
+		const QString& sInstrumentFile = iter.next();
+		setup.iMidiChannel = (iMidiChannel++ % 16);
+		Channel *pChannel = new Channel();
+		if (!pChannel->applySetup(setup)) {
+			delete pChannel;
+			continue;
+		}
+		const int iChannelID = pChannel->channelID();
+		if (!pMainForm->createChannel(pChannel)) {
+			delete pChannel;
+			continue;
+		}
+		// The instrument itself gets loaded later...
+		Load load;
+		load.iChannelID = iChannelID;
+		load.sInstrumentFile = sInstrumentFile;
+		load.iElapsed = 0;
+		m_queue.append(load);
+		++iChannels;
+	}
+
+	if (!m_queue.isEmpty() && !m_timer.isActive()) {
+		m_timer.start();
+		loadSlot();
+	}
+
+	return iChannels;
+}
+
+
+// Pending instrument loads.
+bool ChannelLoader::isLoading (void) const
+{
+	return !m_queue.isEmpty() || !m_loading.isEmpty();
+}
+
+
+// Forget all pending loads.
+void ChannelLoader::clear (void)
+{
+	m_timer.stop();
+
+	m_queue.clear();
+	m_loading.clear();
+}
+
+
+// Staggered instrument loader tick.
+void ChannelLoader::loadSlot (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr || pMainForm->client() == nullptr) {
+		clear();
+		return;
+	}
+
+	// Check which ones are still loading, straight from the
+	// channels themselves, whatever's shown of them...
+	QMutableListIterator<Load> iter(m_loading);
+	while (iter.hasNext()) {
+		Load& load = iter.next();
+		Channel *pChannel = pMainForm->channel(load.iChannelID);
+		const int iInstrumentStatus
+			= (pChannel && pChannel->updateChannelInfo()
+				? pChannel->instrumentStatus() : -1);
+		load.iElapsed += QSAMPLER_LOADER_MSECS;
+		if (iInstrumentStatus < 0 || iInstrumentStatus >= 100
+			|| load.iElapsed > QSAMPLER_LOADER_TIMEOUT)
+			iter.remove();
+	}
+
+	// Let the next ones in...
+	while (m_loading.count() < QSAMPLER_LOADER_MAX_LOADS
+		&& !m_queue.isEmpty()) {
+		Load load = m_queue.takeFirst();
+		Channel *pChannel = pMainForm->channel(load.iChannelID);
+		if (pChannel && pChannel->loadInstrument(load.sInstrumentFile, 0)) {
+			ChannelStrip *pChannelStrip = pMainForm->channelStrip(load.iChannelID);
+			if (pChannelStrip)
+				pChannelStrip->updateInstrumentName(false);
+			m_loading.append(load);
+		}
+	}
+
+	// Nothing else to do?
+	if (m_queue.isEmpty() && m_loading.isEmpty())
+		m_timer.stop();
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerChannelLoader.cpp
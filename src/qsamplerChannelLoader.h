@@ -0,0 +1,91 @@
+// qsamplerChannelLoader.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerChannelLoader_h
+#define __qsamplerChannelLoader_h
+
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QList>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelLoader -- Bulk channel creation from instrument files.
+//
+
+class ChannelLoader : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	ChannelLoader(QObject *pParent = nullptr);
+	// Destructor.
+	~ChannelLoader();
+
+	// Expand dropped paths (files and folders) into instrument files.
+	static QStringList instrumentFiles(const QStringList& paths);
+
+	// Create one channel per instrument file, all with default settings;
+	// returns the number of channels actually created.
+	int addChannels(const QStringList& files);
+
+	// Pending instrument loads.
+	bool isLoading() const;
+
+	// Forget all pending loads (eg. on session close).
+	void clear();
+
+protected slots:
+
+	// Staggered instrument loader tick.
+	void loadSlot();
+
+private:
+
+	// Pending instrument load item.
+	struct Load
+	{
+		int     iChannelID;
+		QString sInstrumentFile;
+		int     iElapsed;
+	};
+
+	// Instance variables.
+	QList<Load>  m_queue;
+	QList<Load>  m_loading;
+
+	QTimer       m_timer;
+	QThreadPool  m_threadPool;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerChannelLoader_h
+
+
+// end of qsamplerChannelLoader.h
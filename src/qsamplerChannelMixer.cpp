@@ -0,0 +1,776 @@
+// qsamplerChannelMixer.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerChannelMixer.h"
+
+#include "qsamplerChannel.h"
+#include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
+
+#include <QTimer>
+#include <QScrollBar>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+
+
+namespace QSampler {
+
+// Fixed column widths (pixels).
+#define QSAMPLER_MIXER_LED_WIDTH      16
+#define QSAMPLER_MIXER_NAME_WIDTH     160
+#define QSAMPLER_MIXER_STATUS_WIDTH   48
+#define QSAMPLER_MIXER_BOX_WIDTH      22
+#define QSAMPLER_MIXER_VOLUME_WIDTH   140
+#define QSAMPLER_MIXER_USAGE_WIDTH    64
+#define QSAMPLER_MIXER_COUNT_WIDTH    72
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelMixerView -- Custom-painted channel mixer rows.
+//
+
+// Constructor.
+ChannelMixerView::ChannelMixerView ( QWidget *pParent )
+	: QAbstractScrollArea(pParent)
+{
+	m_bRefreshPending = false;
+
+	m_iMaxVolume  = 100;
+	m_iCurrentRow = -1;
+	m_iDragRow    = -1;
+
+	QAbstractScrollArea::viewport()->setBackgroundRole(QPalette::Base);
+	QAbstractScrollArea::viewport()->setAutoFillBackground(true);
+	QAbstractScrollArea::setFocusPolicy(Qt::ClickFocus);
+	QAbstractScrollArea::setMinimumHeight(120);
+}
+
+
+// Destructor.
+ChannelMixerView::~ChannelMixerView (void)
+{
+	clearChannels();
+}
+
+
+// Channel list (re)synchronization.
+void ChannelMixerView::updateChannels (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr || pMainForm->client() == nullptr) {
+		clearChannels();
+		return;
+	}
+
+	int *piChannelIDs = QSAMPLER_LSCP(lscp_list_channels, pMainForm->client());
+	if (piChannelIDs == nullptr) {
+		if (::lscp_client_get_errno(pMainForm->client()))
+			pMainForm->appendMessagesClient("lscp_list_channels");
+		clearChannels();
+		return;
+	}
+
+	// Keep the rows we already know of, add the new ones...
+	QList<Row> rows;
+	for (int iChannel = 0; piChannelIDs[iChannel] >= 0; ++iChannel) {
+		const int iChannelID = piChannelIDs[iChannel];
+		const int iRow = m_rowIndex.value(iChannelID, -1);
+		if (iRow >= 0) {
+			rows.append(m_rows.at(iRow));
+			m_rows[iRow].pChannel = nullptr;
+		} else {
+			Row row;
+			row.pChannel = new Channel(iChannelID);
+			row.bDirty   = true;
+			MidiActivityClock::attach(this, iChannelID);
+			rows.append(row);
+		}
+	}
+
+	// ...and drop the dead ones.
+	QListIterator<Row> iter(m_rows);
+	while (iter.hasNext()) {
+		Channel *pChannel = iter.next().pChannel;
+		if (pChannel) {
+			MidiActivityClock::detach(this, pChannel->channelID());
+			delete pChannel;
+		}
+	}
+
+	m_rows = rows;
+	updateRowIndex();
+
+	if (m_iCurrentRow >= m_rows.count())
+		m_iCurrentRow = -1;
+	m_iDragRow = -1;
+
+	updateScrollBars();
+	QAbstractScrollArea::viewport()->update();
+	scheduleRefresh();
+}
+
+
+// Remove all channel rows.
+void ChannelMixerView::clearChannels (void)
+{
+	QListIterator<Row> iter(m_rows);
+	while (iter.hasNext()) {
+		Channel *pChannel = iter.next().pChannel;
+		if (pChannel) {
+			MidiActivityClock::detach(this, pChannel->channelID());
+			delete pChannel;
+		}
+	}
+
+	m_rows.clear();
+	m_rowIndex.clear();
+
+	m_iCurrentRow = -1;
+	m_iDragRow = -1;
+
+	updateScrollBars();
+	QAbstractScrollArea::viewport()->update();
+}
+
+
+// Channel row add (takes channel ownership).
+void ChannelMixerView::addChannel ( Channel *pChannel )
+{
+	const int iChannelID = pChannel->channelID();
+	const int iRow = m_rowIndex.value(iChannelID, -1);
+	if (iRow >= 0) {
+		// Already known of (eg. thru a channel count event)...
+		Row& row = m_rows[iRow];
+		if (row.pChannel != pChannel) {
+			delete row.pChannel;
+			row.pChannel = pChannel;
+		}
+		row.bDirty = true;
+	} else {
+		Row row;
+		row.pChannel = pChannel;
+		row.bDirty   = true;
+		MidiActivityClock::attach(this, iChannelID);
+		m_rowIndex.insert(iChannelID, m_rows.count());
+		m_rows.append(row);
+		updateScrollBars();
+	}
+
+	QAbstractScrollArea::viewport()->update();
+	scheduleRefresh();
+}
+
+
+// Channel row remove (drops channel ownership).
+void ChannelMixerView::removeChannel ( int iChannelID )
+{
+	const int iRow = m_rowIndex.value(iChannelID, -1);
+	if (iRow < 0)
+		return;
+
+	MidiActivityClock::detach(this, iChannelID);
+	delete m_rows.at(iRow).pChannel;
+	m_rows.removeAt(iRow);
+	updateRowIndex();
+
+	if (m_iCurrentRow >= m_rows.count())
+		m_iCurrentRow = -1;
+	m_iDragRow = -1;
+
+	updateScrollBars();
+	QAbstractScrollArea::viewport()->update();
+}
+
+
+// Channel row accessors.
+Channel *ChannelMixerView::channel ( int iChannelID ) const
+{
+	const int iRow = m_rowIndex.value(iChannelID, -1);
+	return (iRow >= 0 ? m_rows.at(iRow).pChannel : nullptr);
+}
+
+
+QList<Channel *> ChannelMixerView::channels ( bool bUpdate )
+{
+	QList<Channel *> list;
+
+	for (int iRow = 0; iRow < m_rows.count(); ++iRow) {
+		Row& row = m_rows[iRow];
+		// Hidden rows may have not been fetched yet...
+		if (bUpdate && row.bDirty && row.pChannel->updateChannelInfo()) {
+			row.bDirty = false;
+			QAbstractScrollArea::viewport()->update(rowRect(iRow));
+		}
+		list.append(row.pChannel);
+	}
+
+	return list;
+}
+
+
+// Lazy channel info state refresh.
+void ChannelMixerView::updateChannel ( int iChannelID )
+{
+	const int iRow = m_rowIndex.value(iChannelID, -1);
+	if (iRow < 0)
+		return;
+
+	// Just mark it; all get fetched in one go, later.
+	m_rows[iRow].bDirty = true;
+
+	scheduleRefresh();
+}
+
+
+// Channel usage repaint (as last polled), only of visible rows.
+void ChannelMixerView::updateChannelUsage (void)
+{
+	if (!isVisible())
+		return;
+
+	int iFirstRow, iLastRow;
+	visibleRows(iFirstRow, iLastRow);
+	for (int iRow = iFirstRow; iRow <= iLastRow; ++iRow) {
+		const Row& row = m_rows.at(iRow);
+		if (row.bDirty || row.pChannel->usageTime() < 1)
+			continue;
+		QAbstractScrollArea::viewport()->update(
+			areaRect(iRow, UsageArea) | areaRect(iRow, CountArea));
+	}
+}
+
+
+// MIDI activity indicator (latched on the shared clock).
+void ChannelMixerView::midiActivity ( int iChannelID )
+{
+	MidiActivityClock::trigger(this, iChannelID);
+}
+
+
+void ChannelMixerView::midiActivityChanged ( int iChannelID )
+{
+	const int iRow = m_rowIndex.value(iChannelID, -1);
+	if (iRow < 0)
+		return;
+
+	int iFirstRow, iLastRow;
+	visibleRows(iFirstRow, iLastRow);
+	if (iRow >= iFirstRow && iRow <= iLastRow)
+		QAbstractScrollArea::viewport()->update(areaRect(iRow, LedArea));
+}
+
+
+// Maximum volume setting.
+void ChannelMixerView::setMaxVolume ( int iMaxVolume )
+{
+	m_iMaxVolume = (iMaxVolume > 0 ? iMaxVolume : 100);
+
+	QAbstractScrollArea::viewport()->update();
+}
+
+
+// Number of channel rows.
+int ChannelMixerView::channelCount (void) const
+{
+	return m_rows.count();
+}
+
+
+// Channel info refresh of all the dirty or still loading rows,
+// whether shown or not; only the visible ones get repainted.
+void ChannelMixerView::updateChannelInfo (void)
+{
+	int iFirstRow, iLastRow;
+	visibleRows(iFirstRow, iLastRow);
+	for (int iRow = 0; iRow < m_rows.count(); ++iRow) {
+		Row& row = m_rows[iRow];
+		const int iInstrumentStatus = row.pChannel->instrumentStatus();
+		if (!row.bDirty && (iInstrumentStatus < 0 || iInstrumentStatus >= 100))
+			continue;
+		// Failed ones won't be tried again, unless still loading...
+		const bool bUpdated = row.pChannel->updateChannelInfo();
+		if (!bUpdated && !row.bDirty)
+			continue;
+		row.bDirty = false;
+		if (iRow >= iFirstRow && iRow <= iLastRow)
+			QAbstractScrollArea::viewport()->update(rowRect(iRow));
+	}
+}
+
+
+// Deferred dirty row refresh.
+void ChannelMixerView::refreshSlot (void)
+{
+	m_bRefreshPending = false;
+
+	updateChannelInfo();
+}
+
+
+// Row index (re)builder.
+void ChannelMixerView::updateRowIndex (void)
+{
+	m_rowIndex.clear();
+	for (int iRow = 0; iRow < m_rows.count(); ++iRow)
+		m_rowIndex.insert(m_rows.at(iRow).pChannel->channelID(), iRow);
+}
+
+
+// Row geometry helpers.
+int ChannelMixerView::rowHeight (void) const
+{
+	return QAbstractScrollArea::fontMetrics().height() + 8;
+}
+
+
+QRect ChannelMixerView::rowRect ( int iRow ) const
+{
+	const int h = rowHeight();
+	const int x = - QAbstractScrollArea::horizontalScrollBar()->value();
+	const int y = iRow * h - QAbstractScrollArea::verticalScrollBar()->value();
+	const int w = qMax(QAbstractScrollArea::viewport()->width(),
+		QSAMPLER_MIXER_LED_WIDTH
+		+ QSAMPLER_MIXER_NAME_WIDTH
+		+ QSAMPLER_MIXER_STATUS_WIDTH
+		+ QSAMPLER_MIXER_BOX_WIDTH * 2
+		+ QSAMPLER_MIXER_VOLUME_WIDTH
+		+ QSAMPLER_MIXER_USAGE_WIDTH
+		+ QSAMPLER_MIXER_COUNT_WIDTH);
+
+	return QRect(x, y, w, h);
+}
+
+
+QRect ChannelMixerView::areaRect ( int iRow, Area area ) const
+{
+	const QRect& rect = rowRect(iRow);
+
+	// The name column takes whatever is left.
+	const int iNameWidth = rect.width()
+		- QSAMPLER_MIXER_LED_WIDTH
+		- QSAMPLER_MIXER_STATUS_WIDTH
+		- QSAMPLER_MIXER_BOX_WIDTH * 2
+		- QSAMPLER_MIXER_VOLUME_WIDTH
+		- QSAMPLER_MIXER_USAGE_WIDTH
+		- QSAMPLER_MIXER_COUNT_WIDTH;
+
+	int x = rect.left();
+	int w = 0;
+
+	switch (area) {
+	case CountArea:
+		x += QSAMPLER_MIXER_USAGE_WIDTH;
+		// Fall thru...
+	case UsageArea:
+		x += QSAMPLER_MIXER_VOLUME_WIDTH;
+		// Fall thru...
+	case VolumeArea:
+		x += QSAMPLER_MIXER_BOX_WIDTH;
+		// Fall thru...
+	case SoloArea:
+		x += QSAMPLER_MIXER_BOX_WIDTH;
+		// Fall thru...
+	case MuteArea:
+		x += QSAMPLER_MIXER_STATUS_WIDTH;
+		// Fall thru...
+	case StatusArea:
+		x += iNameWidth;
+		// Fall thru...
+	case NameArea:
+		x += QSAMPLER_MIXER_LED_WIDTH;
+		// Fall thru...
+	case LedArea:
+	default:
+		break;
+	}
+
+	switch (area) {
+	case LedArea:    w = QSAMPLER_MIXER_LED_WIDTH;    break;
+	case NameArea:   w = iNameWidth;                  break;
+	case StatusArea: w = QSAMPLER_MIXER_STATUS_WIDTH; break;
+	case MuteArea:
+	case SoloArea:   w = QSAMPLER_MIXER_BOX_WIDTH;    break;
+	case VolumeArea: w = QSAMPLER_MIXER_VOLUME_WIDTH; break;
+	case UsageArea:  w = QSAMPLER_MIXER_USAGE_WIDTH;  break;
+	case CountArea:  w = QSAMPLER_MIXER_COUNT_WIDTH;  break;
+	default:         break;
+	}
+
+	return QRect(x, rect.top(), w, rect.height()).adjusted(2, 3, -2, -3);
+}
+
+
+ChannelMixerView::Area ChannelMixerView::areaAt (
+	int iRow, const QPoint& pos ) const
+{
+	if (areaRect(iRow, NameArea).contains(pos))
+		return NameArea;
+#ifdef CONFIG_MUTE_SOLO
+	if (areaRect(iRow, MuteArea).contains(pos))
+		return MuteArea;
+	if (areaRect(iRow, SoloArea).contains(pos))
+		return SoloArea;
+#endif
+	if (areaRect(iRow, VolumeArea).contains(pos))
+		return VolumeArea;
+
+	return NoArea;
+}
+
+
+int ChannelMixerView::rowAt ( const QPoint& pos ) const
+{
+	const int iRow = (pos.y()
+		+ QAbstractScrollArea::verticalScrollBar()->value()) / rowHeight();
+
+	return (iRow >= 0 && iRow < m_rows.count() ? iRow : -1);
+}
+
+
+// Visible rows range.
+void ChannelMixerView::visibleRows ( int& iFirstRow, int& iLastRow ) const
+{
+	const int h = rowHeight();
+	const int y = QAbstractScrollArea::verticalScrollBar()->value();
+
+	iFirstRow = y / h;
+	iLastRow  = qMin(m_rows.count() - 1,
+		(y + QAbstractScrollArea::viewport()->height()) / h);
+}
+
+
+// Schedule a deferred refresh of dirty rows.
+void ChannelMixerView::scheduleRefresh (void)
+{
+	if (m_bRefreshPending)
+		return;
+
+	m_bRefreshPending = true;
+	QTimer::singleShot(0, this, SLOT(refreshSlot()));
+}
+
+
+// Volume drag helper.
+void ChannelMixerView::dragVolume ( int iRow, const QPoint& pos )
+{
+	const QRect& rect = areaRect(iRow, VolumeArea);
+	if (rect.width() < 1)
+		return;
+
+	const int x = qBound(0, pos.x() - rect.left(), rect.width());
+	const int iVolume = (x * m_iMaxVolume + rect.width() / 2) / rect.width();
+
+	// Convert and clip.
+	float fVolume = float(iVolume) / 100.0f;
+	if (fVolume < 0.001f)
+		fVolume = 0.0f;
+
+	Channel *pChannel = m_rows.at(iRow).pChannel;
+	if (pChannel->volume() == fVolume)
+		return;
+
+	if (pChannel->setVolume(fVolume))
+		QAbstractScrollArea::viewport()->update(rect);
+}
+
+
+// Row painter.
+void ChannelMixerView::drawRow ( QPainter *pPainter, int iRow )
+{
+	const Row& row = m_rows.at(iRow);
+	Channel *pChannel = row.pChannel;
+
+	const QPalette& pal = QAbstractScrollArea::palette();
+	const QRect& rect = rowRect(iRow);
+
+	// Row background...
+	if (iRow == m_iCurrentRow)
+		pPainter->fillRect(rect, pal.highlight());
+	else
+	if (iRow & 1)
+		pPainter->fillRect(rect, pal.alternateBase());
+
+	const QColor& rgbText = (iRow == m_iCurrentRow
+		? pal.highlightedText().color() : pal.text().color());
+	const QColor& rgbDark = pal.mid().color();
+
+	// MIDI activity LED...
+	const QRect& rectLed = areaRect(iRow, LedArea);
+	const int d = qMin(rectLed.width(), rectLed.height()) - 2;
+	const QRect rectDot(rectLed.center().x() - d / 2,
+		rectLed.center().y() - d / 2, d, d);
+	pPainter->setPen(rgbDark);
+	const bool bActivity
+		= MidiActivityClock::isLit(this, pChannel->channelID());
+	pPainter->setBrush(bActivity ? QColor(Qt::green) : rgbDark.darker());
+	pPainter->drawEllipse(rectDot);
+	pPainter->setBrush(Qt::NoBrush);
+
+	// Channel and instrument names...
+	QString sText = pChannel->channelName();
+	if (!row.bDirty) {
+		sText += " - ";
+		if (pChannel->instrumentName().isEmpty()) {
+			if (pChannel->instrumentStatus() >= 0)
+				sText += Channel::loadingInstrument();
+			else
+				sText += Channel::noInstrumentName();
+		}
+		else sText += pChannel->instrumentName();
+	}
+	const QRect& rectName = areaRect(iRow, NameArea);
+	pPainter->setPen(rgbText);
+	pPainter->drawText(rectName, Qt::AlignLeft | Qt::AlignVCenter,
+		pPainter->fontMetrics().elidedText(sText, Qt::ElideRight,
+			rectName.width()));
+
+	// Nothing else to show until we've got the real thing.
+	if (row.bDirty)
+		return;
+
+	// Instrument status...
+	const int iInstrumentStatus = pChannel->instrumentStatus();
+	if (iInstrumentStatus < 0) {
+		pPainter->setPen(Qt::red);
+		sText = tr("ERR%1").arg(iInstrumentStatus);
+	} else {
+		pPainter->setPen(iInstrumentStatus < 100
+			? QColor(Qt::darkYellow) : QColor(Qt::darkGreen));
+		sText = QString::number(iInstrumentStatus) + '%';
+	}
+	pPainter->drawText(areaRect(iRow, StatusArea),
+		Qt::AlignCenter, sText);
+
+#ifdef CONFIG_MUTE_SOLO
+	// Mute/solo boxes...
+	const QRect& rectMute = areaRect(iRow, MuteArea);
+	if (pChannel->channelMute())
+		pPainter->fillRect(rectMute, QColor(Qt::red).lighter(140));
+	pPainter->setPen(rgbDark);
+	pPainter->drawRect(rectMute.adjusted(0, 0, -1, -1));
+	pPainter->setPen(rgbText);
+	pPainter->drawText(rectMute, Qt::AlignCenter, tr("M"));
+
+	const QRect& rectSolo = areaRect(iRow, SoloArea);
+	if (pChannel->channelSolo())
+		pPainter->fillRect(rectSolo, QColor(Qt::yellow));
+	pPainter->setPen(rgbDark);
+	pPainter->drawRect(rectSolo.adjusted(0, 0, -1, -1));
+	pPainter->setPen(rgbText);
+	pPainter->drawText(rectSolo, Qt::AlignCenter, tr("S"));
+#endif
+
+	// Volume bar...
+	const QRect& rectVolume = areaRect(iRow, VolumeArea);
+	const int iVolume = int(100.0f * pChannel->volume() + 0.5f);
+	const int wVolume = qBound(0,
+		(rectVolume.width() * iVolume) / m_iMaxVolume, rectVolume.width());
+	pPainter->fillRect(rectVolume.x(), rectVolume.y(),
+		wVolume, rectVolume.height(), pal.highlight().color().lighter(130));
+	pPainter->setPen(rgbDark);
+	pPainter->drawRect(rectVolume.adjusted(0, 0, -1, -1));
+	pPainter->setPen(rgbText);
+	pPainter->drawText(rectVolume, Qt::AlignCenter,
+		QString("%1 %").arg(iVolume));
+
+	// Stream usage bar...
+	const QRect& rectUsage = areaRect(iRow, UsageArea);
+	const int wUsage = qBound(0,
+		(rectUsage.width() * pChannel->streamUsage()) / 100, rectUsage.width());
+	pPainter->fillRect(rectUsage.x(), rectUsage.y(),
+		wUsage, rectUsage.height(), QColor(Qt::green).darker(120));
+	pPainter->setPen(rgbDark);
+	pPainter->drawRect(rectUsage.adjusted(0, 0, -1, -1));
+
+	// Stream/voice count...
+	pPainter->setPen(rgbText);
+	pPainter->drawText(areaRect(iRow, CountArea), Qt::AlignCenter,
+		QString("%1 / %2").arg(pChannel->streamCount()).arg(pChannel->voiceCount()));
+}
+
+
+// Scroll-area overrides.
+void ChannelMixerView::paintEvent ( QPaintEvent *pPaintEvent )
+{
+	QPainter painter(QAbstractScrollArea::viewport());
+
+	// Only the rows that intersect the exposed area...
+	const QRect& rect = pPaintEvent->rect();
+	const int h = rowHeight();
+	const int y = QAbstractScrollArea::verticalScrollBar()->value();
+	const int iFirstRow = qMax(0, (y + rect.top()) / h);
+	const int iLastRow  = qMin(m_rows.count() - 1, (y + rect.bottom()) / h);
+
+	for (int iRow = iFirstRow; iRow <= iLastRow; ++iRow)
+		drawRow(&painter, iRow);
+}
+
+
+void ChannelMixerView::resizeEvent ( QResizeEvent *pResizeEvent )
+{
+	QAbstractScrollArea::resizeEvent(pResizeEvent);
+
+	updateScrollBars();
+}
+
+
+void ChannelMixerView::scrollContentsBy ( int /*dx*/, int /*dy*/ )
+{
+	QAbstractScrollArea::viewport()->update();
+}
+
+
+void ChannelMixerView::mousePressEvent ( QMouseEvent *pMouseEvent )
+{
+	if (pMouseEvent->button() != Qt::LeftButton)
+		return;
+
+	const QPoint& pos = pMouseEvent->pos();
+	const int iRow = rowAt(pos);
+	if (iRow < 0)
+		return;
+
+	if (m_iCurrentRow != iRow) {
+		if (m_iCurrentRow >= 0)
+			QAbstractScrollArea::viewport()->update(rowRect(m_iCurrentRow));
+		m_iCurrentRow = iRow;
+		QAbstractScrollArea::viewport()->update(rowRect(m_iCurrentRow));
+	}
+
+	Row& row = m_rows[iRow];
+	if (row.bDirty)
+		return;
+
+	MainForm *pMainForm = MainForm::getInstance();
+	bool bChanged = false;
+
+	switch (areaAt(iRow, pos)) {
+	case MuteArea:
+		bChanged = row.pChannel->setChannelMute(!row.pChannel->channelMute());
+		break;
+	case SoloArea:
+		bChanged = row.pChannel->setChannelSolo(!row.pChannel->channelSolo());
+		break;
+	case VolumeArea:
+		m_iDragRow = iRow;
+		dragVolume(iRow, pos);
+		break;
+	default:
+		break;
+	}
+
+	if (bChanged) {
+		QAbstractScrollArea::viewport()->update(rowRect(iRow));
+		if (pMainForm)
+			pMainForm->sessionDirty();
+	}
+}
+
+
+void ChannelMixerView::mouseMoveEvent ( QMouseEvent *pMouseEvent )
+{
+	if (m_iDragRow >= 0 && m_iDragRow < m_rows.count())
+		dragVolume(m_iDragRow, pMouseEvent->pos());
+}
+
+
+void ChannelMixerView::mouseReleaseEvent ( QMouseEvent */*pMouseEvent*/ )
+{
+	m_iDragRow = -1;
+}
+
+
+void ChannelMixerView::mouseDoubleClickEvent ( QMouseEvent *pMouseEvent )
+{
+	const QPoint& pos = pMouseEvent->pos();
+	const int iRow = rowAt(pos);
+	if (iRow < 0 || areaAt(iRow, pos) != NameArea)
+		return;
+
+	// Open the usual channel setup dialog on it...
+	Row& row = m_rows[iRow];
+	if (row.pChannel->channelSetup(this)) {
+		row.bDirty = true;
+		scheduleRefresh();
+		MainForm *pMainForm = MainForm::getInstance();
+		if (pMainForm)
+			pMainForm->sessionDirty();
+	}
+}
+
+
+void ChannelMixerView::updateScrollBars (void)
+{
+	const QSize& size = QAbstractScrollArea::viewport()->size();
+	const int h = rowHeight();
+
+	QScrollBar *pVScrollBar = QAbstractScrollArea::verticalScrollBar();
+	pVScrollBar->setRange(0, qMax(0, m_rows.count() * h - size.height()));
+	pVScrollBar->setPageStep(size.height());
+	pVScrollBar->setSingleStep(h);
+
+	QScrollBar *pHScrollBar = QAbstractScrollArea::horizontalScrollBar();
+	pHScrollBar->setRange(0, qMax(0, rowRect(0).width() - size.width()));
+	pHScrollBar->setPageStep(size.width());
+	pHScrollBar->setSingleStep(QSAMPLER_MIXER_LED_WIDTH);
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelMixer -- Channel mixer dockable window.
+//
+
+// Constructor.
+ChannelMixer::ChannelMixer ( QWidget *pParent )
+	: QDockWidget(pParent)
+{
+	// Surely a name is crucial (e.g.for storing geometry settings)
+	QDockWidget::setObjectName("qsamplerChannelMixer");
+
+	m_pMixerView = new ChannelMixerView(this);
+
+	// Prepare the dockable window stuff.
+	QDockWidget::setWidget(m_pMixerView);
+	QDockWidget::setAllowedAreas(Qt::AllDockWidgetAreas);
+	// It's either the mixer or the channel strips, switched
+	// over thru the main form's view menu only...
+	QDockWidget::setFeatures(QDockWidget::DockWidgetMovable
+		| QDockWidget::DockWidgetFloatable);
+
+	// Finally set the default caption and tooltip.
+	const QString& sCaption = tr("Mixer");
+	QDockWidget::setWindowTitle(sCaption);
+	QDockWidget::setToolTip(sCaption);
+}
+
+
+// The mixer view itself.
+ChannelMixerView *ChannelMixer::mixerView (void) const
+{
+	return m_pMixerView;
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerChannelMixer.cpp
@@ -0,0 +1,180 @@
+// qsamplerChannelMixer.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerChannelMixer_h
+#define __qsamplerChannelMixer_h
+
+#include "qsamplerMidiActivity.h"
+
+#include <QAbstractScrollArea>
+#include <QDockWidget>
+#include <QHash>
+#include <QList>
+
+class QPainter;
+
+
+namespace QSampler {
+
+class Channel;
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelMixerView -- Custom-painted channel mixer rows.
+//
+
+class ChannelMixerView : public QAbstractScrollArea, public MidiActivityView
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	ChannelMixerView(QWidget *pParent = nullptr);
+	// Destructor.
+	~ChannelMixerView();
+
+	// Channel list (re)synchronization.
+	void updateChannels();
+	void clearChannels();
+
+	// Channel row add/remove (takes/drops channel ownership).
+	void addChannel(Channel *pChannel);
+	void removeChannel(int iChannelID);
+
+	// Channel row accessors; dirty ones may get refreshed first.
+	Channel *channel(int iChannelID) const;
+	QList<Channel *> channels(bool bUpdate = false);
+
+	// Lazy channel info state refresh.
+	void updateChannel(int iChannelID);
+
+	// Channel info refresh of all dirty or still loading rows.
+	void updateChannelInfo();
+
+	// Channel usage repaint (as last polled), only of visible rows.
+	void updateChannelUsage();
+
+	// MIDI activity indicator.
+	void midiActivity(int iChannelID);
+	void midiActivityChanged(int iChannelID);
+
+	// Maximum volume setting.
+	void setMaxVolume(int iMaxVolume);
+
+	// Number of channel rows.
+	int channelCount() const;
+
+protected slots:
+
+	// Deferred dirty row refresh.
+	void refreshSlot();
+
+protected:
+
+	// Row column areas.
+	enum Area { NoArea = 0, LedArea, NameArea, StatusArea,
+		MuteArea, SoloArea, VolumeArea, UsageArea, CountArea };
+
+	// Row geometry helpers.
+	int rowHeight() const;
+	QRect rowRect(int iRow) const;
+	QRect areaRect(int iRow, Area area) const;
+	Area areaAt(int iRow, const QPoint& pos) const;
+	int rowAt(const QPoint& pos) const;
+
+	// Visible rows range.
+	void visibleRows(int& iFirstRow, int& iLastRow) const;
+
+	// Schedule a deferred refresh of dirty rows.
+	void scheduleRefresh();
+
+	// Volume drag helper.
+	void dragVolume(int iRow, const QPoint& pos);
+
+	// Row painter.
+	void drawRow(QPainter *pPainter, int iRow);
+
+	// Scroll-area overrides.
+	void paintEvent(QPaintEvent *pPaintEvent);
+	void resizeEvent(QResizeEvent *pResizeEvent);
+	void scrollContentsBy(int dx, int dy);
+
+	void mousePressEvent(QMouseEvent *pMouseEvent);
+	void mouseMoveEvent(QMouseEvent *pMouseEvent);
+	void mouseReleaseEvent(QMouseEvent *pMouseEvent);
+	void mouseDoubleClickEvent(QMouseEvent *pMouseEvent);
+
+	void updateScrollBars();
+
+private:
+
+	// Channel row state.
+	struct Row
+	{
+		Channel *pChannel;
+		bool bDirty;
+	};
+
+	// Row index (re)builder.
+	void updateRowIndex();
+
+	// Instance variables.
+	QList<Row> m_rows;
+	QHash<int, int> m_rowIndex;
+
+	bool m_bRefreshPending;
+
+	int  m_iMaxVolume;
+	int  m_iCurrentRow;
+	int  m_iDragRow;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::ChannelMixer -- Channel mixer dockable window.
+//
+
+class ChannelMixer : public QDockWidget
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	ChannelMixer(QWidget *pParent);
+
+	// The mixer view itself.
+	ChannelMixerView *mixerView() const;
+
+private:
+
+	// Instance variables.
+	ChannelMixerView *m_pMixerView;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerChannelMixer_h
+
+
+// end of qsamplerChannelMixer.h
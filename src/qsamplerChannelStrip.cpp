@@ -26,11 +26,13 @@
 #include "qsamplerMainForm.h"
 
 #include "qsamplerChannelFxForm.h"
+#include "qsamplerMidiActivity.h"
+#include "qsamplerChannelLoader.h"
+#include "qsamplerTrace.h"
 
 #include <QMessageBox>
 #include <QDragEnterEvent>
 #include <QFileInfo>
-#include <QTimer>
 #include <QUrl>
 #include <QMenu>
 
@@ -61,11 +63,6 @@ namespace QSampler {
 // QSampler::ChannelStrip -- Channel strip form implementation.
 //
 
-// MIDI activity pixmap common resources.
-int      ChannelStrip::g_iMidiActivityRefCount = 0;
-QPixmap *ChannelStrip::g_pMidiActivityLedOn    = nullptr;
-QPixmap *ChannelStrip::g_pMidiActivityLedOff   = nullptr;
-
 // Channel strip activation/selection.
 ChannelStrip *ChannelStrip::g_pSelectedStrip = nullptr;
 
@@ -80,25 +77,13 @@ ChannelStrip::ChannelStrip ( QWidget* pParent, Qt::WindowFlags wflags )
 	m_iErrorCount  = 0;
 	m_instrumentListPopupMenu = nullptr;
 
-	if (++g_iMidiActivityRefCount == 1) {
-		g_pMidiActivityLedOn  = new QPixmap(":/images/ledon1.png");
-		g_pMidiActivityLedOff = new QPixmap(":/images/ledoff1.png");
-	}
-
-	m_ui.MidiActivityLabel->setPixmap(*g_pMidiActivityLedOff);
+	// MIDI activity LED is driven by the shared clock.
+	MidiActivityClock::attach(m_ui.MidiActivityLabel);
 
 #ifndef CONFIG_EVENT_CHANNEL_MIDI
 	m_ui.MidiActivityLabel->setToolTip("MIDI activity (disabled)");
 #endif
 
-	m_pMidiActivityTimer = new QTimer(this);
-	m_pMidiActivityTimer->setSingleShot(true);
-
-	QObject::connect(m_pMidiActivityTimer,
-		SIGNAL(timeout()),
-		SLOT(midiActivityLedOff())
-	);
-
 	// Try to restore normal window positioning.
 	adjustSize();
 
@@ -137,14 +122,7 @@ ChannelStrip::~ChannelStrip (void)
 		delete m_pChannel;
 	m_pChannel = nullptr;
 
-	if (--g_iMidiActivityRefCount == 0) {
-		if (g_pMidiActivityLedOn)
-			delete g_pMidiActivityLedOn;
-		g_pMidiActivityLedOn = nullptr;
-		if (g_pMidiActivityLedOff)
-			delete g_pMidiActivityLedOff;
-		g_pMidiActivityLedOff = nullptr;
-	}
+	MidiActivityClock::detach(m_ui.MidiActivityLabel);
 }
 
 
@@ -188,6 +166,17 @@ void ChannelStrip::dropEvent ( QDropEvent* pDropEvent )
 
 	const QMimeData *pMimeData = pDropEvent->mimeData();
 	if (pMimeData && pMimeData->hasUrls()) {
+		// Many instrument files (or folders) at once?
+		QStringList paths;
+		QListIterator<QUrl> url_iter(pMimeData->urls());
+		while (url_iter.hasNext())
+			paths.append(url_iter.next().toLocalFile());
+		if (paths.count() > 1 || QFileInfo(paths.first()).isDir()) {
+			MainForm *pMainForm = MainForm::getInstance();
+			if (pMainForm)
+				pMainForm->addChannelStrips(ChannelLoader::instrumentFiles(paths));
+			return;
+		}
 		QStringList files;
 		QListIterator<QUrl> iter(pMimeData->urls());
 		while (iter.hasNext()) {
@@ -215,6 +204,9 @@ void ChannelStrip::setup ( Channel *pChannel )
 	// Set the new one...
 	m_pChannel = pChannel;
 
+	// Usage history is the channel's own.
+	m_ui.UsageSparkline->setHistory(m_pChannel ? &m_pChannel->history() : nullptr);
+
 	// Stabilize this around.
 	updateChannelInfo();
 
@@ -483,6 +475,8 @@ bool ChannelStrip::updateChannelVolume (void)
 // Update whole channel info state.
 bool ChannelStrip::updateChannelInfo (void)
 {
+	QSAMPLER_TRACE("gui", "ChannelStrip::updateChannelInfo");
+
 	if (m_pChannel == nullptr)
 		return false;
 
@@ -572,36 +566,27 @@ bool ChannelStrip::updateChannelInfo (void)
 }
 
 
-// Update whole channel usage state.
+// Update whole channel usage state (as last polled by the channel).
 bool ChannelStrip::updateChannelUsage (void)
 {
-	if (m_pChannel == nullptr)
-		return false;
+	QSAMPLER_TRACE("gui", "ChannelStrip::updateChannelUsage");
 
-	MainForm *pMainForm = MainForm::getInstance();
-	if (pMainForm->client() == nullptr)
+	if (m_pChannel == nullptr)
 		return false;
 
-	// This only makes sense on fully loaded channels...
-	if (m_pChannel->instrumentStatus() < 100)
+	// Not polled yet (only fully loaded ones are)...
+	if (m_pChannel->usageTime() < 1)
 		return false;
 
-	// Get current channel voice count.
-	const int iVoiceCount  = ::lscp_get_channel_voice_count(
-		pMainForm->client(), m_pChannel->channelID());
-	// Get current stream count.
-	const int iStreamCount = ::lscp_get_channel_stream_count(
-		pMainForm->client(), m_pChannel->channelID());
-	// Get current channel buffer fill usage.
-	// As benno has suggested this is the percentage usage
-	// of the least filled buffer stream...
-	const int iStreamUsage = ::lscp_get_channel_stream_usage(
-		pMainForm->client(), m_pChannel->channelID());
+	const int iVoiceCount  = m_pChannel->voiceCount();
+	const int iStreamCount = m_pChannel->streamCount();
+	const int iStreamUsage = m_pChannel->streamUsage();
 
 	// Update the GUI elements...
 	m_ui.StreamUsageProgressBar->setValue(iStreamUsage);
 	m_ui.StreamVoiceCountTextLabel->setText(
 		QString("%1 / %2").arg(iStreamCount).arg(iVoiceCount));
+	m_ui.UsageSparkline->update();
 
 	// We're clean.
 	return true;
@@ -623,11 +608,10 @@ void ChannelStrip::volumeChanged ( int iVolume )
 	if (fVolume < 0.001f)
 		fVolume = 0.0f;
 
-	// Update the GUI elements.
-	if (m_pChannel->setVolume(fVolume)) {
+	// Update the GUI elements (the session gets
+	// dirty only once, when the gesture is over).
+	if (m_pChannel->setVolume(fVolume))
 		updateChannelVolume();
-		emit channelChanged(this);
-	}
 }
 
 
@@ -644,14 +628,8 @@ void ChannelStrip::contextMenuEvent( QContextMenuEvent *pEvent )
 
 void ChannelStrip::midiActivityLedOn (void)
 {
-	m_ui.MidiActivityLabel->setPixmap(*g_pMidiActivityLedOn);
-	m_pMidiActivityTimer->start(100);
-}
-
-
-void ChannelStrip::midiActivityLedOff (void)
-{
-	m_ui.MidiActivityLabel->setPixmap(*g_pMidiActivityLedOff);
+	// Just latch it; shown on the next shared clock frame.
+	MidiActivityClock::trigger(m_ui.MidiActivityLabel);
 }
 
 
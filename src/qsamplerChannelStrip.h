@@ -28,7 +28,6 @@
 #include "qsamplerChannel.h"
 
 class QDragEnterEvent;
-class QTimer;
 class QMenu;
 
 
@@ -93,7 +92,6 @@ protected:
 
 protected slots:
 
-	void midiActivityLedOff();
 	void instrumentListPopupItemClicked(QAction* action);
 
 private:
@@ -105,13 +103,6 @@ private:
 	int m_iErrorCount;
 	QMenu* m_instrumentListPopupMenu;
 
-	QTimer  *m_pMidiActivityTimer;
-
-	// MIDI activity pixmap common resources.
-	static int      g_iMidiActivityRefCount;
-	static QPixmap *g_pMidiActivityLedOn;
-	static QPixmap *g_pMidiActivityLedOff;
-
 	// Channel strip activation/selection.
 	static ChannelStrip *g_pSelectedStrip;
 };
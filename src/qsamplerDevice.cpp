@@ -25,6 +25,7 @@
 
 #include "qsamplerMainForm.h"
 #include "qsamplerDeviceForm.h"
+#include "qsamplerLscpStats.h"
 
 #include <QCheckBox>
 #include <QSpinBox>
@@ -100,6 +101,14 @@ void DeviceParam::setParam ( lscp_param_info_t *pParamInfo,
 // QSampler::Device - MIDI/Audio Device structure.
 //
 
+// Driver parameter info cache (driver name -> parameter name).
+QMap<QString, DeviceParamMap> Device::g_audioDriverParams;
+QMap<QString, DeviceParamMap> Device::g_midiDriverParams;
+
+// Port parameter info cache (driver name -> parameter name).
+QMap<QString, DeviceParamMap> Device::g_audioPortParams;
+QMap<QString, DeviceParamMap> Device::g_midiPortParams;
+
 // Constructor.
 Device::Device ( DeviceType deviceType, int iDeviceID )
 {
@@ -150,13 +159,13 @@ void Device::setDevice ( DeviceType deviceType, int iDeviceID )
 	switch (deviceType) {
 	case Device::Audio:
 		m_sDeviceType = QObject::tr("Audio");
-		if (m_iDeviceID >= 0 && (pDeviceInfo = ::lscp_get_audio_device_info(
+		if (m_iDeviceID >= 0 && (pDeviceInfo = QSAMPLER_LSCP(lscp_get_audio_device_info,
 				pMainForm->client(), m_iDeviceID)) == nullptr)
 			appendMessagesClient("lscp_get_audio_device_info");
 		break;
 	case Device::Midi:
 		m_sDeviceType = QObject::tr("MIDI");
-		if (m_iDeviceID >= 0 && (pDeviceInfo = ::lscp_get_midi_device_info(
+		if (m_iDeviceID >= 0 && (pDeviceInfo = QSAMPLER_LSCP(lscp_get_midi_device_info,
 				pMainForm->client(), m_iDeviceID)) == nullptr)
 			appendMessagesClient("lscp_get_midi_device_info");
 		break;
@@ -179,26 +188,13 @@ void Device::setDevice ( DeviceType deviceType, int iDeviceID )
 	// Grab device parameters...
 	for (int i = 0; pDeviceInfo->params && pDeviceInfo->params[i].key; i++) {
 		const QString sParam = pDeviceInfo->params[i].key;
-		lscp_param_info_t *pParamInfo = nullptr;
-		switch (deviceType) {
-		case Device::Audio:
-			if ((pParamInfo = ::lscp_get_audio_driver_param_info(
-					pMainForm->client(), m_sDriverName.toUtf8().constData(),
-					sParam.toUtf8().constData(), nullptr)) == nullptr)
-				appendMessagesClient("lscp_get_audio_driver_param_info");
-			break;
-		case Device::Midi:
-			if ((pParamInfo = ::lscp_get_midi_driver_param_info(
-					pMainForm->client(), m_sDriverName.toUtf8().constData(),
-					sParam.toUtf8().constData(), nullptr)) == nullptr)
-				appendMessagesClient("lscp_get_midi_driver_param_info");
-			break;
-		case Device::None:
-			break;
-		}
-		if (pParamInfo) {
-			m_params[sParam.toUpper()] = DeviceParam(pParamInfo,
-				pDeviceInfo->params[i].value);
+		DeviceParam param;
+		if (driverParam(m_sDriverName, sParam, param)) {
+			if (pDeviceInfo->params[i].value)
+				param.value = pDeviceInfo->params[i].value;
+			else
+				param.value.clear();
+			m_params[sParam.toUpper()] = param;
 		}
 	}
 
@@ -231,12 +227,12 @@ void Device::setDriver ( const QString& sDriverName )
 	lscp_driver_info_t *pDriverInfo = nullptr;
 	switch (m_deviceType) {
 	case Device::Audio:
-		if ((pDriverInfo = ::lscp_get_audio_driver_info(pMainForm->client(),
+		if ((pDriverInfo = QSAMPLER_LSCP(lscp_get_audio_driver_info, pMainForm->client(),
 				sDriverName.toUtf8().constData())) == nullptr)
 			appendMessagesClient("lscp_get_audio_driver_info");
 		break;
 	case Device::Midi:
-		if ((pDriverInfo = ::lscp_get_midi_driver_info(pMainForm->client(),
+		if ((pDriverInfo = QSAMPLER_LSCP(lscp_get_midi_driver_info, pMainForm->client(),
 				sDriverName.toUtf8().constData())) == nullptr)
 			appendMessagesClient("lscp_get_midi_driver_info");
 		break;
@@ -254,26 +250,10 @@ void Device::setDriver ( const QString& sDriverName )
 	// Grab driver parameters...
 	for (int i = 0; pDriverInfo->parameters && pDriverInfo->parameters[i]; i++) {
 		const QString sParam = pDriverInfo->parameters[i];
-		lscp_param_info_t *pParamInfo = nullptr;
-		switch (m_deviceType) {
-		case Device::Audio:
-			if ((pParamInfo = ::lscp_get_audio_driver_param_info(
-					pMainForm->client(), sDriverName.toUtf8().constData(),
-					sParam.toUtf8().constData(), nullptr)) == nullptr)
-				appendMessagesClient("lscp_get_audio_driver_param_info");
-			break;
-		case Device::Midi:
-			if ((pParamInfo = ::lscp_get_midi_driver_param_info(
-					pMainForm->client(), sDriverName.toUtf8().constData(),
-					sParam.toUtf8().constData(), nullptr)) == nullptr)
-				appendMessagesClient("lscp_get_midi_driver_param_info");
-			break;
-		case Device::None:
-			break;
-		}
-		if (pParamInfo) {
-			m_params[sParam.toUpper()] = DeviceParam(pParamInfo,
-				pParamInfo->defaultv);
+		DeviceParam param;
+		if (driverParam(sDriverName, sParam, param)) {
+			param.value = param.defaultv;
+			m_params[sParam.toUpper()] = param;
 		}
 	}
 
@@ -347,13 +327,13 @@ bool Device::setParam ( const QString& sParam,
 		switch (m_deviceType) {
 		case Device::Audio:
 			if (sParam == "CHANNELS") iRefresh++;
-			if ((ret = ::lscp_set_audio_device_param(pMainForm->client(),
+			if ((ret = QSAMPLER_LSCP(lscp_set_audio_device_param, pMainForm->client(),
 					m_iDeviceID, &param)) != LSCP_OK)
 				appendMessagesClient("lscp_set_audio_device_param");
 			break;
 		case Device::Midi:
 			if (sParam == "PORTS") iRefresh++;
-			if ((ret = ::lscp_set_midi_device_param(pMainForm->client(),
+			if ((ret = QSAMPLER_LSCP(lscp_set_midi_device_param, pMainForm->client(),
 					m_iDeviceID, &param)) != LSCP_OK)
 				appendMessagesClient("lscp_set_midi_device_param");
 			break;
@@ -431,12 +411,12 @@ bool Device::createDevice (void)
 	// Now it depends on the device type...
 	switch (m_deviceType) {
 	case Device::Audio:
-		if ((m_iDeviceID = ::lscp_create_audio_device(pMainForm->client(),
+		if ((m_iDeviceID = QSAMPLER_LSCP(lscp_create_audio_device, pMainForm->client(),
 				m_sDriverName.toUtf8().constData(), pParams)) < 0)
 			appendMessagesClient("lscp_create_audio_device");
 		break;
 	case Device::Midi:
-		if ((m_iDeviceID = ::lscp_create_midi_device(pMainForm->client(),
+		if ((m_iDeviceID = QSAMPLER_LSCP(lscp_create_midi_device, pMainForm->client(),
 				m_sDriverName.toUtf8().constData(), pParams)) < 0)
 			appendMessagesClient("lscp_create_midi_device");
 		break;
@@ -474,12 +454,12 @@ bool Device::deleteDevice (void)
 	lscp_status_t ret = LSCP_FAILED;
 	switch (m_deviceType) {
 	case Device::Audio:
-		if ((ret = ::lscp_destroy_audio_device(pMainForm->client(),
+		if ((ret = QSAMPLER_LSCP(lscp_destroy_audio_device, pMainForm->client(),
 				m_iDeviceID)) != LSCP_OK)
 			appendMessagesClient("lscp_destroy_audio_device");
 		break;
 	case Device::Midi:
-		if ((ret = ::lscp_destroy_midi_device(pMainForm->client(),
+		if ((ret = QSAMPLER_LSCP(lscp_destroy_midi_device, pMainForm->client(),
 				m_iDeviceID)) != LSCP_OK)
 			appendMessagesClient("lscp_destroy_midi_device");
 		break;
@@ -612,13 +592,13 @@ int Device::refreshParam ( const QString& sParam )
 	lscp_param_info_t *pParamInfo = nullptr;
 	switch (m_deviceType) {
 	case Device::Audio:
-		if ((pParamInfo = ::lscp_get_audio_driver_param_info(
+		if ((pParamInfo = QSAMPLER_LSCP(lscp_get_audio_driver_param_info,
 				pMainForm->client(), m_sDriverName.toUtf8().constData(),
 				sParam.toUtf8().constData(), pDepends)) == nullptr)
 			appendMessagesClient("lscp_get_audio_driver_param_info");
 		break;
 	case Device::Midi:
-		if ((pParamInfo = ::lscp_get_midi_driver_param_info(
+		if ((pParamInfo = QSAMPLER_LSCP(lscp_get_midi_driver_param_info,
 				pMainForm->client(), m_sDriverName.toUtf8().constData(),
 				sParam.toUtf8().constData(), pDepends)) == nullptr)
 			appendMessagesClient("lscp_get_midi_driver_param_info");
@@ -640,6 +620,224 @@ int Device::refreshParam ( const QString& sParam )
 }
 
 
+// Driver parameter info (cached) retriever.
+bool Device::driverParam ( const QString& sDriverName,
+	const QString& sParam, DeviceParam& param ) const
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+	if (pMainForm->client() == nullptr)
+		return false;
+
+	QMap<QString, DeviceParamMap> *pDriverParams = nullptr;
+	switch (m_deviceType) {
+	case Device::Audio:
+		pDriverParams = &g_audioDriverParams;
+		break;
+	case Device::Midi:
+		pDriverParams = &g_midiDriverParams;
+		break;
+	case Device::None:
+		break;
+	}
+	if (pDriverParams == nullptr)
+		return false;
+
+	// Driver parameter metadata won't ever change
+	// while connected, so it's fetched only once...
+	DeviceParamMap& params = (*pDriverParams)[sDriverName];
+	const QString& sKey = sParam.toUpper();
+	DeviceParamMap::ConstIterator iter = params.constFind(sKey);
+	if (iter != params.constEnd()) {
+		param = iter.value();
+		return true;
+	}
+
+	lscp_param_info_t *pParamInfo = nullptr;
+	switch (m_deviceType) {
+	case Device::Audio:
+		if ((pParamInfo = QSAMPLER_LSCP(lscp_get_audio_driver_param_info,
+				pMainForm->client(), sDriverName.toUtf8().constData(),
+				sParam.toUtf8().constData(), nullptr)) == nullptr)
+			appendMessagesClient("lscp_get_audio_driver_param_info");
+		break;
+	case Device::Midi:
+		if ((pParamInfo = QSAMPLER_LSCP(lscp_get_midi_driver_param_info,
+				pMainForm->client(), sDriverName.toUtf8().constData(),
+				sParam.toUtf8().constData(), nullptr)) == nullptr)
+			appendMessagesClient("lscp_get_midi_driver_param_info");
+		break;
+	case Device::None:
+		break;
+	}
+	if (pParamInfo == nullptr)
+		return false;
+
+	param = DeviceParam(pParamInfo);
+	params.insert(sKey, param);
+	return true;
+}
+
+
+// Port parameter info (cached per driver) retriever.
+bool Device::portParam ( const QString& sDriverName, int iDeviceID,
+	int iPortID, const QString& sParam, DeviceParam& param ) const
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+	if (pMainForm->client() == nullptr)
+		return false;
+
+	QMap<QString, DeviceParamMap> *pPortParams = nullptr;
+	switch (m_deviceType) {
+	case Device::Audio:
+		pPortParams = &g_audioPortParams;
+		break;
+	case Device::Midi:
+		pPortParams = &g_midiPortParams;
+		break;
+	case Device::None:
+		break;
+	}
+	if (pPortParams == nullptr)
+		return false;
+
+	// Whatever the port, it's the same driver parameter...
+	DeviceParamMap& params = (*pPortParams)[sDriverName];
+	const QString& sKey = sParam.toUpper();
+	DeviceParamMap::ConstIterator iter = params.constFind(sKey);
+	if (iter != params.constEnd()) {
+		param = iter.value();
+		return true;
+	}
+
+	lscp_param_info_t *pParamInfo = nullptr;
+	switch (m_deviceType) {
+	case Device::Audio:
+		if ((pParamInfo = QSAMPLER_LSCP(lscp_get_audio_channel_param_info,
+				pMainForm->client(), iDeviceID, iPortID,
+				sParam.toUtf8().constData())) == nullptr)
+			appendMessagesClient("lscp_get_audio_channel_param_info");
+		break;
+	case Device::Midi:
+		if ((pParamInfo = QSAMPLER_LSCP(lscp_get_midi_port_param_info,
+				pMainForm->client(), iDeviceID, iPortID,
+				sParam.toUtf8().constData())) == nullptr)
+			appendMessagesClient("lscp_get_midi_port_param_info");
+		break;
+	case Device::None:
+		break;
+	}
+	if (pParamInfo == nullptr)
+		return false;
+
+	param = DeviceParam(pParamInfo);
+	params.insert(sKey, param);
+	return true;
+}
+
+
+// Device and port parameters, as of current values, with all
+// other parameter info taken from the driver caches (snapshots).
+bool Device::getSnapshot ( int iDeviceID, QString& sDriverName,
+	DeviceParamMap& params, QList<DeviceParamMap>& ports ) const
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+
+	lscp_client_t *pClient = pMainForm->client();
+	if (pClient == nullptr)
+		return false;
+
+	sDriverName.clear();
+	params.clear();
+	ports.clear();
+
+	// Device info, for the current parameter values...
+	lscp_device_info_t *pDeviceInfo = nullptr;
+	switch (m_deviceType) {
+	case Device::Audio:
+		if ((pDeviceInfo = QSAMPLER_LSCP(lscp_get_audio_device_info,
+				pClient, iDeviceID)) == nullptr)
+			appendMessagesClient("lscp_get_audio_device_info");
+		break;
+	case Device::Midi:
+		if ((pDeviceInfo = QSAMPLER_LSCP(lscp_get_midi_device_info,
+				pClient, iDeviceID)) == nullptr)
+			appendMessagesClient("lscp_get_midi_device_info");
+		break;
+	case Device::None:
+		break;
+	}
+	if (pDeviceInfo == nullptr)
+		return false;
+
+	sDriverName = pDeviceInfo->driver;
+
+	for (int i = 0; pDeviceInfo->params && pDeviceInfo->params[i].key; i++) {
+		const QString sParam = pDeviceInfo->params[i].key;
+		DeviceParam param;
+		if (driverParam(sDriverName, sParam, param)) {
+			if (pDeviceInfo->params[i].value)
+				param.value = pDeviceInfo->params[i].value;
+			else
+				param.value.clear();
+			params[sParam.toUpper()] = param;
+		}
+	}
+
+	// Port/channel info, for their current parameter values...
+	const int iPorts = params.value(
+		m_deviceType == Device::Audio ? "CHANNELS" : "PORTS").value.toInt();
+	for (int iPort = 0; iPort < iPorts; iPort++) {
+		lscp_device_port_info_t *pPortInfo = nullptr;
+		switch (m_deviceType) {
+		case Device::Audio:
+			if ((pPortInfo = QSAMPLER_LSCP(lscp_get_audio_channel_info,
+					pClient, iDeviceID, iPort)) == nullptr)
+				appendMessagesClient("lscp_get_audio_channel_info");
+			break;
+		case Device::Midi:
+			if ((pPortInfo = QSAMPLER_LSCP(lscp_get_midi_port_info,
+					pClient, iDeviceID, iPort)) == nullptr)
+				appendMessagesClient("lscp_get_midi_port_info");
+			break;
+		case Device::None:
+			break;
+		}
+		DeviceParamMap portParams;
+		for (int i = 0; pPortInfo
+				&& pPortInfo->params && pPortInfo->params[i].key; i++) {
+			const QString sParam = pPortInfo->params[i].key;
+			DeviceParam param;
+			if (portParam(sDriverName, iDeviceID, iPort, sParam, param)) {
+				if (pPortInfo->params[i].value)
+					param.value = pPortInfo->params[i].value;
+				else
+					param.value.clear();
+				portParams[sParam.toUpper()] = param;
+			}
+		}
+		ports.append(portParams);
+	}
+
+	return true;
+}
+
+
+// Driver parameter info cache reset.
+void Device::clearDriverParams (void)
+{
+	g_audioDriverParams.clear();
+	g_midiDriverParams.clear();
+	g_audioPortParams.clear();
+	g_midiPortParams.clear();
+}
+
+
 // Redirected messages output methods.
 void Device::appendMessages( const QString& s ) const
 {
@@ -684,10 +882,10 @@ int *Device::getDevices ( lscp_client_t *pClient,
 	int *piDeviceIDs = nullptr;
 	switch (deviceType) {
 	case Device::Audio:
-		piDeviceIDs = ::lscp_list_audio_devices(pClient);
+		piDeviceIDs = QSAMPLER_LSCP(lscp_list_audio_devices, pClient);
 		break;
 	case Device::Midi:
-		piDeviceIDs = ::lscp_list_midi_devices(pClient);
+		piDeviceIDs = QSAMPLER_LSCP(lscp_list_midi_devices, pClient);
 		break;
 	case Device::None:
 		break;
@@ -716,10 +914,10 @@ QStringList Device::getDrivers ( lscp_client_t *pClient,
 	const char **ppszDrivers = nullptr;
 	switch (deviceType) {
 	case Device::Audio:
-		ppszDrivers = ::lscp_list_available_audio_drivers(pClient);
+		ppszDrivers = QSAMPLER_LSCP(lscp_list_available_audio_drivers, pClient);
 		break;
 	case Device::Midi:
-		ppszDrivers = ::lscp_list_available_midi_drivers(pClient);
+		ppszDrivers = QSAMPLER_LSCP(lscp_list_available_midi_drivers, pClient);
 		break;
 	case Device::None:
 		break;
@@ -768,12 +966,12 @@ void DevicePort::setDevicePort ( int iPortID )
 	lscp_device_port_info_t *pPortInfo = nullptr;
 	switch (m_device.deviceType()) {
 	case Device::Audio:
-		if ((pPortInfo = ::lscp_get_audio_channel_info(pMainForm->client(),
+		if ((pPortInfo = QSAMPLER_LSCP(lscp_get_audio_channel_info, pMainForm->client(),
 				m_device.deviceID(), m_iPortID)) == nullptr)
 			m_device.appendMessagesClient("lscp_get_audio_channel_info");
 		break;
 	case Device::Midi:
-		if ((pPortInfo = ::lscp_get_midi_port_info(pMainForm->client(),
+		if ((pPortInfo = QSAMPLER_LSCP(lscp_get_midi_port_info, pMainForm->client(),
 				m_device.deviceID(), m_iPortID)) == nullptr)
 			m_device.appendMessagesClient("lscp_get_midi_port_info");
 		break;
@@ -797,13 +995,13 @@ void DevicePort::setDevicePort ( int iPortID )
 		lscp_param_info_t *pParamInfo = nullptr;
 		switch (m_device.deviceType()) {
 		case Device::Audio:
-			if ((pParamInfo = ::lscp_get_audio_channel_param_info(
+			if ((pParamInfo = QSAMPLER_LSCP(lscp_get_audio_channel_param_info,
 					pMainForm->client(), m_device.deviceID(),
 					m_iPortID, sParam.toUtf8().constData())) == nullptr)
 				m_device.appendMessagesClient("lscp_get_audio_channel_param_info");
 			break;
 		case Device::Midi:
-			if ((pParamInfo = ::lscp_get_midi_port_param_info(
+			if ((pParamInfo = QSAMPLER_LSCP(lscp_get_midi_port_param_info,
 					pMainForm->client(), m_device.deviceID(),
 					m_iPortID, sParam.toUtf8().constData())) == nullptr)
 				m_device.appendMessagesClient("lscp_get_midi_port_param_info");
@@ -868,12 +1066,12 @@ bool DevicePort::setParam ( const QString& sParam,
 		lscp_status_t ret = LSCP_FAILED;
 		switch (m_device.deviceType()) {
 		case Device::Audio:
-			if ((ret = ::lscp_set_audio_channel_param(pMainForm->client(),
+			if ((ret = QSAMPLER_LSCP(lscp_set_audio_channel_param, pMainForm->client(),
 					m_device.deviceID(), m_iPortID, &param)) != LSCP_OK)
 				m_device.appendMessagesClient("lscp_set_audio_channel_param");
 			break;
 		case Device::Midi:
-			if ((ret = ::lscp_set_midi_port_param(pMainForm->client(),
+			if ((ret = QSAMPLER_LSCP(lscp_set_midi_port_param, pMainForm->client(),
 					m_device.deviceID(), m_iPortID, &param)) != LSCP_OK)
 				m_device.appendMessagesClient("lscp_set_midi_port_param");
 			break;
@@ -956,6 +1154,15 @@ Device& DeviceItem::device ()
 }
 
 
+// Device info refreshner (in-place).
+void DeviceItem::refreshDevice (void)
+{
+	m_device.setDevice(m_device.deviceType(), m_device.deviceID());
+
+	setText(0, m_device.deviceName());
+}
+
+
 //-------------------------------------------------------------------------
 // QSampler::AbstractDeviceParamModel - data model base class for device parameters
 //
@@ -158,11 +158,27 @@ public:
 	static QStringList getDrivers(lscp_client_t *pClient,
 		DeviceType deviceType);
 
+	// Driver parameter info cache reset (eg. on client (re)connection).
+	static void clearDriverParams();
+
+	// Device and port parameters, as of current values, with all
+	// other parameter info taken from the driver caches (snapshots).
+	bool getSnapshot(int iDeviceID, QString& sDriverName,
+		DeviceParamMap& params, QList<DeviceParamMap>& ports) const;
+
 private:
 
 	// Refresh/set given parameter based on driver supplied dependencies.
 	int refreshParam(const QString& sParam);
 
+	// Driver parameter info (cached) retriever.
+	bool driverParam(const QString& sDriverName,
+		const QString& sParam, DeviceParam& param) const;
+
+	// Port parameter info (cached per driver) retriever.
+	bool portParam(const QString& sDriverName, int iDeviceID, int iPortID,
+		const QString& sParam, DeviceParam& param) const;
+
 	// Instance variables.
 	int        m_iDeviceID;
 	DeviceType m_deviceType;
@@ -175,6 +191,15 @@ private:
 
 	// Device port/channel list.
 	DevicePortList m_ports;
+
+	// Driver parameter info cache (driver name -> parameter name).
+	static QMap<QString, DeviceParamMap> g_audioDriverParams;
+	static QMap<QString, DeviceParamMap> g_midiDriverParams;
+
+	// Port parameter info cache (driver name -> parameter name);
+	// only good for what's the same on every port (eg. fix, type).
+	static QMap<QString, DeviceParamMap> g_audioPortParams;
+	static QMap<QString, DeviceParamMap> g_midiPortParams;
 };
 
 
@@ -238,6 +263,9 @@ public:
 	// Instance accessors.
 	Device& device();
 
+	// Device info refreshner (in-place).
+	void refreshDevice();
+
 private:
 
 	// Instance variables.
@@ -24,6 +24,7 @@
 
 #include "qsamplerAbout.h"
 #include "qsamplerMainForm.h"
+#include "qsamplerTrace.h"
 
 #include <QHeaderView>
 #include <QMessageBox>
@@ -132,7 +133,7 @@ void DeviceForm::showEvent ( QShowEvent *pShowEvent )
 {
 	MainForm* pMainForm = MainForm::getInstance();
 	if (pMainForm)
-		pMainForm->stabilizeForm();
+		pMainForm->stabilizeForm(MainForm::StabilizeForms);
 
 	QWidget::showEvent(pShowEvent);
 
@@ -147,7 +148,7 @@ void DeviceForm::hideEvent ( QHideEvent *pHideEvent )
 
 	MainForm *pMainForm = MainForm::getInstance();
 	if (pMainForm)
-		pMainForm->stabilizeForm();
+		pMainForm->stabilizeForm(MainForm::StabilizeForms);
 
 	// Signal special whether we changed the device set.
 	if (m_iDirtyCount > 0) {
@@ -324,6 +325,8 @@ void DeviceForm::deleteDevice (void)
 // Refresh all device list and views.
 void DeviceForm::refreshDevices (void)
 {
+	QSAMPLER_TRACE("model", "DeviceForm::refreshDevices");
+
 	MainForm *pMainForm = MainForm::getInstance();
 	if (pMainForm == nullptr)
 		return;
@@ -334,48 +337,187 @@ void DeviceForm::refreshDevices (void)
 	//
 	// (Re)Load complete device configuration data ...
 	//
+	updateRootItems();
+	if (m_pAudioItems)
+		updateDeviceItems(m_pAudioItems, true);
+	if (m_pMidiItems)
+		updateDeviceItems(m_pMidiItems, true);
+
+	// Done.
+	m_iDirtySetup--;
+
+	// Show something (current selection is kept, if still there).
+	selectDevice();
+}
+
+
+// Update device list items, only those that were added or removed.
+void DeviceForm::updateDevices (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return;
+
+	// Avoid nested changes.
+	m_iDirtySetup++;
+
+	QTreeWidgetItem *pCurrentItem = m_ui.DeviceListView->currentItem();
+	updateRootItems();
+	int iChanges = 0;
+	if (m_pAudioItems && updateDeviceItems(m_pAudioItems, false))
+		++iChanges;
+	if (m_pMidiItems && updateDeviceItems(m_pMidiItems, false))
+		++iChanges;
+
+	// Done.
+	m_iDirtySetup--;
+
+	// Only bother if current selection has gone...
+	if (m_ui.DeviceListView->currentItem() != pCurrentItem)
+		selectDevice();
+	else
+	if (iChanges > 0)
+		stabilizeForm();
+}
+
+
+// Update one single device list item, in place.
+void DeviceForm::updateDevice ( Device::DeviceType deviceType, int iDeviceID )
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return;
+	if (pMainForm->client() == nullptr)
+		return;
+
+	DeviceItem *pRootItem = nullptr;
+	switch (deviceType) {
+	case Device::Audio:
+		pRootItem = m_pAudioItems;
+		break;
+	case Device::Midi:
+		pRootItem = m_pMidiItems;
+		break;
+	case Device::None:
+		break;
+	}
+
+	if (pRootItem == nullptr)
+		return;
+
+	// Do we know about it already?
+	DeviceItem *pDeviceItem = deviceItem(pRootItem, iDeviceID);
+	if (pDeviceItem == nullptr) {
+		updateDevices();
+		return;
+	}
+
+	// Avoid nested changes.
+	m_iDirtySetup++;
+	pDeviceItem->refreshDevice();
+	m_iDirtySetup--;
+
+	// Current selected device views must be refreshed,
+	// as its parameters and ports have been reset...
+	if (m_ui.DeviceListView->currentItem() == pDeviceItem)
+		selectDevice();
+}
+
+
+// Device list view root items (re)creation.
+void DeviceForm::updateRootItems (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return;
+
+	const bool bAudio = (pMainForm->client() != nullptr
+		&& (m_deviceTypeMode == Device::None
+		||  m_deviceTypeMode == Device::Audio));
+	const bool bMidi = (pMainForm->client() != nullptr
+		&& (m_deviceTypeMode == Device::None
+		||  m_deviceTypeMode == Device::Midi));
+
+	// Nothing to do if root items are just what we need...
+	if (bAudio == (m_pAudioItems != nullptr) &&
+		bMidi  == (m_pMidiItems  != nullptr))
+		return;
+
 	m_pAudioItems = nullptr;
 	m_pMidiItems = nullptr;
 	m_ui.DeviceListView->clear();
-	if (pMainForm->client()) {
-		int *piDeviceIDs;
-		// Grab and pop Audio devices...
-		if (m_deviceTypeMode == Device::None ||
-			m_deviceTypeMode == Device::Audio) {
-			m_pAudioItems = new DeviceItem(m_ui.DeviceListView,
-				Device::Audio);
-		}
-		if (m_pAudioItems) {
-			piDeviceIDs = Device::getDevices(pMainForm->client(),
-				Device::Audio);
-			for (int i = 0; piDeviceIDs && piDeviceIDs[i] >= 0; i++) {
-				new DeviceItem(m_pAudioItems,
-					Device::Audio, piDeviceIDs[i]);
-			}
-			m_pAudioItems->setExpanded(true);
-		}
-		// Grab and pop MIDI devices...
-		if (m_deviceTypeMode == Device::None ||
-			m_deviceTypeMode == Device::Midi) {
-			m_pMidiItems = new DeviceItem(m_ui.DeviceListView,
-				Device::Midi);
+
+	if (bAudio) {
+		m_pAudioItems = new DeviceItem(m_ui.DeviceListView,
+			Device::Audio);
+		m_pAudioItems->setExpanded(true);
+	}
+
+	if (bMidi) {
+		m_pMidiItems = new DeviceItem(m_ui.DeviceListView,
+			Device::Midi);
+		m_pMidiItems->setExpanded(true);
+	}
+}
+
+
+// Device list view items diff against the server;
+// returns whether any item has been added or removed.
+bool DeviceForm::updateDeviceItems ( DeviceItem *pRootItem, bool bRefresh )
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+	if (pMainForm->client() == nullptr)
+		return false;
+
+	const Device::DeviceType deviceType = pRootItem->device().deviceType();
+	const std::set<int> deviceIDs
+		= Device::getDeviceIDs(pMainForm->client(), deviceType);
+
+	int iChanges = 0;
+
+	// Remove stale items, refreshing existing ones if asked...
+	std::set<int> itemIDs;
+	for (int i = pRootItem->childCount() - 1; i >= 0; --i) {
+		DeviceItem *pDeviceItem
+			= static_cast<DeviceItem *> (pRootItem->child(i));
+		const int iDeviceID = pDeviceItem->device().deviceID();
+		if (deviceIDs.find(iDeviceID) == deviceIDs.end()) {
+			delete pDeviceItem;
+			++iChanges;
+		} else {
+			if (bRefresh)
+				pDeviceItem->refreshDevice();
+			itemIDs.insert(iDeviceID);
 		}
-		if (m_pMidiItems) {
-			piDeviceIDs = Device::getDevices(pMainForm->client(),
-				Device::Midi);
-			for (int i = 0; piDeviceIDs && piDeviceIDs[i] >= 0; i++) {
-				new DeviceItem(m_pMidiItems,
-					Device::Midi, piDeviceIDs[i]);
-			}
-			m_pMidiItems->setExpanded(true);
+	}
+
+	// Add the brand new ones...
+	std::set<int>::const_iterator iter = deviceIDs.begin();
+	for ( ; iter != deviceIDs.end(); ++iter) {
+		if (itemIDs.find(*iter) == itemIDs.end()) {
+			new DeviceItem(pRootItem, deviceType, *iter);
+			++iChanges;
 		}
 	}
 
-	// Done.
-	m_iDirtySetup--;
+	return (iChanges > 0);
+}
 
-	// Show something.
-	selectDevice();
+
+// Device list view item finder.
+DeviceItem *DeviceForm::deviceItem (
+	DeviceItem *pRootItem, int iDeviceID ) const
+{
+	for (int i = 0; i < pRootItem->childCount(); i++) {
+		DeviceItem *pDeviceItem
+			= static_cast<DeviceItem *> (pRootItem->child(i));
+		if (pDeviceItem->device().deviceID() == iDeviceID)
+			return pDeviceItem;
+	}
+
+	return nullptr;
 }
 
 
@@ -47,6 +47,10 @@ public:
 	void setDriverName(const QString& sDriverName);
 	void setDevice(Device *pDevice);
 
+	// Incremental device list updates (eg. on LSCP events).
+	void updateDevices();
+	void updateDevice(Device::DeviceType deviceType, int iDeviceID);
+
 public slots:
 
 	void createDevice();
@@ -76,6 +80,15 @@ protected:
 	void showEvent(QShowEvent* pShowEvent);
 	void hideEvent(QHideEvent* pHideEvent);
 
+	// Device list view root items (re)creation.
+	void updateRootItems();
+
+	// Device list view items diff against the server.
+	bool updateDeviceItems(DeviceItem *pRootItem, bool bRefresh);
+
+	// Device list view item finder.
+	DeviceItem *deviceItem(DeviceItem *pRootItem, int iDeviceID) const;
+
 private:
 
 	Ui::qsamplerDeviceForm m_ui;
@@ -24,6 +24,7 @@
 #include "qsamplerDeviceStatusForm.h"
 
 #include "qsamplerMainForm.h"
+#include "qsamplerMidiActivity.h"
 
 #include <QGridLayout>
 
@@ -40,55 +41,25 @@ namespace QSampler {
 // QSampler::MidiActivityLED -- Graphical indicator for MIDI activity.
 //
 
-// MIDI activity pixmap common resources.
-int      MidiActivityLED::g_iMidiActivityRefCount = 0;
-QPixmap *MidiActivityLED::g_pMidiActivityLedOn    = nullptr;
-QPixmap *MidiActivityLED::g_pMidiActivityLedOff   = nullptr;
-
-
 MidiActivityLED::MidiActivityLED ( QString sText, QWidget *pParent )
 	: QLabel(sText, pParent)
 {
-	if (++g_iMidiActivityRefCount == 1) {
-		g_pMidiActivityLedOn  = new QPixmap(":/images/ledon1.png");
-		g_pMidiActivityLedOff = new QPixmap(":/images/ledoff1.png");
-	}
-
-	setPixmap(*g_pMidiActivityLedOff);
+	MidiActivityClock::attach(this);
 #ifndef CONFIG_EVENT_DEVICE_MIDI
 	setToolTip("MIDI Activity disabled");
 #endif
-	m_timer.setSingleShot(true);
-
-	QObject::connect(&m_timer,
-		SIGNAL(timeout()),
-		SLOT(midiActivityLedOff())
-	);
 }
 
 MidiActivityLED::~MidiActivityLED (void)
 {
-	if (--g_iMidiActivityRefCount == 0) {
-		if (g_pMidiActivityLedOn)
-			delete g_pMidiActivityLedOn;
-		g_pMidiActivityLedOn = nullptr;
-		if (g_pMidiActivityLedOff)
-			delete g_pMidiActivityLedOff;
-		g_pMidiActivityLedOff = nullptr;
-	}
+	MidiActivityClock::detach(this);
 }
 
 
 void MidiActivityLED::midiActivityLedOn (void)
 {
-	setPixmap(*g_pMidiActivityLedOn);
-	m_timer.start(100);
-}
-
-
-void MidiActivityLED::midiActivityLedOff (void)
-{
-	setPixmap(*g_pMidiActivityLedOff);
+	// Just latch it; shown on the next shared clock frame.
+	MidiActivityClock::trigger(this);
 }
 
 
@@ -130,32 +101,42 @@ void DeviceStatusForm::updateGUIPorts (void)
 {
 	// refresh device informations
 	m_pDevice->setDevice(m_pDevice->deviceType(), m_pDevice->deviceID());
-	DevicePortList ports = m_pDevice->ports();
+	const DevicePortList& ports = m_pDevice->ports();
+	const uint iPorts = ports.size();
 
-	// clear the GUI
 	QGridLayout *pLayout = static_cast<QGridLayout *> (layout());
-	for (int i = pLayout->count() - 1; i >= 0; --i) {
-		QLayoutItem *pItem = pLayout->itemAt(i);
-		if (pItem) {
-			pLayout->removeItem(pItem);
-			if (pItem->widget())
-				delete pItem->widget();
-			delete pItem;
-		}
-	}
 
-	m_midiActivityLEDs.clear();
+	// drop any port rows in excess
+	while (m_midiActivityLEDs.size() > iPorts) {
+		MidiActivityLED *pLED = m_midiActivityLEDs.back();
+		m_midiActivityLEDs.pop_back();
+		pLayout->removeWidget(pLED);
+		delete pLED;
+		QLabel *pLabel = m_midiPortLabels.back();
+		m_midiPortLabels.pop_back();
+		pLayout->removeWidget(pLabel);
+		delete pLabel;
+	}
 
-	// rebuild the GUI
-	for (int i = 0; i < ports.size(); ++i) {
+	// add any missing port rows
+	while (m_midiActivityLEDs.size() < iPorts) {
+		const int iRow = m_midiActivityLEDs.size();
 		MidiActivityLED *pLED = new MidiActivityLED();
 		m_midiActivityLEDs.push_back(pLED);
-		pLayout->addWidget(pLED, i, 0);
-		QLabel *pLabel = new QLabel(
-			m_pDevice->deviceTypeName()
+		pLayout->addWidget(pLED, iRow, 0);
+		QLabel *pLabel = new QLabel();
+		m_midiPortLabels.push_back(pLabel);
+		pLayout->addWidget(pLabel, iRow, 1, Qt::AlignLeft);
+	}
+
+	// update port names, in place
+	for (uint i = 0; i < iPorts; ++i) {
+		const QString& sText = m_pDevice->deviceTypeName()
 			+ ' ' + m_pDevice->driverName()
-			+ ' ' + ports[i]->portName());
-		pLayout->addWidget(pLabel, i, 1, Qt::AlignLeft);
+			+ ' ' + ports.at(i)->portName();
+		QLabel *pLabel = m_midiPortLabels[i];
+		if (pLabel->text() != sText)
+			pLabel->setText(sText);
 	}
 }
 
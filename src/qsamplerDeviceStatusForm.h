@@ -29,7 +29,6 @@
 #include <QAction>
 #include <QCloseEvent>
 #include <QLabel>
-#include <QTimer>
 
 #include <map>
 
@@ -46,19 +45,6 @@ public:
 	~MidiActivityLED();
 
 	void midiActivityLedOn();
-
-protected slots:
-
-	void midiActivityLedOff();
-
-private:
-
-	QTimer m_timer;
-
-	// MIDI activity pixmap common resources.
-	static int      g_iMidiActivityRefCount;
-	static QPixmap *g_pMidiActivityLedOn;
-	static QPixmap *g_pMidiActivityLedOff;
 };
 
 
@@ -96,6 +82,7 @@ private:
 	QAction *m_pVisibleAction;
 
 	std::vector<MidiActivityLED *> m_midiActivityLEDs;
+	std::vector<QLabel *> m_midiPortLabels;
 
 	static std::map<int, DeviceStatusForm*> g_instances;
 };
@@ -25,6 +25,7 @@
 #include "qsamplerUtilities.h"
 #include "qsamplerOptions.h"
 #include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
 
 namespace QSampler {
 
@@ -33,7 +34,8 @@ namespace QSampler {
 
 FxSend::FxSend(int SamplerChannelID, int FxSendID) :
 	m_iSamplerChannelID(SamplerChannelID),
-	m_iFxSendID(FxSendID), m_bDelete(false), m_bModified(false)
+	m_iFxSendID(FxSendID), m_bDelete(false), m_bDestroyed(false),
+	m_iDirty(0)
 {
 	m_MidiCtrl = 91;
 	m_Depth    = 0.0f;
@@ -41,7 +43,8 @@ FxSend::FxSend(int SamplerChannelID, int FxSendID) :
 
 FxSend::FxSend(int SamplerChannelID) :
 	m_iSamplerChannelID(SamplerChannelID),
-	m_iFxSendID(NEW_FX_SEND), m_bDelete(false), m_bModified(true)
+	m_iFxSendID(NEW_FX_SEND), m_bDelete(false), m_bDestroyed(false),
+	m_iDirty(DirtyName | DirtyDepth)
 {
 	m_MidiCtrl = 91;
 	m_Depth    = 0.0f;
@@ -60,7 +63,6 @@ bool FxSend::isNew() const {
 
 void FxSend::setDeletion(bool bDelete) {
 	m_bDelete = bDelete;
-	m_bModified = true;
 }
 
 bool FxSend::deletion() const {
@@ -68,12 +70,18 @@ bool FxSend::deletion() const {
 }
 
 void FxSend::setName(const QString& sName) {
+	if (m_FxSendName == sName)
+		return;
 	m_FxSendName = sName;
-	m_bModified = true;
+	m_iDirty |= DirtyName;
 }
 
 bool FxSend::isModified() const {
-	return m_bModified;
+	return isNew() || m_bDelete || m_iDirty || !m_DirtyRouting.isEmpty();
+}
+
+bool FxSend::isDestroyed() const {
+	return m_bDestroyed;
 }
 
 const QString& FxSend::name() const {
@@ -81,8 +89,10 @@ const QString& FxSend::name() const {
 }
 
 void FxSend::setSendDepthMidiCtrl(int iMidiController) {
+	if (m_MidiCtrl == iMidiController)
+		return;
 	m_MidiCtrl = iMidiController;
-	m_bModified = true;
+	m_iDirty |= DirtyMidiCtrl;
 }
 
 int FxSend::sendDepthMidiCtrl() const {
@@ -90,8 +100,10 @@ int FxSend::sendDepthMidiCtrl() const {
 }
 
 void FxSend::setCurrentDepth(float depth) {
+	if (m_Depth == depth)
+		return;
 	m_Depth = depth;
-	m_bModified = true;
+	m_iDirty |= DirtyDepth;
 }
 
 float FxSend::currentDepth() const {
@@ -109,8 +121,12 @@ bool FxSend::setAudioChannel(int iAudioSrc, int iAudioDst) {
 	if (iAudioSrc < 0 || iAudioSrc >= m_AudioRouting.size())
 		return false;
 
+	if (m_AudioRouting[iAudioSrc] == iAudioDst)
+		return true;
+
 	m_AudioRouting[iAudioSrc] = iAudioDst;
-	m_bModified = true;
+	if (!m_DirtyRouting.contains(iAudioSrc))
+		m_DirtyRouting.append(iAudioSrc);
 
 	return true;
 }
@@ -121,7 +137,8 @@ const FxSendRoutingMap& FxSend::audioRouting() const {
 
 bool FxSend::getFromSampler() {
 #if CONFIG_FXSEND
-	m_bModified = false;
+	m_iDirty = 0;
+	m_DirtyRouting.clear();
 
 	// in case this is a new, actually not yet existing FX send, ignore update
 	if (isNew())
@@ -132,7 +149,7 @@ bool FxSend::getFromSampler() {
 		return false;
 
 	lscp_fxsend_info_t* pFxSendInfo =
-		::lscp_get_fxsend_info(
+		QSAMPLER_LSCP(lscp_get_fxsend_info,
 			pMainForm->client(),
 			m_iSamplerChannelID,
 			m_iFxSendID);
@@ -167,12 +184,14 @@ bool FxSend::applyToSampler() {
 	if (isNew()) {
 		// doesn't exist and scheduled for deletion? nothing to do
 		if (deletion()) {
-			m_bModified = false;
+			m_iDirty = 0;
+			m_DirtyRouting.clear();
+			m_bDestroyed = true;
 			return true;
 		}
 
 		int result =
-			::lscp_create_fxsend(
+			QSAMPLER_LSCP(lscp_create_fxsend,
 				pMainForm->client(),
 				m_iSamplerChannelID,
 				m_MidiCtrl, nullptr
@@ -182,77 +201,71 @@ bool FxSend::applyToSampler() {
 			return false;
 		}
 		m_iFxSendID = result;
+		m_iDirty &= ~DirtyMidiCtrl;
 	}
 
-	lscp_status_t result;
+	const QString sFxSend = QString::number(m_iSamplerChannelID)
+		+ ' ' + QString::number(m_iFxSendID);
+
+	// build the batch of commands, only for what has really changed
+	QStringList commands;
+	QList<int> flags;
 
-	// delete FX send on sampler side
 	if (deletion()) {
-		result =
-			::lscp_destroy_fxsend(
-				pMainForm->client(), m_iSamplerChannelID, m_iFxSendID
-			);
-		if (result != LSCP_OK) {
-			pMainForm->appendMessagesClient("lscp_destroy_fxsend");
-			return false;
+		commands.append("DESTROY FX_SEND " + sFxSend);
+		flags.append(0);
+	} else {
+		if (m_iDirty & DirtyMidiCtrl) {
+			commands.append("SET FX_SEND MIDI_CONTROLLER " + sFxSend
+				+ ' ' + QString::number(m_MidiCtrl));
+			flags.append(DirtyMidiCtrl);
+		}
+	#if CONFIG_FXSEND_RENAME
+		if (m_iDirty & DirtyName) {
+			commands.append("SET FX_SEND NAME " + sFxSend + " '"
+				+ qsamplerUtilities::lscpEscapeText(m_FxSendName) + '\'');
+			flags.append(DirtyName);
+		}
+	#else
+		// no way to rename it anyway
+		m_iDirty &= ~DirtyName;
+	#endif // CONFIG_FXSEND_RENAME
+		if (m_iDirty & DirtyDepth) {
+			commands.append("SET FX_SEND LEVEL " + sFxSend
+				+ ' ' + QString::number(m_Depth));
+			flags.append(DirtyDepth);
+		}
+		QListIterator<int> iter(m_DirtyRouting);
+		while (iter.hasNext()) {
+			const int iAudioSrc = iter.next();
+			commands.append("SET FX_SEND AUDIO_OUTPUT_CHANNEL " + sFxSend
+				+ ' ' + QString::number(iAudioSrc)
+				+ ' ' + QString::number(m_AudioRouting.value(iAudioSrc)));
+			flags.append(-1 - iAudioSrc);
 		}
-		m_bModified = false;
-		return true;
-	}
-
-	// set FX send depth MIDI controller
-	result =
-		::lscp_set_fxsend_midi_controller(
-			pMainForm->client(),
-			m_iSamplerChannelID, m_iFxSendID, m_MidiCtrl
-		);
-	if (result != LSCP_OK) {
-		pMainForm->appendMessagesClient("lscp_set_fxsend_midi_controller");
-		return false;
-	}
-
-#if CONFIG_FXSEND_RENAME
-	// set FX send's name
-	result =
-		::lscp_set_fxsend_name(
-			pMainForm->client(),
-			m_iSamplerChannelID, m_iFxSendID,
-			qsamplerUtilities::lscpEscapeText(
-				m_FxSendName
-			).toUtf8().constData()
-		);
-	if (result != LSCP_OK) {
-		pMainForm->appendMessagesClient("lscp_set_fxsend_name");
-		return false;
-	}
-#endif // CONFIG_FXSEND_RENAME
-
-	// set FX send current send level
-	result =
-		::lscp_set_fxsend_level(
-			pMainForm->client(),
-			m_iSamplerChannelID, m_iFxSendID, m_Depth
-		);
-	if (result != LSCP_OK) {
-		pMainForm->appendMessagesClient("lscp_set_fxsend_level");
-		return false;
 	}
 
-	// set FX send's audio routing
-	for (int i = 0; i < m_AudioRouting.size(); ++i) {
-		result =
-			::lscp_set_fxsend_audio_channel(
-				pMainForm->client(), m_iSamplerChannelID, m_iFxSendID,
-				i, /*audio source*/
-				m_AudioRouting[i] /*audio destination*/
-			);
-		if (result != LSCP_OK) {
-			pMainForm->appendMessagesClient("lscp_set_fxsend_audio_channel");
+	// send it all over in one go
+	for (int i = 0; i < commands.size(); ++i) {
+		// all LSCP commands are CR/LF terminated.
+		const QString sCommand = commands.at(i) + "\r\n";
+		if (LscpStats::query(pMainForm->client(),
+				sCommand.toUtf8().constData()) != LSCP_OK) {
+			pMainForm->appendMessagesColor(commands.at(i), "#996633");
+			pMainForm->appendMessagesClient("lscp_client_query");
 			return false;
 		}
+		// clean it up, as we go...
+		const int iFlag = flags.at(i);
+		if (iFlag < 0)
+			m_DirtyRouting.removeAll(-1 - iFlag);
+		else
+			m_iDirty &= ~iFlag;
 	}
 
-	m_bModified = false;
+	if (deletion())
+		m_bDestroyed = true;
+
 	return true;
 #else // CONFIG_FXSEND
 	return false;
@@ -267,7 +280,7 @@ QList<int> FxSend::allFxSendsOfSamplerChannel(int samplerChannelID) {
 		return sends;
 
 #ifdef CONFIG_FXSEND
-	int *piSends = ::lscp_list_fxsends(pMainForm->client(), samplerChannelID);
+	int *piSends = QSAMPLER_LSCP(lscp_list_fxsends, pMainForm->client(), samplerChannelID);
 	if (!piSends) {
 		if (::lscp_client_get_errno(pMainForm->client()))
 			pMainForm->appendMessagesClient("lscp_list_fxsends");
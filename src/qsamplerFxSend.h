@@ -71,13 +71,25 @@ public:
 	bool getFromSampler();
 	bool applyToSampler();
 
+	// whether successfully destroyed on sampler side
+	bool isDestroyed() const;
+
 	static QList<int> allFxSendsOfSamplerChannel(int samplerChannelID);
 
 private:
+	// per-field modification flags
+	enum DirtyFlag {
+		DirtyName     = 1,
+		DirtyMidiCtrl = 2,
+		DirtyDepth    = 4
+	};
+
 	int m_iSamplerChannelID;
 	int m_iFxSendID;
 	bool m_bDelete;
-	bool m_bModified;
+	bool m_bDestroyed;
+	int m_iDirty;
+	QList<int> m_DirtyRouting;
 
 	QString m_FxSendName;
 	int m_MidiCtrl;
@@ -203,12 +203,38 @@ void FxSendsModel::onExternalModifiication ( const QModelIndex& index )
 
 void FxSendsModel::applyToSampler (void)
 {
-	for (int i = 0; i < m_fxSends.size(); ++i)
-		m_fxSends[i].applyToSampler();
+	bool bDirty = false;
+
+	// send only what's changed, keeping the values we know of...
+	FxSendsList::Iterator iter = m_fxSends.begin();
+	while (iter != m_fxSends.end()) {
+		FxSend& fxSend = *iter;
+		if (!fxSend.isModified()) {
+			++iter;
+			continue;
+		}
+		const bool bNew = fxSend.isNew();
+		if (fxSend.applyToSampler() && bNew && !fxSend.deletion()) {
+			// only brand new ones need to learn their default routing
+			fxSend.getFromSampler();
+		}
+		// throw out the ones actually gone...
+		if (fxSend.isDestroyed()) {
+			iter = m_fxSends.erase(iter);
+			continue;
+		}
+		if (fxSend.isModified())
+			bDirty = true;
+		++iter;
+	}
 
-	// make a clean refresh
-	// (throws out all FxSend objects marked for deletion)
-	cleanRefresh();
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+	QAbstractListModel::reset();
+#else
+	QAbstractListModel::beginResetModel();
+	QAbstractListModel::endResetModel();
+#endif
+	emit fxSendsDirtyChanged(bDirty);
 }
 
 
@@ -26,6 +26,7 @@
 
 #include "qsamplerOptions.h"
 #include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
 
 
 namespace QSampler {
@@ -194,7 +195,7 @@ bool Instrument::mapInstrument (void)
 			break;
 	}
 
-	if (::lscp_map_midi_instrument(pMainForm->client(), &instr,
+	if (QSAMPLER_LSCP(lscp_map_midi_instrument, pMainForm->client(), &instr,
 			m_sEngineName.toUtf8().constData(),
 			qsamplerUtilities::lscpEscapePath(
 				m_sInstrumentFile).toUtf8().constData(),
@@ -233,7 +234,7 @@ bool Instrument::unmapInstrument (void)
 	instr.bank = (m_iBank & 0x0fff);
 	instr.prog = (m_iProg & 0x7f);
 
-	if (::lscp_unmap_midi_instrument(pMainForm->client(), &instr) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_unmap_midi_instrument, pMainForm->client(), &instr) != LSCP_OK) {
 		pMainForm->appendMessagesClient("lscp_unmap_midi_instrument");
 		return false;
 	}
@@ -268,7 +269,7 @@ bool Instrument::getInstrument (void)
 	instr.prog = (m_iProg & 0x7f);
 
 	lscp_midi_instrument_info_t *pInstrInfo
-		= ::lscp_get_midi_instrument_info(pMainForm->client(), &instr);
+		= QSAMPLER_LSCP(lscp_get_midi_instrument_info, pMainForm->client(), &instr);
 	if (pInstrInfo == nullptr) {
 		pMainForm->appendMessagesClient("lscp_get_midi_instrument_info");
 		return false;
@@ -325,7 +326,7 @@ QStringList Instrument::getMapNames (void)
 		return maps;
 
 #ifdef CONFIG_MIDI_INSTRUMENT
-	int *piMaps = ::lscp_list_midi_instrument_maps(pMainForm->client());
+	int *piMaps = QSAMPLER_LSCP(lscp_list_midi_instrument_maps, pMainForm->client());
 	if (piMaps == nullptr) {
 		if (::lscp_client_get_errno(pMainForm->client()))
 			pMainForm->appendMessagesClient("lscp_list_midi_instruments");
@@ -354,7 +355,7 @@ QString Instrument::getMapName ( int iMidiMap )
 
 #ifdef CONFIG_MIDI_INSTRUMENT
 	const char *pszMapName
-		= ::lscp_get_midi_instrument_map_name(pMainForm->client(), iMidiMap);
+		= QSAMPLER_LSCP(lscp_get_midi_instrument_map_name, pMainForm->client(), iMidiMap);
 	if (pszMapName == nullptr) {
 		pszMapName = " -";
 		if (::lscp_client_get_errno(pMainForm->client()))
@@ -26,6 +26,7 @@
 #include "qsamplerOptions.h"
 #include "qsamplerChannel.h"
 #include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
 
 #include <QMessageBox>
 #include <QPushButton>
@@ -153,7 +154,7 @@ void InstrumentForm::setup ( Instrument *pInstrument )
 
 	// Populate Engines list.
 	const char **ppszEngines
-		= ::lscp_list_available_engines(pMainForm->client());
+		= QSAMPLER_LSCP(lscp_list_available_engines, pMainForm->client());
 	if (ppszEngines) {
 		m_ui.EngineNameComboBox->clear();
 		for (int iEngine = 0; ppszEngines[iEngine]; iEngine++)
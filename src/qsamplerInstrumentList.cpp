@@ -24,29 +24,116 @@
 #include "qsamplerInstrumentList.h"
 
 #include "qsamplerInstrument.h"
+#include "qsamplerTask.h"
 
 #include "qsamplerOptions.h"
 #include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
+#include "qsamplerTrace.h"
 
-#include <QApplication>
 #include <QHeaderView>
-#include <QCursor>
+#include <QPointer>
 
 
 namespace QSampler {
 
+//-------------------------------------------------------------------------
+// QSampler::InstrumentListTask - MIDI prog mappings loader (one per step)
+//
+
+class InstrumentListTask : public Task
+{
+public:
+
+	// Constructor.
+	InstrumentListTask(InstrumentListModel *pModel, int iMidiMap)
+		: m_pModel(pModel), m_iMidiMap(iMidiMap),
+			m_bListed(false), m_iInstr(0) {}
+
+	// Resolve just one instrument item.
+	bool step()
+	{
+		MainForm *pMainForm = MainForm::getInstance();
+		if (pMainForm == nullptr || pMainForm->client() == nullptr)
+			return false;
+		if (m_pModel.isNull())
+			return false;
+
+		// First, the whole list of keys...
+		if (!m_bListed) {
+			m_bListed = true;
+			lscp_midi_instrument_t *pInstrs
+				= QSAMPLER_LSCP(lscp_list_midi_instruments, pMainForm->client(), m_iMidiMap);
+			for (int iInstr = 0; pInstrs && pInstrs[iInstr].map >= 0; ++iInstr)
+				m_keys.append(pInstrs[iInstr]);
+			if (pInstrs == nullptr && ::lscp_client_get_errno(pMainForm->client())) {
+				pMainForm->appendMessagesClient("lscp_list_midi_instruments");
+				pMainForm->appendMessagesError(
+					QObject::tr("Could not get current list of MIDI instrument mappings.\n\nSorry."));
+			}
+			return !m_keys.isEmpty();
+		}
+
+		// Then each instrument info...
+		const lscp_midi_instrument_t& key = m_keys.at(m_iInstr++);
+		Instrument *pInstr = new Instrument(key.map, key.bank, key.prog);
+		if (pInstr->getInstrument())
+			m_instruments.append(pInstr);
+		else
+			delete pInstr;
+
+		return (m_iInstr < m_keys.count());
+	}
+
+	// Hand it all over to the model, if still there.
+	void finish()
+	{
+		if (isCancelled()) {
+			qDeleteAll(m_instruments);
+			m_instruments.clear();
+		}
+		if (m_pModel)
+			m_pModel->refreshDone(this, m_instruments);
+		else
+			qDeleteAll(m_instruments);
+	}
+
+	// Current progress percentage.
+	int progress() const
+	{
+		return (m_keys.isEmpty() ? 0 : (100 * m_iInstr) / m_keys.count());
+	}
+
+private:
+
+	// Instance variables.
+	QPointer<InstrumentListModel> m_pModel;
+
+	int  m_iMidiMap;
+	bool m_bListed;
+	int  m_iInstr;
+
+	QList<lscp_midi_instrument_t> m_keys;
+	QList<Instrument *> m_instruments;
+};
+
+
 //-------------------------------------------------------------------------
 // QSampler::InstrumentListModel - data model for MIDI prog mappings
 //
 
 InstrumentListModel::InstrumentListModel ( QObject *pParent )
-	: QAbstractItemModel(pParent), m_iMidiMap(LSCP_MIDI_MAP_ALL)
+	: QAbstractItemModel(pParent), m_iMidiMap(LSCP_MIDI_MAP_ALL),
+		m_pRefreshTask(nullptr), m_iLoadedMap(LSCP_MIDI_MAP_ALL), m_bLoaded(false)
 {
 //	QAbstractItemModel::reset();
 }
 
 InstrumentListModel::~InstrumentListModel (void)
 {
+	if (m_pRefreshTask)
+		m_pRefreshTask->cancel();
+
 	clear();
 }
 
@@ -187,6 +274,25 @@ int InstrumentListModel::midiMap (void) const
 const Instrument *InstrumentListModel::addInstrument (
 	int iMap, int iBank, int iProg )
 {
+	Instrument *pInstr = new Instrument(iMap, iBank, iProg);
+	if (pInstr->getInstrument()) {
+		insertInstrument(pInstr);
+	} else {
+		delete pInstr;
+		pInstr = nullptr;
+	}
+
+	return pInstr;
+}
+
+
+// Insert an already resolved instrument (takes ownership).
+void InstrumentListModel::insertInstrument ( Instrument *pInstrument )
+{
+	const int iMap  = pInstrument->map();
+	const int iBank = pInstrument->bank();
+	const int iProg = pInstrument->prog();
+
 	// Check it there's already one instrument item
 	// with the very same key (bank, program);
 	// if yes, just remove it without prejudice...
@@ -211,15 +317,7 @@ const Instrument *InstrumentListModel::addInstrument (
 		}
 	}
 
-	Instrument *pInstr = new Instrument(iMap, iBank, iProg);
-	if (pInstr->getInstrument()) {
-		list.insert(i, pInstr);
-	} else {
-		delete pInstr;
-		pInstr = nullptr;
-	}
-
-	return pInstr;
+	list.insert(i, pInstrument);
 }
 
 
@@ -263,35 +361,46 @@ void InstrumentListModel::resortInstrument ( Instrument *pInstrument )
 
 void InstrumentListModel::refresh (void)
 {
+	QSAMPLER_TRACE("model", "InstrumentListModel::refresh");
+
 	MainForm *pMainForm = MainForm::getInstance();
 	if (pMainForm == nullptr)
 		return;
 	if (pMainForm->client() == nullptr)
 		return;
 
-	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	// Supersede any refresh still going on...
+	if (m_pRefreshTask)
+		m_pRefreshTask->cancel();
 
-	clear();
+	// Load the whole bunch of instrument items, on the side...
+	m_iLoadedMap = m_iMidiMap;
+	m_bLoaded = false;
+	m_pRefreshTask = new InstrumentListTask(this, m_iMidiMap);
+	pMainForm->taskScheduler()->start(m_pRefreshTask);
+}
 
-	// Load the whole bunch of instrument items...
-	lscp_midi_instrument_t *pInstrs
-		= ::lscp_list_midi_instruments(pMainForm->client(), m_iMidiMap);
-	for (int iInstr = 0; pInstrs && pInstrs[iInstr].map >= 0; ++iInstr) {
-		const int iMap  = pInstrs[iInstr].map;
-		const int iBank = pInstrs[iInstr].bank;
-		const int iProg = pInstrs[iInstr].prog;
-		addInstrument(iMap, iBank, iProg);
-		// Try to keep it snappy :)
-		QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-	}
 
-	QApplication::restoreOverrideCursor();
+// Refresh completion (takes ownership of all the instruments).
+void InstrumentListModel::refreshDone (
+	Task *pTask, const QList<Instrument *>& instruments )
+{
+	QSAMPLER_TRACE("model", "InstrumentListModel::refreshDone");
 
-	if (pInstrs == nullptr && ::lscp_client_get_errno(pMainForm->client())) {
-		pMainForm->appendMessagesClient("lscp_list_midi_instruments");
-		pMainForm->appendMessagesError(
-			tr("Could not get current list of MIDI instrument mappings.\n\nSorry."));
+	if (m_pRefreshTask != pTask) {
+		qDeleteAll(instruments);
+		return;
 	}
+
+	m_pRefreshTask = nullptr;
+
+	beginReset();
+	clear();
+	QListIterator<Instrument *> iter(instruments);
+	while (iter.hasNext())
+		insertInstrument(iter.next());
+	m_bLoaded = !pTask->isCancelled();
+	endReset();
 }
 
 void InstrumentListModel::beginReset (void)
@@ -322,6 +431,23 @@ void InstrumentListModel::clear (void)
 	}
 
 	m_instruments.clear();
+
+	m_bLoaded = false;
+}
+
+
+// Whether the given map entries are all loaded.
+bool InstrumentListModel::isLoaded ( int iMidiMap ) const
+{
+	return (m_bLoaded && m_pRefreshTask == nullptr
+		&& (m_iLoadedMap == LSCP_MIDI_MAP_ALL || m_iLoadedMap == iMidiMap));
+}
+
+
+// The given map entries, sorted by bank and program.
+QList<Instrument *> InstrumentListModel::instruments ( int iMidiMap ) const
+{
+	return m_instruments.value(iMidiMap);
 }
 
 
@@ -420,9 +546,14 @@ void InstrumentListView::resortInstrument ( Instrument *pInstrument )
 // Refreshener.
 void InstrumentListView::refresh (void)
 {
-	m_pListModel->beginReset();
 	m_pListModel->refresh();
-	m_pListModel->endReset();
+}
+
+
+// Data model accessor.
+InstrumentListModel *InstrumentListView::listModel (void) const
+{
+	return m_pListModel;
 }
 
 
@@ -28,6 +28,7 @@
 namespace QSampler {
 
 class Instrument;
+class Task;
 
 //-------------------------------------------------------------------------
 // QSampler:InstrumentListModel - data model for MIDI prog mappings
@@ -63,9 +64,12 @@ public:
 	void updateInstrument(Instrument *pInstrument);
 	void resortInstrument(Instrument *pInstrument);
 
-	// General reloader.
+	// General reloader (deferred).
 	void refresh();
 
+	// Reloader completion (takes ownership of all the instruments).
+	void refreshDone(Task *pTask, const QList<Instrument *>& instruments);
+
 	// Make the following method public
 	void beginReset();
 	void endReset();
@@ -73,11 +77,19 @@ public:
 	// Map clear.
 	void clear();
 
+	// Whether the given map entries are all loaded, as of the last
+	// refresh (and our own changes since); and those entries.
+	bool isLoaded(int iMidiMap) const;
+	QList<Instrument *> instruments(int iMidiMap) const;
+
 protected:
 
 	QModelIndex index(int row, int col, const QModelIndex& parent) const;
 	QModelIndex parent(const QModelIndex& child) const;
 
+	// Insert an already resolved instrument (takes ownership).
+	void insertInstrument(Instrument *pInstrument);
+
 private:
 
 	typedef QList<Instrument *> InstrumentList;
@@ -87,6 +99,13 @@ private:
 
 	// Current map selection.
 	int m_iMidiMap;
+
+	// Pending reloader, if any.
+	Task *m_pRefreshTask;
+
+	// Last complete reload map selection, if any.
+	int  m_iLoadedMap;
+	bool m_bLoaded;
 };
 
 
@@ -119,6 +138,9 @@ public:
 	// General reloader.
 	void refresh();
 
+	// Data model accessor.
+	InstrumentListModel *listModel() const;
+
 private:
 
 	// Instance variables.
@@ -105,12 +105,19 @@ InstrumentListForm::~InstrumentListForm (void)
 }
 
 
+// List view accessor.
+InstrumentListView *InstrumentListForm::listView (void) const
+{
+	return m_pInstrumentListView;
+}
+
+
 // Notify our parent that we're emerging.
 void InstrumentListForm::showEvent ( QShowEvent *pShowEvent )
 {
 	MainForm* pMainForm = MainForm::getInstance();
 	if (pMainForm)
-		pMainForm->stabilizeForm();
+		pMainForm->stabilizeForm(MainForm::StabilizeForms);
 
 	QWidget::showEvent(pShowEvent);
 }
@@ -123,7 +130,7 @@ void InstrumentListForm::hideEvent ( QHideEvent *pHideEvent )
 
 	MainForm* pMainForm = MainForm::getInstance();
 	if (pMainForm)
-		pMainForm->stabilizeForm();
+		pMainForm->stabilizeForm(MainForm::StabilizeForms);
 }
 
 
@@ -134,7 +141,7 @@ void InstrumentListForm::closeEvent ( QCloseEvent * /*pCloseEvent*/ )
 
 	MainForm *pMainForm = MainForm::getInstance();
 	if (pMainForm)
-		pMainForm->stabilizeForm();
+		pMainForm->stabilizeForm(MainForm::StabilizeForms);
 }
 
 
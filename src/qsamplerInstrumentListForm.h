@@ -45,6 +45,9 @@ public:
 	InstrumentListForm(QWidget *pParent = nullptr, Qt::WindowFlags wflags = Qt::WindowFlags());
 	~InstrumentListForm();
 
+	// List view accessor.
+	InstrumentListView *listView() const;
+
 public slots:
 
 	void newInstrument();
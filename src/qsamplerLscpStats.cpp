@@ -0,0 +1,292 @@
+// qsamplerLscpStats.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerLscpStats.h"
+#include "qsamplerTrace.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QFile>
+
+#include <algorithm>
+#include <cstring>
+
+
+// Deprecated QTextStreamFunctions/Qt namespaces workaround.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+#define endl	Qt::endl
+#endif
+
+
+namespace QSampler {
+
+// Histogram sub-bucket resolution (bits).
+#define QSAMPLER_HISTOGRAM_BITS  5
+#define QSAMPLER_HISTOGRAM_SUBS  (1 << QSAMPLER_HISTOGRAM_BITS)
+
+
+//-------------------------------------------------------------------------
+// QSampler::LscpHistogram -- Fixed memory, log-linear latency histogram.
+//
+
+// Constructor.
+LscpHistogram::LscpHistogram (void)
+{
+	clear();
+}
+
+
+// Record a single value.
+void LscpHistogram::record ( qint64 iValue )
+{
+	++m_buckets[bucketIndex(iValue)];
+	++m_iCount;
+}
+
+
+// Percentile value (p in [0, 100]).
+qint64 LscpHistogram::percentile ( float p ) const
+{
+	if (m_iCount < 1)
+		return 0;
+
+	quint64 iRank = quint64(0.01f * p * float(m_iCount) + 0.5f);
+	if (iRank < 1)
+		iRank = 1;
+	if (iRank > m_iCount)
+		iRank = m_iCount;
+
+	quint64 iSum = 0;
+	for (int i = 0; i < Buckets; ++i) {
+		iSum += m_buckets[i];
+		if (iSum >= iRank)
+			return bucketValue(i);
+	}
+
+	return bucketValue(Buckets - 1);
+}
+
+
+// Number of recorded values.
+quint64 LscpHistogram::count (void) const
+{
+	return m_iCount;
+}
+
+
+// Start over.
+void LscpHistogram::clear (void)
+{
+	::memset(m_buckets, 0, sizeof(m_buckets));
+	m_iCount = 0;
+}
+
+
+// Bucket index from value: the first 64 values get one bucket each,
+// then each power of two gets its own 32 linear sub-buckets.
+int LscpHistogram::bucketIndex ( qint64 iValue )
+{
+	if (iValue < 0)
+		iValue = 0;
+	if (iValue >= 0xffffffffLL)
+		iValue = 0xffffffffLL;
+
+	if (iValue < (QSAMPLER_HISTOGRAM_SUBS << 1))
+		return int(iValue);
+
+	int iShift = 0;
+	while ((iValue >> iShift) >= (QSAMPLER_HISTOGRAM_SUBS << 1))
+		++iShift;
+
+	return (iShift * QSAMPLER_HISTOGRAM_SUBS) + int(iValue >> iShift);
+}
+
+
+// Value back from bucket index (bucket middle).
+qint64 LscpHistogram::bucketValue ( int iIndex )
+{
+	if (iIndex < (QSAMPLER_HISTOGRAM_SUBS << 1))
+		return qint64(iIndex);
+
+	const int iShift = (iIndex / QSAMPLER_HISTOGRAM_SUBS) - 1;
+	const qint64 iSub = (iIndex % QSAMPLER_HISTOGRAM_SUBS) + QSAMPLER_HISTOGRAM_SUBS;
+
+	return (iSub << iShift) + ((1LL << iShift) >> 1);
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::LscpStats -- Per-command LSCP call statistics.
+//
+
+// The global accumulators.
+QMutex LscpStats::g_mutex;
+QHash<QByteArray, LscpStats::Entry *> LscpStats::g_entries;
+
+// Call probe timer (one per calling thread).
+static thread_local QElapsedTimer g_lscpTimer;
+
+
+// Call probes.
+void LscpStats::start (void)
+{
+	g_lscpTimer.start();
+}
+
+
+lscp_status_t LscpStats::stop ( const char *pszFunc, lscp_status_t ret )
+{
+	record(pszFunc, elapsed(), (ret != LSCP_OK));
+	return ret;
+}
+
+
+int LscpStats::stop ( const char *pszFunc, int ret )
+{
+	record(pszFunc, elapsed(), (ret < 0));
+	return ret;
+}
+
+
+// Instrumented raw LSCP query (also counts bytes).
+lscp_status_t LscpStats::query ( lscp_client_t *pClient, const char *pszQuery )
+{
+	start();
+
+	const lscp_status_t ret = ::lscp_client_query(pClient, pszQuery);
+
+	const qint64 iUsecs = elapsed();
+	const char *pszResult = ::lscp_client_get_result(pClient);
+	record("lscp_client_query", iUsecs, (ret != LSCP_OK),
+		int(::strlen(pszQuery)), (pszResult ? int(::strlen(pszResult)) : 0));
+
+	return ret;
+}
+
+
+// Elapsed time since the last start probe (usecs).
+qint64 LscpStats::elapsed (void)
+{
+	return g_lscpTimer.nsecsElapsed() / 1000;
+}
+
+
+// Record one call.
+void LscpStats::record ( const char *pszFunc, qint64 iUsecs, bool bError,
+	int iBytesOut, int iBytesIn )
+{
+	if (Trace::isEnabled())
+		Trace::complete("lscp", pszFunc, Trace::now() - iUsecs, iUsecs);
+
+	QMutexLocker locker(&g_mutex);
+
+	const QByteArray& func = QByteArray::fromRawData(pszFunc, ::strlen(pszFunc));
+	Entry *pEntry = g_entries.value(func, nullptr);
+	if (pEntry == nullptr) {
+		pEntry = new Entry();
+		g_entries.insert(QByteArray(pszFunc), pEntry);
+	}
+
+	pEntry->histogram.record(iUsecs);
+	pEntry->iTotal += iUsecs;
+	if (pEntry->iMax < iUsecs)
+		pEntry->iMax = iUsecs;
+	if (bError)
+		++pEntry->iErrors;
+	pEntry->iBytesOut += iBytesOut;
+	pEntry->iBytesIn += iBytesIn;
+}
+
+
+// Snapshot of all statistics, sorted by command.
+QList<LscpStats::Row> LscpStats::rows (void)
+{
+	QMutexLocker locker(&g_mutex);
+
+	QList<QByteArray> funcs = g_entries.keys();
+	std::sort(funcs.begin(), funcs.end());
+
+	QList<Row> rows;
+	QListIterator<QByteArray> iter(funcs);
+	while (iter.hasNext()) {
+		const QByteArray& func = iter.next();
+		const Entry *pEntry = g_entries.value(func);
+		Row row;
+		row.sCommand  = QString::fromLatin1(func);
+		row.iCount    = pEntry->histogram.count();
+		row.iErrors   = pEntry->iErrors;
+		row.iP50      = pEntry->histogram.percentile(50.0f);
+		row.iP95      = pEntry->histogram.percentile(95.0f);
+		row.iP99      = pEntry->histogram.percentile(99.0f);
+		row.iMax      = pEntry->iMax;
+		row.iMean     = (row.iCount > 0 ? pEntry->iTotal / qint64(row.iCount) : 0);
+		row.iBytesOut = pEntry->iBytesOut;
+		row.iBytesIn  = pEntry->iBytesIn;
+		rows.append(row);
+	}
+
+	return rows;
+}
+
+
+// Start over.
+void LscpStats::reset (void)
+{
+	QMutexLocker locker(&g_mutex);
+
+	qDeleteAll(g_entries);
+	g_entries.clear();
+}
+
+
+// Export all statistics as CSV.
+bool LscpStats::saveCsv ( const QString& sFilename )
+{
+	QFile file(sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		return false;
+
+	QTextStream ts(&file);
+	ts << "command,count,errors,p50_us,p95_us,p99_us,max_us,mean_us,"
+		"bytes_out,bytes_in" << endl;
+
+	const QList<Row>& rows = LscpStats::rows();
+	QListIterator<Row> iter(rows);
+	while (iter.hasNext()) {
+		const Row& row = iter.next();
+		ts << row.sCommand << ','
+			<< row.iCount << ',' << row.iErrors << ','
+			<< row.iP50 << ',' << row.iP95 << ',' << row.iP99 << ','
+			<< row.iMax << ',' << row.iMean << ','
+			<< row.iBytesOut << ',' << row.iBytesIn << endl;
+	}
+
+	file.close();
+
+	return (file.error() == QFile::NoError);
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerLscpStats.cpp
@@ -0,0 +1,167 @@
+// qsamplerLscpStats.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerLscpStats_h
+#define __qsamplerLscpStats_h
+
+#include <lscp/client.h>
+
+#include <QStringList>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+
+
+// Instrumented LSCP call, eg. QSAMPLER_LSCP(lscp_get_channels, pClient);
+// evaluates to whatever the plain call returns.
+#define QSAMPLER_LSCP(func, ...) \
+	(QSampler::LscpStats::start(), \
+		QSampler::LscpStats::stop(#func, ::func(__VA_ARGS__)))
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::LscpHistogram -- Fixed memory, log-linear latency histogram.
+//
+// Values (usecs) are bucketed with 5 significant bits of precision
+// (~3% relative error) from 1 usec up to a bit more than an hour.
+//
+
+class LscpHistogram
+{
+public:
+
+	// Constructor.
+	LscpHistogram();
+
+	// Record a single value.
+	void record(qint64 iValue);
+
+	// Percentile value (p in [0, 100]).
+	qint64 percentile(float p) const;
+
+	// Number of recorded values.
+	quint64 count() const;
+
+	// Start over.
+	void clear();
+
+	// Number of buckets.
+	enum { Buckets = 896 };
+
+private:
+
+	// Bucket index from value, and back (bucket middle).
+	static int bucketIndex(qint64 iValue);
+	static qint64 bucketValue(int iIndex);
+
+	// Instance variables.
+	quint32 m_buckets[Buckets];
+	quint64 m_iCount;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::LscpStats -- Per-command LSCP call statistics.
+//
+
+class LscpStats
+{
+public:
+
+	// Per-command statistics row (computed).
+	struct Row
+	{
+		QString sCommand;
+		quint64 iCount;
+		quint64 iErrors;
+		qint64  iP50;      // usecs.
+		qint64  iP95;      // usecs.
+		qint64  iP99;      // usecs.
+		qint64  iMax;      // usecs.
+		qint64  iMean;     // usecs.
+		quint64 iBytesOut; // Raw queries only.
+		quint64 iBytesIn;  // Raw queries only.
+	};
+
+	// Call probes (see QSAMPLER_LSCP above).
+	static void start();
+
+	static lscp_status_t stop(const char *pszFunc, lscp_status_t ret);
+	static int stop(const char *pszFunc, int ret);
+
+	template <typename T>
+	static T *stop(const char *pszFunc, T *p)
+		{ record(pszFunc, elapsed(), (p == nullptr)); return p; }
+
+	template <typename T>
+	static T stop(const char *pszFunc, T ret)
+		{ record(pszFunc, elapsed(), false); return ret; }
+
+	// Instrumented raw LSCP query (also counts bytes).
+	static lscp_status_t query(lscp_client_t *pClient, const char *pszQuery);
+
+	// Snapshot of all statistics, sorted by command.
+	static QList<Row> rows();
+
+	// Start over.
+	static void reset();
+
+	// Export all statistics as CSV.
+	static bool saveCsv(const QString& sFilename);
+
+private:
+
+	// Per-command accumulator.
+	struct Entry
+	{
+		Entry() : iErrors(0), iTotal(0), iMax(0),
+			iBytesOut(0), iBytesIn(0) {}
+
+		LscpHistogram histogram;
+
+		quint64 iErrors;
+		qint64  iTotal;
+		qint64  iMax;
+		quint64 iBytesOut;
+		quint64 iBytesIn;
+	};
+
+	// Elapsed time since the last start probe (usecs).
+	static qint64 elapsed();
+
+	// Record one call.
+	static void record(const char *pszFunc, qint64 iUsecs, bool bError,
+		int iBytesOut = 0, int iBytesIn = 0);
+
+	// The global accumulators.
+	static QMutex g_mutex;
+	static QHash<QByteArray, Entry *> g_entries;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerLscpStats_h
+
+
+// end of qsamplerLscpStats.h
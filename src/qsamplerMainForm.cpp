@@ -26,8 +26,24 @@
 #include "qsamplerOptions.h"
 #include "qsamplerChannel.h"
 #include "qsamplerMessages.h"
+#include "qsamplerChannelMixer.h"
+#include "qsamplerStatistics.h"
+#include "qsamplerMetrics.h"
+#include "qsamplerUnderrun.h"
+#include "qsamplerBudgetTuner.h"
+#include "qsamplerChannelLoader.h"
+#include "qsamplerChannelGroup.h"
+#include "qsamplerVolumeSender.h"
+#include "qsamplerSessionTask.h"
+#include "qsamplerSessionSnapshot.h"
+#include "qsamplerSessionDelta.h"
+
+#ifdef CONFIG_RECORDER
+#include "qsamplerRecorder.h"
+#endif
 
 #include "qsamplerChannelStrip.h"
+#include "qsamplerInstrument.h"
 #include "qsamplerInstrumentList.h"
 
 #include "qsamplerInstrumentListForm.h"
@@ -36,6 +52,8 @@
 #include "qsamplerDeviceStatusForm.h"
 
 #include "qsamplerPaletteForm.h"
+#include "qsamplerLscpStats.h"
+#include "qsamplerTrace.h"
 
 #include <QStyleFactory>
 
@@ -45,6 +63,8 @@
 #include <QApplication>
 #include <QProcess>
 #include <QMessageBox>
+#include <QInputDialog>
+#include <QMenu>
 
 #include <QRegExp>
 #include <QTextStream>
@@ -59,11 +79,11 @@
 #include <QSpinBox>
 #include <QSlider>
 #include <QLabel>
+#include <QProgressBar>
+#include <QToolButton>
 #include <QTimer>
 #include <QDateTime>
 
-#include <QElapsedTimer>
-
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 #include <QMimeData>
 #endif
@@ -160,6 +180,22 @@ namespace QSampler {
 // Specialties for thread-callback comunication.
 #define QSAMPLER_LSCP_EVENT   QEvent::Type(QEvent::User + 1)
 
+// Channel groups menu operations (as action data).
+enum ChannelGroupOperation
+{
+	ChannelGroupNew = 0,
+	ChannelGroupAdd,
+	ChannelGroupRemove,
+	ChannelGroupReset,
+	ChannelGroupMute,
+	ChannelGroupUnmute,
+	ChannelGroupSolo,
+	ChannelGroupUnsolo,
+	ChannelGroupVolume,
+	ChannelGroupMidiMap,
+	ChannelGroupDelete
+};
+
 
 //-------------------------------------------------------------------------
 // QSampler::LscpEvent -- specialty for LSCP callback comunication.
@@ -228,6 +264,15 @@ MainForm::MainForm ( QWidget *pParent )
 
 	// All child forms are to be created later, not earlier than setup.
 	m_pMessages = nullptr;
+	m_pChannelMixer = nullptr;
+	m_pStatistics = nullptr;
+	m_pChannelLoader = new ChannelLoader(this);
+	m_pVolumeSender = new VolumeSender(this);
+	m_pRecorder = nullptr;
+	m_pMetrics = new MetricsExporter(this);
+	m_pUnderrunDetector = new UnderrunDetector();
+	m_pBudgetTuner = new BudgetTuner(this);
+	m_pTaskScheduler = new TaskScheduler(this);
 	m_pInstrumentListForm = nullptr;
 	m_pDeviceForm = nullptr;
 
@@ -235,6 +280,8 @@ MainForm::MainForm ( QWidget *pParent )
 	m_iUntitled   = 0;
 	m_iDirtySetup = 0;
 	m_iDirtyCount = 0;
+	m_iStabilize = 0;
+	m_bStabilize = false;
 
 	m_pServer = nullptr;
 	m_pClient = nullptr;
@@ -365,6 +412,27 @@ MainForm::MainForm ( QWidget *pParent )
 	pLabel->setMinimumSize(pLabel->sizeHint());
 	m_statusItem[QSAMPLER_STATUS_SESSION] = pLabel;
 	statusBar()->addWidget(pLabel);
+	// Session loading/saving progress.
+	m_pTaskProgress = new QProgressBar(this);
+	m_pTaskProgress->setRange(0, 100);
+	m_pTaskProgress->setMaximumWidth(120);
+	m_pTaskProgress->setMaximumHeight(pLabel->sizeHint().height());
+	m_pTaskProgress->hide();
+	statusBar()->addPermanentWidget(m_pTaskProgress);
+	m_pTaskCancel = new QToolButton(this);
+	m_pTaskCancel->setText(tr("Cancel"));
+	m_pTaskCancel->setAutoRaise(true);
+	m_pTaskCancel->hide();
+	statusBar()->addPermanentWidget(m_pTaskCancel);
+	QObject::connect(m_pTaskScheduler,
+		SIGNAL(progress(int)),
+		m_pTaskProgress, SLOT(setValue(int)));
+	QObject::connect(m_pTaskScheduler,
+		SIGNAL(busyChanged(bool)),
+		SLOT(taskBusyChanged(bool)));
+	QObject::connect(m_pTaskCancel,
+		SIGNAL(clicked()),
+		m_pTaskScheduler, SLOT(cancel()));
 
 #if defined(__WIN32__) || defined(_WIN32) || defined(WIN32)
 	WSAStartup(MAKEWORD(1, 1), &_wsaData);
@@ -426,6 +494,15 @@ MainForm::MainForm ( QWidget *pParent )
 	QObject::connect(m_ui.viewMessagesAction,
 		SIGNAL(toggled(bool)),
 		SLOT(viewMessages(bool)));
+	QObject::connect(m_ui.viewMixerAction,
+		SIGNAL(toggled(bool)),
+		SLOT(viewMixer(bool)));
+	QObject::connect(m_ui.viewStatisticsAction,
+		SIGNAL(toggled(bool)),
+		SLOT(viewStatistics(bool)));
+	QObject::connect(m_ui.viewUnderrunReportAction,
+		SIGNAL(triggered()),
+		SLOT(viewUnderrunReport()));
 	QObject::connect(m_ui.viewInstrumentsAction,
 		SIGNAL(triggered()),
 		SLOT(viewInstruments()));
@@ -454,6 +531,9 @@ MainForm::MainForm ( QWidget *pParent )
 	QObject::connect(m_ui.channelsMenu,
 		SIGNAL(aboutToShow()),
 		SLOT(channelsMenuAboutToShow()));
+
+	// Channel groups submenu, rebuilt on demand.
+	m_pGroupsMenu = new QMenu(tr("&Groups"), this);
 #ifdef CONFIG_VOLUME
 	QObject::connect(m_ui.channelsToolbar,
 		SIGNAL(orientationChanged(Qt::Orientation)),
@@ -478,11 +558,22 @@ MainForm::~MainForm()
 		delete m_pSigtermNotifier;
 #endif
 
+	// Stop recording, if any.
+	if (m_pRecorder)
+		delete m_pRecorder;
+
+	if (m_pUnderrunDetector)
+		delete m_pUnderrunDetector;
+
 	// Finally drop any widgets around...
 	if (m_pDeviceForm)
 		delete m_pDeviceForm;
 	if (m_pInstrumentListForm)
 		delete m_pInstrumentListForm;
+	if (m_pChannelMixer)
+		delete m_pChannelMixer;
+	if (m_pStatistics)
+		delete m_pStatistics;
 	if (m_pMessages)
 		delete m_pMessages;
 	if (m_pWorkspace)
@@ -526,6 +617,8 @@ void MainForm::setup ( Options *pOptions )
 
 	// Some child forms are to be created right now.
 	m_pMessages = new Messages(this);
+	m_pChannelMixer = new ChannelMixer(this);
+	m_pStatistics = new Statistics(this);
 	m_pDeviceForm = new DeviceForm(this, wflags);
 #ifdef CONFIG_MIDI_INSTRUMENT
 	m_pInstrumentListForm = new InstrumentListForm(this, wflags);
@@ -543,10 +636,24 @@ void MainForm::setup ( Options *pOptions )
 	updateMessagesLimit();
 	updateMessagesCapture();
 
+	// Setup metrics exporting appropriately...
+	updateMetrics();
+
+	// Auto-tuned sampler limits are to be exported as well.
+	QObject::connect(m_pBudgetTuner,
+		SIGNAL(budgetChanged()),
+		m_pMetrics, SLOT(resetLimits()));
+
 	// Set the visibility signal.
 	QObject::connect(m_pMessages,
 		SIGNAL(visibilityChanged(bool)),
-		SLOT(stabilizeForm()));
+		SLOT(formVisibilityChanged()));
+	QObject::connect(m_pChannelMixer,
+		SIGNAL(visibilityChanged(bool)),
+		SLOT(formVisibilityChanged()));
+	QObject::connect(m_pStatistics,
+		SIGNAL(visibilityChanged(bool)),
+		SLOT(formVisibilityChanged()));
 
 	// Initial decorations toggle state.
 	m_ui.viewMenubarAction->setChecked(m_pOptions->bMenubar);
@@ -560,6 +667,11 @@ void MainForm::setup ( Options *pOptions )
 	viewStatusbar(m_pOptions->bStatusbar);
 
 	addDockWidget(Qt::BottomDockWidgetArea, m_pMessages);
+	addDockWidget(Qt::RightDockWidgetArea, m_pChannelMixer);
+	m_pChannelMixer->hide();
+	addDockWidget(Qt::BottomDockWidgetArea, m_pStatistics);
+	tabifyDockWidget(m_pMessages, m_pStatistics);
+	m_pStatistics->hide();
 
 	// Restore whole dock windows state.
 	QByteArray aDockables = m_pOptions->settings().value(
@@ -568,6 +680,9 @@ void MainForm::setup ( Options *pOptions )
 		restoreState(aDockables);
 	}
 
+	// The mixer shows up only if it's the channel view of choice.
+	m_pChannelMixer->setVisible(m_pOptions->bChannelMixer);
+
 	// Try to restore old window positioning and initial visibility.
 	m_pOptions->loadWidgetGeometry(this, true);
 	m_pOptions->loadWidgetGeometry(m_pInstrumentListForm);
@@ -640,9 +755,11 @@ void MainForm::closeEvent ( QCloseEvent *pCloseEvent )
 // Window drag-n-drop event handlers.
 void MainForm::dragEnterEvent ( QDragEnterEvent* pDragEnterEvent )
 {
-	// Accept external drags only...
+	// Accept external drags only, and not while
+	// a session file is being loaded or saved...
 	if (pDragEnterEvent->source() == nullptr
-		&& pDragEnterEvent->mimeData()->hasUrls()) {
+		&& pDragEnterEvent->mimeData()->hasUrls()
+		&& !isSessionBusy()) {
 		pDragEnterEvent->accept();
 	} else {
 		pDragEnterEvent->ignore();
@@ -653,11 +770,20 @@ void MainForm::dragEnterEvent ( QDragEnterEvent* pDragEnterEvent )
 void MainForm::dropEvent ( QDropEvent *pDropEvent )
 {
 	// Accept externally originated drops only...
-	if (pDropEvent->source())
+	if (pDropEvent->source() || isSessionBusy())
 		return;
 
 	const QMimeData *pMimeData = pDropEvent->mimeData();
 	if (pMimeData->hasUrls()) {
+		// Many instrument files (or folders) at once?
+		QStringList paths;
+		QListIterator<QUrl> url_iter(pMimeData->urls());
+		while (url_iter.hasNext())
+			paths.append(url_iter.next().toLocalFile());
+		if (paths.count() > 1 || QFileInfo(paths.first()).isDir()) {
+			addChannelStrips(ChannelLoader::instrumentFiles(paths));
+			return;
+		}
 		QListIterator<QUrl> iter(pMimeData->urls());
 		while (iter.hasNext()) {
 			const QString& sPath = iter.next().toLocalFile();
@@ -676,21 +802,17 @@ void MainForm::dropEvent ( QDropEvent *pDropEvent )
 					return;
 				}
 				// Finally, give it to a new channel strip...
-				if (!createChannelStrip(pChannel)) {
+				if (!createChannel(pChannel)) {
 					delete pChannel;
 					return;
 				}
 				// Make that an overall update.
 				m_iDirtyCount++;
-				stabilizeForm();
+				stabilizeForm(StabilizeSession | StabilizeChannel | StabilizeChannels);
 			}   // Otherwise, load an usual session file (LSCP script)...
-			else if (closeSession(true)) {
-				loadSessionFile(sPath);
+			else if (openSessionFile(sPath))
 				break;
-			}
 		}
-		// Make it look responsive...:)
-		QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 	}
 }
 
@@ -698,6 +820,10 @@ void MainForm::dropEvent ( QDropEvent *pDropEvent )
 // Custome event handler.
 void MainForm::customEvent ( QEvent* pEvent )
 {
+	QSAMPLER_TRACE("event", (pEvent->type() == QSAMPLER_LSCP_EVENT
+		? ::lscp_event_to_text(static_cast<LscpEvent *> (pEvent)->event())
+		: "customEvent"));
+
 	// For the time being, just pump it to messages.
 	if (pEvent->type() == QSAMPLER_LSCP_EVENT) {
 		LscpEvent *pLscpEvent = static_cast<LscpEvent *> (pEvent);
@@ -710,31 +836,37 @@ void MainForm::customEvent ( QEvent* pEvent )
 				ChannelStrip *pChannelStrip = channelStrip(iChannelID);
 				if (pChannelStrip)
 					channelStripChanged(pChannelStrip);
+				if (m_pChannelMixer)
+					m_pChannelMixer->mixerView()->updateChannel(iChannelID);
 				break;
 			}
 			case LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT:
-				if (m_pDeviceForm) m_pDeviceForm->refreshDevices();
+				if (m_pDeviceForm) m_pDeviceForm->updateDevices();
 				DeviceStatusForm::onDevicesChanged();
 				updateViewMidiDeviceStatusMenu();
 				break;
 			case LSCP_EVENT_MIDI_INPUT_DEVICE_INFO: {
-				if (m_pDeviceForm) m_pDeviceForm->refreshDevices();
 				const int iDeviceID = pLscpEvent->data().section(' ', 0, 0).toInt();
+				if (m_pDeviceForm) m_pDeviceForm->updateDevice(Device::Midi, iDeviceID);
 				DeviceStatusForm::onDeviceChanged(iDeviceID);
 				break;
 			}
 			case LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT:
-				if (m_pDeviceForm) m_pDeviceForm->refreshDevices();
+				if (m_pDeviceForm) m_pDeviceForm->updateDevices();
 				break;
-			case LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO:
-				if (m_pDeviceForm) m_pDeviceForm->refreshDevices();
+			case LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO: {
+				const int iDeviceID = pLscpEvent->data().section(' ', 0, 0).toInt();
+				if (m_pDeviceForm) m_pDeviceForm->updateDevice(Device::Audio, iDeviceID);
 				break;
+			}
 		#if CONFIG_EVENT_CHANNEL_MIDI
 			case LSCP_EVENT_CHANNEL_MIDI: {
 				const int iChannelID = pLscpEvent->data().section(' ', 0, 0).toInt();
 				ChannelStrip *pChannelStrip = channelStrip(iChannelID);
 				if (pChannelStrip)
 					pChannelStrip->midiActivityLedOn();
+				if (m_pChannelMixer)
+					m_pChannelMixer->mixerView()->midiActivity(iChannelID);
 				break;
 			}
 		#endif
@@ -797,13 +929,17 @@ void MainForm::updateViewMidiDeviceStatusMenu (void)
 		m_ui.viewMidiDeviceStatusMenu->addAction(
 			pStatusForm->visibleAction());
 	}
+
+	stabilizeForm(StabilizeForms);
 }
 
 
 // Context menu event handler.
 void MainForm::contextMenuEvent( QContextMenuEvent *pEvent )
 {
+	// Must be up-to-date, right now...
 	stabilizeForm();
+	stabilizeFlush();
 
 	m_ui.editMenu->exec(pEvent->globalPos());
 }
@@ -826,6 +962,27 @@ lscp_client_t *MainForm::client (void) const
 }
 
 
+// Cooperative task scheduler accessor.
+TaskScheduler *MainForm::taskScheduler (void) const
+{
+	return m_pTaskScheduler;
+}
+
+
+// Stream buffer underrun detector accessor.
+UnderrunDetector *MainForm::underrunDetector (void) const
+{
+	return m_pUnderrunDetector;
+}
+
+
+// Volume control sender accessor.
+VolumeSender *MainForm::volumeSender (void) const
+{
+	return m_pVolumeSender;
+}
+
+
 // The pseudo-singleton instance accessor.
 MainForm *MainForm::getInstance (void)
 {
@@ -866,7 +1023,7 @@ bool MainForm::newSession (void)
 	m_sFilename = QString();
 	m_iDirtyCount = 0;
 	appendMessages(tr("New session: \"%1\".").arg(sessionName(m_sFilename)));
-	stabilizeForm();
+	stabilizeForm(StabilizeSession | StabilizeChannel | StabilizeChannels);
 
 	return true;
 }
@@ -882,24 +1039,22 @@ bool MainForm::openSession (void)
 	QString sFilename = QFileDialog::getOpenFileName(this,
 		tr("Open Session"),                       // Caption.
 		m_pOptions->sSessionDir,                  // Start here.
-		tr("LSCP Session files") + " (*.lscp)"    // Filter (LSCP files)
+		tr("Session files") + " (*.lscp *.lss);;" // Filter (LSCP files)
+		+ tr("LSCP Session files") + " (*.lscp);;"
+		+ tr("Session snapshot files") + " (*.lss)"
 	);
 
 	// Have we cancelled?
 	if (sFilename.isEmpty())
 		return false;
 
-	// Check if we're going to discard safely the current one...
-	if (!closeSession(true))
-		return false;
-
 	// Load it right away.
-	return loadSessionFile(sFilename);
+	return openSessionFile(sFilename);
 }
 
 
 // Save current sampler session with another name.
-bool MainForm::saveSession ( bool bPrompt )
+bool MainForm::saveSession ( bool bPrompt, bool bAsync )
 {
 	if (m_pOptions == nullptr)
 		return false;
@@ -912,17 +1067,21 @@ bool MainForm::saveSession ( bool bPrompt )
 		if (sFilename.isEmpty())
 			sFilename = m_pOptions->sSessionDir;
 		// Prompt the guy...
+		const QString sSnapshotFilter
+			= tr("Session snapshot files") + " (*.lss)";
+		QString sFilter;
 		sFilename = QFileDialog::getSaveFileName(this,
 			tr("Save Session"),                       // Caption.
 			sFilename,                                // Start here.
-			tr("LSCP Session files") + " (*.lscp)"    // Filter (LSCP files)
+			tr("LSCP Session files") + " (*.lscp);;"  // Filter (LSCP files)
+			+ sSnapshotFilter, &sFilter
 		);
 		// Have we cancelled it?
 		if (sFilename.isEmpty())
 			return false;
-		// Enforce .lscp extension...
+		// Enforce .lscp (or .lss) extension...
 		if (QFileInfo(sFilename).suffix().isEmpty())
-			sFilename += ".lscp";
+			sFilename += (sFilter == sSnapshotFilter ? ".lss" : ".lscp");
 	#if 0
 		// Check if already exists...
 		if (sFilename != m_sFilename && QFileInfo(sFilename).exists()) {
@@ -940,15 +1099,20 @@ bool MainForm::saveSession ( bool bPrompt )
 	}
 
 	// Save it right away.
-	return saveSessionFile(sFilename);
+	return saveSessionFile(sFilename, bAsync);
 }
 
 
-// Close current session.
-bool MainForm::closeSession ( bool bForce )
+// Ask whether current session changes may be discarded.
+bool MainForm::querySession (void)
 {
 	bool bClose = true;
 
+	// Stop whatever session loading is going on,
+	// but let any session saving complete...
+	m_pTaskScheduler->cancel();
+	sessionWritersWait();
+
 	// Are we dirty enough to prompt it?
 	if (m_iDirtyCount > 0) {
 		switch (QMessageBox::warning(this,
@@ -961,7 +1125,7 @@ bool MainForm::closeSession ( bool bForce )
 			QMessageBox::Discard |
 			QMessageBox::Cancel)) {
 		case QMessageBox::Save:
-			bClose = saveSession(false);
+			bClose = saveSession(false, false);
 			// Fall thru....
 		case QMessageBox::Discard:
 			break;
@@ -971,8 +1135,24 @@ bool MainForm::closeSession ( bool bForce )
 		}
 	}
 
+	return bClose;
+}
+
+
+// Close current session.
+bool MainForm::closeSession ( bool bForce )
+{
+	const bool bClose = querySession();
+
 	// If we may close it, dot it.
 	if (bClose) {
+		// No more pending instrument loads...
+		m_pChannelLoader->clear();
+		// Nor volume changes...
+		m_pVolumeSender->flush();
+		// Nor channel groups...
+		qDeleteAll(m_channelGroups);
+		m_channelGroups.clear();
 		// Remove all channel strips from sight...
 		m_pWorkspace->setUpdatesEnabled(false);
 		const QList<QMdiSubWindow *>& wlist
@@ -989,6 +1169,16 @@ bool MainForm::closeSession ( bool bForce )
 			delete pMdiSubWindow;
 		}
 		m_pWorkspace->setUpdatesEnabled(true);
+		// Or the mixer rows, whichever...
+		if (m_pChannelMixer) {
+			ChannelMixerView *pMixerView = m_pChannelMixer->mixerView();
+			if (bForce) {
+				QListIterator<Channel *> iter(pMixerView->channels());
+				while (iter.hasNext())
+					iter.next()->removeChannel();
+			}
+			pMixerView->clearChannels();
+		}
 		// We're now clean, for sure.
 		m_iDirtyCount = 0;
 	}
@@ -997,59 +1187,108 @@ bool MainForm::closeSession ( bool bForce )
 }
 
 
+// Open a session from specific file path,
+// incrementally whenever possible (smart open).
+bool MainForm::openSessionFile ( const QString& sFilename )
+{
+	// One session file at a time...
+	if (isSessionBusy()) {
+		appendMessagesError(
+			tr("Could not open \"%1\" session file,\n"
+			"while another one is being loaded or saved.\n\nSorry.")
+			.arg(sFilename));
+		return false;
+	}
+
+	if (m_pOptions && m_pOptions->bSmartOpen && m_pClient) {
+		// Only if we fully understand it...
+		SessionSnapshot session;
+		if (session.load(sFilename) && session.isReset()) {
+			if (!querySession())
+				return false;
+			return switchSessionFile(session);
+		}
+		appendMessages(tr("Smart open: \"%1\" is not a plain session file.")
+			.arg(sessionName(sFilename)));
+	}
+
+	// Check if we're going to discard safely the current one...
+	if (!closeSession(true))
+		return false;
+
+	// Load it right away.
+	return loadSessionFile(sFilename);
+}
+
+
+// Switch to a parsed session, only changing what's different.
+bool MainForm::switchSessionFile ( const SessionSnapshot& session )
+{
+	if (m_pClient == nullptr)
+		return false;
+
+	// No more pending instrument loads...
+	m_pChannelLoader->clear();
+
+	// No channel strips updates while switching...
+	m_iDirtySetup++;
+
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	SessionDelta delta(session);
+	delta.apply();
+	QApplication::restoreOverrideCursor();
+
+	appendMessages(tr("Smart open: %1 channels kept, %2 changed, "
+		"%3 added, %4 removed.")
+		.arg(delta.keptChannels())
+		.arg(delta.changedChannels())
+		.arg(delta.addedChannels())
+		.arg(delta.removedChannels()));
+
+	// Same as if it were loaded from scratch.
+	loadSessionDone(session.filename(), delta.errors(), false);
+	return true;
+}
+
+
 // Load a session from specific file path.
 bool MainForm::loadSessionFile ( const QString& sFilename )
 {
+	QSAMPLER_TRACE("session", "MainForm::loadSessionFile");
+
 	if (m_pClient == nullptr)
 		return false;
 
 	// Open and read from real file.
-	QFile file(sFilename);
-	if (!file.open(QIODevice::ReadOnly)) {
+	LoadSessionTask *pTask = new LoadSessionTask(sFilename);
+	if (!pTask->open()) {
+		delete pTask;
 		appendMessagesError(
 			tr("Could not open \"%1\" session file.\n\nSorry.")
 			.arg(sFilename));
 		return false;
 	}
 
-	// Tell the world we'll take some time...
-	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	// No channel strips updates while loading...
+	m_iDirtySetup++;
+
+	// Read the file, a few lines at a time...
+	m_pTaskScheduler->start(pTask);
+	return true;
+}
 
-	// Read the file.
-	int iLine = 0;
-	int iErrors = 0;
-	QTextStream ts(&file);
-	while (!ts.atEnd()) {
-		// Read the line.
-		QString sCommand = ts.readLine().trimmed();
-		iLine++;
-		// If not empty, nor a comment, call the server...
-		if (!sCommand.isEmpty() && sCommand[0] != '#') {
-			// Remember that, no matter what,
-			// all LSCP commands are CR/LF terminated.
-			sCommand += "\r\n";
-			if (::lscp_client_query(m_pClient, sCommand.toUtf8().constData())
-				!= LSCP_OK) {
-				appendMessagesColor(QString("%1(%2): %3")
-					.arg(QFileInfo(sFilename).fileName()).arg(iLine)
-					.arg(sCommand.simplified()), "#996633");
-				appendMessagesClient("lscp_client_query");
-				iErrors++;
-			}
-		}
-		// Try to make it snappy :)
-		QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-	}
 
-	// Ok. we've read it.
-	file.close();
+// Session file loading completion.
+void MainForm::loadSessionDone (
+	const QString& sFilename, int iErrors, bool bCancelled )
+{
+	QSAMPLER_TRACE("session", "MainForm::loadSessionDone");
+
+	m_iDirtySetup--;
 
 	// Now we'll try to create (update) the whole GUI session.
 	updateSession();
 
-	// We're fornerly done.
-	QApplication::restoreOverrideCursor();
-
 	// Have we any errors?
 	if (iErrors > 0) {
 		appendMessagesError(
@@ -1065,345 +1304,131 @@ bool MainForm::loadSessionFile ( const QString& sFilename )
 	// Stabilize form...
 	m_sFilename = sFilename;
 	updateRecentFiles(sFilename);
-	appendMessages(tr("Open session: \"%1\".").arg(sessionName(m_sFilename)));
+	if (bCancelled) {
+		appendMessages(tr("Open session: \"%1\" (cancelled).")
+			.arg(sessionName(m_sFilename)));
+		m_iDirtyCount++;
+	}
+	else appendMessages(tr("Open session: \"%1\".").arg(sessionName(m_sFilename)));
 
 	// Make that an overall update.
-	stabilizeForm();
-	return true;
+	stabilizeForm(StabilizeSession | StabilizeChannel | StabilizeChannels);
 }
 
 
 // Save current session to specific file path.
-bool MainForm::saveSessionFile ( const QString& sFilename )
+bool MainForm::saveSessionFile ( const QString& sFilename, bool bAsync )
 {
+	QSAMPLER_TRACE("session", "MainForm::saveSessionFile");
+
 	if (m_pClient == nullptr)
 		return false;
 
+	// One writer at a time: a newer save waits for the pending one
+	// to complete, only then taking its own (the latest) snapshot...
+	if (bAsync && !m_sessionWriters.isEmpty()) {
+		m_sSaveFilename = sFilename;
+		return true;
+	}
+
+	// Or supersedes it, when it's needed done right now.
+	m_sSaveFilename.clear();
+	sessionWritersWait();
+
 	// Check whether server is apparently OK...
-	if (::lscp_get_channels(m_pClient) < 0) {
+	if (QSAMPLER_LSCP(lscp_get_channels, m_pClient) < 0) {
 		appendMessagesClient("lscp_get_channels");
 		return false;
 	}
 
-	// Open and write into real file.
-	QFile file(sFilename);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-		appendMessagesError(
-			tr("Could not open \"%1\" session file.\n\nSorry.")
-			.arg(sFilename));
+	// Take a consistent snapshot, all in one go...
+	SessionSnapshot snapshot;
+	if (!snapshot.take(sFilename))
 		return false;
+
+	// Write the file on the side...
+	if (bAsync) {
+		SessionWriter *pWriter = new SessionWriter(snapshot, this);
+		QObject::connect(pWriter,
+			SIGNAL(finished()),
+			SLOT(sessionWriterFinished()));
+		m_sessionWriters.append(pWriter);
+		pWriter->start();
+		stabilizeForm();
+		return true;
 	}
 
-	// Tell the world we'll take some time...
+	// Or right away, as we need it done right now...
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+	const bool bSaved = snapshot.save();
+	QApplication::restoreOverrideCursor();
 
-	// Write the file.
-	int iErrors = 0;
-	QTextStream ts(&file);
-	ts << "# " << QSAMPLER_TITLE " - " << tr(QSAMPLER_SUBTITLE) << endl;
-	ts << "# " << tr("Version") << ": " CONFIG_BUILD_VERSION << endl;
-//	ts << "# " << tr("Build") << ": " CONFIG_BUILD_DATE << endl;
-	ts << "#"  << endl;
-	ts << "# " << tr("File")
-	<< ": " << QFileInfo(sFilename).fileName() << endl;
-	ts << "# " << tr("Date")
-	<< ": " << QDate::currentDate().toString("MMM dd yyyy")
-	<< " "  << QTime::currentTime().toString("hh:mm:ss") << endl;
-	ts << "#"  << endl;
-	ts << endl;
-
-	// It is assumed that this new kind of device+session file
-	// will be loaded from a complete initialized server...
-	int *piDeviceIDs;
-	int  i, iDevice;
-	ts << "RESET" << endl;
-
-	// Audio device mapping.
-	QMap<int, int> audioDeviceMap; iDevice = 0;
-	piDeviceIDs = Device::getDevices(m_pClient, Device::Audio);
-	for (i = 0; piDeviceIDs && piDeviceIDs[i] >= 0; ++i) {
-		Device device(Device::Audio, piDeviceIDs[i]);
-		// Avoid plug-in driver devices...
-		if (device.driverName().toUpper() == "PLUGIN")
-			continue;
-		// Audio device specification...
-		ts << endl;
-		ts << "# " << device.deviceTypeName() << " " << device.driverName()
-			<< " " << tr("Device") << " " << iDevice << endl;
-		ts << "CREATE AUDIO_OUTPUT_DEVICE " << device.driverName();
-		DeviceParamMap::ConstIterator deviceParam;
-		for (deviceParam = device.params().begin();
-				deviceParam != device.params().end();
-					++deviceParam) {
-			const DeviceParam& param = deviceParam.value();
-			if (param.value.isEmpty()) ts << "# ";
-			ts << " " << deviceParam.key() << "='" << param.value << "'";
-		}
-		ts << endl;
-		// Audio channel parameters...
-		int iPort = 0;
-		QListIterator<DevicePort *> iter(device.ports());
-		while (iter.hasNext()) {
-			DevicePort *pPort = iter.next();
-			DeviceParamMap::ConstIterator portParam;
-			for (portParam = pPort->params().begin();
-					portParam != pPort->params().end();
-						++portParam) {
-				const DeviceParam& param = portParam.value();
-				if (param.fix || param.value.isEmpty()) ts << "# ";
-				ts << "SET AUDIO_OUTPUT_CHANNEL_PARAMETER " << iDevice
-					<< " " << iPort << " " << portParam.key()
-					<< "='" << param.value << "'" << endl;
-			}
-			iPort++;
-		}
-		// Audio device index/id mapping.
-		audioDeviceMap.insert(device.deviceID(), iDevice++);
-		// Try to keep it snappy :)
-		QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-	}
-
-	// MIDI device mapping.
-	QMap<int, int> midiDeviceMap; iDevice = 0;
-	piDeviceIDs = Device::getDevices(m_pClient, Device::Midi);
-	for (i = 0; piDeviceIDs && piDeviceIDs[i] >= 0; ++i) {
-		Device device(Device::Midi, piDeviceIDs[i]);
-		// Avoid plug-in driver devices...
-		if (device.driverName().toUpper() == "PLUGIN")
-			continue;
-		// MIDI device specification...
-		ts << endl;
-		ts << "# " << device.deviceTypeName() << " " << device.driverName()
-			<< " " << tr("Device") << " " << iDevice << endl;
-		ts << "CREATE MIDI_INPUT_DEVICE " << device.driverName();
-		DeviceParamMap::ConstIterator deviceParam;
-		for (deviceParam = device.params().begin();
-				deviceParam != device.params().end();
-					++deviceParam) {
-			const DeviceParam& param = deviceParam.value();
-			if (param.value.isEmpty()) ts << "# ";
-			ts << " " << deviceParam.key() << "='" << param.value << "'";
-		}
-		ts << endl;
-		// MIDI port parameters...
-		int iPort = 0;
-		QListIterator<DevicePort *> iter(device.ports());
-		while (iter.hasNext()) {
-			DevicePort *pPort = iter.next();
-			DeviceParamMap::ConstIterator portParam;
-			for (portParam = pPort->params().begin();
-					portParam != pPort->params().end();
-						++portParam) {
-				const DeviceParam& param = portParam.value();
-				if (param.fix || param.value.isEmpty()) ts << "# ";
-				ts << "SET MIDI_INPUT_PORT_PARAMETER " << iDevice
-				<< " " << iPort << " " << portParam.key()
-				<< "='" << param.value << "'" << endl;
-			}
-			iPort++;
-		}
-		// MIDI device index/id mapping.
-		midiDeviceMap.insert(device.deviceID(), iDevice++);
-		// Try to keep it snappy :)
-		QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-	}
-	ts << endl;
+	saveSessionDone(sFilename,
+		snapshot.errors(), snapshot.dirtyCount(), bSaved);
+	return bSaved;
+}
 
-#ifdef CONFIG_MIDI_INSTRUMENT
-	// MIDI instrument mapping...
-	QMap<int, int> midiInstrumentMap;
-	int *piMaps = ::lscp_list_midi_instrument_maps(m_pClient);
-	for (int iMap = 0; piMaps && piMaps[iMap] >= 0; iMap++) {
-		const int iMidiMap = piMaps[iMap];
-		const char *pszMapName
-			= ::lscp_get_midi_instrument_map_name(m_pClient, iMidiMap);
-		ts << "# " << tr("MIDI instrument map") << " " << iMap;
-		if (pszMapName)
-			ts << " - " << pszMapName;
-		ts << endl;
-		ts << "ADD MIDI_INSTRUMENT_MAP";
-		if (pszMapName)
-			ts << " '" << pszMapName << "'";
-		ts << endl;
-		// MIDI instrument mapping...
-		lscp_midi_instrument_t *pInstrs
-			= ::lscp_list_midi_instruments(m_pClient, iMidiMap);
-		for (int iInstr = 0; pInstrs && pInstrs[iInstr].map >= 0; iInstr++) {
-			lscp_midi_instrument_info_t *pInstrInfo
-				= ::lscp_get_midi_instrument_info(m_pClient, &pInstrs[iInstr]);
-			if (pInstrInfo) {
-				ts << "MAP MIDI_INSTRUMENT "
-					<< iMap                        << " "
-					<< pInstrs[iInstr].bank        << " "
-					<< pInstrs[iInstr].prog        << " "
-					<< pInstrInfo->engine_name     << " '"
-					<< pInstrInfo->instrument_file << "' "
-					<< pInstrInfo->instrument_nr   << " "
-					<< pInstrInfo->volume          << " ";
-				switch (pInstrInfo->load_mode) {
-					case LSCP_LOAD_PERSISTENT:
-						ts << "PERSISTENT";
-						break;
-					case LSCP_LOAD_ON_DEMAND_HOLD:
-						ts << "ON_DEMAND_HOLD";
-						break;
-					case LSCP_LOAD_ON_DEMAND:
-					case LSCP_LOAD_DEFAULT:
-					default:
-						ts << "ON_DEMAND";
-						break;
-				}
-				if (pInstrInfo->name)
-					ts << " '" << pInstrInfo->name << "'";
-				ts << endl;
-			}	// Check for errors...
-			else if (::lscp_client_get_errno(m_pClient)) {
-				appendMessagesClient("lscp_get_midi_instrument_info");
-				iErrors++;
-			}
-			// Try to keep it snappy :)
-			QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-		}
-		ts << endl;
-		// Check for errors...
-		if (pInstrs == nullptr && ::lscp_client_get_errno(m_pClient)) {
-			appendMessagesClient("lscp_list_midi_instruments");
-			iErrors++;
-		}
-		// MIDI strument index/id mapping.
-		midiInstrumentMap.insert(iMidiMap, iMap);
-	}
-	// Check for errors...
-	if (piMaps == nullptr && ::lscp_client_get_errno(m_pClient)) {
-		appendMessagesClient("lscp_list_midi_instrument_maps");
-		iErrors++;
-	}
-#endif	// CONFIG_MIDI_INSTRUMENT
 
-	// Sampler channel mapping...
-	int iChannelID = 0;
-	const QList<QMdiSubWindow *>& wlist
-		= m_pWorkspace->subWindowList();
-	foreach (QMdiSubWindow *pMdiSubWindow, wlist) {
-		ChannelStrip *pChannelStrip
-			= static_cast<ChannelStrip *> (pMdiSubWindow->widget());
-		if (pChannelStrip) {
-			Channel *pChannel = pChannelStrip->channel();
-			if (pChannel) {
-				// Avoid "artifial" plug-in devices...
-				const int iAudioDevice = pChannel->audioDevice();
-				if (!audioDeviceMap.contains(iAudioDevice))
-					continue;
-				const int iMidiDevice = pChannel->midiDevice();
-				if (!midiDeviceMap.contains(iMidiDevice))
-					continue;
-				// Go for regular, canonical devices...
-				ts << "# " << tr("Channel") << " " << iChannelID << endl;
-				ts << "ADD CHANNEL" << endl;
-				if (audioDeviceMap.isEmpty()) {
-					ts << "SET CHANNEL AUDIO_OUTPUT_TYPE " << iChannelID
-						<< " " << pChannel->audioDriver() << endl;
-				} else {
-					ts << "SET CHANNEL AUDIO_OUTPUT_DEVICE " << iChannelID
-						<< " " << audioDeviceMap.value(iAudioDevice) << endl;
-				}
-				if (midiDeviceMap.isEmpty()) {
-					ts << "SET CHANNEL MIDI_INPUT_TYPE " << iChannelID
-						<< " " << pChannel->midiDriver() << endl;
-				} else {
-					ts << "SET CHANNEL MIDI_INPUT_DEVICE " << iChannelID
-						<< " " << midiDeviceMap.value(iMidiDevice) << endl;
-				}
-				ts << "SET CHANNEL MIDI_INPUT_PORT " << iChannelID
-					<< " " << pChannel->midiPort() << endl;
-				ts << "SET CHANNEL MIDI_INPUT_CHANNEL " << iChannelID << " ";
-				if (pChannel->midiChannel() == LSCP_MIDI_CHANNEL_ALL)
-					ts << "ALL";
-				else
-					ts << pChannel->midiChannel();
-				ts << endl;
-				ts << "LOAD ENGINE " << pChannel->engineName()
-					<< " " << iChannelID << endl;
-				if (pChannel->instrumentStatus() < 100) ts << "# ";
-				ts << "LOAD INSTRUMENT NON_MODAL '"
-					<< pChannel->instrumentFile() << "' "
-					<< pChannel->instrumentNr() << " " << iChannelID << endl;
-				ChannelRoutingMap::ConstIterator audioRoute;
-				for (audioRoute = pChannel->audioRouting().begin();
-						audioRoute != pChannel->audioRouting().end();
-							++audioRoute) {
-					ts << "SET CHANNEL AUDIO_OUTPUT_CHANNEL " << iChannelID
-						<< " " << audioRoute.key()
-						<< " " << audioRoute.value() << endl;
-				}
-				ts << "SET CHANNEL VOLUME " << iChannelID
-					<< " " << pChannel->volume() << endl;
-				if (pChannel->channelMute())
-					ts << "SET CHANNEL MUTE " << iChannelID << " 1" << endl;
-				if (pChannel->channelSolo())
-					ts << "SET CHANNEL SOLO " << iChannelID << " 1" << endl;
-			#ifdef CONFIG_MIDI_INSTRUMENT
-				const int iMidiMap = pChannel->midiMap();
-				if (midiInstrumentMap.contains(iMidiMap)) {
-					ts << "SET CHANNEL MIDI_INSTRUMENT_MAP " << iChannelID
-						<< " " << midiInstrumentMap.value(iMidiMap) << endl;
-				}
-			#endif
-			#ifdef CONFIG_FXSEND
-				int *piFxSends = ::lscp_list_fxsends(m_pClient, iChannelID);
-				for (int iFxSend = 0;
-						piFxSends && piFxSends[iFxSend] >= 0;
-							iFxSend++) {
-					lscp_fxsend_info_t *pFxSendInfo	= ::lscp_get_fxsend_info(
-						m_pClient, iChannelID, piFxSends[iFxSend]);
-					if (pFxSendInfo) {
-						ts << "CREATE FX_SEND " << iChannelID
-							<< " " << pFxSendInfo->midi_controller;
-						if (pFxSendInfo->name)
-							ts << " '" << pFxSendInfo->name << "'";
-						ts << endl;
-						int *piRouting = pFxSendInfo->audio_routing;
-						for (int iAudioSrc = 0;
-								piRouting && piRouting[iAudioSrc] >= 0;
-									iAudioSrc++) {
-							ts << "SET FX_SEND AUDIO_OUTPUT_CHANNEL "
-								<< iChannelID
-								<< " " << iFxSend
-								<< " " << iAudioSrc
-								<< " " << piRouting[iAudioSrc] << endl;
-						}
-					#ifdef CONFIG_FXSEND_LEVEL
-						ts << "SET FX_SEND LEVEL " << iChannelID
-							<< " " << iFxSend
-							<< " " << pFxSendInfo->level << endl;
-					#endif
-					}	// Check for errors...
-					else if (::lscp_client_get_errno(m_pClient)) {
-						appendMessagesClient("lscp_get_fxsend_info");
-						iErrors++;
-					}
-				}
-			#endif
-				ts << endl;
-				// Go for next channel...
-				++iChannelID;
-			}
-		}
-		// Try to keep it snappy :)
-		QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-	}
+// Session file writer completion slot.
+void MainForm::sessionWriterFinished (void)
+{
+	SessionWriter *pWriter = static_cast<SessionWriter *> (sender());
+	if (m_sessionWriters.contains(pWriter))
+		sessionWriterDone(pWriter);
+}
 
-#ifdef CONFIG_VOLUME
-	ts << "# " << tr("Global volume level") << endl;
-	ts << "SET VOLUME " << ::lscp_get_volume(m_pClient) << endl;
-	ts << endl;
-#endif
 
-	// Ok. we've wrote it.
-	file.close();
+// Session file writer completion.
+void MainForm::sessionWriterDone ( SessionWriter *pWriter )
+{
+	m_sessionWriters.removeAll(pWriter);
+
+	// Only the latest snapshot may tell we're clean...
+	const QString sSaveFilename = m_sSaveFilename;
+	m_sSaveFilename.clear();
+
+	const SessionSnapshot& snapshot = pWriter->snapshot();
+	saveSessionDone(snapshot.filename(),
+		snapshot.errors(), snapshot.dirtyCount(), pWriter->isSaved(),
+		sSaveFilename.isEmpty());
+
+	pWriter->deleteLater();
+
+	// Go on with the one waiting, if any.
+	if (!sSaveFilename.isEmpty())
+		saveSessionFile(sSaveFilename, true);
+}
 
-	// We're fornerly done.
-	QApplication::restoreOverrideCursor();
+
+// Whether a session file is being loaded or saved.
+bool MainForm::isSessionBusy (void) const
+{
+	return m_pTaskScheduler->isBusy() || !m_sessionWriters.isEmpty();
+}
+
+
+// Wait for all session file writers to complete.
+void MainForm::sessionWritersWait (void)
+{
+	while (!m_sessionWriters.isEmpty()) {
+		SessionWriter *pWriter = m_sessionWriters.first();
+		pWriter->wait();
+		sessionWriterDone(pWriter);
+	}
+}
+
+
+// Session file saving completion.
+void MainForm::saveSessionDone ( const QString& sFilename,
+	int iErrors, int iDirtyCount, bool bSaved, bool bLatest )
+{
+	if (!bSaved) {
+		appendMessagesError(
+			tr("Could not save \"%1\" session file.\n\nSorry.")
+			.arg(sFilename));
+		stabilizeForm(StabilizeSession);
+		return;
+	}
 
 	// Have we any errors?
 	if (iErrors > 0) {
@@ -1416,14 +1441,15 @@ bool MainForm::saveSessionFile ( const QString& sFilename )
 	// Save as default session directory.
 	if (m_pOptions)
 		m_pOptions->sSessionDir = QFileInfo(sFilename).dir().absolutePath();
-	// We're not dirty anymore.
-	m_iDirtyCount = 0;
+	// We're not dirty anymore (unless changed while saving,
+	// or there's a newer save still to come).
+	if (bLatest)
+		m_iDirtyCount = (m_iDirtyCount > iDirtyCount ? 1 : 0);
 	// Stabilize form...
 	m_sFilename = sFilename;
 	updateRecentFiles(sFilename);
 	appendMessages(tr("Save session: \"%1\".").arg(sessionName(m_sFilename)));
-	stabilizeForm();
-	return true;
+	stabilizeForm(StabilizeSession);
 }
 
 
@@ -1433,7 +1459,7 @@ void MainForm::sessionDirty (void)
 	// Just mark the dirty form.
 	m_iDirtyCount++;
 	// and update the form status...
-	stabilizeForm();
+	stabilizeForm(StabilizeSession);
 }
 
 
@@ -1465,9 +1491,9 @@ void MainForm::fileOpenRecent (void)
 		const int iIndex = pAction->data().toInt();
 		if (iIndex >= 0 && iIndex < m_pOptions->recentFiles.count()) {
 			QString sFilename = m_pOptions->recentFiles[iIndex];
-			// Check if we can safely close the current session...
-			if (!sFilename.isEmpty() && closeSession(true))
-				loadSessionFile(sFilename);
+			// Check if we can safely switch the current session...
+			if (!sFilename.isEmpty())
+				openSessionFile(sFilename);
 		}
 	}
 }
@@ -1531,7 +1557,7 @@ void MainForm::fileReset (void)
 
 	// Just do the reset, after closing down current session...
 	// Do the actual sampler reset...
-	if (::lscp_reset_sampler(m_pClient) != LSCP_OK) {
+	if (QSAMPLER_LSCP(lscp_reset_sampler, m_pClient) != LSCP_OK) {
 		appendMessagesClient("lscp_reset_sampler");
 		appendMessagesError(tr("Could not reset sampler instance.\n\nSorry."));
 		return;
@@ -1616,7 +1642,7 @@ void MainForm::editAddChannel (void)
 
 void MainForm::addChannelStrip (void)
 {
-	if (m_pClient == nullptr)
+	if (m_pClient == nullptr || isSessionBusy())
 		return;
 
 	// Just create the channel instance...
@@ -1631,9 +1657,9 @@ void MainForm::addChannelStrip (void)
 		return;
 	}
 
-	// And give it to the strip...
+	// And give it to the strip (or mixer row)...
 	// (will own the channel instance, if successful).
-	if (!createChannelStrip(pChannel)) {
+	if (!createChannel(pChannel)) {
 		delete pChannel;
 		return;
 	}
@@ -1643,7 +1669,7 @@ void MainForm::addChannelStrip (void)
 
 	// Make that an overall update.
 	m_iDirtyCount++;
-	stabilizeForm();
+	stabilizeForm(StabilizeSession | StabilizeChannel | StabilizeChannels);
 }
 
 
@@ -1657,7 +1683,7 @@ void MainForm::editRemoveChannel (void)
 
 void MainForm::removeChannelStrip (void)
 {
-	if (m_pClient == nullptr)
+	if (m_pClient == nullptr || isSessionBusy())
 		return;
 
 	ChannelStrip *pChannelStrip = activeChannelStrip();
@@ -1706,14 +1732,14 @@ void MainForm::removeChannelStrip (void)
 
 	// We'll be dirty, for sure...
 	m_iDirtyCount++;
-	stabilizeForm();
+	stabilizeForm(StabilizeSession | StabilizeChannel | StabilizeChannels);
 }
 
 
 // Setup current sampler channel.
 void MainForm::editSetupChannel (void)
 {
-	if (m_pClient == nullptr)
+	if (m_pClient == nullptr || isSessionBusy())
 		return;
 
 	ChannelStrip *pChannelStrip = activeChannelStrip();
@@ -1743,7 +1769,7 @@ void MainForm::editEditChannel (void)
 // Reset current sampler channel.
 void MainForm::editResetChannel (void)
 {
-	if (m_pClient == nullptr)
+	if (m_pClient == nullptr || isSessionBusy())
 		return;
 
 	ChannelStrip *pChannelStrip = activeChannelStrip();
@@ -1758,21 +1784,15 @@ void MainForm::editResetChannel (void)
 // Reset all sampler channels.
 void MainForm::editResetAllChannels (void)
 {
-	if (m_pClient == nullptr)
+	if (m_pClient == nullptr || isSessionBusy())
 		return;
 
-	// Invoque the channel strip procedure,
-	// for all channels out there...
-	m_pWorkspace->setUpdatesEnabled(false);
-	const QList<QMdiSubWindow *>& wlist
-		= m_pWorkspace->subWindowList();
-	foreach (QMdiSubWindow *pMdiSubWindow, wlist) {
-		ChannelStrip *pChannelStrip
-			= static_cast<ChannelStrip *> (pMdiSubWindow->widget());
-		if (pChannelStrip)
-			pChannelStrip->channelReset();
-	}
-	m_pWorkspace->setUpdatesEnabled(true);
+	// Reset all channels out there, in one batch...
+	ChannelGroup group;
+	QListIterator<Channel *> iter(channels());
+	while (iter.hasNext())
+		group.addChannel(iter.next()->channelID());
+	group.resetChannels();
 }
 
 
@@ -1824,6 +1844,70 @@ void MainForm::viewMessages ( bool bOn )
 }
 
 
+// Switch between the channel mixer and the channel strips.
+void MainForm::viewMixer ( bool bOn )
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	if (m_pOptions->bChannelMixer != bOn) {
+		m_pOptions->bChannelMixer = bOn;
+		// Never both: the other view goes away, but
+		// not the sampler channels themselves...
+		m_changedStrips.clear();
+		if (bOn) {
+			m_pWorkspace->setUpdatesEnabled(false);
+			const QList<QMdiSubWindow *>& wlist
+				= m_pWorkspace->subWindowList();
+			foreach (QMdiSubWindow *pMdiSubWindow, wlist) {
+				ChannelStrip *pChannelStrip
+					= static_cast<ChannelStrip *> (pMdiSubWindow->widget());
+				if (pChannelStrip)
+					delete pChannelStrip;
+				delete pMdiSubWindow;
+			}
+			m_pWorkspace->setUpdatesEnabled(true);
+		}
+		else m_pChannelMixer->mixerView()->clearChannels();
+		// ...which are to be shown on the new view.
+		if (m_pClient)
+			updateAllChannelStrips(false);
+	}
+
+	m_pChannelMixer->setVisible(bOn);
+
+	stabilizeForm();
+}
+
+
+// Show/hide the LSCP statistics window.
+void MainForm::viewStatistics ( bool bOn )
+{
+	if (bOn) {
+		m_pStatistics->show();
+		m_pStatistics->raise();
+	} else {
+		m_pStatistics->hide();
+	}
+}
+
+
+// Log the stream buffer underrun report.
+void MainForm::viewUnderrunReport (void)
+{
+	const QStringList& lines = m_pUnderrunDetector->report();
+	QStringListIterator iter(lines);
+	while (iter.hasNext())
+		appendMessagesColor(iter.next(), "#cc6600");
+
+	// Make sure it gets seen.
+	if (m_pMessages) {
+		m_pMessages->show();
+		m_pMessages->raise();
+	}
+}
+
+
 // Show/hide the MIDI instrument list-view form.
 void MainForm::viewInstruments (void)
 {
@@ -1884,6 +1968,9 @@ void MainForm::viewOptions (void)
 		const QString sOldServerCmdLine    = m_pOptions->sServerCmdLine;
 		const bool    bOldMessagesLog      = m_pOptions->bMessagesLog;
 		const QString sOldMessagesLogPath  = m_pOptions->sMessagesLogPath;
+		const bool    bOldMetrics          = m_pOptions->bMetrics;
+		const QString sOldMetricsPath      = m_pOptions->sMetricsPath;
+		const int     iOldMetricsInterval  = m_pOptions->iMetricsInterval;
 		const QString sOldDisplayFont      = m_pOptions->sDisplayFont;
 		const bool    bOldDisplayEffect    = m_pOptions->bDisplayEffect;
 		const int     iOldMaxVolume        = m_pOptions->iMaxVolume;
@@ -1940,6 +2027,13 @@ void MainForm::viewOptions (void)
 				(sOldMessagesLogPath != m_pOptions->sMessagesLogPath))
 				m_pMessages->setLogging(
 					m_pOptions->bMessagesLog, m_pOptions->sMessagesLogPath);
+			if (( bOldMetrics && !m_pOptions->bMetrics) ||
+				(!bOldMetrics &&  m_pOptions->bMetrics) ||
+				(sOldMetricsPath != m_pOptions->sMetricsPath) ||
+				(iOldMetricsInterval != m_pOptions->iMetricsInterval))
+				updateMetrics();
+			// Sampler limits may have been just changed...
+			m_pMetrics->resetLimits();
 			if (( bOldCompletePath && !m_pOptions->bCompletePath) ||
 				(!bOldCompletePath &&  m_pOptions->bCompletePath) ||
 				(iOldMaxRecentFiles != m_pOptions->iMaxRecentFiles))
@@ -2013,7 +2107,7 @@ void MainForm::channelsArrange (void)
 	}
 	m_pWorkspace->setUpdatesEnabled(true);
 
-	stabilizeForm();
+	stabilizeForm(StabilizeChannel);
 }
 
 
@@ -2131,79 +2225,150 @@ void MainForm::helpAbout (void)
 //-------------------------------------------------------------------------
 // QSampler::MainForm -- Main window stabilization.
 
-void MainForm::stabilizeForm (void)
+// Invalidate some form state facets (deferred).
+void MainForm::stabilizeForm ( int iFacets )
+{
+	// Just invalidate the given facets;
+	// they get all flushed at once, later...
+	m_iStabilize |= iFacets;
+
+	if (!m_bStabilize) {
+		m_bStabilize = true;
+		QMetaObject::invokeMethod(this,
+			"stabilizeFlush", Qt::QueuedConnection);
+	}
+}
+
+
+// Flush all invalidated form state facets, right now.
+void MainForm::stabilizeFlush (void)
 {
+	int iFacets = m_iStabilize;
+
+	m_iStabilize = 0;
+	m_bStabilize = false;
+
+	if (iFacets == 0)
+		return;
+
+	// Everything else depends on the client state...
+	if (iFacets & StabilizeClient)
+		iFacets = StabilizeAll;
+
+	const bool bHasClient = (m_pOptions != nullptr && m_pClient != nullptr);
+
+	// No session file nor channel changes while loading or saving one
+	// (session scripts address channels by their absolute ids)...
+	const bool bIdle = (bHasClient && !isSessionBusy());
+
 	// Update the main application caption...
-	QString sSessionName = sessionName(m_sFilename);
-	if (m_iDirtyCount > 0)
-		sSessionName += " *";
-	setWindowTitle(sSessionName);
+	if (iFacets & StabilizeSession) {
+		QString sSessionName = sessionName(m_sFilename);
+		if (m_iDirtyCount > 0)
+			sSessionName += " *";
+		setWindowTitle(sSessionName);
+		m_ui.fileNewAction->setEnabled(bIdle);
+		m_ui.fileOpenAction->setEnabled(bIdle);
+		m_ui.fileSaveAction->setEnabled(bIdle && m_iDirtyCount > 0);
+		m_ui.fileSaveAsAction->setEnabled(bIdle);
+		m_ui.fileResetAction->setEnabled(bIdle);
+		// Session status...
+		if (m_iDirtyCount > 0)
+			m_statusItem[QSAMPLER_STATUS_SESSION]->setText(tr("MOD"));
+		else
+			m_statusItem[QSAMPLER_STATUS_SESSION]->clear();
+		// Recent files menu.
+		if (m_pOptions)
+			m_ui.fileOpenRecentMenu->setEnabled(!isSessionBusy()
+				&& m_pOptions->recentFiles.count() > 0);
+	}
 
 	// Update the main menu state...
-	ChannelStrip *pChannelStrip = activeChannelStrip();
-	const QList<QMdiSubWindow *>& wlist = m_pWorkspace->subWindowList();
-	const bool bHasClient = (m_pOptions != nullptr && m_pClient != nullptr);
-	const bool bHasChannel = (bHasClient && pChannelStrip != nullptr);
-	const bool bHasChannels = (bHasClient && wlist.count() > 0);
-	m_ui.fileNewAction->setEnabled(bHasClient);
-	m_ui.fileOpenAction->setEnabled(bHasClient);
-	m_ui.fileSaveAction->setEnabled(bHasClient && m_iDirtyCount > 0);
-	m_ui.fileSaveAsAction->setEnabled(bHasClient);
-	m_ui.fileResetAction->setEnabled(bHasClient);
-	m_ui.fileRestartAction->setEnabled(bHasClient || m_pServer == nullptr);
-	m_ui.editAddChannelAction->setEnabled(bHasClient);
-	m_ui.editRemoveChannelAction->setEnabled(bHasChannel);
-	m_ui.editSetupChannelAction->setEnabled(bHasChannel);
-#ifdef CONFIG_EDIT_INSTRUMENT
-	m_ui.editEditChannelAction->setEnabled(bHasChannel);
-#else
-	m_ui.editEditChannelAction->setEnabled(false);
-#endif
-	m_ui.editResetChannelAction->setEnabled(bHasChannel);
-	m_ui.editResetAllChannelsAction->setEnabled(bHasChannels);
-	m_ui.viewMessagesAction->setChecked(m_pMessages && m_pMessages->isVisible());
-#ifdef CONFIG_MIDI_INSTRUMENT
-	m_ui.viewInstrumentsAction->setChecked(m_pInstrumentListForm
-		&& m_pInstrumentListForm->isVisible());
-	m_ui.viewInstrumentsAction->setEnabled(bHasClient);
-#else
-	m_ui.viewInstrumentsAction->setEnabled(false);
-#endif
-	m_ui.viewDevicesAction->setChecked(m_pDeviceForm
-		&& m_pDeviceForm->isVisible());
-	m_ui.viewDevicesAction->setEnabled(bHasClient);
-	m_ui.viewMidiDeviceStatusMenu->setEnabled(
-		DeviceStatusForm::getInstances().size() > 0);
-	m_ui.channelsArrangeAction->setEnabled(bHasChannels);
+	if (iFacets & StabilizeClient) {
+		m_ui.fileRestartAction->setEnabled(bHasClient || m_pServer == nullptr);
+		m_ui.editAddChannelAction->setEnabled(bIdle);
+	#ifdef CONFIG_MIDI_INSTRUMENT
+		m_ui.viewInstrumentsAction->setEnabled(bHasClient);
+	#else
+		m_ui.viewInstrumentsAction->setEnabled(false);
+	#endif
+		m_ui.viewDevicesAction->setEnabled(bHasClient);
+	#ifdef CONFIG_VOLUME
+		// Toolbar widgets are also affected...
+		m_pVolumeSlider->setEnabled(bHasClient);
+		m_pVolumeSpinBox->setEnabled(bHasClient);
+	#endif
+		// Client/Server status...
+		if (bHasClient) {
+			m_statusItem[QSAMPLER_STATUS_CLIENT]->setText(tr("Connected"));
+			m_statusItem[QSAMPLER_STATUS_SERVER]->setText(m_pOptions->sServerHost
+				+ ':' + QString::number(m_pOptions->iServerPort));
+		} else {
+			m_statusItem[QSAMPLER_STATUS_CLIENT]->clear();
+			m_statusItem[QSAMPLER_STATUS_SERVER]->clear();
+		}
+	}
 
-#ifdef CONFIG_VOLUME
-	// Toolbar widgets are also affected...
-	m_pVolumeSlider->setEnabled(bHasClient);
-	m_pVolumeSpinBox->setEnabled(bHasClient);
-#endif
+	// Active channel selection...
+	if (iFacets & StabilizeChannel) {
+		ChannelStrip *pChannelStrip = activeChannelStrip();
+		const bool bHasChannel = (bHasClient && pChannelStrip != nullptr);
+		m_ui.editRemoveChannelAction->setEnabled(bHasChannel && bIdle);
+		m_ui.editSetupChannelAction->setEnabled(bHasChannel && bIdle);
+	#ifdef CONFIG_EDIT_INSTRUMENT
+		m_ui.editEditChannelAction->setEnabled(bHasChannel);
+	#else
+		m_ui.editEditChannelAction->setEnabled(false);
+	#endif
+		m_ui.editResetChannelAction->setEnabled(bHasChannel && bIdle);
+		// Channel status...
+		if (bHasChannel)
+			m_statusItem[QSAMPLER_STATUS_CHANNEL]->setText(pChannelStrip->windowTitle());
+		else
+			m_statusItem[QSAMPLER_STATUS_CHANNEL]->clear();
+	}
 
-	// Client/Server status...
-	if (bHasClient) {
-		m_statusItem[QSAMPLER_STATUS_CLIENT]->setText(tr("Connected"));
-		m_statusItem[QSAMPLER_STATUS_SERVER]->setText(m_pOptions->sServerHost
-			+ ':' + QString::number(m_pOptions->iServerPort));
-	} else {
-		m_statusItem[QSAMPLER_STATUS_CLIENT]->clear();
-		m_statusItem[QSAMPLER_STATUS_SERVER]->clear();
+	// Number of channels...
+	if (iFacets & StabilizeChannels) {
+		const bool bHasChannels = (bHasClient && !channels().isEmpty());
+		m_ui.editResetAllChannelsAction->setEnabled(bHasChannels && bIdle);
+		m_ui.channelsArrangeAction->setEnabled(bHasChannels && !isChannelMixer());
 	}
-	// Channel status...
-	if (bHasChannel)
-		m_statusItem[QSAMPLER_STATUS_CHANNEL]->setText(pChannelStrip->windowTitle());
-	else
-		m_statusItem[QSAMPLER_STATUS_CHANNEL]->clear();
-	// Session status...
-	if (m_iDirtyCount > 0)
-		m_statusItem[QSAMPLER_STATUS_SESSION]->setText(tr("MOD"));
-	else
-		m_statusItem[QSAMPLER_STATUS_SESSION]->clear();
 
-	// Recent files menu.
-	m_ui.fileOpenRecentMenu->setEnabled(m_pOptions->recentFiles.count() > 0);
+	// Child forms visibility...
+	if (iFacets & StabilizeForms) {
+		m_ui.viewMessagesAction->setChecked(m_pMessages && m_pMessages->isVisible());
+		m_ui.viewMixerAction->setChecked(isChannelMixer());
+		m_ui.viewStatisticsAction->setChecked(m_pStatistics
+			&& m_pStatistics->isVisible());
+	#ifdef CONFIG_MIDI_INSTRUMENT
+		m_ui.viewInstrumentsAction->setChecked(m_pInstrumentListForm
+			&& m_pInstrumentListForm->isVisible());
+	#endif
+		m_ui.viewDevicesAction->setChecked(m_pDeviceForm
+			&& m_pDeviceForm->isVisible());
+		m_ui.viewMidiDeviceStatusMenu->setEnabled(
+			DeviceStatusForm::getInstances().size() > 0);
+	}
+}
+
+
+// Session tasks busy state change slot.
+void MainForm::taskBusyChanged ( bool bBusy )
+{
+	m_pTaskProgress->setValue(0);
+	m_pTaskProgress->setVisible(bBusy);
+	m_pTaskCancel->setVisible(bBusy);
+
+	// Channel actions are gated on it too.
+	stabilizeForm();
+}
+
+
+// Child forms visibility change slot.
+void MainForm::formVisibilityChanged (void)
+{
+	stabilizeForm(StabilizeForms);
 }
 
 
@@ -2223,18 +2388,13 @@ void MainForm::volumeChanged ( int iVolume )
 	if (m_pVolumeSpinBox->value() != iVolume)
 		m_pVolumeSpinBox->setValue(iVolume);
 
-	// Do it as commanded...
+	// Do it as commanded (coalesced and sent on the side)...
 	const float fVolume = 0.01f * float(iVolume);
-	if (::lscp_set_volume(m_pClient, fVolume) == LSCP_OK)
-		appendMessages(QObject::tr("Volume: %1.").arg(fVolume));
-	else
-		appendMessagesClient("lscp_set_volume");
+	if (m_pClient)
+		m_pVolumeSender->setVolume(VolumeSender::GlobalVolume, fVolume);
 
 	m_iVolumeChanging--;
 
-	m_iDirtyCount++;
-	stabilizeForm();
-
 #endif
 }
 
@@ -2251,7 +2411,35 @@ void MainForm::channelStripChanged ( ChannelStrip *pChannelStrip )
 	// Just mark the dirty form.
 	m_iDirtyCount++;
 	// and update the form status...
-	stabilizeForm();
+	stabilizeForm(StabilizeSession | StabilizeChannel);
+}
+
+
+// Coalesced channel strips update (eg. after batched group commands).
+void MainForm::updateChannelStrips ( const QList<int>& channelIDs )
+{
+	if (channelIDs.isEmpty())
+		return;
+
+	// Add those strips to the changed list, all at once...
+	QListIterator<int> iter(channelIDs);
+	while (iter.hasNext()) {
+		const int iChannelID = iter.next();
+		if (isChannelMixer()) {
+			m_pChannelMixer->mixerView()->updateChannel(iChannelID);
+			continue;
+		}
+		ChannelStrip *pChannelStrip = channelStrip(iChannelID);
+		if (pChannelStrip && !m_changedStrips.contains(pChannelStrip)) {
+			m_changedStrips.append(pChannelStrip);
+			pChannelStrip->resetErrorCount();
+		}
+	}
+
+	// Just mark the dirty form.
+	m_iDirtyCount++;
+	// and update the form status...
+	stabilizeForm(StabilizeSession | StabilizeChannel);
 }
 
 
@@ -2259,7 +2447,7 @@ void MainForm::channelStripChanged ( ChannelStrip *pChannelStrip )
 void MainForm::updateSession (void)
 {
 #ifdef CONFIG_VOLUME
-	const int iVolume = ::lroundf(100.0f * ::lscp_get_volume(m_pClient));
+	const int iVolume = ::lroundf(100.0f * QSAMPLER_LSCP(lscp_get_volume, m_pClient));
 	m_iVolumeChanging++;
 	m_pVolumeSlider->setValue(iVolume);
 	m_pVolumeSpinBox->setValue(iVolume);
@@ -2267,13 +2455,13 @@ void MainForm::updateSession (void)
 #endif
 #ifdef CONFIG_MIDI_INSTRUMENT
 	// FIXME: Make some room for default instrument maps...
-	const int iMaps = ::lscp_get_midi_instrument_maps(m_pClient);
+	const int iMaps = QSAMPLER_LSCP(lscp_get_midi_instrument_maps, m_pClient);
 	if (iMaps < 0)
 		appendMessagesClient("lscp_get_midi_instrument_maps");
 	else if (iMaps < 1) {
-		::lscp_add_midi_instrument_map(m_pClient,
+		QSAMPLER_LSCP(lscp_add_midi_instrument_map, m_pClient,
 			tr("Chromatic").toUtf8().constData());
-		::lscp_add_midi_instrument_map(m_pClient,
+		QSAMPLER_LSCP(lscp_add_midi_instrument_map, m_pClient,
 			tr("Drum Kits").toUtf8().constData());
 	}
 #endif
@@ -2293,12 +2481,21 @@ void MainForm::updateSession (void)
 
 void MainForm::updateAllChannelStrips ( bool bRemoveDeadStrips )
 {
+	QSAMPLER_TRACE("gui", "MainForm::updateAllChannelStrips");
+
 	// Skip if setting up a new channel strip...
 	if (m_iDirtySetup > 0)
 		return;
 
+	// The mixer rows are (re)synchronized on their own...
+	if (isChannelMixer()) {
+		m_pChannelMixer->mixerView()->updateChannels();
+		stabilizeForm(StabilizeSession | StabilizeChannel | StabilizeChannels);
+		return;
+	}
+
 	// Retrieve the current channel list.
-	int *piChannelIDs = ::lscp_list_channels(m_pClient);
+	int *piChannelIDs = QSAMPLER_LSCP(lscp_list_channels, m_pClient);
 	if (piChannelIDs == nullptr) {
 		if (::lscp_client_get_errno(m_pClient)) {
 			appendMessagesClient("lscp_list_channels");
@@ -2342,7 +2539,7 @@ void MainForm::updateAllChannelStrips ( bool bRemoveDeadStrips )
 		m_pWorkspace->setUpdatesEnabled(true);
 	}
 
-	stabilizeForm();
+	stabilizeForm(StabilizeSession | StabilizeChannel | StabilizeChannels);
 }
 
 
@@ -2473,6 +2670,9 @@ void MainForm::updateMaxVolume (void)
 	m_iVolumeChanging--;
 #endif
 
+	if (m_pChannelMixer)
+		m_pChannelMixer->mixerView()->setMaxVolume(m_pOptions->iMaxVolume);
+
 	// Full channel list update...
 	const QList<QMdiSubWindow *>& wlist
 		= m_pWorkspace->subWindowList();
@@ -2523,9 +2723,6 @@ void MainForm::appendMessagesError ( const QString& s )
 
 	appendMessagesColor(s.simplified(), Qt::red);
 
-	// Make it look responsive...:)
-	QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-
 	if (m_pOptions && m_pOptions->bConfirmError) {
 		const QString& sTitle = tr("Error");
 	#if 0
@@ -2556,9 +2753,6 @@ void MainForm::appendMessagesClient( const QString& s )
 	appendMessagesColor(s + QString(": %1 (errno=%2)")
 		.arg(::lscp_client_get_result(m_pClient))
 		.arg(::lscp_client_get_errno(m_pClient)), "#996666");
-
-	// Make it look responsive...:)
-	QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 }
 
 
@@ -2591,6 +2785,21 @@ void MainForm::updateMessagesLimit (void)
 }
 
 
+// Setup the metrics textfile exporter.
+void MainForm::updateMetrics (void)
+{
+	if (m_pOptions == nullptr)
+		return;
+
+	if (m_pOptions->bMetrics) {
+		m_pMetrics->setup(
+			m_pOptions->sMetricsPath,
+			m_pOptions->iMetricsInterval);
+	}
+	else m_pMetrics->setup(QString(), 0);
+}
+
+
 // Enablement of the messages capture feature.
 void MainForm::updateMessagesCapture (void)
 {
@@ -2653,6 +2862,40 @@ ChannelStrip *MainForm::createChannelStrip ( Channel *pChannel )
 }
 
 
+// Bulk channel strip creation, one per instrument file.
+int MainForm::addChannelStrips ( const QStringList& files )
+{
+	if (m_pClient == nullptr || files.isEmpty() || isSessionBusy())
+		return 0;
+
+	appendMessages(tr("Adding %1 channels...").arg(files.count()));
+
+	// Tell the world we'll take some time...
+	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+	// Skip the channel count event storm meanwhile...
+	++m_iDirtySetup;
+	m_pWorkspace->setUpdatesEnabled(false);
+	const int iChannels = m_pChannelLoader->addChannels(files);
+	m_pWorkspace->setUpdatesEnabled(true);
+	--m_iDirtySetup;
+
+	// Do we auto-arrange?
+	channelsArrangeAuto();
+
+	QApplication::restoreOverrideCursor();
+
+	appendMessages(tr("Added %1 channels.").arg(iChannels));
+
+	// Make that an overall update.
+	if (iChannels > 0)
+		m_iDirtyCount++;
+	stabilizeForm(StabilizeSession | StabilizeChannel | StabilizeChannels);
+
+	return iChannels;
+}
+
+
 void MainForm::destroyChannelStrip ( ChannelStrip *pChannelStrip )
 {
 	QMdiSubWindow *pMdiSubWindow
@@ -2660,6 +2903,14 @@ void MainForm::destroyChannelStrip ( ChannelStrip *pChannelStrip )
 	if (pMdiSubWindow == nullptr)
 		return;
 
+	// No more group membership...
+	Channel *pChannel = pChannelStrip->channel();
+	if (pChannel) {
+		QListIterator<ChannelGroup *> iter(m_channelGroups);
+		while (iter.hasNext())
+			iter.next()->removeChannel(pChannel->channelID());
+	}
+
 	// Just delete the channel strip.
 	delete pChannelStrip;
 	delete pMdiSubWindow;
@@ -2724,6 +2975,84 @@ ChannelStrip *MainForm::channelStrip ( int iChannelID )
 }
 
 
+// Whether the channel mixer stands in for the channel strips.
+bool MainForm::isChannelMixer (void) const
+{
+	return (m_pChannelMixer && m_pOptions && m_pOptions->bChannelMixer);
+}
+
+
+// The sampler channel view creation executive
+// (will own the channel instance, if successful).
+bool MainForm::createChannel ( Channel *pChannel )
+{
+	if (m_pClient == nullptr || pChannel == nullptr)
+		return false;
+
+	if (isChannelMixer()) {
+		m_pChannelMixer->mixerView()->addChannel(pChannel);
+		return true;
+	}
+
+	return (createChannelStrip(pChannel) != nullptr);
+}
+
+
+// The sampler channel view destruction executive.
+void MainForm::destroyChannel ( Channel *pChannel )
+{
+	if (pChannel == nullptr)
+		return;
+
+	const int iChannelID = pChannel->channelID();
+
+	if (isChannelMixer()) {
+		// No more group membership...
+		QListIterator<ChannelGroup *> iter(m_channelGroups);
+		while (iter.hasNext())
+			iter.next()->removeChannel(iChannelID);
+		m_pChannelMixer->mixerView()->removeChannel(iChannelID);
+		return;
+	}
+
+	ChannelStrip *pChannelStrip = channelStrip(iChannelID);
+	if (pChannelStrip)
+		destroyChannelStrip(pChannelStrip);
+}
+
+
+// Retrieve a sampler channel by id.
+Channel *MainForm::channel ( int iChannelID )
+{
+	if (isChannelMixer())
+		return m_pChannelMixer->mixerView()->channel(iChannelID);
+
+	ChannelStrip *pChannelStrip = channelStrip(iChannelID);
+	return (pChannelStrip ? pChannelStrip->channel() : nullptr);
+}
+
+
+// Retrieve all sampler channels, in view order;
+// strips are always up-to-date, mixer rows only if asked.
+QList<Channel *> MainForm::channels ( bool bUpdate )
+{
+	if (isChannelMixer())
+		return m_pChannelMixer->mixerView()->channels(bUpdate);
+
+	QList<Channel *> list;
+	const QList<QMdiSubWindow *>& wlist
+		= m_pWorkspace->subWindowList();
+	foreach (QMdiSubWindow *pMdiSubWindow, wlist) {
+		ChannelStrip *pChannelStrip
+			= static_cast<ChannelStrip *> (pMdiSubWindow->widget());
+		if (pChannelStrip && pChannelStrip->channel())
+			list.append(pChannelStrip->channel());
+	}
+
+	return list;
+}
+
+
 // Construct the windows menu.
 void MainForm::channelsMenuAboutToShow (void)
 {
@@ -2750,6 +3079,81 @@ void MainForm::channelsMenuAboutToShow (void)
 			++iStrip;
 		}
 	}
+
+	// Channel groups...
+	m_ui.channelsMenu->addSeparator();
+	// Drop the old per-group submenus, as clear() wouldn't...
+	qDeleteAll(m_pGroupsMenu->findChildren<QMenu *> (
+		QString(), Qt::FindDirectChildrenOnly));
+	m_pGroupsMenu->clear();
+	QMenu *pGroupsMenu = m_pGroupsMenu;
+	m_ui.channelsMenu->addMenu(pGroupsMenu);
+	QAction *pAction = pGroupsMenu->addAction(tr("&New Group..."),
+		this, SLOT(channelsGroupActivated()));
+	pAction->setData(ChannelGroupNew);
+	pAction->setEnabled(m_pClient != nullptr);
+	ChannelStrip *pActiveStrip = activeChannelStrip();
+	const int iActiveChannelID = (pActiveStrip && pActiveStrip->channel()
+		? pActiveStrip->channel()->channelID() : -1);
+	const int iGroupCount = m_channelGroups.count();
+	if (iGroupCount > 0)
+		pGroupsMenu->addSeparator();
+	for (int iGroup = 0; iGroup < iGroupCount; ++iGroup) {
+		ChannelGroup *pChannelGroup = m_channelGroups.at(iGroup);
+		QMenu *pGroupMenu = pGroupsMenu->addMenu(
+			tr("%1 (%2)").arg(pChannelGroup->name())
+				.arg(pChannelGroup->channelIDs().count()));
+		const int iData = (iGroup << 8);
+		const bool bEnabled
+			= (m_pClient != nullptr && !pChannelGroup->isEmpty());
+		pAction = pGroupMenu->addAction(tr("&Add Current Channel"),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupAdd);
+		pAction->setEnabled(iActiveChannelID >= 0
+			&& !pChannelGroup->contains(iActiveChannelID));
+		pAction = pGroupMenu->addAction(tr("Re&move Current Channel"),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupRemove);
+		pAction->setEnabled(iActiveChannelID >= 0
+			&& pChannelGroup->contains(iActiveChannelID));
+		pGroupMenu->addSeparator();
+		pAction = pGroupMenu->addAction(tr("&Reset"),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupReset);
+		pAction->setEnabled(bEnabled);
+	#ifdef CONFIG_MUTE_SOLO
+		pAction = pGroupMenu->addAction(tr("M&ute"),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupMute);
+		pAction->setEnabled(bEnabled);
+		pAction = pGroupMenu->addAction(tr("U&nmute"),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupUnmute);
+		pAction->setEnabled(bEnabled);
+		pAction = pGroupMenu->addAction(tr("&Solo"),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupSolo);
+		pAction->setEnabled(bEnabled);
+		pAction = pGroupMenu->addAction(tr("Unso&lo"),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupUnsolo);
+		pAction->setEnabled(bEnabled);
+	#endif
+		pAction = pGroupMenu->addAction(tr("&Volume Scale..."),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupVolume);
+		pAction->setEnabled(bEnabled);
+	#ifdef CONFIG_MIDI_INSTRUMENT
+		pAction = pGroupMenu->addAction(tr("MIDI &Instrument Map..."),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupMidiMap);
+		pAction->setEnabled(bEnabled);
+	#endif
+		pGroupMenu->addSeparator();
+		pAction = pGroupMenu->addAction(tr("&Delete Group"),
+			this, SLOT(channelsGroupActivated()));
+		pAction->setData(iData | ChannelGroupDelete);
+	}
 }
 
 
@@ -2769,6 +3173,107 @@ void MainForm::channelsMenuActivated (void)
 }
 
 
+// Channel groups menu activation slot
+void MainForm::channelsGroupActivated (void)
+{
+	// Retrive group index and operation from action data...
+	QAction *pAction = qobject_cast<QAction *> (sender());
+	if (pAction == nullptr)
+		return;
+
+	const int iData = pAction->data().toInt();
+	const int iOperation = (iData & 0xff);
+
+	ChannelStrip *pActiveStrip = activeChannelStrip();
+	const int iActiveChannelID = (pActiveStrip && pActiveStrip->channel()
+		? pActiveStrip->channel()->channelID() : -1);
+
+	// Creating a brand new group?
+	if (iOperation == ChannelGroupNew) {
+		bool bOk = false;
+		const QString& sName = QInputDialog::getText(this,
+			tr("New Group"), tr("Group name:"), QLineEdit::Normal,
+			tr("Group %1").arg(m_channelGroups.count() + 1), &bOk).simplified();
+		if (bOk && !sName.isEmpty()) {
+			ChannelGroup *pChannelGroup = new ChannelGroup(sName);
+			pChannelGroup->addChannel(iActiveChannelID);
+			m_channelGroups.append(pChannelGroup);
+			sessionDirty();
+		}
+		return;
+	}
+
+	const int iGroup = (iData >> 8);
+	if (iGroup < 0 || iGroup >= m_channelGroups.count())
+		return;
+
+	ChannelGroup *pChannelGroup = m_channelGroups.at(iGroup);
+
+	switch (iOperation) {
+	case ChannelGroupAdd:
+		pChannelGroup->addChannel(iActiveChannelID);
+		sessionDirty();
+		break;
+	case ChannelGroupRemove:
+		pChannelGroup->removeChannel(iActiveChannelID);
+		sessionDirty();
+		break;
+	case ChannelGroupReset:
+		pChannelGroup->resetChannels();
+		break;
+	case ChannelGroupMute:
+		pChannelGroup->setChannelMute(true);
+		break;
+	case ChannelGroupUnmute:
+		pChannelGroup->setChannelMute(false);
+		break;
+	case ChannelGroupSolo:
+		pChannelGroup->setChannelSolo(true);
+		break;
+	case ChannelGroupUnsolo:
+		pChannelGroup->setChannelSolo(false);
+		break;
+	case ChannelGroupVolume: {
+		bool bOk = false;
+		const double fScale = QInputDialog::getDouble(this,
+			pChannelGroup->name(), tr("Volume scale:"),
+			1.0, 0.0, 10.0, 2, &bOk);
+		if (bOk)
+			pChannelGroup->scaleVolume(float(fScale));
+		break;
+	}
+#ifdef CONFIG_MIDI_INSTRUMENT
+	case ChannelGroupMidiMap: {
+		QStringList maps;
+		QList<int> mapIDs;
+		maps.append(tr("(Default)"));
+		mapIDs.append(LSCP_MIDI_MAP_DEFAULT);
+		maps.append(tr("(None)"));
+		mapIDs.append(LSCP_MIDI_MAP_NONE);
+		int *piMaps = QSAMPLER_LSCP(lscp_list_midi_instrument_maps, m_pClient);
+		for (int iMap = 0; piMaps && piMaps[iMap] >= 0; ++iMap) {
+			maps.append(Instrument::getMapName(piMaps[iMap]));
+			mapIDs.append(piMaps[iMap]);
+		}
+		bool bOk = false;
+		const QString& sMap = QInputDialog::getItem(this,
+			pChannelGroup->name(), tr("MIDI Instrument Map:"),
+			maps, 0, false, &bOk);
+		const int iMap = maps.indexOf(sMap);
+		if (bOk && iMap >= 0)
+			pChannelGroup->setMidiMap(mapIDs.at(iMap));
+		break;
+	}
+#endif
+	case ChannelGroupDelete:
+		m_channelGroups.removeAt(iGroup);
+		delete pChannelGroup;
+		sessionDirty();
+		break;
+	}
+}
+
+
 //-------------------------------------------------------------------------
 // QSampler::MainForm -- Timer stuff.
 
@@ -2789,6 +3294,8 @@ void MainForm::stopSchedule (void)
 // Timer slot funtion.
 void MainForm::timerSlot (void)
 {
+	QSAMPLER_TRACE("gui", "MainForm::timerSlot");
+
 	if (m_pOptions == nullptr)
 		return;
 
@@ -2805,7 +3312,11 @@ void MainForm::timerSlot (void)
 	}
 
 	if (m_pClient) {
-		// Update the channel information for each pending strip...
+		// Update the channel information for each pending strip,
+		// all in one single workspace update...
+		const bool bChangedStrips = !m_changedStrips.isEmpty();
+		if (bChangedStrips)
+			m_pWorkspace->setUpdatesEnabled(false);
 		QListIterator<ChannelStrip *> iter(m_changedStrips);
 		while (iter.hasNext()) {
 			ChannelStrip *pChannelStrip = iter.next();
@@ -2816,12 +3327,21 @@ void MainForm::timerSlot (void)
 					m_changedStrips.removeAt(iChannelStrip);
 			}
 		}
+		if (bChangedStrips)
+			m_pWorkspace->setUpdatesEnabled(true);
+		// ...or each mixer row still loading, whether shown or not.
+		if (isChannelMixer())
+			m_pChannelMixer->mixerView()->updateChannelInfo();
 		// Refresh each channel usage, on each period...
 		if (m_pOptions->bAutoRefresh) {
 			m_iTimerSlot += QSAMPLER_TIMER_MSECS;
 			if (m_iTimerSlot >= m_pOptions->iAutoRefreshTime)  {
 				m_iTimerSlot = 0;
-				// Update the channel stream usage for each strip...
+				// Poll each channel stream usage, whether shown or not...
+				QListIterator<Channel *> channel_iter(channels());
+				while (channel_iter.hasNext())
+					channel_iter.next()->updateChannelUsage();
+				// ...then just refresh the visible strips...
 				const QList<QMdiSubWindow *>& wlist
 					= m_pWorkspace->subWindowList();
 				foreach (QMdiSubWindow *pMdiSubWindow, wlist) {
@@ -2830,6 +3350,9 @@ void MainForm::timerSlot (void)
 					if (pChannelStrip && pChannelStrip->isVisible())
 						pChannelStrip->updateChannelUsage();
 				}
+				// ...or the mixer visible rows only.
+				if (m_pChannelMixer)
+					m_pChannelMixer->mixerView()->updateChannelUsage();
 			}
 		}
 
@@ -2960,7 +3483,11 @@ void MainForm::stopServer ( bool bInteractive )
 		#else
 			// Try softly...
 			m_pServer->terminate();
+			// (not re-entering processServerExit, which
+			// would delete it from within its own wait)...
+			m_pServer->blockSignals(true);
 			bool bFinished = m_pServer->waitForFinished(QSAMPLER_TIMER_MSECS * 1000);
+			m_pServer->blockSignals(false);
 			if (bFinished) bGraceWait = false;
 		#endif
 		}
@@ -2968,12 +3495,16 @@ void MainForm::stopServer ( bool bInteractive )
 	else processServerExit();
 
 	// Give it some time to terminate gracefully and stabilize...
-	if (bGraceWait) {
-		QElapsedTimer timer;
-		timer.start();
-		while (timer.elapsed() < QSAMPLER_TIMER_MSECS)
-			QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+	if (bGraceWait && m_pServer) {
+		m_pServer->blockSignals(true);
+		m_pServer->waitForFinished(QSAMPLER_TIMER_MSECS);
+		m_pServer->blockSignals(false);
 	}
+
+	// Do the final processing ourselves, as it's been kept
+	// from happening while waiting above...
+	if (m_pServer && m_bForceServerStop)
+		processServerExit();
 }
 
 
@@ -3000,11 +3531,10 @@ void MainForm::processServerExit (void)
 			appendMessages(tr("Server is being forced..."));
 			// Force final server shutdown...
 			m_pServer->kill();
-			// Give it some time to terminate gracefully and stabilize...
-			QElapsedTimer timer;
-			timer.start();
-			while (timer.elapsed() < QSAMPLER_TIMER_MSECS)
-				QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+			// Give it some time to terminate gracefully and stabilize
+			// (not re-entering here, as it is about to go anyway)...
+			m_pServer->blockSignals(true);
+			m_pServer->waitForFinished(QSAMPLER_TIMER_MSECS);
 		}
 		// Force final server shutdown...
 		appendMessages(
@@ -3054,10 +3584,47 @@ bool MainForm::startClient (bool bReconnectOnly)
 	// Log prepare here.
 	appendMessages(tr("Client connecting..."));
 
+	QString sServerHost = m_pOptions->sServerHost;
+	int iServerPort = m_pOptions->iServerPort;
+
+#ifdef CONFIG_RECORDER
+	// Record all LSCP traffic through a local proxy, if asked to...
+	if (!m_pOptions->sRecordFile.isEmpty()) {
+		if (m_pRecorder == nullptr) {
+			m_pRecorder = new Recorder(m_pOptions->sRecordFile);
+			if (m_pRecorder->startRecorder(sServerHost, iServerPort) < 0) {
+				appendMessagesError(
+					tr("Could not start recording LSCP traffic to:\n\n"
+					"\"%1\".\n\nSorry.").arg(m_pOptions->sRecordFile));
+				delete m_pRecorder;
+				m_pRecorder = nullptr;
+				m_pOptions->sRecordFile.clear();
+			} else {
+				appendMessages(tr("Recording LSCP traffic to \"%1\"...")
+					.arg(m_pOptions->sRecordFile));
+			}
+		}
+		if (m_pRecorder) {
+			m_pRecorder->setServer(sServerHost, iServerPort);
+			sServerHost = "127.0.0.1";
+			iServerPort = m_pRecorder->proxyPort();
+		}
+	}
+#endif
+
 	// Create the client handle...
-	m_pClient = ::lscp_client_create(
-		m_pOptions->sServerHost.toUtf8().constData(),
-		m_pOptions->iServerPort, qsampler_client_callback, this);
+	bool bServer = true;
+#ifdef CONFIG_RECORDER
+	// The local proxy accepts anyway, so there
+	// must be an actual server behind it first...
+	if (m_pRecorder && !m_pRecorder->checkServer(m_pOptions->iServerTimeout))
+		bServer = false;
+#endif
+	if (bServer) {
+		m_pClient = ::lscp_client_create(
+			sServerHost.toUtf8().constData(),
+			iServerPort, qsampler_client_callback, this);
+	}
 	if (m_pClient == nullptr) {
 		// Is this the first try?
 		// maybe we need to start a local server...
@@ -3079,38 +3646,43 @@ bool MainForm::startClient (bool bReconnectOnly)
 		return false;
 	}
 
+	// Driver parameter info is cached per connection.
+	Device::clearDriverParams();
+
 	// Just set receive timeout value, blindly.
 	::lscp_client_set_timeout(m_pClient, m_pOptions->iServerTimeout);
+	m_pVolumeSender->setServer(sServerHost, iServerPort,
+		m_pOptions->iServerTimeout);
 	appendMessages(
 		tr("Client receive timeout is set to %1 msec.")
 		.arg(::lscp_client_get_timeout(m_pClient)));
 
 	// Subscribe to channel info change notifications...
-	if (::lscp_client_subscribe(m_pClient, LSCP_EVENT_CHANNEL_COUNT) != LSCP_OK)
+	if (QSAMPLER_LSCP(lscp_client_subscribe, m_pClient, LSCP_EVENT_CHANNEL_COUNT) != LSCP_OK)
 		appendMessagesClient("lscp_client_subscribe(CHANNEL_COUNT)");
-	if (::lscp_client_subscribe(m_pClient, LSCP_EVENT_CHANNEL_INFO) != LSCP_OK)
+	if (QSAMPLER_LSCP(lscp_client_subscribe, m_pClient, LSCP_EVENT_CHANNEL_INFO) != LSCP_OK)
 		appendMessagesClient("lscp_client_subscribe(CHANNEL_INFO)");
 
 	DeviceStatusForm::onDevicesChanged(); // initialize
 	updateViewMidiDeviceStatusMenu();
-	if (::lscp_client_subscribe(m_pClient, LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT) != LSCP_OK)
+	if (QSAMPLER_LSCP(lscp_client_subscribe, m_pClient, LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT) != LSCP_OK)
 		appendMessagesClient("lscp_client_subscribe(MIDI_INPUT_DEVICE_COUNT)");
-	if (::lscp_client_subscribe(m_pClient, LSCP_EVENT_MIDI_INPUT_DEVICE_INFO) != LSCP_OK)
+	if (QSAMPLER_LSCP(lscp_client_subscribe, m_pClient, LSCP_EVENT_MIDI_INPUT_DEVICE_INFO) != LSCP_OK)
 		appendMessagesClient("lscp_client_subscribe(MIDI_INPUT_DEVICE_INFO)");
-	if (::lscp_client_subscribe(m_pClient, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT) != LSCP_OK)
+	if (QSAMPLER_LSCP(lscp_client_subscribe, m_pClient, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT) != LSCP_OK)
 		appendMessagesClient("lscp_client_subscribe(AUDIO_OUTPUT_DEVICE_COUNT)");
-	if (::lscp_client_subscribe(m_pClient, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO) != LSCP_OK)
+	if (QSAMPLER_LSCP(lscp_client_subscribe, m_pClient, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO) != LSCP_OK)
 		appendMessagesClient("lscp_client_subscribe(AUDIO_OUTPUT_DEVICE_INFO)");
 
 #if CONFIG_EVENT_CHANNEL_MIDI
 	// Subscribe to channel MIDI data notifications...
-	if (::lscp_client_subscribe(m_pClient, LSCP_EVENT_CHANNEL_MIDI) != LSCP_OK)
+	if (QSAMPLER_LSCP(lscp_client_subscribe, m_pClient, LSCP_EVENT_CHANNEL_MIDI) != LSCP_OK)
 		appendMessagesClient("lscp_client_subscribe(CHANNEL_MIDI)");
 #endif
 
 #if CONFIG_EVENT_DEVICE_MIDI
 	// Subscribe to channel MIDI data notifications...
-	if (::lscp_client_subscribe(m_pClient, LSCP_EVENT_DEVICE_MIDI) != LSCP_OK)
+	if (QSAMPLER_LSCP(lscp_client_subscribe, m_pClient, LSCP_EVENT_DEVICE_MIDI) != LSCP_OK)
 		appendMessagesClient("lscp_client_subscribe(DEVICE_MIDI)");
 #endif
 
@@ -3162,6 +3734,9 @@ void MainForm::stopClient (void)
 	// We'll reject drops from now on...
 	setAcceptDrops(false);
 
+	// Have any pending volume changes through.
+	m_pVolumeSender->setServer(QString(), 0, 0);
+
 	// Force any channel strips around, but
 	// but avoid removing the corresponding
 	// channels from the back-end server.
@@ -3170,20 +3745,36 @@ void MainForm::stopClient (void)
 
 	// Close us as a client...
 #if CONFIG_EVENT_DEVICE_MIDI
-	::lscp_client_unsubscribe(m_pClient, LSCP_EVENT_DEVICE_MIDI);
+	QSAMPLER_LSCP(lscp_client_unsubscribe, m_pClient, LSCP_EVENT_DEVICE_MIDI);
 #endif
 #if CONFIG_EVENT_CHANNEL_MIDI
-	::lscp_client_unsubscribe(m_pClient, LSCP_EVENT_CHANNEL_MIDI);
+	QSAMPLER_LSCP(lscp_client_unsubscribe, m_pClient, LSCP_EVENT_CHANNEL_MIDI);
 #endif
-	::lscp_client_unsubscribe(m_pClient, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO);
-	::lscp_client_unsubscribe(m_pClient, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT);
-	::lscp_client_unsubscribe(m_pClient, LSCP_EVENT_MIDI_INPUT_DEVICE_INFO);
-	::lscp_client_unsubscribe(m_pClient, LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT);
-	::lscp_client_unsubscribe(m_pClient, LSCP_EVENT_CHANNEL_INFO);
-	::lscp_client_unsubscribe(m_pClient, LSCP_EVENT_CHANNEL_COUNT);
+	QSAMPLER_LSCP(lscp_client_unsubscribe, m_pClient, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO);
+	QSAMPLER_LSCP(lscp_client_unsubscribe, m_pClient, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT);
+	QSAMPLER_LSCP(lscp_client_unsubscribe, m_pClient, LSCP_EVENT_MIDI_INPUT_DEVICE_INFO);
+	QSAMPLER_LSCP(lscp_client_unsubscribe, m_pClient, LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT);
+	QSAMPLER_LSCP(lscp_client_unsubscribe, m_pClient, LSCP_EVENT_CHANNEL_INFO);
+	QSAMPLER_LSCP(lscp_client_unsubscribe, m_pClient, LSCP_EVENT_CHANNEL_COUNT);
 	::lscp_client_destroy(m_pClient);
 	m_pClient = nullptr;
 
+	// Forget about any cached driver parameter info.
+	Device::clearDriverParams();
+
+	// Nor the sampler limits, as for the metrics.
+	m_pMetrics->resetLimits();
+
+	// Nor any channel underrun states (counts are kept).
+	m_pUnderrunDetector->reset();
+
+	// Nor the last budget recommendations.
+	m_pBudgetTuner->reset();
+
+	// No more channels to mix.
+	if (m_pChannelMixer)
+		m_pChannelMixer->mixerView()->clearChannels();
+
 	// Hard-notify instrumnet and device configuration forms,
 	// if visible, that we're running out...
 	if (m_pInstrumentListForm)
@@ -3224,7 +3815,7 @@ void MainForm::activateStrip ( QMdiSubWindow *pMdiSubWindow )
 	if (pChannelStrip)
 		pChannelStrip->setSelected(true);
 
-	stabilizeForm();
+	stabilizeForm(StabilizeChannel);
 }
 
 
@@ -33,12 +33,29 @@ class QSocketNotifier;
 class QSpinBox;
 class QSlider;
 class QLabel;
+class QProgressBar;
+class QToolButton;
+class QMenu;
 
 namespace QSampler {
 
 class Workspace;
 class Options;
 class Messages;
+class ChannelMixer;
+class Statistics;
+class ChannelLoader;
+class VolumeSender;
+class TaskScheduler;
+class LoadSessionTask;
+class SessionSnapshot;
+class SessionWriter;
+class SessionDelta;
+class Recorder;
+class MetricsExporter;
+class UnderrunDetector;
+class BudgetTuner;
+class ChannelGroup;
 class Channel;
 class ChannelStrip;
 class DeviceForm;
@@ -57,10 +74,24 @@ public:
 	MainForm(QWidget *pParent = nullptr);
 	~MainForm();
 
+	// Form state facets (to stabilize).
+	enum StabilizeFacet
+	{
+		StabilizeSession  = 1,  // Session name and modified state.
+		StabilizeClient   = 2,  // Client/server connection state.
+		StabilizeChannel  = 4,  // Active channel selection.
+		StabilizeChannels = 8,  // Number of channels.
+		StabilizeForms    = 16, // Child forms visibility.
+		StabilizeAll      = 31
+	};
+
 	void setup(Options *pOptions);
 
 	Options *options() const;
 	lscp_client_t *client() const;
+	VolumeSender *volumeSender() const;
+	TaskScheduler *taskScheduler() const;
+	UnderrunDetector *underrunDetector() const;
 
 	QString sessionName(const QString& sFilename);
 
@@ -72,10 +103,19 @@ public:
 
 	ChannelStrip *createChannelStrip(Channel *pChannel);
 	void destroyChannelStrip(ChannelStrip *pChannelStrip);
+	int addChannelStrips(const QStringList& files);
+	void updateChannelStrips(const QList<int>& channelIDs);
 	ChannelStrip *activeChannelStrip();
 	ChannelStrip *channelStripAt(int iChannel);
 	ChannelStrip *channelStrip(int iChannelID);
 
+	// Sampler channels, whichever the view (strips or mixer rows).
+	bool isChannelMixer() const;
+	bool createChannel(Channel *pChannel);
+	void destroyChannel(Channel *pChannel);
+	Channel *channel(int iChannelID);
+	QList<Channel *> channels(bool bUpdate = false);
+
 	void channelsArrangeAuto();
 	void contextMenuEvent(QContextMenuEvent *pEvent);
 	void sessionDirty();
@@ -102,6 +142,9 @@ public slots:
 	void viewToolbar(bool bOn);
 	void viewStatusbar(bool bOn);
 	void viewMessages(bool bOn);
+	void viewMixer(bool bOn);
+	void viewStatistics(bool bOn);
+	void viewUnderrunReport();
 	void viewInstruments();
 	void viewDevices();
 	void viewOptions();
@@ -110,7 +153,7 @@ public slots:
 	void helpAboutQt();
 	void helpAbout();
 
-	void stabilizeForm();
+	void stabilizeForm(int iFacets = StabilizeAll);
 
 protected slots:
 
@@ -120,6 +163,11 @@ protected slots:
 	void channelStripChanged(ChannelStrip *pChannelStrip);
 	void channelsMenuAboutToShow();
 	void channelsMenuActivated();
+	void channelsGroupActivated();
+	void stabilizeFlush();
+	void taskBusyChanged(bool bBusy);
+	void sessionWriterFinished();
+	void formVisibilityChanged();
 	void timerSlot();
 	void readServerStdout();
 	void processServerExit();
@@ -146,10 +194,22 @@ protected:
 	void customEvent(QEvent *pCustomEvent);
 	bool newSession();
 	bool openSession();
-	bool saveSession(bool bPrompt);
+	bool saveSession(bool bPrompt, bool bAsync = true);
+	bool querySession();
 	bool closeSession(bool bForce);
+	bool openSessionFile(const QString& sFilename);
+	bool switchSessionFile(const SessionSnapshot& session);
 	bool loadSessionFile(const QString& sFilename);
-	bool saveSessionFile(const QString& sFilename);
+	bool saveSessionFile(const QString& sFilename, bool bAsync = true);
+
+	void loadSessionDone(const QString& sFilename,
+		int iErrors, bool bCancelled);
+	void saveSessionDone(const QString& sFilename,
+		int iErrors, int iDirtyCount, bool bSaved, bool bLatest = true);
+
+	void sessionWriterDone(SessionWriter *pWriter);
+	void sessionWritersWait();
+	bool isSessionBusy() const;
 	void updateSession();
 	void updateRecentFiles(const QString& sFilename);
 	void updateInstrumentNames();
@@ -159,6 +219,7 @@ protected:
 	void updateMessagesFont();
 	void updateMessagesLimit();
 	void updateMessagesCapture();
+	void updateMetrics();
 	void updateViewMidiDeviceStatusMenu();
 	void updateAllChannelStrips(bool bRemoveDeadStrips);
 
@@ -172,10 +233,30 @@ protected:
 
 private:
 
+	// Session loader, snapshot and delta do need to get in here.
+	friend class LoadSessionTask;
+	friend class SessionSnapshot;
+	friend class SessionDelta;
+
 	Ui::qsamplerMainForm m_ui;
 
 	Options *m_pOptions;
 	Messages *m_pMessages;
+	ChannelMixer *m_pChannelMixer;
+	Statistics *m_pStatistics;
+	ChannelLoader *m_pChannelLoader;
+	VolumeSender *m_pVolumeSender;
+	Recorder *m_pRecorder;
+	MetricsExporter *m_pMetrics;
+	UnderrunDetector *m_pUnderrunDetector;
+	BudgetTuner *m_pBudgetTuner;
+	TaskScheduler *m_pTaskScheduler;
+	QProgressBar *m_pTaskProgress;
+	QToolButton *m_pTaskCancel;
+	QList<SessionWriter *> m_sessionWriters;
+	QString m_sSaveFilename;
+	QList<ChannelGroup *> m_channelGroups;
+	QMenu *m_pGroupsMenu;
 	Workspace *m_pWorkspace;
 	QSocketNotifier *m_pSigusr1Notifier;
 	QSocketNotifier *m_pSigtermNotifier;
@@ -183,6 +264,8 @@ private:
 	int m_iUntitled;
 	int m_iDirtySetup;
 	int m_iDirtyCount;
+	int m_iStabilize;
+	bool m_bStabilize;
 	lscp_client_t *m_pClient;
 	QProcess *m_pServer;
 	bool m_bForceServerStop;
@@ -0,0 +1,243 @@
+// qsamplerMetrics.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerMetrics.h"
+
+#include "qsamplerChannel.h"
+#include "qsamplerOptions.h"
+#include "qsamplerMainForm.h"
+#include "qsamplerTrace.h"
+
+#include <QSaveFile>
+#include <QTextStream>
+#include <QDateTime>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+#define endl	Qt::endl
+#endif
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::MetricsExporter -- Prometheus textfile metrics exporter.
+//
+
+// Label value escaping, as of the text exposition format.
+static QString metricsLabel ( const QString& sValue )
+{
+	QString sLabel = sValue;
+	sLabel.replace('\\', "\\\\");
+	sLabel.replace('"', "\\\"");
+	sLabel.replace('\n', "\\n");
+	return sLabel;
+}
+
+
+// Metric family header.
+static void metricsHeader ( QTextStream& ts,
+	const char *pszName, const char *pszHelp )
+{
+	ts << "# HELP " << pszName << ' ' << pszHelp << endl;
+	ts << "# TYPE " << pszName << " gauge" << endl;
+}
+
+
+// Constructor.
+MetricsExporter::MetricsExporter ( QObject *pParent ) : QObject(pParent)
+{
+	m_iMaxVoices  = -1;
+	m_iMaxStreams = -1;
+	m_bError = false;
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(exportMetrics()));
+}
+
+
+// Exporter setup; a null interval (secs) disables it.
+void MetricsExporter::setup ( const QString& sFilename, int iInterval )
+{
+	m_timer.stop();
+
+	m_sFilename = sFilename;
+	m_bError = false;
+
+	if (m_sFilename.isEmpty() || iInterval < 1)
+		return;
+
+	m_timer.start(iInterval * 1000);
+}
+
+
+bool MetricsExporter::isEnabled (void) const
+{
+	return m_timer.isActive();
+}
+
+
+// Forget the cached sampler limits (eg. on client changes).
+void MetricsExporter::resetLimits (void)
+{
+	m_iMaxVoices  = -1;
+	m_iMaxStreams = -1;
+}
+
+
+// Write the metrics file right away.
+bool MetricsExporter::exportMetrics (void)
+{
+	QSAMPLER_TRACE("gui", "MetricsExporter::exportMetrics");
+
+	if (m_sFilename.isEmpty())
+		return false;
+
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+
+	const bool bClient = (pMainForm->client() != nullptr);
+
+	// The sampler limits are only asked once per connection...
+	Options *pOptions = pMainForm->options();
+	if (bClient && pOptions && m_iMaxVoices < 0) {
+		m_iMaxVoices  = pOptions->getEffectiveMaxVoices();
+		m_iMaxStreams = pOptions->getEffectiveMaxStreams();
+	}
+
+	// Everything else is just what the channels have got so far...
+	const QList<Channel *>& channels = pMainForm->channels();
+	int iVoices  = 0;
+	int iStreams = 0;
+	QListIterator<Channel *> channel_iter(channels);
+	while (channel_iter.hasNext()) {
+		Channel *pChannel = channel_iter.next();
+		if (pChannel->instrumentStatus() >= 100) {
+			iVoices  += pChannel->voiceCount();
+			iStreams += pChannel->streamCount();
+		}
+	}
+
+	QString sText;
+	QTextStream ts(&sText);
+
+	metricsHeader(ts, "qsampler_up",
+		"Whether qsampler is connected to the sampler.");
+	ts << "qsampler_up " << int(bClient) << endl;
+
+	metricsHeader(ts, "qsampler_channels",
+		"Number of sampler channels.");
+	ts << "qsampler_channels " << channels.count() << endl;
+
+	metricsHeader(ts, "qsampler_voices",
+		"Total number of active voices, as last refreshed.");
+	ts << "qsampler_voices " << iVoices << endl;
+
+	metricsHeader(ts, "qsampler_streams",
+		"Total number of active disk streams, as last refreshed.");
+	ts << "qsampler_streams " << iStreams << endl;
+
+	if (bClient && m_iMaxVoices >= 0) {
+		metricsHeader(ts, "qsampler_max_voices",
+			"Effective maximum number of voices.");
+		ts << "qsampler_max_voices " << m_iMaxVoices << endl;
+	}
+
+	if (bClient && m_iMaxStreams >= 0) {
+		metricsHeader(ts, "qsampler_max_streams",
+			"Effective maximum number of disk streams.");
+		ts << "qsampler_max_streams " << m_iMaxStreams << endl;
+	}
+
+	// Per channel metric families, one label set each...
+	QStringList labels;
+	QListIterator<Channel *> iter(channels);
+	while (iter.hasNext()) {
+		Channel *pChannel = iter.next();
+		labels.append(QString("{channel=\"%1\",instrument=\"%2\"}")
+			.arg(pChannel->channelID())
+			.arg(metricsLabel(pChannel->instrumentName())));
+	}
+
+	metricsHeader(ts, "qsampler_channel_instrument_status",
+		"Instrument loading progress in percent (negative on error).");
+	for (int i = 0; i < channels.count(); ++i) {
+		ts << "qsampler_channel_instrument_status" << labels.at(i) << ' '
+			<< channels.at(i)->instrumentStatus() << endl;
+	}
+
+	metricsHeader(ts, "qsampler_channel_voices",
+		"Number of active voices, as last refreshed.");
+	for (int i = 0; i < channels.count(); ++i) {
+		ts << "qsampler_channel_voices" << labels.at(i) << ' '
+			<< channels.at(i)->voiceCount() << endl;
+	}
+
+	metricsHeader(ts, "qsampler_channel_streams",
+		"Number of active disk streams, as last refreshed.");
+	for (int i = 0; i < channels.count(); ++i) {
+		ts << "qsampler_channel_streams" << labels.at(i) << ' '
+			<< channels.at(i)->streamCount() << endl;
+	}
+
+	metricsHeader(ts, "qsampler_channel_stream_fill_percent",
+		"Fill level of the least filled stream buffer, as last refreshed.");
+	for (int i = 0; i < channels.count(); ++i) {
+		ts << "qsampler_channel_stream_fill_percent" << labels.at(i) << ' '
+			<< channels.at(i)->streamUsage() << endl;
+	}
+
+	metricsHeader(ts, "qsampler_channel_refresh_timestamp_seconds",
+		"Time of the last channel usage refresh (zero if never).");
+	for (int i = 0; i < channels.count(); ++i) {
+		ts << "qsampler_channel_refresh_timestamp_seconds" << labels.at(i) << ' '
+			<< QString::number(double(channels.at(i)->usageTime()) / 1000.0, 'f', 3)
+			<< endl;
+	}
+
+	ts.flush();
+
+	// Write to a temporary file, then rename over (atomic).
+	QSaveFile file(m_sFilename);
+	bool bResult = file.open(QIODevice::WriteOnly | QIODevice::Text);
+	if (bResult) {
+		file.write(sText.toUtf8());
+		bResult = file.commit();
+	}
+
+	// Complain only once in a row...
+	if (!bResult && !m_bError) {
+		pMainForm->appendMessagesError(
+			tr("Could not write metrics file:\n\n\"%1\"\n\n%2.")
+			.arg(m_sFilename).arg(file.errorString()));
+	}
+
+	m_bError = !bResult;
+
+	return bResult;
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerMetrics.cpp
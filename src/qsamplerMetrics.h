@@ -0,0 +1,80 @@
+// qsamplerMetrics.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerMetrics_h
+#define __qsamplerMetrics_h
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::MetricsExporter -- Prometheus textfile metrics exporter.
+//
+// Periodically writes the last known sampler load figures, as already
+// fetched by the channel strips auto-refresh, into a textfile suitable
+// for the node_exporter textfile collector (written atomically).
+//
+
+class MetricsExporter : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	MetricsExporter(QObject *pParent = nullptr);
+
+	// Exporter setup; a null interval (secs) disables it.
+	void setup(const QString& sFilename, int iInterval);
+
+	bool isEnabled() const;
+
+public slots:
+
+	// Forget the cached sampler limits (eg. on client changes).
+	void resetLimits();
+
+	// Write the metrics file right away.
+	bool exportMetrics();
+
+private:
+
+	// Instance variables.
+	QString m_sFilename;
+	QTimer  m_timer;
+
+	int     m_iMaxVoices;
+	int     m_iMaxStreams;
+
+	bool    m_bError;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerMetrics_h
+
+
+// end of qsamplerMetrics.h
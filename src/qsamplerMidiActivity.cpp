@@ -0,0 +1,206 @@
+// qsamplerMidiActivity.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerMidiActivity.h"
+
+#include <QLabel>
+
+
+// Frame period (~30Hz) and LED hold-on frames (~100msec).
+#define QSAMPLER_MIDI_ACTIVITY_MSECS   33
+#define QSAMPLER_MIDI_ACTIVITY_FRAMES  3
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::MidiActivityClock -- Shared MIDI activity LED animation clock.
+//
+
+// The one and only clock instance.
+MidiActivityClock *MidiActivityClock::g_pClock = nullptr;
+
+
+// Constructor.
+MidiActivityClock::MidiActivityClock (void)
+	: m_ledOn(":/images/ledon1.png"), m_ledOff(":/images/ledoff1.png")
+{
+	m_timer.setInterval(QSAMPLER_MIDI_ACTIVITY_MSECS);
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(frameSlot()));
+}
+
+
+// MIDI activity LED (label) registry.
+void MidiActivityClock::attach ( QLabel *pLabel )
+{
+	if (g_pClock == nullptr)
+		g_pClock = new MidiActivityClock();
+
+	Led& led = g_pClock->m_leds[pLabel];
+	led.bActivity = false;
+	led.iHold = 0;
+
+	pLabel->setPixmap(g_pClock->m_ledOff);
+}
+
+
+void MidiActivityClock::detach ( QLabel *pLabel )
+{
+	if (g_pClock == nullptr)
+		return;
+
+	g_pClock->m_leds.remove(pLabel);
+
+	cleanup();
+}
+
+
+// Latch MIDI activity, to be shown on next frame.
+void MidiActivityClock::trigger ( QLabel *pLabel )
+{
+	if (g_pClock == nullptr)
+		return;
+
+	QHash<QLabel *, Led>::Iterator iter = g_pClock->m_leds.find(pLabel);
+	if (iter == g_pClock->m_leds.end())
+		return;
+
+	iter.value().bActivity = true;
+
+	if (!g_pClock->m_timer.isActive())
+		g_pClock->m_timer.start();
+}
+
+
+// Custom-painted MIDI activity LED registry.
+void MidiActivityClock::attach ( MidiActivityView *pView, int iLed )
+{
+	if (g_pClock == nullptr)
+		g_pClock = new MidiActivityClock();
+
+	Led& led = g_pClock->m_views[ViewLed(pView, iLed)];
+	led.bActivity = false;
+	led.iHold = 0;
+}
+
+
+void MidiActivityClock::detach ( MidiActivityView *pView, int iLed )
+{
+	if (g_pClock == nullptr)
+		return;
+
+	g_pClock->m_views.remove(ViewLed(pView, iLed));
+
+	cleanup();
+}
+
+
+// Latch custom-painted MIDI activity, to be shown on next frame.
+void MidiActivityClock::trigger ( MidiActivityView *pView, int iLed )
+{
+	if (g_pClock == nullptr)
+		return;
+
+	QHash<ViewLed, Led>::Iterator iter
+		= g_pClock->m_views.find(ViewLed(pView, iLed));
+	if (iter == g_pClock->m_views.end())
+		return;
+
+	iter.value().bActivity = true;
+
+	if (!g_pClock->m_timer.isActive())
+		g_pClock->m_timer.start();
+}
+
+
+// Whether a custom-painted LED is currently lit.
+bool MidiActivityClock::isLit ( MidiActivityView *pView, int iLed )
+{
+	if (g_pClock == nullptr)
+		return false;
+
+	return (g_pClock->m_views.value(ViewLed(pView, iLed)).iHold > 0);
+}
+
+
+// Last one turns off the lights...
+void MidiActivityClock::cleanup (void)
+{
+	if (g_pClock && g_pClock->m_leds.isEmpty() && g_pClock->m_views.isEmpty()) {
+		delete g_pClock;
+		g_pClock = nullptr;
+	}
+}
+
+
+// Shared frame tick: repaint only those LEDs whose state has changed.
+void MidiActivityClock::frameSlot (void)
+{
+	int iLit = 0;
+
+	QHash<QLabel *, Led>::Iterator iter = m_leds.begin();
+	for ( ; iter != m_leds.end(); ++iter) {
+		Led& led = iter.value();
+		if (led.bActivity) {
+			led.bActivity = false;
+			if (led.iHold == 0)
+				iter.key()->setPixmap(m_ledOn);
+			led.iHold = QSAMPLER_MIDI_ACTIVITY_FRAMES;
+		}
+		else
+		if (led.iHold > 0 && --led.iHold == 0)
+			iter.key()->setPixmap(m_ledOff);
+		if (led.iHold > 0)
+			++iLit;
+	}
+
+	QHash<ViewLed, Led>::Iterator view_iter = m_views.begin();
+	for ( ; view_iter != m_views.end(); ++view_iter) {
+		Led& led = view_iter.value();
+		const ViewLed& key = view_iter.key();
+		if (led.bActivity) {
+			led.bActivity = false;
+			const bool bChanged = (led.iHold == 0);
+			led.iHold = QSAMPLER_MIDI_ACTIVITY_FRAMES;
+			if (bChanged)
+				key.first->midiActivityChanged(key.second);
+		}
+		else
+		if (led.iHold > 0 && --led.iHold == 0)
+			key.first->midiActivityChanged(key.second);
+		if (led.iHold > 0)
+			++iLit;
+	}
+
+	// Go idle when all is dark...
+	if (iLit == 0)
+		m_timer.stop();
+}
+
+
+} // namespace QSampler
+
+
+// end of qsamplerMidiActivity.cpp
@@ -0,0 +1,121 @@
+// qsamplerMidiActivity.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerMidiActivity_h
+#define __qsamplerMidiActivity_h
+
+#include <QObject>
+#include <QPixmap>
+#include <QTimer>
+#include <QHash>
+#include <QPair>
+
+class QLabel;
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::MidiActivityView -- Custom-painted MIDI activity LEDs.
+//
+
+class MidiActivityView
+{
+public:
+
+	// Destructor.
+	virtual ~MidiActivityView() {}
+
+	// LED state change notification (repaint it).
+	virtual void midiActivityChanged(int iLed) = 0;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::MidiActivityClock -- Shared MIDI activity LED animation clock.
+//
+
+class MidiActivityClock : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// MIDI activity LED (label) registry.
+	static void attach(QLabel *pLabel);
+	static void detach(QLabel *pLabel);
+
+	// Latch MIDI activity, to be shown on next frame.
+	static void trigger(QLabel *pLabel);
+
+	// Custom-painted MIDI activity LED registry.
+	static void attach(MidiActivityView *pView, int iLed);
+	static void detach(MidiActivityView *pView, int iLed);
+
+	// Latch custom-painted MIDI activity, to be shown on next frame.
+	static void trigger(MidiActivityView *pView, int iLed);
+
+	// Whether a custom-painted LED is currently lit.
+	static bool isLit(MidiActivityView *pView, int iLed);
+
+protected slots:
+
+	// Shared frame tick.
+	void frameSlot();
+
+private:
+
+	// Constructor.
+	MidiActivityClock();
+
+	// Check whether there's no LEDs left.
+	static void cleanup();
+
+	// MIDI activity LED state.
+	struct Led
+	{
+		bool bActivity;
+		int  iHold;
+	};
+
+	// Custom-painted LED key.
+	typedef QPair<MidiActivityView *, int> ViewLed;
+
+	// Instance variables.
+	QHash<QLabel *, Led> m_leds;
+	QHash<ViewLed, Led>  m_views;
+
+	QTimer  m_timer;
+
+	QPixmap m_ledOn;
+	QPixmap m_ledOff;
+
+	// The one and only clock instance.
+	static MidiActivityClock *g_pClock;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerMidiActivity_h
+
+
+// end of qsamplerMidiActivity.h
@@ -23,6 +23,7 @@
 #include "qsamplerAbout.h"
 #include "qsamplerOptions.h"
 #include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
 
 #include <QTextStream>
 #include <QComboBox>
@@ -50,6 +51,8 @@ namespace QSampler {
 Options::Options (void)
 	: m_settings(QSAMPLER_DOMAIN, QSAMPLER_TITLE)
 {
+	bSessionCheck = false;
+
 	loadOptions();
 }
 
@@ -90,6 +93,9 @@ void Options::loadOptions (void)
 	m_settings.beginGroup("/Logging");
 	bMessagesLog     = m_settings.value("/MessagesLog", false).toBool();
 	sMessagesLogPath = m_settings.value("/MessagesLogPath", "qsampler.log").toString();
+	bMetrics         = m_settings.value("/Metrics", false).toBool();
+	sMetricsPath     = m_settings.value("/MetricsPath", "qsampler.prom").toString();
+	iMetricsInterval = m_settings.value("/MetricsInterval", 15).toInt();
 	m_settings.endGroup();
 
 	// Load display options...
@@ -109,6 +115,7 @@ void Options::loadOptions (void)
 	bKeepOnTop       = m_settings.value("/KeepOnTop", true).toBool();
 	bStdoutCapture   = m_settings.value("/StdoutCapture", true).toBool();
 	bCompletePath    = m_settings.value("/CompletePath", true).toBool();
+	bSmartOpen       = m_settings.value("/SmartOpen", false).toBool();
 	iMaxRecentFiles  = m_settings.value("/MaxRecentFiles", 5).toInt();
 	iBaseFontSize    = m_settings.value("/BaseFontSize", 0).toInt();
 // if libgig provides a fast way to retrieve instrument names even for large
@@ -132,6 +139,7 @@ void Options::loadOptions (void)
 	bToolbar     = m_settings.value("/Toolbar", true).toBool();
 	bStatusbar   = m_settings.value("/Statusbar", true).toBool();
 	bAutoArrange = m_settings.value("/AutoArrange", true).toBool();
+	bChannelMixer = m_settings.value("/ChannelMixer", false).toBool();
 	m_settings.endGroup();
 
 	m_settings.endGroup(); // Options group.
@@ -151,6 +159,15 @@ void Options::loadOptions (void)
 	m_settings.beginGroup("/Tuning");
 	iMaxVoices  = m_settings.value("/MaxVoices",  -1).toInt();
 	iMaxStreams = m_settings.value("/MaxStreams",  -1).toInt();
+	bUnderrunAlert = m_settings.value("/UnderrunAlert", true).toBool();
+	iUnderrunLow   = m_settings.value("/UnderrunLow",  10).toInt();
+	iUnderrunHigh  = m_settings.value("/UnderrunHigh", 25).toInt();
+	iTuneMode       = m_settings.value("/TuneMode", 0).toInt();
+	iTuneFillTarget = m_settings.value("/TuneFillTarget", 30).toInt();
+	iTuneMinVoices  = m_settings.value("/TuneMinVoices",  32).toInt();
+	iTuneMaxVoices  = m_settings.value("/TuneMaxVoices",  256).toInt();
+	iTuneMinStreams = m_settings.value("/TuneMinStreams", 32).toInt();
+	iTuneMaxStreams = m_settings.value("/TuneMaxStreams", 256).toInt();
 	m_settings.endGroup();
 
 	// Last but not least, get the default directories.
@@ -194,6 +211,9 @@ void Options::saveOptions (void)
 	m_settings.beginGroup("/Logging");
 	m_settings.setValue("/MessagesLog", bMessagesLog);
 	m_settings.setValue("/MessagesLogPath", sMessagesLogPath);
+	m_settings.setValue("/Metrics", bMetrics);
+	m_settings.setValue("/MetricsPath", sMetricsPath);
+	m_settings.setValue("/MetricsInterval", iMetricsInterval);
 	m_settings.endGroup();
 
 	// Save display options.
@@ -213,6 +233,7 @@ void Options::saveOptions (void)
 	m_settings.setValue("/KeepOnTop", bKeepOnTop);
 	m_settings.setValue("/StdoutCapture", bStdoutCapture);
 	m_settings.setValue("/CompletePath", bCompletePath);
+	m_settings.setValue("/SmartOpen", bSmartOpen);
 	m_settings.setValue("/MaxRecentFiles", iMaxRecentFiles);
 	m_settings.setValue("/BaseFontSize", iBaseFontSize);
 	m_settings.setValue("/InstrumentNames", bInstrumentNames);
@@ -230,6 +251,7 @@ void Options::saveOptions (void)
 	m_settings.setValue("/Toolbar", bToolbar);
 	m_settings.setValue("/Statusbar", bStatusbar);
 	m_settings.setValue("/AutoArrange", bAutoArrange);
+	m_settings.setValue("/ChannelMixer", bChannelMixer);
 	m_settings.endGroup();
 
 	m_settings.endGroup(); // Options group.
@@ -248,6 +270,15 @@ void Options::saveOptions (void)
 		m_settings.setValue("/MaxVoices", iMaxVoices);
 	if (iMaxStreams >= 0)
 		m_settings.setValue("/MaxStreams", iMaxStreams);
+	m_settings.setValue("/UnderrunAlert", bUnderrunAlert);
+	m_settings.setValue("/UnderrunLow",  iUnderrunLow);
+	m_settings.setValue("/UnderrunHigh", iUnderrunHigh);
+	m_settings.setValue("/TuneMode", iTuneMode);
+	m_settings.setValue("/TuneFillTarget", iTuneFillTarget);
+	m_settings.setValue("/TuneMinVoices",  iTuneMinVoices);
+	m_settings.setValue("/TuneMaxVoices",  iTuneMaxVoices);
+	m_settings.setValue("/TuneMinStreams", iTuneMinStreams);
+	m_settings.setValue("/TuneMaxStreams", iTuneMaxStreams);
 	m_settings.endGroup();
 
 	// Default directories.
@@ -293,6 +324,10 @@ void Options::print_usage ( const QString& arg0 )
 		"  -s, --start\n\tStart linuxsampler server locally\n\n"
 		"  -h, --hostname\n\tSpecify linuxsampler server hostname (default = localhost)\n\n"
 		"  -p, --port\n\tSpecify linuxsampler server port number (default = 8888)\n\n"
+		"  -c, --check\n\tCheck the given session files offline, then exit\n\n"
+		"  -x, --convert\n\tConvert the session file into another (.lscp or .lss), then exit\n\n"
+		"  -r, --record\n\tRecord all LSCP traffic into this file (.lsr)\n\n"
+		"  -t, --trace\n\tWrite trace-event JSON into this file (Chrome/Perfetto)\n\n"
 		"  -?, --help\n\tShow help about command line options\n\n"
 		"  -v, --version\n\tShow version information\n\n")
 		.arg(arg0);
@@ -309,6 +344,11 @@ bool Options::parse_args ( const QStringList& args )
 
 	for (int i = 1; i < argc; ++i) {
 
+		if (bSessionCheck && iCmdArgs > 0) {
+			sessionCheckFiles.append(args.at(i));
+			continue;
+		}
+
 		if (iCmdArgs > 0) {
 			sSessionFile += " ";
 			sSessionFile += args.at(i);
@@ -332,6 +372,36 @@ bool Options::parse_args ( const QStringList& args )
 		if (sArg == "-s" || sArg == "--start") {
 			bServerStart = true;
 		}
+		else if (sArg == "-c" || sArg == "--check") {
+			bSessionCheck = true;
+		}
+		else if (sArg == "-x" || sArg == "--convert") {
+			if (sVal.isNull()) {
+				out << QObject::tr("Option -x requires an argument (file).") + sEol;
+				return false;
+			}
+			sSessionConvertFile = sVal;
+			if (iEqual < 0)
+				++i;
+		}
+		else if (sArg == "-r" || sArg == "--record") {
+			if (sVal.isNull()) {
+				out << QObject::tr("Option -r requires an argument (file).") + sEol;
+				return false;
+			}
+			sRecordFile = sVal;
+			if (iEqual < 0)
+				++i;
+		}
+		else if (sArg == "-t" || sArg == "--trace") {
+			if (sVal.isNull()) {
+				out << QObject::tr("Option -t requires an argument (file).") + sEol;
+				return false;
+			}
+			sTraceFile = sVal;
+			if (iEqual < 0)
+				++i;
+		}
 		else if (sArg == "-h" || sArg == "--hostname") {
 			if (sVal.isNull()) {
 				out << QObject::tr("Option -h requires an argument (host).") + sEol;
@@ -370,6 +440,11 @@ bool Options::parse_args ( const QStringList& args )
 				.arg(::lscp_client_version());
 			return false;
 		}
+		else if (bSessionCheck) {
+			// All the rest are files to check...
+			sessionCheckFiles.append(args.at(i));
+			++iCmdArgs;
+		}
 		else {
 			// If we don't have one by now,
 			// this will be the startup sesion file...
@@ -542,7 +617,7 @@ int Options::getEffectiveMaxVoices() {
 	if (!pMainForm || !pMainForm->client())
 		return -1;
 
-	return ::lscp_get_voices(pMainForm->client());
+	return QSAMPLER_LSCP(lscp_get_voices, pMainForm->client());
 #endif // CONFIG_MAX_VOICES
 }
 
@@ -555,7 +630,7 @@ void Options::setMaxVoices(int iMaxVoices) {
 		return;
 
 	lscp_status_t result =
-		::lscp_set_voices(pMainForm->client(), iMaxVoices);
+		QSAMPLER_LSCP(lscp_set_voices, pMainForm->client(), iMaxVoices);
 
 	if (result != LSCP_OK) {
 		pMainForm->appendMessagesClient("lscp_set_voices");
@@ -583,7 +658,7 @@ int Options::getEffectiveMaxStreams() {
 	if (!pMainForm || !pMainForm->client())
 		return -1;
 
-	return ::lscp_get_streams(pMainForm->client());
+	return QSAMPLER_LSCP(lscp_get_streams, pMainForm->client());
 #endif // CONFIG_MAX_VOICES
 }
 
@@ -596,7 +671,7 @@ void Options::setMaxStreams(int iMaxStreams) {
 		return;
 
 	lscp_status_t result =
-		::lscp_set_streams(pMainForm->client(), iMaxStreams);
+		QSAMPLER_LSCP(lscp_set_streams, pMainForm->client(), iMaxStreams);
 
 	if (result != LSCP_OK) {
 		pMainForm->appendMessagesClient("lscp_set_streams");
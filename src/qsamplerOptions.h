@@ -60,6 +60,20 @@ public:
 	// Startup supplied session file.
 	QString sSessionFile;
 
+	// Offline session files check (command line only).
+	bool        bSessionCheck;
+	QStringList sessionCheckFiles;
+
+	// Offline session file conversion (command line only),
+	// from the startup session file into this one.
+	QString sSessionConvertFile;
+
+	// LSCP traffic recording file (command line only).
+	QString sRecordFile;
+
+	// Trace-event output file (command line only).
+	QString sTraceFile;
+
 	// Server options...
 	QString sServerHost;
 	int     iServerPort;
@@ -71,6 +85,22 @@ public:
 	// Logging options...
 	bool    bMessagesLog;
 	QString sMessagesLogPath;
+	bool    bMetrics;
+	QString sMetricsPath;
+	int     iMetricsInterval;
+
+	// Stream buffer underrun detection options...
+	bool    bUnderrunAlert;
+	int     iUnderrunLow;
+	int     iUnderrunHigh;
+
+	// Voice/stream budget auto-tuning options...
+	int     iTuneMode;	// 0=Off, 1=Recommend, 2=Apply.
+	int     iTuneFillTarget;
+	int     iTuneMinVoices;
+	int     iTuneMaxVoices;
+	int     iTuneMinStreams;
+	int     iTuneMaxStreams;
 
 	// Display options...
 	QString sDisplayFont;
@@ -88,6 +118,7 @@ public:
 	bool    bKeepOnTop;
 	bool    bStdoutCapture;
 	bool    bCompletePath;
+	bool    bSmartOpen;
 	bool    bInstrumentNames;
 	int     iBaseFontSize;
 
@@ -99,6 +130,7 @@ public:
 	bool    bToolbar;
 	bool    bStatusbar;
 	bool    bAutoArrange;
+	bool    bChannelMixer;
 
 	// Default options...
 	QString sSessionDir;
@@ -90,6 +90,18 @@ OptionsForm::OptionsForm ( QWidget* pParent )
 	QObject::connect(m_ui.MessagesLogPathToolButton,
 		SIGNAL(clicked()),
 		SLOT(browseMessagesLogPath()));
+	QObject::connect(m_ui.MetricsCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.MetricsPathComboBox,
+		SIGNAL(editTextChanged(const QString&)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.MetricsIntervalSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.MetricsPathToolButton,
+		SIGNAL(clicked()),
+		SLOT(browseMetricsPath()));
 	QObject::connect(m_ui.DisplayFontPushButton,
 		SIGNAL(clicked()),
 		SLOT(chooseDisplayFont()));
@@ -138,6 +150,9 @@ OptionsForm::OptionsForm ( QWidget* pParent )
 	QObject::connect(m_ui.CompletePathCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(optionsChanged()));
+	QObject::connect(m_ui.SmartOpenCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(optionsChanged()));
 	QObject::connect(m_ui.InstrumentNamesCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(optionsChanged()));
@@ -153,6 +168,33 @@ OptionsForm::OptionsForm ( QWidget* pParent )
 	QObject::connect(m_ui.BaseFontSizeComboBox,
 		SIGNAL(editTextChanged(const QString&)),
 		SLOT(optionsChanged()));
+	QObject::connect(m_ui.UnderrunCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.UnderrunLowSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.UnderrunHighSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.TuneModeComboBox,
+		SIGNAL(activated(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.TuneFillTargetSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.TuneMinVoicesSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.TuneMaxVoicesSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.TuneMinStreamsSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(optionsChanged()));
+	QObject::connect(m_ui.TuneMaxStreamsSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(optionsChanged()));
 	QObject::connect(m_ui.MaxVoicesSpinBox,
 		SIGNAL(valueChanged(int)),
 		SLOT(maxVoicesChanged(int)));
@@ -187,6 +229,7 @@ void OptionsForm::setup ( Options *pOptions )
 	m_pOptions->loadComboBoxHistory(m_ui.ServerPortComboBox);
 	m_pOptions->loadComboBoxHistory(m_ui.ServerCmdLineComboBox);
 	m_pOptions->loadComboBoxHistory(m_ui.MessagesLogPathComboBox);
+	m_pOptions->loadComboBoxHistory(m_ui.MetricsPathComboBox);
 
 	// Load Server settings...
 	m_ui.ServerHostComboBox->setEditText(m_pOptions->sServerHost);
@@ -199,6 +242,9 @@ void OptionsForm::setup ( Options *pOptions )
 	// Logging options...
 	m_ui.MessagesLogCheckBox->setChecked(m_pOptions->bMessagesLog);
 	m_ui.MessagesLogPathComboBox->setEditText(m_pOptions->sMessagesLogPath);
+	m_ui.MetricsCheckBox->setChecked(m_pOptions->bMetrics);
+	m_ui.MetricsPathComboBox->setEditText(m_pOptions->sMetricsPath);
+	m_ui.MetricsIntervalSpinBox->setValue(m_pOptions->iMetricsInterval);
 
 	// Load Display options...
 	QFont font;
@@ -244,6 +290,7 @@ void OptionsForm::setup ( Options *pOptions )
 	m_ui.KeepOnTopCheckBox->setChecked(m_pOptions->bKeepOnTop);
 	m_ui.StdoutCaptureCheckBox->setChecked(m_pOptions->bStdoutCapture);
 	m_ui.CompletePathCheckBox->setChecked(m_pOptions->bCompletePath);
+	m_ui.SmartOpenCheckBox->setChecked(m_pOptions->bSmartOpen);
 	m_ui.InstrumentNamesCheckBox->setChecked(m_pOptions->bInstrumentNames);
 	m_ui.MaxRecentFilesSpinBox->setValue(m_pOptions->iMaxRecentFiles);
 	if (m_pOptions->iBaseFontSize > 0)
@@ -255,6 +302,19 @@ void OptionsForm::setup ( Options *pOptions )
 	m_ui.InstrumentNamesCheckBox->setEnabled(false);
 #endif
 
+	// Underrun detection options...
+	m_ui.UnderrunCheckBox->setChecked(m_pOptions->bUnderrunAlert);
+	m_ui.UnderrunLowSpinBox->setValue(m_pOptions->iUnderrunLow);
+	m_ui.UnderrunHighSpinBox->setValue(m_pOptions->iUnderrunHigh);
+
+	// Voice/stream budget auto-tuning options...
+	m_ui.TuneModeComboBox->setCurrentIndex(m_pOptions->iTuneMode);
+	m_ui.TuneFillTargetSpinBox->setValue(m_pOptions->iTuneFillTarget);
+	m_ui.TuneMinVoicesSpinBox->setValue(m_pOptions->iTuneMinVoices);
+	m_ui.TuneMaxVoicesSpinBox->setValue(m_pOptions->iTuneMaxVoices);
+	m_ui.TuneMinStreamsSpinBox->setValue(m_pOptions->iTuneMinStreams);
+	m_ui.TuneMaxStreamsSpinBox->setValue(m_pOptions->iTuneMaxStreams);
+
 	bMaxVoicesModified = bMaxStreamsModified = false;
 #ifdef CONFIG_MAX_VOICES
 	const bool bMaxVoicesSupported =
@@ -296,6 +356,7 @@ void OptionsForm::setup ( Options *pOptions )
 	m_ui.MaxStreamsSpinBox->setToolTip(
 		tr("QSampler was built without support for this parameter.")
 	);
+	m_ui.AutoTuningGroupBox->setEnabled(false);
 #endif // CONFIG_MAX_VOICES
 
 	// Custom display options...
@@ -323,12 +384,26 @@ void OptionsForm::accept (void)
 		// Logging options...
 		m_pOptions->bMessagesLog   = m_ui.MessagesLogCheckBox->isChecked();
 		m_pOptions->sMessagesLogPath = m_ui.MessagesLogPathComboBox->currentText();
+		m_pOptions->bMetrics       = m_ui.MetricsCheckBox->isChecked();
+		m_pOptions->sMetricsPath   = m_ui.MetricsPathComboBox->currentText();
+		m_pOptions->iMetricsInterval = m_ui.MetricsIntervalSpinBox->value();
 		// Channels options...
 		m_pOptions->sDisplayFont   = m_ui.DisplayFontTextLabel->font().toString();
 		m_pOptions->bDisplayEffect = m_ui.DisplayEffectCheckBox->isChecked();
 		m_pOptions->bAutoRefresh   = m_ui.AutoRefreshCheckBox->isChecked();
 		m_pOptions->iAutoRefreshTime = m_ui.AutoRefreshTimeSpinBox->value();
 		m_pOptions->iMaxVolume     = m_ui.MaxVolumeSpinBox->value();
+		// Underrun detection options...
+		m_pOptions->bUnderrunAlert = m_ui.UnderrunCheckBox->isChecked();
+		m_pOptions->iUnderrunLow   = m_ui.UnderrunLowSpinBox->value();
+		m_pOptions->iUnderrunHigh  = m_ui.UnderrunHighSpinBox->value();
+		// Voice/stream budget auto-tuning options...
+		m_pOptions->iTuneMode       = m_ui.TuneModeComboBox->currentIndex();
+		m_pOptions->iTuneFillTarget = m_ui.TuneFillTargetSpinBox->value();
+		m_pOptions->iTuneMinVoices  = m_ui.TuneMinVoicesSpinBox->value();
+		m_pOptions->iTuneMaxVoices  = m_ui.TuneMaxVoicesSpinBox->value();
+		m_pOptions->iTuneMinStreams = m_ui.TuneMinStreamsSpinBox->value();
+		m_pOptions->iTuneMaxStreams = m_ui.TuneMaxStreamsSpinBox->value();
 		// Messages options...
 		m_pOptions->sMessagesFont  = m_ui.MessagesFontTextLabel->font().toString();
 		m_pOptions->bMessagesLimit = m_ui.MessagesLimitCheckBox->isChecked();
@@ -341,6 +416,7 @@ void OptionsForm::accept (void)
 		m_pOptions->bKeepOnTop     = m_ui.KeepOnTopCheckBox->isChecked();
 		m_pOptions->bStdoutCapture = m_ui.StdoutCaptureCheckBox->isChecked();
 		m_pOptions->bCompletePath  = m_ui.CompletePathCheckBox->isChecked();
+		m_pOptions->bSmartOpen     = m_ui.SmartOpenCheckBox->isChecked();
 		m_pOptions->bInstrumentNames = m_ui.InstrumentNamesCheckBox->isChecked();
 		m_pOptions->iMaxRecentFiles  = m_ui.MaxRecentFilesSpinBox->value();
 		m_pOptions->iBaseFontSize  = m_ui.BaseFontSizeComboBox->currentText().toInt();
@@ -369,6 +445,7 @@ void OptionsForm::accept (void)
 	m_pOptions->saveComboBoxHistory(m_ui.ServerPortComboBox);
 	m_pOptions->saveComboBoxHistory(m_ui.ServerCmdLineComboBox);
 	m_pOptions->saveComboBoxHistory(m_ui.MessagesLogPathComboBox);
+	m_pOptions->saveComboBoxHistory(m_ui.MetricsPathComboBox);
 
 	// Save/commit to disk.
 	m_pOptions->saveOptions();
@@ -437,6 +514,43 @@ void OptionsForm::stabilizeForm (void)
 		bValid = !sPath.isEmpty();
 	}
 
+	bEnabled = m_ui.MetricsCheckBox->isChecked();
+	m_ui.MetricsPathComboBox->setEnabled(bEnabled);
+	m_ui.MetricsIntervalSpinBox->setEnabled(bEnabled);
+	m_ui.MetricsPathToolButton->setEnabled(bEnabled);
+	if (bEnabled && bValid) {
+		const QString& sPath = m_ui.MetricsPathComboBox->currentText();
+		bValid = !sPath.isEmpty();
+	}
+
+	bEnabled = m_ui.UnderrunCheckBox->isChecked();
+	m_ui.UnderrunLowTextLabel->setEnabled(bEnabled);
+	m_ui.UnderrunLowSpinBox->setEnabled(bEnabled);
+	m_ui.UnderrunHighTextLabel->setEnabled(bEnabled);
+	m_ui.UnderrunHighSpinBox->setEnabled(bEnabled);
+	if (bEnabled && bValid) {
+		bValid = (m_ui.UnderrunLowSpinBox->value()
+			< m_ui.UnderrunHighSpinBox->value());
+	}
+
+	bEnabled = (m_ui.TuneModeComboBox->currentIndex() > 0);
+	m_ui.TuneFillTargetTextLabel->setEnabled(bEnabled);
+	m_ui.TuneFillTargetSpinBox->setEnabled(bEnabled);
+	m_ui.TuneMinVoicesTextLabel->setEnabled(bEnabled);
+	m_ui.TuneMinVoicesSpinBox->setEnabled(bEnabled);
+	m_ui.TuneMaxVoicesTextLabel->setEnabled(bEnabled);
+	m_ui.TuneMaxVoicesSpinBox->setEnabled(bEnabled);
+	m_ui.TuneMinStreamsTextLabel->setEnabled(bEnabled);
+	m_ui.TuneMinStreamsSpinBox->setEnabled(bEnabled);
+	m_ui.TuneMaxStreamsTextLabel->setEnabled(bEnabled);
+	m_ui.TuneMaxStreamsSpinBox->setEnabled(bEnabled);
+	if (bEnabled && bValid) {
+		bValid = (m_ui.TuneMinVoicesSpinBox->value()
+				<= m_ui.TuneMaxVoicesSpinBox->value())
+			&& (m_ui.TuneMinStreamsSpinBox->value()
+				<= m_ui.TuneMaxStreamsSpinBox->value());
+	}
+
 	m_ui.AutoRefreshTimeSpinBox->setEnabled(
 		m_ui.AutoRefreshCheckBox->isChecked());
 	m_ui.MessagesLimitLinesSpinBox->setEnabled(
@@ -464,6 +578,24 @@ void OptionsForm::browseMessagesLogPath (void)
 }
 
 
+// Metrics textfile path browse slot.
+void OptionsForm::browseMetricsPath (void)
+{
+	QString sFileName = QFileDialog::getSaveFileName(
+		this,											// Parent.
+		tr("Metrics File"),				                // Caption.
+		m_ui.MetricsPathComboBox->currentText(),		// Start here.
+		tr("Prometheus textfiles") + " (*.prom)"	    // Filter (prom files)
+	);
+
+	if (!sFileName.isEmpty()) {
+		m_ui.MetricsPathComboBox->setEditText(sFileName);
+		m_ui.MetricsPathComboBox->setFocus();
+		optionsChanged();
+	}
+}
+
+
 // The channel display font selection dialog.
 void OptionsForm::chooseDisplayFont (void)
 {
@@ -53,6 +53,7 @@ protected slots:
 	void optionsChanged();
 
 	void browseMessagesLogPath();
+	void browseMetricsPath();
 	void chooseDisplayFont();
 	void chooseMessagesFont();
 	void toggleDisplayEffect(bool bOn);
@@ -0,0 +1,272 @@
+// qsamplerRecorder.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerRecorder.h"
+
+#include <QHostAddress>
+#include <QMutexLocker>
+
+
+namespace QSampler {
+
+// Give up connecting to the actual server after this long (msecs).
+#define QSAMPLER_RECORDER_TIMEOUT  10000
+
+
+//-------------------------------------------------------------------------
+// QSampler::RecorderProxy -- Recording LSCP proxy (recorder thread).
+//
+
+// Constructor.
+RecorderProxy::RecorderProxy ( Recorder *pRecorder, Recording *pRecording )
+	: QTcpServer(), m_pRecorder(pRecorder), m_pRecording(pRecording),
+		m_iConns(0)
+{
+	QObject::connect(this,
+		SIGNAL(newConnection()),
+		SLOT(newConnectionSlot()));
+}
+
+
+// Destructor.
+RecorderProxy::~RecorderProxy (void)
+{
+	// Whatever is still connected gets closed now...
+	QHash<QTcpSocket *, Link>::ConstIterator iter = m_links.constBegin();
+	for ( ; iter != m_links.constEnd(); ++iter) {
+		if (iter.value().bClient)
+			m_pRecording->append(iter.value().iConn, Recording::Close);
+	}
+
+	m_links.clear();
+}
+
+
+// Server slot: a new client connection, proxied to the actual server.
+void RecorderProxy::newConnectionSlot (void)
+{
+	while (hasPendingConnections()) {
+		QTcpSocket *pClient = nextPendingConnection();
+		QString sHost;
+		int iPort = 0;
+		m_pRecorder->server(sHost, iPort);
+		const int iConn = ++m_iConns;
+		m_pRecording->append(iConn, Recording::Open,
+			QString("%1:%2").arg(sHost).arg(iPort).toUtf8());
+		// We're on our own thread, so block here...
+		QTcpSocket *pServer = new QTcpSocket(this);
+		pServer->connectToHost(sHost, iPort);
+		if (!pServer->waitForConnected(QSAMPLER_RECORDER_TIMEOUT)) {
+			m_pRecording->append(iConn, Recording::Close);
+			delete pServer;
+			pClient->close();
+			pClient->deleteLater();
+			continue;
+		}
+		Link client_link;
+		client_link.iConn = iConn;
+		client_link.bClient = true;
+		client_link.pPeer = pServer;
+		m_links.insert(pClient, client_link);
+		Link server_link;
+		server_link.iConn = iConn;
+		server_link.bClient = false;
+		server_link.pPeer = pClient;
+		m_links.insert(pServer, server_link);
+		QObject::connect(pClient,
+			SIGNAL(readyRead()),
+			SLOT(readyReadSlot()));
+		QObject::connect(pClient,
+			SIGNAL(disconnected()),
+			SLOT(disconnectedSlot()));
+		QObject::connect(pServer,
+			SIGNAL(readyRead()),
+			SLOT(readyReadSlot()));
+		QObject::connect(pServer,
+			SIGNAL(disconnected()),
+			SLOT(disconnectedSlot()));
+		// The client may have spoken already...
+		forward(pClient);
+	}
+}
+
+
+// Socket slots.
+void RecorderProxy::readyReadSlot (void)
+{
+	forward(qobject_cast<QTcpSocket *> (sender()));
+}
+
+
+void RecorderProxy::disconnectedSlot (void)
+{
+	QTcpSocket *pSocket = qobject_cast<QTcpSocket *> (sender());
+	if (pSocket == nullptr || !m_links.contains(pSocket))
+		return;
+
+	// Last words, if any...
+	forward(pSocket);
+
+	const Link link = m_links.take(pSocket);
+	m_links.remove(link.pPeer);
+
+	m_pRecording->append(link.iConn, Recording::Close);
+
+	link.pPeer->disconnectFromHost();
+	link.pPeer->deleteLater();
+	pSocket->deleteLater();
+}
+
+
+// Forward whatever is pending on one side to the other.
+void RecorderProxy::forward ( QTcpSocket *pSocket )
+{
+	if (pSocket == nullptr || !m_links.contains(pSocket))
+		return;
+
+	const QByteArray& data = pSocket->readAll();
+	if (data.isEmpty())
+		return;
+
+	const Link& link = m_links.value(pSocket);
+	m_pRecording->append(link.iConn,
+		link.bClient ? Recording::Send : Recording::Recv, data);
+
+	link.pPeer->write(data);
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::Recorder -- LSCP traffic recorder (client side).
+//
+
+// Constructor.
+Recorder::Recorder ( const QString& sFilename )
+	: QThread(), m_sFilename(sFilename), m_iPort(0), m_iProxyPort(-1)
+{
+}
+
+
+// Destructor.
+Recorder::~Recorder (void)
+{
+	if (isRunning()) {
+		quit();
+		wait();
+	}
+}
+
+
+// Start recording; return the local proxy port (-1 on failure).
+int Recorder::startRecorder ( const QString& sHost, int iPort )
+{
+	if (isRunning())
+		return m_iProxyPort;
+
+	setServer(sHost, iPort);
+
+	start();
+
+	m_started.acquire();
+
+	return m_iProxyPort;
+}
+
+
+// Where to proxy new connections to.
+void Recorder::setServer ( const QString& sHost, int iPort )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_sHost = sHost;
+	m_iPort = iPort;
+}
+
+void Recorder::server ( QString& sHost, int& iPort ) const
+{
+	QMutexLocker locker(&m_mutex);
+
+	sHost = m_sHost;
+	iPort = m_iPort;
+}
+
+
+// Whether the actual server is there to proxy to at all.
+bool Recorder::checkServer ( int iTimeout ) const
+{
+	QString sHost;
+	int iPort = 0;
+	server(sHost, iPort);
+
+	QTcpSocket socket;
+	socket.connectToHost(sHost, iPort);
+	if (!socket.waitForConnected(iTimeout))
+		return false;
+
+	socket.disconnectFromHost();
+	return true;
+}
+
+
+// Local proxy port (-1 if not started).
+int Recorder::proxyPort (void) const
+{
+	return m_iProxyPort;
+}
+
+
+// Recording file name.
+const QString& Recorder::filename (void) const
+{
+	return m_sFilename;
+}
+
+
+// The recorder thread executive.
+void Recorder::run (void)
+{
+	QString sHost;
+	int iPort = 0;
+	server(sHost, iPort);
+
+	Recording recording;
+	if (!recording.create(m_sFilename, sHost, iPort)) {
+		m_started.release();
+		return;
+	}
+
+	RecorderProxy proxy(this, &recording);
+	if (!proxy.listen(QHostAddress::LocalHost, 0)) {
+		m_started.release();
+		return;
+	}
+
+	m_iProxyPort = proxy.serverPort();
+	m_started.release();
+
+	exec();
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerRecorder.cpp
@@ -0,0 +1,142 @@
+// qsamplerRecorder.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerRecorder_h
+#define __qsamplerRecorder_h
+
+#include "qsamplerRecording.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QSemaphore>
+#include <QMutex>
+#include <QHash>
+
+
+namespace QSampler {
+
+class Recorder;
+
+
+//-------------------------------------------------------------------------
+// QSampler::RecorderProxy -- Recording LSCP proxy (recorder thread).
+//
+
+class RecorderProxy : public QTcpServer
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	RecorderProxy(Recorder *pRecorder, Recording *pRecording);
+
+	// Destructor.
+	~RecorderProxy();
+
+protected slots:
+
+	// Server and socket slots.
+	void newConnectionSlot();
+	void readyReadSlot();
+	void disconnectedSlot();
+
+private:
+
+	// Forward whatever is pending on one side to the other.
+	void forward(QTcpSocket *pSocket);
+
+	// One side of a proxied connection.
+	struct Link
+	{
+		int         iConn;
+		bool        bClient;
+		QTcpSocket *pPeer;
+	};
+
+	// Instance variables.
+	Recorder  *m_pRecorder;
+	Recording *m_pRecording;
+
+	QHash<QTcpSocket *, Link> m_links;
+
+	int m_iConns;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::Recorder -- LSCP traffic recorder (client side).
+//
+
+class Recorder : public QThread
+{
+public:
+
+	// Constructor.
+	Recorder(const QString& sFilename);
+
+	// Destructor.
+	~Recorder();
+
+	// Start recording; return the local proxy port (-1 on failure).
+	int startRecorder(const QString& sHost, int iPort);
+
+	// Where to proxy new connections to.
+	void setServer(const QString& sHost, int iPort);
+	void server(QString& sHost, int& iPort) const;
+
+	// Whether the actual server is there to proxy to at all
+	// (the local proxy would accept connections anyway).
+	bool checkServer(int iTimeout) const;
+
+	// Local proxy port (-1 if not started).
+	int proxyPort() const;
+
+	// Recording file name.
+	const QString& filename() const;
+
+protected:
+
+	// The recorder thread executive.
+	void run();
+
+private:
+
+	// Instance variables.
+	QString m_sFilename;
+
+	QString m_sHost;
+	int     m_iPort;
+
+	mutable QMutex m_mutex;
+
+	QSemaphore m_started;
+	int m_iProxyPort;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerRecorder_h
+
+
+// end of qsamplerRecorder.h
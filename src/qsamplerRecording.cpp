@@ -0,0 +1,233 @@
+// qsamplerRecording.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerRecording.h"
+
+#include <cstring>
+
+
+namespace QSampler {
+
+// Recording file magic and version.
+#define QSAMPLER_RECORDING_MAGIC    "QSLR"
+#define QSAMPLER_RECORDING_VERSION  1
+
+
+//-------------------------------------------------------------------------
+// QSampler::Recording -- LSCP traffic recording file (*.lsr).
+//
+// Layout (QDataStream, Qt 5.0, big-endian):
+//
+//   magic "QSLR", quint16 version, QString host, quint16 port,
+//   qint64 start time (msecs since epoch),
+//
+// then as many records as there are, each one:
+//
+//   quint32 time delta since the previous record (usecs),
+//   quint16 connection number, quint8 type, QByteArray data.
+//
+
+// Constructor.
+Recording::Recording (void) : m_iPort(0), m_iLastTime(0)
+{
+}
+
+
+// Destructor.
+Recording::~Recording (void)
+{
+	close();
+}
+
+
+// Writer: start a new recording file.
+bool Recording::create ( const QString& sFilename,
+	const QString& sHost, int iPort )
+{
+	close();
+
+	m_file.setFileName(sFilename);
+	if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	m_sHost = sHost;
+	m_iPort = iPort;
+	m_startTime = QDateTime::currentDateTime();
+	m_records.clear();
+
+	m_stream.setDevice(&m_file);
+	m_stream.setVersion(QDataStream::Qt_5_0);
+	m_stream.writeRawData(QSAMPLER_RECORDING_MAGIC, 4);
+	m_stream << quint16(QSAMPLER_RECORDING_VERSION);
+	m_stream << m_sHost << quint16(m_iPort);
+	m_stream << qint64(m_startTime.toMSecsSinceEpoch());
+	m_file.flush();
+
+	m_timer.start();
+	m_iLastTime = 0;
+
+	return true;
+}
+
+
+// Writer: append a record, time-stamped now (flushed right away).
+void Recording::append ( int iConn, Type type, const QByteArray& data )
+{
+	if (!m_file.isOpen())
+		return;
+
+	const qint64 iTime = m_timer.nsecsElapsed() / 1000;
+	qint64 iDelta = iTime - m_iLastTime;
+	if (iDelta > 0xffffffffLL)
+		iDelta = 0xffffffffLL;
+	m_iLastTime += iDelta;
+
+	m_stream << quint32(iDelta) << quint16(iConn) << quint8(type) << data;
+
+	// Make it survive whatever comes next...
+	m_file.flush();
+}
+
+
+// Writer: done.
+void Recording::close (void)
+{
+	if (m_file.isOpen()) {
+		m_stream.setDevice(nullptr);
+		m_file.close();
+	}
+}
+
+
+bool Recording::isRecording (void) const
+{
+	return m_file.isOpen();
+}
+
+
+// Reader: load a whole recording file.
+bool Recording::load ( const QString& sFilename )
+{
+	close();
+
+	QFile file(sFilename);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	char magic[4];
+	if (stream.readRawData(magic, 4) != 4
+		|| ::memcmp(magic, QSAMPLER_RECORDING_MAGIC, 4) != 0)
+		return false;
+
+	quint16 iVersion = 0;
+	stream >> iVersion;
+	if (iVersion != QSAMPLER_RECORDING_VERSION)
+		return false;
+
+	quint16 iPort = 0;
+	qint64 iStartTime = 0;
+	stream >> m_sHost >> iPort >> iStartTime;
+	if (stream.status() != QDataStream::Ok)
+		return false;
+
+	m_iPort = iPort;
+	m_startTime = QDateTime::fromMSecsSinceEpoch(iStartTime);
+	m_records.clear();
+
+	// A recording cut short (eg. crashed) is still good,
+	// up to its last whole record...
+	qint64 iTime = 0;
+	while (!stream.atEnd()) {
+		quint32 iDelta = 0;
+		quint16 iConn = 0;
+		quint8 iType = 0;
+		QByteArray data;
+		stream >> iDelta >> iConn >> iType >> data;
+		if (stream.status() != QDataStream::Ok || iType > Recv)
+			break;
+		iTime += iDelta;
+		Record record;
+		record.iTime = iTime;
+		record.iConn = iConn;
+		record.type  = Type(iType);
+		record.data  = data;
+		m_records.append(record);
+	}
+
+	return true;
+}
+
+
+// Recording properties.
+const QString& Recording::host (void) const
+{
+	return m_sHost;
+}
+
+int Recording::port (void) const
+{
+	return m_iPort;
+}
+
+const QDateTime& Recording::startTime (void) const
+{
+	return m_startTime;
+}
+
+const QList<Recording::Record>& Recording::records (void) const
+{
+	return m_records;
+}
+
+
+// Number of connections and total bytes, either way.
+int Recording::connections (void) const
+{
+	int iConnections = 0;
+	QListIterator<Record> iter(m_records);
+	while (iter.hasNext()) {
+		if (iter.next().type == Open)
+			++iConnections;
+	}
+
+	return iConnections;
+}
+
+qint64 Recording::bytes ( Type type ) const
+{
+	qint64 iBytes = 0;
+	QListIterator<Record> iter(m_records);
+	while (iter.hasNext()) {
+		const Record& record = iter.next();
+		if (record.type == type)
+			iBytes += record.data.size();
+	}
+
+	return iBytes;
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerRecording.cpp
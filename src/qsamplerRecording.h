@@ -0,0 +1,106 @@
+// qsamplerRecording.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerRecording_h
+#define __qsamplerRecording_h
+
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QList>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::Recording -- LSCP traffic recording file (*.lsr).
+//
+
+class Recording
+{
+public:
+
+	// Record types.
+	enum Type { Open = 0, Close = 1, Send = 2, Recv = 3 };
+
+	// One single traffic record.
+	struct Record
+	{
+		qint64     iTime;  // Since start (usecs).
+		int        iConn;  // Connection number (1-based).
+		Type       type;   // Open, Close, Send (to server), Recv (from server).
+		QByteArray data;   // Raw bytes (peer address on Open).
+	};
+
+	// Constructor.
+	Recording();
+
+	// Destructor.
+	~Recording();
+
+	// Writer: start a new recording file.
+	bool create(const QString& sFilename, const QString& sHost, int iPort);
+
+	// Writer: append a record, time-stamped now (flushed right away).
+	void append(int iConn, Type type, const QByteArray& data = QByteArray());
+
+	// Writer: done.
+	void close();
+
+	bool isRecording() const;
+
+	// Reader: load a whole recording file.
+	bool load(const QString& sFilename);
+
+	// Recording properties.
+	const QString& host() const;
+	int port() const;
+	const QDateTime& startTime() const;
+
+	const QList<Record>& records() const;
+
+	// Number of connections and total bytes, either way.
+	int connections() const;
+	qint64 bytes(Type type) const;
+
+private:
+
+	// Instance variables.
+	QString   m_sHost;
+	int       m_iPort;
+	QDateTime m_startTime;
+
+	QList<Record> m_records;
+
+	QFile         m_file;
+	QDataStream   m_stream;
+	QElapsedTimer m_timer;
+	qint64        m_iLastTime;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerRecording_h
+
+
+// end of qsamplerRecording.h
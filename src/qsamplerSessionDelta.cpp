@@ -0,0 +1,639 @@
+// qsamplerSessionDelta.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerSessionDelta.h"
+
+#include "qsamplerMainForm.h"
+#include "qsamplerChannel.h"
+#include "qsamplerVolumeSender.h"
+#include "qsamplerDevice.h"
+#include "qsamplerFxSend.h"
+#include "qsamplerLscpStats.h"
+
+#include <QVector>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::SessionDelta -- Incremental session switcher (no RESET).
+//
+
+// Constructor.
+SessionDelta::SessionDelta ( const SessionSnapshot& session )
+	: m_session(session),
+		m_iKeptChannels(0), m_iChangedChannels(0),
+		m_iAddedChannels(0), m_iRemovedChannels(0),
+		m_iChanges(0), m_iErrors(0)
+{
+}
+
+
+// Bring the live session in line with the target one,
+// only changing what's different (main thread).
+bool SessionDelta::apply (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+
+	lscp_client_t *pClient = pMainForm->client();
+	if (pClient == nullptr)
+		return false;
+
+	// What we've got right now...
+	SessionSnapshot live;
+	if (!live.take(QString()))
+		return false;
+
+	m_audioDeviceMap.clear();
+	m_midiDeviceMap.clear();
+	m_midiMapMap.clear();
+	m_channelMap.clear();
+
+	// Devices and maps first, as channels refer to them...
+	applyDevices(Device::Audio,
+		m_session.audioDevices(), live.audioDevices(), m_audioDeviceMap);
+	applyDevices(Device::Midi,
+		m_session.midiDevices(), live.midiDevices(), m_midiDeviceMap);
+	applyInstrumentMaps(live.instrumentMaps());
+
+	// Sampler channels, keeping whatever's already loaded...
+	applyChannels(live.channels());
+
+	// Only now it's safe to get rid of the leftovers...
+	removeDevices(Device::Audio, live.audioDevices(), m_audioDeviceMap);
+	removeDevices(Device::Midi, live.midiDevices(), m_midiDeviceMap);
+	removeInstrumentMaps(live.instrumentMaps());
+
+	applyChannelGroups();
+
+#ifdef CONFIG_VOLUME
+	if (qAbs(m_session.volume() - live.volume()) > 0.0001f) {
+		pMainForm->volumeSender()->setVolume(
+			VolumeSender::GlobalVolume, m_session.volume());
+		++m_iChanges;
+	}
+#endif
+
+	// Make sure all volume changes are through...
+	pMainForm->volumeSender()->flush();
+
+	return (m_iErrors == 0);
+}
+
+
+// Audio/MIDI devices delta executive.
+void SessionDelta::applyDevices ( int iDeviceType,
+	const QList<DeviceItem>& devices, const QList<DeviceItem>& live,
+	QMap<int, int>& deviceMap )
+{
+	QList<int> used;
+
+	QListIterator<DeviceItem> iter(devices);
+	while (iter.hasNext()) {
+		const DeviceItem& device = iter.next();
+		// Look for an unused one that's just the same...
+		const DeviceItem *pLive = nullptr;
+		QListIterator<DeviceItem> live_iter(live);
+		while (live_iter.hasNext()) {
+			const DeviceItem& live_device = live_iter.next();
+			if (!used.contains(live_device.iDeviceID)
+				&& isSameDevice(device, live_device)) {
+				pLive = &live_device;
+				break;
+			}
+		}
+		int iDeviceID = -1;
+		if (pLive) {
+			iDeviceID = pLive->iDeviceID;
+			used.append(iDeviceID);
+		} else {
+			// Otherwise create a brand new one...
+			Device newDevice(Device::DeviceType(iDeviceType));
+			newDevice.setDriver(device.sDriverName);
+			QListIterator<ParamItem> param_iter(device.params);
+			while (param_iter.hasNext()) {
+				const ParamItem& param = param_iter.next();
+				if (!param.sValue.isEmpty())
+					newDevice.setParam(param.sKey, param.sValue);
+			}
+			if (!newDevice.createDevice()) {
+				++m_iErrors;
+				continue;
+			}
+			iDeviceID = newDevice.deviceID();
+			++m_iChanges;
+		}
+		applyPorts(iDeviceType, iDeviceID, device, pLive);
+		deviceMap.insert(device.iDeviceID, iDeviceID);
+	}
+}
+
+
+// Audio channel/MIDI port parameters delta executive.
+void SessionDelta::applyPorts ( int iDeviceType, int iDeviceID,
+	const DeviceItem& device, const DeviceItem *pLive )
+{
+	Device *pDevice = nullptr;
+
+	for (int iPort = 0; iPort < device.ports.count(); ++iPort) {
+		QListIterator<ParamItem> iter(device.ports.at(iPort));
+		while (iter.hasNext()) {
+			const ParamItem& param = iter.next();
+			if (param.bFix || param.sValue.isEmpty())
+				continue;
+			// Skip the ones that are already there...
+			if (pLive && iPort < pLive->ports.count()) {
+				bool bSame = false;
+				QListIterator<ParamItem> live_iter(pLive->ports.at(iPort));
+				while (live_iter.hasNext() && !bSame) {
+					const ParamItem& live_param = live_iter.next();
+					bSame = (live_param.sKey == param.sKey
+						&& live_param.sValue == param.sValue);
+				}
+				if (bSame)
+					continue;
+			}
+			// Lazy device (and ports) query...
+			if (pDevice == nullptr)
+				pDevice = new Device(Device::DeviceType(iDeviceType), iDeviceID);
+			if (iPort < pDevice->ports().count()) {
+				pDevice->ports().at(iPort)->setParam(param.sKey, param.sValue);
+				++m_iChanges;
+			}
+			else ++m_iErrors;
+		}
+	}
+
+	if (pDevice)
+		delete pDevice;
+}
+
+
+// MIDI instrument maps delta executive.
+void SessionDelta::applyInstrumentMaps ( const QList<MapItem>& live )
+{
+#ifdef CONFIG_MIDI_INSTRUMENT
+	MainForm *pMainForm = MainForm::getInstance();
+	lscp_client_t *pClient = pMainForm->client();
+
+	QList<int> used;
+
+	QListIterator<MapItem> iter(m_session.instrumentMaps());
+	while (iter.hasNext()) {
+		const MapItem& map = iter.next();
+		// Look for an unused one by the same name...
+		const MapItem *pLive = nullptr;
+		QListIterator<MapItem> live_iter(live);
+		while (live_iter.hasNext()) {
+			const MapItem& live_map = live_iter.next();
+			if (!used.contains(live_map.iMidiMap)
+				&& live_map.sName == map.sName) {
+				pLive = &live_map;
+				break;
+			}
+		}
+		// Current map entries, by bank and program...
+		QMap<int, InstrumentItem> instrs;
+		int iMidiMap = -1;
+		if (pLive) {
+			iMidiMap = pLive->iMidiMap;
+			used.append(iMidiMap);
+			QListIterator<InstrumentItem> instr_iter(pLive->instruments);
+			while (instr_iter.hasNext()) {
+				const InstrumentItem& instr = instr_iter.next();
+				instrs.insert((instr.iBank << 7) | instr.iProg, instr);
+			}
+		} else {
+			iMidiMap = QSAMPLER_LSCP(lscp_add_midi_instrument_map, pClient,
+				map.sName.toUtf8().constData());
+			if (iMidiMap < 0) {
+				pMainForm->appendMessagesClient("lscp_add_midi_instrument_map");
+				++m_iErrors;
+				continue;
+			}
+			++m_iChanges;
+		}
+		m_midiMapMap.insert(map.iMidiMap, iMidiMap);
+		// Map whatever's new or different...
+		QListIterator<InstrumentItem> instr_iter(map.instruments);
+		while (instr_iter.hasNext()) {
+			const InstrumentItem& instr = instr_iter.next();
+			const int iKey = (instr.iBank << 7) | instr.iProg;
+			if (instrs.contains(iKey)) {
+				const bool bSame = isSameInstrument(instr, instrs.value(iKey));
+				instrs.remove(iKey);
+				if (bSame)
+					continue;
+			}
+			// Instrument file goes verbatim, as if read from the script.
+			lscp_midi_instrument_t midi_instr;
+			midi_instr.map  = iMidiMap;
+			midi_instr.bank = instr.iBank;
+			midi_instr.prog = instr.iProg;
+			if (QSAMPLER_LSCP(lscp_map_midi_instrument, pClient, &midi_instr,
+					instr.sEngineName.toUtf8().constData(),
+					instr.sInstrumentFile.toUtf8().constData(),
+					instr.iInstrumentNr, instr.fVolume,
+					lscp_load_mode_t(instr.iLoadMode),
+					instr.sName.toUtf8().constData()) != LSCP_OK) {
+				pMainForm->appendMessagesClient("lscp_map_midi_instrument");
+				++m_iErrors;
+			}
+			else ++m_iChanges;
+		}
+		// Unmap whatever's left over...
+		QMapIterator<int, InstrumentItem> left_iter(instrs);
+		while (left_iter.hasNext()) {
+			const InstrumentItem& instr = left_iter.next().value();
+			lscp_midi_instrument_t midi_instr;
+			midi_instr.map  = iMidiMap;
+			midi_instr.bank = instr.iBank;
+			midi_instr.prog = instr.iProg;
+			if (QSAMPLER_LSCP(lscp_unmap_midi_instrument, pClient, &midi_instr) != LSCP_OK) {
+				pMainForm->appendMessagesClient("lscp_unmap_midi_instrument");
+				++m_iErrors;
+			}
+			else ++m_iChanges;
+		}
+	}
+#endif	// CONFIG_MIDI_INSTRUMENT
+}
+
+
+// Sampler channels delta executive.
+void SessionDelta::applyChannels ( const QList<ChannelItem>& live )
+{
+	MainForm *pMainForm = MainForm::getInstance();
+
+	const QList<ChannelItem>& channels = m_session.channels();
+	const int iChannels = channels.count();
+
+	// Pair each target channel with a live one, if any;
+	// first the ones with the very same instrument...
+	QList<int> used;
+	QVector<const ChannelItem *> pairs(iChannels, nullptr);
+	for (int i = 0; i < iChannels; ++i) {
+		const ChannelItem& channel = channels.at(i);
+		if (channel.sInstrumentFile.isEmpty())
+			continue;
+		QListIterator<ChannelItem> live_iter(live);
+		while (live_iter.hasNext()) {
+			const ChannelItem& live_channel = live_iter.next();
+			if (!used.contains(live_channel.iChannelID)
+				&& live_channel.iInstrumentStatus >= 0
+				&& live_channel.sEngineName.toUpper()
+					== channel.sEngineName.toUpper()
+				&& isSameInstrumentFile(
+					live_channel.sInstrumentFile, channel.sInstrumentFile)
+				&& live_channel.iInstrumentNr == channel.iInstrumentNr) {
+				used.append(live_channel.iChannelID);
+				pairs[i] = &live_channel;
+				break;
+			}
+		}
+	}
+
+	// ...then whatever's left, in order.
+	QListIterator<ChannelItem> left_iter(live);
+	for (int i = 0; i < iChannels; ++i) {
+		if (pairs.at(i))
+			continue;
+		while (left_iter.hasNext()) {
+			const ChannelItem& live_channel = left_iter.next();
+			if (!used.contains(live_channel.iChannelID)) {
+				used.append(live_channel.iChannelID);
+				pairs[i] = &live_channel;
+				break;
+			}
+		}
+	}
+
+	// Remove the live ones that don't fit in anymore...
+	QListIterator<ChannelItem> live_iter(live);
+	while (live_iter.hasNext()) {
+		const ChannelItem& live_channel = live_iter.next();
+		if (used.contains(live_channel.iChannelID))
+			continue;
+		Channel *pChannel = pMainForm->channel(live_channel.iChannelID);
+		if (pChannel == nullptr)
+			continue;
+		if (pChannel->removeChannel()) {
+			pMainForm->destroyChannel(pChannel);
+			++m_iRemovedChannels;
+		}
+		else ++m_iErrors;
+	}
+
+	// Set up each one, only for what's really different...
+	for (int i = 0; i < iChannels; ++i) {
+		const ChannelItem& channel = channels.at(i);
+		const ChannelItem *pLive = pairs.at(i);
+		ChannelSetup setup;
+		if (channel.iAudioDevice >= 0
+			&& m_audioDeviceMap.contains(channel.iAudioDevice)) {
+			setup.iAudioDevice = m_audioDeviceMap.value(channel.iAudioDevice);
+			setup.audioRouting = channel.audioRouting;
+		}
+		else setup.sAudioDriver = channel.sAudioDriver;
+		if (channel.iMidiDevice >= 0
+			&& m_midiDeviceMap.contains(channel.iMidiDevice))
+			setup.iMidiDevice = m_midiDeviceMap.value(channel.iMidiDevice);
+		else
+			setup.sMidiDriver = channel.sMidiDriver;
+		setup.iMidiPort = channel.iMidiPort;
+		setup.iMidiChannel = channel.iMidiChannel;
+		setup.sEngineName = channel.sEngineName;
+		// Commented out instruments weren't loaded in the first place...
+		if (channel.iInstrumentStatus >= 100) {
+			setup.sInstrumentFile
+				= SessionSnapshot::instrumentPath(channel.sInstrumentFile);
+			setup.iInstrumentNr = channel.iInstrumentNr;
+		}
+		setup.iMidiMap = (channel.iMidiMap >= 0
+			? m_midiMapMap.value(channel.iMidiMap, -1) : channel.iMidiMap);
+		// Existing or brand new channel?
+		Channel *pChannel = nullptr;
+		if (pLive)
+			pChannel = pMainForm->channel(pLive->iChannelID);
+		if (pChannel) {
+			const bool bKept = (pLive->iInstrumentStatus >= 0
+				&& SessionSnapshot::instrumentPath(pLive->sInstrumentFile)
+					== setup.sInstrumentFile
+				&& pLive->iInstrumentNr == setup.iInstrumentNr);
+			if (!pChannel->applySetup(setup)) {
+				++m_iErrors;
+				continue;
+			}
+			if (bKept)
+				++m_iKeptChannels;
+			else
+				++m_iChangedChannels;
+		} else {
+			pChannel = new Channel();
+			if (!pChannel->applySetup(setup)) {
+				delete pChannel;
+				++m_iErrors;
+				continue;
+			}
+			if (!pMainForm->createChannel(pChannel)) {
+				delete pChannel;
+				++m_iErrors;
+				continue;
+			}
+			++m_iAddedChannels;
+			pLive = nullptr;
+		}
+		const int iChannelID = pChannel->channelID();
+		if (pLive == nullptr || qAbs(pLive->fVolume - channel.fVolume) > 0.0001f)
+			pChannel->setVolume(channel.fVolume);
+	#ifdef CONFIG_MUTE_SOLO
+		if (pLive == nullptr || pLive->bMute != channel.bMute)
+			pChannel->setChannelMute(channel.bMute);
+		if (pLive == nullptr || pLive->bSolo != channel.bSolo)
+			pChannel->setChannelSolo(channel.bSolo);
+	#endif
+		applyFxSends(iChannelID, channel, pLive);
+		m_channelMap.insert(channel.iChannelID, iChannelID);
+	}
+
+	// One single GUI update for them all...
+	pMainForm->updateChannelStrips(m_channelMap.values());
+}
+
+
+// Channel effect sends delta executive.
+void SessionDelta::applyFxSends ( int iChannelID,
+	const ChannelItem& channel, const ChannelItem *pLive )
+{
+#ifdef CONFIG_FXSEND
+	// Anything different at all?
+	if (pLive && pLive->fxsends.count() == channel.fxsends.count()) {
+		bool bSame = true;
+		for (int i = 0; bSame && i < channel.fxsends.count(); ++i)
+			bSame = isSameFxSend(channel.fxsends.at(i), pLive->fxsends.at(i));
+		if (bSame)
+			return;
+	}
+
+	// Out with the old...
+	if (pLive) {
+		QListIterator<int> iter(FxSend::allFxSendsOfSamplerChannel(iChannelID));
+		while (iter.hasNext()) {
+			FxSend fxsend(iChannelID, iter.next());
+			fxsend.setDeletion(true);
+			if (!fxsend.applyToSampler())
+				++m_iErrors;
+		}
+	}
+
+	// ...in with the new.
+	QListIterator<FxSendItem> iter(channel.fxsends);
+	while (iter.hasNext()) {
+		const FxSendItem& item = iter.next();
+		FxSend fxsend(iChannelID);
+		fxsend.setName(item.sName);
+		fxsend.setSendDepthMidiCtrl(item.iMidiController);
+		fxsend.setCurrentDepth(item.fLevel);
+		for (int iAudioSrc = 0; iAudioSrc < item.routing.count(); ++iAudioSrc)
+			fxsend.setAudioChannel(iAudioSrc, item.routing.at(iAudioSrc));
+		if (fxsend.applyToSampler())
+			++m_iChanges;
+		else
+			++m_iErrors;
+	}
+#endif	// CONFIG_FXSEND
+}
+
+
+// Channel groups, with channel ids as they are now.
+void SessionDelta::applyChannelGroups (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+
+	qDeleteAll(pMainForm->m_channelGroups);
+	pMainForm->m_channelGroups.clear();
+
+	QListIterator<ChannelGroup> iter(m_session.channelGroups());
+	while (iter.hasNext()) {
+		const ChannelGroup& group = iter.next();
+		ChannelGroup *pChannelGroup = new ChannelGroup(group.name());
+		QListIterator<int> id_iter(group.channelIDs());
+		while (id_iter.hasNext()) {
+			const int iChannelID = id_iter.next();
+			if (m_channelMap.contains(iChannelID))
+				pChannelGroup->addChannel(m_channelMap.value(iChannelID));
+		}
+		pMainForm->m_channelGroups.append(pChannelGroup);
+	}
+}
+
+
+// Leftover devices removal.
+void SessionDelta::removeDevices ( int iDeviceType,
+	const QList<DeviceItem>& live, const QMap<int, int>& deviceMap )
+{
+	const QList<int>& deviceIDs = deviceMap.values();
+
+	QListIterator<DeviceItem> iter(live);
+	while (iter.hasNext()) {
+		const DeviceItem& device = iter.next();
+		if (deviceIDs.contains(device.iDeviceID))
+			continue;
+		Device oldDevice(Device::DeviceType(iDeviceType), device.iDeviceID);
+		if (oldDevice.deleteDevice())
+			++m_iChanges;
+		else
+			++m_iErrors;
+	}
+}
+
+
+// Leftover MIDI instrument maps removal.
+void SessionDelta::removeInstrumentMaps ( const QList<MapItem>& live )
+{
+#ifdef CONFIG_MIDI_INSTRUMENT
+	MainForm *pMainForm = MainForm::getInstance();
+	const QList<int>& midiMaps = m_midiMapMap.values();
+
+	QListIterator<MapItem> iter(live);
+	while (iter.hasNext()) {
+		const MapItem& map = iter.next();
+		if (midiMaps.contains(map.iMidiMap))
+			continue;
+		if (QSAMPLER_LSCP(lscp_remove_midi_instrument_map,
+				pMainForm->client(), map.iMidiMap) != LSCP_OK) {
+			pMainForm->appendMessagesClient("lscp_remove_midi_instrument_map");
+			++m_iErrors;
+		}
+		else ++m_iChanges;
+	}
+#endif
+}
+
+
+// Whether a live device is just as the session wants it.
+bool SessionDelta::isSameDevice (
+	const DeviceItem& device, const DeviceItem& live )
+{
+	if (device.sDriverName.toUpper() != live.sDriverName.toUpper())
+		return false;
+
+	QListIterator<ParamItem> iter(device.params);
+	while (iter.hasNext()) {
+		const ParamItem& param = iter.next();
+		if (param.sValue.isEmpty())
+			continue;
+		bool bSame = false;
+		QListIterator<ParamItem> live_iter(live.params);
+		while (live_iter.hasNext() && !bSame) {
+			const ParamItem& live_param = live_iter.next();
+			bSame = (live_param.sKey == param.sKey
+				&& live_param.sValue == param.sValue);
+		}
+		if (!bSame)
+			return false;
+	}
+
+	return true;
+}
+
+
+// Whether two (LSCP escaped) instrument file paths are just the same.
+bool SessionDelta::isSameInstrumentFile (
+	const QString& sInstrumentFile, const QString& sLiveInstrumentFile )
+{
+	// Either may be escaped differently, only compare them decoded...
+	return (sInstrumentFile == sLiveInstrumentFile
+		|| SessionSnapshot::instrumentPath(sInstrumentFile)
+			== SessionSnapshot::instrumentPath(sLiveInstrumentFile));
+}
+
+
+// Whether a live MIDI instrument map entry is just the same.
+bool SessionDelta::isSameInstrument (
+	const InstrumentItem& instr, const InstrumentItem& live )
+{
+	// Default load mode is the same as on-demand...
+	const int iLoadMode = (instr.iLoadMode == LSCP_LOAD_DEFAULT
+		? int(LSCP_LOAD_ON_DEMAND) : instr.iLoadMode);
+	const int iLiveLoadMode = (live.iLoadMode == LSCP_LOAD_DEFAULT
+		? int(LSCP_LOAD_ON_DEMAND) : live.iLoadMode);
+
+	return (instr.sEngineName.toUpper() == live.sEngineName.toUpper()
+		&& isSameInstrumentFile(instr.sInstrumentFile, live.sInstrumentFile)
+		&& instr.iInstrumentNr == live.iInstrumentNr
+		&& qAbs(instr.fVolume - live.fVolume) < 0.0001f
+		&& iLoadMode == iLiveLoadMode
+		&& instr.sName == live.sName);
+}
+
+
+// Whether a live channel effect send is just the same.
+bool SessionDelta::isSameFxSend (
+	const FxSendItem& fxsend, const FxSendItem& live )
+{
+	return (fxsend.iMidiController == live.iMidiController
+		&& fxsend.sName == live.sName
+		&& fxsend.routing == live.routing
+		&& qAbs(fxsend.fLevel - live.fLevel) < 0.0001f);
+}
+
+
+// Sampler channel statistics.
+int SessionDelta::keptChannels (void) const
+{
+	return m_iKeptChannels;
+}
+
+int SessionDelta::changedChannels (void) const
+{
+	return m_iChangedChannels;
+}
+
+int SessionDelta::addedChannels (void) const
+{
+	return m_iAddedChannels;
+}
+
+int SessionDelta::removedChannels (void) const
+{
+	return m_iRemovedChannels;
+}
+
+
+// Accessors.
+int SessionDelta::changes (void) const
+{
+	return m_iChanges;
+}
+
+int SessionDelta::errors (void) const
+{
+	return m_iErrors;
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerSessionDelta.cpp
@@ -0,0 +1,114 @@
+// qsamplerSessionDelta.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerSessionDelta_h
+#define __qsamplerSessionDelta_h
+
+#include "qsamplerSessionSnapshot.h"
+
+#include <QMap>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::SessionDelta -- Incremental session switcher (no RESET).
+//
+
+class SessionDelta
+{
+public:
+
+	// Constructor.
+	SessionDelta(const SessionSnapshot& session);
+
+	// Bring the live session in line with the target one,
+	// only changing what's different (main thread).
+	bool apply();
+
+	// Sampler channel statistics.
+	int keptChannels() const;
+	int changedChannels() const;
+	int addedChannels() const;
+	int removedChannels() const;
+
+	// Accessors.
+	int changes() const;
+	int errors() const;
+
+private:
+
+	// Type shortcuts.
+	typedef SessionSnapshot::ParamItem      ParamItem;
+	typedef SessionSnapshot::DeviceItem     DeviceItem;
+	typedef SessionSnapshot::InstrumentItem InstrumentItem;
+	typedef SessionSnapshot::MapItem        MapItem;
+	typedef SessionSnapshot::FxSendItem     FxSendItem;
+	typedef SessionSnapshot::ChannelItem    ChannelItem;
+
+	// Delta executives.
+	void applyDevices(int iDeviceType,
+		const QList<DeviceItem>& devices, const QList<DeviceItem>& live,
+		QMap<int, int>& deviceMap);
+	void applyPorts(int iDeviceType, int iDeviceID,
+		const DeviceItem& device, const DeviceItem *pLive);
+	void applyInstrumentMaps(const QList<MapItem>& live);
+	void applyChannels(const QList<ChannelItem>& live);
+	void applyFxSends(int iChannelID, const ChannelItem& channel,
+		const ChannelItem *pLive);
+	void applyChannelGroups();
+
+	void removeDevices(int iDeviceType,
+		const QList<DeviceItem>& live, const QMap<int, int>& deviceMap);
+	void removeInstrumentMaps(const QList<MapItem>& live);
+
+	// Comparison helpers.
+	static bool isSameDevice(const DeviceItem& device, const DeviceItem& live);
+	static bool isSameInstrumentFile(const QString& sInstrumentFile,
+		const QString& sLiveInstrumentFile);
+	static bool isSameInstrument(const InstrumentItem& instr,
+		const InstrumentItem& live);
+	static bool isSameFxSend(const FxSendItem& fxsend, const FxSendItem& live);
+
+	// Instance variables.
+	SessionSnapshot m_session;
+
+	QMap<int, int> m_audioDeviceMap;
+	QMap<int, int> m_midiDeviceMap;
+	QMap<int, int> m_midiMapMap;
+	QMap<int, int> m_channelMap;
+
+	int m_iKeptChannels;
+	int m_iChangedChannels;
+	int m_iAddedChannels;
+	int m_iRemovedChannels;
+
+	int m_iChanges;
+	int m_iErrors;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerSessionDelta_h
+
+
+// end of qsamplerSessionDelta.h
@@ -0,0 +1,2049 @@
+// qsamplerSessionSnapshot.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerSessionSnapshot.h"
+
+#include "qsamplerMainForm.h"
+#include "qsamplerChannel.h"
+#include "qsamplerDevice.h"
+#include "qsamplerInstrument.h"
+#include "qsamplerInstrumentList.h"
+#include "qsamplerInstrumentListForm.h"
+#include "qsamplerLscpStats.h"
+#include "qsamplerUtilities.h"
+#include "qsamplerTrace.h"
+
+#include <QSaveFile>
+#include <QFile>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QtEndian>
+
+#include <cstring>
+
+// Deprecated QTextStreamFunctions/Qt namespaces workaround.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+#define endl	Qt::endl
+#endif
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::SessionSnapshot -- Sampler session state, as plain data.
+//
+
+// Constructor.
+SessionSnapshot::SessionSnapshot (void)
+	: m_fVolume(1.0f), m_bVolume(true), m_bReset(true),
+		m_iErrors(0), m_iDirtyCount(0),
+		m_iLine(0), m_iWarnings(0), m_iDeadCommands(0), m_bScript(false)
+{
+}
+
+
+// Take the whole current session state, in one go (main thread).
+bool SessionSnapshot::take ( const QString& sFilename )
+{
+	QSAMPLER_TRACE("session", "SessionSnapshot::take");
+
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+
+	lscp_client_t *pClient = pMainForm->client();
+	if (pClient == nullptr)
+		return false;
+
+	m_sFilename = sFilename;
+	m_iErrors = 0;
+
+	m_commands.clear();
+	m_bScript = false;
+
+	// A whole session, from scratch.
+	m_bReset = true;
+
+	// Whatever gets changed from now on, won't get saved...
+	m_iDirtyCount = pMainForm->m_iDirtyCount;
+
+	// Devices (and their ports) parameters...
+	m_audioDevices.clear();
+	int *piDeviceIDs = Device::getDevices(pClient, Device::Audio);
+	for (int i = 0; piDeviceIDs && piDeviceIDs[i] >= 0; ++i) {
+		const DeviceItem& item = takeDevice(Device::Audio, piDeviceIDs[i]);
+		// Avoid plug-in driver devices...
+		if (item.sDriverName.toUpper() != "PLUGIN")
+			m_audioDevices.append(item);
+	}
+
+	m_midiDevices.clear();
+	piDeviceIDs = Device::getDevices(pClient, Device::Midi);
+	for (int i = 0; piDeviceIDs && piDeviceIDs[i] >= 0; ++i) {
+		const DeviceItem& item = takeDevice(Device::Midi, piDeviceIDs[i]);
+		// Avoid plug-in driver devices...
+		if (item.sDriverName.toUpper() != "PLUGIN")
+			m_midiDevices.append(item);
+	}
+
+	// MIDI instrument maps; their entries are taken from the
+	// instrument list model, whenever it has them all loaded...
+	m_instrumentMaps.clear();
+#ifdef CONFIG_MIDI_INSTRUMENT
+	InstrumentListModel *pListModel = nullptr;
+	if (pMainForm->m_pInstrumentListForm)
+		pListModel = pMainForm->m_pInstrumentListForm->listView()->listModel();
+	int *piMaps = QSAMPLER_LSCP(lscp_list_midi_instrument_maps, pClient);
+	for (int iMap = 0; piMaps && piMaps[iMap] >= 0; iMap++) {
+		MapItem map;
+		map.iMidiMap = piMaps[iMap];
+		map.sName = QString::fromUtf8(
+			QSAMPLER_LSCP(lscp_get_midi_instrument_map_name, pClient, map.iMidiMap));
+		if (pListModel && pListModel->isLoaded(map.iMidiMap)) {
+			QListIterator<Instrument *> instr_iter(
+				pListModel->instruments(map.iMidiMap));
+			while (instr_iter.hasNext())
+				map.instruments.append(takeInstrument(instr_iter.next()));
+			m_instrumentMaps.append(map);
+			continue;
+		}
+		// Otherwise, one by one...
+		lscp_midi_instrument_t *pInstrs
+			= QSAMPLER_LSCP(lscp_list_midi_instruments, pClient, map.iMidiMap);
+		for (int iInstr = 0; pInstrs && pInstrs[iInstr].map >= 0; iInstr++) {
+			lscp_midi_instrument_info_t *pInstrInfo
+				= QSAMPLER_LSCP(lscp_get_midi_instrument_info, pClient, &pInstrs[iInstr]);
+			if (pInstrInfo) {
+				InstrumentItem instr;
+				instr.iBank = pInstrs[iInstr].bank;
+				instr.iProg = pInstrs[iInstr].prog;
+				instr.sEngineName = pInstrInfo->engine_name;
+				instr.sInstrumentFile = pInstrInfo->instrument_file;
+				instr.iInstrumentNr = pInstrInfo->instrument_nr;
+				instr.fVolume = pInstrInfo->volume;
+				instr.iLoadMode = int(pInstrInfo->load_mode);
+				instr.sName = QString::fromUtf8(pInstrInfo->name);
+				instr.bNonModal = false;
+				map.instruments.append(instr);
+			}	// Check for errors...
+			else if (::lscp_client_get_errno(pClient)) {
+				pMainForm->appendMessagesClient("lscp_get_midi_instrument_info");
+				m_iErrors++;
+			}
+		}
+		// Check for errors...
+		if (pInstrs == nullptr && ::lscp_client_get_errno(pClient)) {
+			pMainForm->appendMessagesClient("lscp_list_midi_instruments");
+			m_iErrors++;
+		}
+		m_instrumentMaps.append(map);
+	}
+	// Check for errors...
+	if (piMaps == nullptr && ::lscp_client_get_errno(pClient)) {
+		pMainForm->appendMessagesClient("lscp_list_midi_instrument_maps");
+		m_iErrors++;
+	}
+#endif	// CONFIG_MIDI_INSTRUMENT
+
+	// Sampler channels, mostly from our own cached state...
+	m_channels.clear();
+	QListIterator<Channel *> channel_iter(pMainForm->channels(true));
+	while (channel_iter.hasNext()) {
+		Channel *pChannel = channel_iter.next();
+		ChannelItem item;
+		item.iChannelID = pChannel->channelID();
+		item.sAudioDriver = pChannel->audioDriver();
+		item.iAudioDevice = pChannel->audioDevice();
+		item.sMidiDriver = pChannel->midiDriver();
+		item.iMidiDevice = pChannel->midiDevice();
+		item.iMidiPort = pChannel->midiPort();
+		item.iMidiChannel = pChannel->midiChannel();
+		item.sEngineName = pChannel->engineName();
+		item.sInstrumentFile
+			= qsamplerUtilities::lscpEscapePath(pChannel->instrumentFile());
+		item.iInstrumentNr = pChannel->instrumentNr();
+		item.iInstrumentStatus = pChannel->instrumentStatus();
+		item.bNonModal = true;
+		item.audioRouting = pChannel->audioRouting();
+		item.fVolume = pChannel->volume();
+		item.bMute = pChannel->channelMute();
+		item.bSolo = pChannel->channelSolo();
+		item.iMidiMap = pChannel->midiMap();
+	#ifdef CONFIG_FXSEND
+		int *piFxSends = QSAMPLER_LSCP(lscp_list_fxsends, pClient, item.iChannelID);
+		for (int iFxSend = 0;
+				piFxSends && piFxSends[iFxSend] >= 0;
+					iFxSend++) {
+			lscp_fxsend_info_t *pFxSendInfo	= QSAMPLER_LSCP(lscp_get_fxsend_info,
+				pClient, item.iChannelID, piFxSends[iFxSend]);
+			if (pFxSendInfo) {
+				FxSendItem fxsend;
+				fxsend.iMidiController = pFxSendInfo->midi_controller;
+				fxsend.sName = QString::fromUtf8(pFxSendInfo->name);
+				int *piRouting = pFxSendInfo->audio_routing;
+				for (int iAudioSrc = 0;
+						piRouting && piRouting[iAudioSrc] >= 0;
+							iAudioSrc++) {
+					fxsend.routing.append(piRouting[iAudioSrc]);
+				}
+			#ifdef CONFIG_FXSEND_LEVEL
+				fxsend.fLevel = pFxSendInfo->level;
+			#else
+				fxsend.fLevel = 1.0f;
+			#endif
+				item.fxsends.append(fxsend);
+			}	// Check for errors...
+			else if (::lscp_client_get_errno(pClient)) {
+				pMainForm->appendMessagesClient("lscp_get_fxsend_info");
+				m_iErrors++;
+			}
+		}
+	#endif
+		m_channels.append(item);
+	}
+
+	// Channel groups, by value...
+	m_channelGroups.clear();
+	QListIterator<ChannelGroup *> group_iter(pMainForm->m_channelGroups);
+	while (group_iter.hasNext())
+		m_channelGroups.append(*group_iter.next());
+
+#ifdef CONFIG_VOLUME
+	m_fVolume = QSAMPLER_LSCP(lscp_get_volume, pClient);
+	m_bVolume = true;
+#endif
+
+	return true;
+}
+
+
+// Device (and ports) snapshot helper; all parameter info but
+// the current values is taken from the driver caches.
+SessionSnapshot::DeviceItem SessionSnapshot::takeDevice (
+	int iDeviceType, int iDeviceID )
+{
+	const Device device(Device::DeviceType(iDeviceType));
+
+	DeviceItem item;
+	item.iDeviceID = iDeviceID;
+	item.sTypeName = device.deviceTypeName();
+
+	DeviceParamMap deviceParams;
+	QList<DeviceParamMap> ports;
+	device.getSnapshot(iDeviceID, item.sDriverName, deviceParams, ports);
+
+	DeviceParamMap::ConstIterator deviceParam;
+	for (deviceParam = deviceParams.constBegin();
+			deviceParam != deviceParams.constEnd();
+				++deviceParam) {
+		ParamItem param;
+		param.sKey = deviceParam.key();
+		param.sValue = deviceParam.value().value;
+		param.bFix = deviceParam.value().fix;
+		item.params.append(param);
+	}
+
+	QListIterator<DeviceParamMap> iter(ports);
+	while (iter.hasNext()) {
+		const DeviceParamMap& portParams = iter.next();
+		QList<ParamItem> params;
+		DeviceParamMap::ConstIterator portParam;
+		for (portParam = portParams.constBegin();
+				portParam != portParams.constEnd();
+					++portParam) {
+			ParamItem param;
+			param.sKey = portParam.key();
+			param.sValue = portParam.value().value;
+			param.bFix = portParam.value().fix;
+			params.append(param);
+		}
+		item.ports.append(params);
+	}
+
+	return item;
+}
+
+
+// MIDI instrument map entry snapshot helper (from the instrument
+// list model, in the same LSCP escaped form as the server's own).
+SessionSnapshot::InstrumentItem SessionSnapshot::takeInstrument (
+	const Instrument *pInstrument )
+{
+	InstrumentItem instr;
+	instr.iBank = pInstrument->bank();
+	instr.iProg = pInstrument->prog();
+	instr.sEngineName = pInstrument->engineName();
+	instr.sInstrumentFile
+		= qsamplerUtilities::lscpEscapePath(pInstrument->instrumentFile());
+	instr.iInstrumentNr = pInstrument->instrumentNr();
+	instr.fVolume = pInstrument->volume();
+	switch (pInstrument->loadMode()) {
+		case 3:
+			instr.iLoadMode = int(LSCP_LOAD_PERSISTENT);
+			break;
+		case 2:
+			instr.iLoadMode = int(LSCP_LOAD_ON_DEMAND_HOLD);
+			break;
+		case 1:
+			instr.iLoadMode = int(LSCP_LOAD_ON_DEMAND);
+			break;
+		case 0:
+		default:
+			instr.iLoadMode = int(LSCP_LOAD_DEFAULT);
+			break;
+	}
+	instr.sName = pInstrument->name();
+	instr.bNonModal = false;
+
+	return instr;
+}
+
+
+// Single quote a session script string; escape sequences are kept
+// as written, only bare quotes (and a trailing backslash) get escaped.
+static QString sessionQuote ( const QString& sText )
+{
+	QString sToken(1, '\'');
+
+	const int iLength = sText.length();
+	for (int i = 0; i < iLength; ++i) {
+		const QChar ch = sText.at(i);
+		if (ch == '\\' && i < iLength - 1) {
+			sToken += ch;
+			sToken += sText.at(++i);
+			continue;
+		}
+		if (ch == '\'' || ch == '\\')
+			sToken += '\\';
+		sToken += ch;
+	}
+
+	sToken += '\'';
+	return sToken;
+}
+
+
+// Serialize as a LSCP session script (any thread).
+QString SessionSnapshot::toScript (void) const
+{
+	QString sText;
+	QTextStream ts(&sText);
+
+	ts << "# " << QSAMPLER_TITLE " - " << QObject::tr(QSAMPLER_SUBTITLE) << endl;
+	ts << "# " << QObject::tr("Version") << ": " CONFIG_BUILD_VERSION << endl;
+//	ts << "# " << QObject::tr("Build") << ": " CONFIG_BUILD_DATE << endl;
+	ts << "#"  << endl;
+	ts << "# " << QObject::tr("File")
+	<< ": " << QFileInfo(m_sFilename).fileName() << endl;
+	ts << "# " << QObject::tr("Date")
+	<< ": " << QDate::currentDate().toString("MMM dd yyyy")
+	<< " "  << QTime::currentTime().toString("hh:mm:ss") << endl;
+	ts << "#"  << endl;
+	ts << endl;
+
+	// It is assumed that this new kind of device+session file
+	// will be loaded from a complete initialized server...
+	if (m_bReset)
+		ts << "RESET" << endl;
+
+	// Audio device mapping.
+	QMap<int, int> audioDeviceMap;
+	QListIterator<DeviceItem> audio_iter(m_audioDevices);
+	while (audio_iter.hasNext()) {
+		const DeviceItem& device = audio_iter.next();
+		const int iDevice = audioDeviceMap.count();
+		// Audio device specification...
+		ts << endl;
+		ts << "# " << device.sTypeName << " " << device.sDriverName
+			<< " " << QObject::tr("Device") << " " << iDevice << endl;
+		ts << "CREATE AUDIO_OUTPUT_DEVICE " << device.sDriverName;
+		QListIterator<ParamItem> param_iter(device.params);
+		while (param_iter.hasNext()) {
+			const ParamItem& param = param_iter.next();
+			if (param.sValue.isEmpty()) ts << "# ";
+			ts << " " << param.sKey << '=' << sessionQuote(param.sValue);
+		}
+		ts << endl;
+		// Audio channel parameters...
+		for (int iPort = 0; iPort < device.ports.count(); ++iPort) {
+			QListIterator<ParamItem> port_iter(device.ports.at(iPort));
+			while (port_iter.hasNext()) {
+				const ParamItem& param = port_iter.next();
+				if (param.bFix || param.sValue.isEmpty()) ts << "# ";
+				ts << "SET AUDIO_OUTPUT_CHANNEL_PARAMETER " << iDevice
+					<< " " << iPort << " " << param.sKey
+					<< '=' << sessionQuote(param.sValue) << endl;
+			}
+		}
+		// Audio device index/id mapping.
+		audioDeviceMap.insert(device.iDeviceID, iDevice);
+	}
+
+	// MIDI device mapping.
+	QMap<int, int> midiDeviceMap;
+	QListIterator<DeviceItem> midi_iter(m_midiDevices);
+	while (midi_iter.hasNext()) {
+		const DeviceItem& device = midi_iter.next();
+		const int iDevice = midiDeviceMap.count();
+		// MIDI device specification...
+		ts << endl;
+		ts << "# " << device.sTypeName << " " << device.sDriverName
+			<< " " << QObject::tr("Device") << " " << iDevice << endl;
+		ts << "CREATE MIDI_INPUT_DEVICE " << device.sDriverName;
+		QListIterator<ParamItem> param_iter(device.params);
+		while (param_iter.hasNext()) {
+			const ParamItem& param = param_iter.next();
+			if (param.sValue.isEmpty()) ts << "# ";
+			ts << " " << param.sKey << '=' << sessionQuote(param.sValue);
+		}
+		ts << endl;
+		// MIDI port parameters...
+		for (int iPort = 0; iPort < device.ports.count(); ++iPort) {
+			QListIterator<ParamItem> port_iter(device.ports.at(iPort));
+			while (port_iter.hasNext()) {
+				const ParamItem& param = port_iter.next();
+				if (param.bFix || param.sValue.isEmpty()) ts << "# ";
+				ts << "SET MIDI_INPUT_PORT_PARAMETER " << iDevice
+					<< " " << iPort << " " << param.sKey
+					<< '=' << sessionQuote(param.sValue) << endl;
+			}
+		}
+		// MIDI device index/id mapping.
+		midiDeviceMap.insert(device.iDeviceID, iDevice);
+	}
+	ts << endl;
+
+	// MIDI instrument mapping...
+	QMap<int, int> midiInstrumentMap;
+	QListIterator<MapItem> map_iter(m_instrumentMaps);
+	while (map_iter.hasNext()) {
+		const MapItem& map = map_iter.next();
+		const int iMap = midiInstrumentMap.count();
+		ts << "# " << QObject::tr("MIDI instrument map") << " " << iMap;
+		if (!map.sName.isNull())
+			ts << " - " << map.sName;
+		ts << endl;
+		ts << "ADD MIDI_INSTRUMENT_MAP";
+		if (!map.sName.isNull())
+			ts << " " << sessionQuote(map.sName);
+		ts << endl;
+		QListIterator<InstrumentItem> instr_iter(map.instruments);
+		while (instr_iter.hasNext()) {
+			const InstrumentItem& instr = instr_iter.next();
+			ts << "MAP MIDI_INSTRUMENT ";
+			if (instr.bNonModal)
+				ts << "NON_MODAL ";
+			ts << iMap                   << " "
+				<< instr.iBank           << " "
+				<< instr.iProg           << " "
+				<< instr.sEngineName     << " "
+				<< sessionQuote(instr.sInstrumentFile) << " "
+				<< instr.iInstrumentNr   << " "
+				<< instr.fVolume         << " ";
+			switch (instr.iLoadMode) {
+				case LSCP_LOAD_PERSISTENT:
+					ts << "PERSISTENT";
+					break;
+				case LSCP_LOAD_ON_DEMAND_HOLD:
+					ts << "ON_DEMAND_HOLD";
+					break;
+				case LSCP_LOAD_ON_DEMAND:
+				case LSCP_LOAD_DEFAULT:
+				default:
+					ts << "ON_DEMAND";
+					break;
+			}
+			if (!instr.sName.isNull())
+				ts << " " << sessionQuote(instr.sName);
+			ts << endl;
+		}
+		ts << endl;
+		// MIDI strument index/id mapping.
+		midiInstrumentMap.insert(map.iMidiMap, iMap);
+	}
+
+	// Sampler channel mapping...
+	QMap<int, int> channelMap;
+	int iChannelID = 0;
+	QListIterator<ChannelItem> channel_iter(m_channels);
+	while (channel_iter.hasNext()) {
+		const ChannelItem& channel = channel_iter.next();
+		// Avoid "artifial" plug-in devices...
+		if (channel.iAudioDevice >= 0
+			&& !audioDeviceMap.contains(channel.iAudioDevice))
+			continue;
+		if (channel.iMidiDevice >= 0
+			&& !midiDeviceMap.contains(channel.iMidiDevice))
+			continue;
+		// Go for regular, canonical devices...
+		ts << "# " << QObject::tr("Channel") << " " << iChannelID << endl;
+		ts << "ADD CHANNEL" << endl;
+		if (channel.iAudioDevice < 0) {
+			if (!channel.sAudioDriver.isEmpty())
+				ts << "SET CHANNEL AUDIO_OUTPUT_TYPE " << iChannelID
+					<< " " << channel.sAudioDriver << endl;
+		} else {
+			ts << "SET CHANNEL AUDIO_OUTPUT_DEVICE " << iChannelID
+				<< " " << audioDeviceMap.value(channel.iAudioDevice) << endl;
+		}
+		if (channel.iMidiDevice < 0) {
+			if (!channel.sMidiDriver.isEmpty())
+				ts << "SET CHANNEL MIDI_INPUT_TYPE " << iChannelID
+					<< " " << channel.sMidiDriver << endl;
+		} else {
+			ts << "SET CHANNEL MIDI_INPUT_DEVICE " << iChannelID
+				<< " " << midiDeviceMap.value(channel.iMidiDevice) << endl;
+		}
+		ts << "SET CHANNEL MIDI_INPUT_PORT " << iChannelID
+			<< " " << channel.iMidiPort << endl;
+		ts << "SET CHANNEL MIDI_INPUT_CHANNEL " << iChannelID << " ";
+		if (channel.iMidiChannel == LSCP_MIDI_CHANNEL_ALL)
+			ts << "ALL";
+		else
+			ts << channel.iMidiChannel;
+		ts << endl;
+		if (!channel.sEngineName.isEmpty())
+			ts << "LOAD ENGINE " << channel.sEngineName
+				<< " " << iChannelID << endl;
+		if (channel.iInstrumentStatus < 100) ts << "# ";
+		ts << "LOAD INSTRUMENT ";
+		if (channel.bNonModal)
+			ts << "NON_MODAL ";
+		ts << sessionQuote(channel.sInstrumentFile) << " "
+			<< channel.iInstrumentNr << " " << iChannelID << endl;
+		ChannelRoutingMap::ConstIterator audioRoute;
+		for (audioRoute = channel.audioRouting.begin();
+				audioRoute != channel.audioRouting.end();
+					++audioRoute) {
+			ts << "SET CHANNEL AUDIO_OUTPUT_CHANNEL " << iChannelID
+				<< " " << audioRoute.key()
+				<< " " << audioRoute.value() << endl;
+		}
+		ts << "SET CHANNEL VOLUME " << iChannelID
+			<< " " << channel.fVolume << endl;
+		if (channel.bMute)
+			ts << "SET CHANNEL MUTE " << iChannelID << " 1" << endl;
+		if (channel.bSolo)
+			ts << "SET CHANNEL SOLO " << iChannelID << " 1" << endl;
+	#ifdef CONFIG_MIDI_INSTRUMENT
+		if (midiInstrumentMap.contains(channel.iMidiMap)) {
+			ts << "SET CHANNEL MIDI_INSTRUMENT_MAP " << iChannelID
+				<< " " << midiInstrumentMap.value(channel.iMidiMap) << endl;
+		}
+		else
+		if (channel.iMidiMap == LSCP_MIDI_MAP_DEFAULT) {
+			ts << "SET CHANNEL MIDI_INSTRUMENT_MAP " << iChannelID
+				<< " DEFAULT" << endl;
+		}
+	#endif
+	#ifdef CONFIG_FXSEND
+		for (int iFxSend = 0; iFxSend < channel.fxsends.count(); ++iFxSend) {
+			const FxSendItem& fxsend = channel.fxsends.at(iFxSend);
+			ts << "CREATE FX_SEND " << iChannelID
+				<< " " << fxsend.iMidiController;
+			if (!fxsend.sName.isNull())
+				ts << " " << sessionQuote(fxsend.sName);
+			ts << endl;
+			for (int iAudioSrc = 0; iAudioSrc < fxsend.routing.count(); ++iAudioSrc) {
+				ts << "SET FX_SEND AUDIO_OUTPUT_CHANNEL "
+					<< iChannelID
+					<< " " << iFxSend
+					<< " " << iAudioSrc
+					<< " " << fxsend.routing.at(iAudioSrc) << endl;
+			}
+		#ifdef CONFIG_FXSEND_LEVEL
+			ts << "SET FX_SEND LEVEL " << iChannelID
+				<< " " << iFxSend
+				<< " " << fxsend.fLevel << endl;
+		#endif
+		}
+	#endif
+		ts << endl;
+		// Go for next channel...
+		channelMap.insert(channel.iChannelID, iChannelID);
+		++iChannelID;
+	}
+
+	// Channel groups, as special comments...
+	if (!m_channelGroups.isEmpty()) {
+		ts << "# " << QObject::tr("Channel groups") << endl;
+		QListIterator<ChannelGroup> group_iter(m_channelGroups);
+		while (group_iter.hasNext())
+			ts << group_iter.next().toSessionLine(channelMap) << endl;
+		ts << endl;
+	}
+
+#ifdef CONFIG_VOLUME
+	if (m_bVolume) {
+		ts << "# " << QObject::tr("Global volume level") << endl;
+		ts << "SET VOLUME " << m_fVolume << endl;
+		ts << endl;
+	}
+#endif
+
+	ts.flush();
+
+	return sText;
+}
+
+
+// Write it down atomically (temp file + rename; any thread).
+bool SessionSnapshot::save (void) const
+{
+	QSAMPLER_TRACE("session", "SessionSnapshot::save");
+
+	QSaveFile file(m_sFilename);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	const QByteArray& data = (isBinaryFile(m_sFilename)
+		? toBinary() : toScript().toUtf8());
+	if (file.write(data) < 0) {
+		file.cancelWriting();
+		return false;
+	}
+
+	// Only now it replaces the old one, if any.
+	return file.commit();
+}
+
+
+// Parse a LSCP session script, as far as we write it (any thread).
+bool SessionSnapshot::fromScript ( const QString& sText )
+{
+	clear();
+
+	m_iErrors = 0;
+	m_iDirtyCount = 0;
+
+	m_iLine = 0;
+	m_iWarnings = 0;
+	m_iDeadCommands = 0;
+	m_diagnostics.clear();
+
+	m_commands.clear();
+	m_bScript = true;
+
+	QString sScript(sText);
+	QTextStream ts(&sScript, QIODevice::ReadOnly);
+	while (!ts.atEnd()) {
+		const QString& sLine = ts.readLine().trimmed();
+		++m_iLine;
+		const int iErrors = m_iErrors;
+		if (!parseLine(sLine)) {
+			if (m_iErrors == iErrors)
+				parseError(QObject::tr("unsupported command: %1").arg(sLine));
+		}
+		else
+		if (!sLine.isEmpty() && !sLine.startsWith('#'))
+			m_commands.insert(m_iLine, sessionTokens(sLine).join(' '));
+	}
+
+	// No line in particular from now on...
+	m_iLine = 0;
+	m_slots.clear();
+
+	validate();
+
+	return (m_iErrors == 0);
+}
+
+
+// Read it up from a session file (any thread).
+bool SessionSnapshot::load ( const QString& sFilename )
+{
+	QSAMPLER_TRACE("session", "SessionSnapshot::load");
+
+	QFile file(sFilename);
+	if (!file.open(QIODevice::ReadOnly)) {
+		clear();
+		m_iLine = 0;
+		m_diagnostics.clear();
+		m_iErrors = 0;
+		parseError(QObject::tr("could not open file"));
+		return false;
+	}
+
+	const QByteArray& data = file.readAll();
+	const bool bResult = (isBinary(data)
+		? fromBinary(data) : fromScript(QString::fromUtf8(data)));
+	m_sFilename = sFilename;
+
+	return bResult;
+}
+
+
+//-------------------------------------------------------------------------
+// Compact binary snapshot format (version 2).
+//
+// All words are 32-bit little-endian and every record is fixed-size,
+// so that an uncompressed payload may be used in place (eg. mmap'ed):
+//
+//   header:  "QSSB", quint16 version, quint16 flags (compressed),
+//            quint32 payload size (uncompressed), quint32 reserved;
+//   payload: quint32 string count, quint32 section count,
+//            quint32 record count per section, float global volume,
+//            quint32 session flags (reset, volume), quint32 string
+//            offsets (count + 1), UTF-8 string data (4-byte padded),
+//            then the records of each section, in section order.
+//
+// Strings are stored once in the table and referred by index (zero
+// is the empty string); record lists (params, ports, instruments,
+// routes, effect sends and group members) are given as first index
+// and count into their own sections.
+//
+// Version 1 instrument records had no flags word (never non-modal)
+// and all channels had their instrument loaded non-modal.
+//
+
+#define QSAMPLER_SNAPSHOT_MAGIC       "QSSB"
+#define QSAMPLER_SNAPSHOT_VERSION     2
+#define QSAMPLER_SNAPSHOT_HEADER      16
+#define QSAMPLER_SNAPSHOT_COMPRESSED  0x0001
+#define QSAMPLER_SNAPSHOT_SUFFIX      "lss"
+
+enum SnapshotSection
+{
+	SnapshotDevices = 0,
+	SnapshotParams,
+	SnapshotPorts,
+	SnapshotMaps,
+	SnapshotInstruments,
+	SnapshotChannels,
+	SnapshotRoutes,
+	SnapshotFxSends,
+	SnapshotGroups,
+	SnapshotMembers,
+	SnapshotSections
+};
+
+// Record sizes, in words, per section.
+static const int g_snapshotRecordWords[SnapshotSections]
+	= { 8, 3, 2, 4, 9, 18, 2, 5, 3, 1 };
+
+enum SnapshotFlags
+{
+	SnapshotReset    = 0x0001,
+	SnapshotVolume   = 0x0002,
+	SnapshotFix      = 0x0001,
+	SnapshotMute     = 0x0001,
+	SnapshotSolo     = 0x0002,
+	SnapshotNonModal = 0x0004
+};
+
+
+// Binary snapshot word writers.
+static void snapshotPut ( QByteArray& data, quint32 iValue )
+{
+	uchar aBuffer[4];
+	qToLittleEndian<quint32>(iValue, aBuffer);
+	data.append((const char *) aBuffer, 4);
+}
+
+static void snapshotPutFloat ( QByteArray& data, float fValue )
+{
+	quint32 iValue = 0;
+	::memcpy(&iValue, &fValue, sizeof(iValue));
+	snapshotPut(data, iValue);
+}
+
+
+// Binary snapshot word readers.
+static quint32 snapshotGet ( const uchar *pRecord, int iWord )
+{
+	return qFromLittleEndian<quint32>(pRecord + (iWord << 2));
+}
+
+static float snapshotGetFloat ( const uchar *pRecord, int iWord )
+{
+	const quint32 iValue = snapshotGet(pRecord, iWord);
+	float fValue = 0.0f;
+	::memcpy(&fValue, &iValue, sizeof(fValue));
+	return fValue;
+}
+
+
+// Binary snapshot string table (writer side).
+class SnapshotStrings
+{
+public:
+
+	// Constructor.
+	SnapshotStrings() { add(QString()); }
+
+	// Intern a string, return its index.
+	quint32 add(const QString& sText)
+	{
+		QHash<QString, quint32>::ConstIterator iter = m_index.constFind(sText);
+		if (iter != m_index.constEnd())
+			return iter.value();
+		const quint32 iIndex = m_offsets.count();
+		m_offsets.append(m_data.size());
+		m_data.append(sText.toUtf8());
+		m_index.insert(sText, iIndex);
+		return iIndex;
+	}
+
+	// Write down the string count, offsets and (padded) data.
+	void write(QByteArray& data) const
+	{
+		QListIterator<quint32> iter(m_offsets);
+		while (iter.hasNext())
+			snapshotPut(data, iter.next());
+		snapshotPut(data, m_data.size());
+		data.append(m_data);
+		data.append(QByteArray((4 - (m_data.size() & 3)) & 3, '\0'));
+	}
+
+	int count() const { return m_offsets.count(); }
+
+private:
+
+	// Instance variables.
+	QHash<QString, quint32> m_index;
+	QList<quint32> m_offsets;
+	QByteArray m_data;
+};
+
+
+// Binary snapshot section record index helper (writer side).
+static quint32 snapshotIndex ( const QByteArray *pSections, int iSection )
+{
+	return pSections[iSection].size() / (g_snapshotRecordWords[iSection] << 2);
+}
+
+// Binary snapshot parameter list writer.
+static void snapshotParams ( QByteArray *pSections, QByteArray& data,
+	SnapshotStrings& strings, const QList<SessionSnapshot::ParamItem>& params )
+{
+	snapshotPut(data, snapshotIndex(pSections, SnapshotParams));
+	snapshotPut(data, params.count());
+
+	QListIterator<SessionSnapshot::ParamItem> iter(params);
+	while (iter.hasNext()) {
+		const SessionSnapshot::ParamItem& param = iter.next();
+		QByteArray& record = pSections[SnapshotParams];
+		snapshotPut(record, strings.add(param.sKey));
+		snapshotPut(record, strings.add(param.sValue));
+		snapshotPut(record, param.bFix ? SnapshotFix : 0);
+	}
+}
+
+
+// Whether it's a binary snapshot file name (by suffix).
+bool SessionSnapshot::isBinaryFile ( const QString& sFilename )
+{
+	return (QFileInfo(sFilename).suffix().toLower() == QSAMPLER_SNAPSHOT_SUFFIX);
+}
+
+
+// Whether it's binary snapshot data (by magic).
+bool SessionSnapshot::isBinary ( const QByteArray& data )
+{
+	return data.startsWith(QSAMPLER_SNAPSHOT_MAGIC);
+}
+
+
+// Instrument file paths are kept just as the server (or script) has
+// them, LSCP escaped; bare quote escapes go as hex ones for decoding.
+QString SessionSnapshot::instrumentPath ( const QString& sPath )
+{
+	QString sEscaped;
+
+	const int iLength = sPath.length();
+	for (int i = 0; i < iLength; ++i) {
+		const QChar ch = sPath.at(i);
+		if (ch == '\\' && i < iLength - 1) {
+			const QChar ch2 = sPath.at(i + 1);
+			if (ch2 == '\'' || ch2 == '"' || ch2 == '\\') {
+				sEscaped += QString::asprintf("\\x%02x", ch2.toLatin1());
+				++i;
+				continue;
+			}
+		}
+		sEscaped += ch;
+	}
+
+	return qsamplerUtilities::lscpEscapedPathToPosix(sEscaped);
+}
+
+
+// Serialize as a compact binary snapshot (any thread).
+QByteArray SessionSnapshot::toBinary ( bool bCompress ) const
+{
+	SnapshotStrings strings;
+	QByteArray sections[SnapshotSections];
+
+	// Devices (audio first), their parameters and ports...
+	for (int iType = 0; iType < 2; ++iType) {
+		QListIterator<DeviceItem> iter(iType == 0
+			? m_audioDevices : m_midiDevices);
+		while (iter.hasNext()) {
+			const DeviceItem& device = iter.next();
+			QByteArray record;
+			snapshotPut(record, iType);
+			snapshotPut(record, quint32(device.iDeviceID));
+			snapshotPut(record, strings.add(device.sTypeName));
+			snapshotPut(record, strings.add(device.sDriverName));
+			snapshotParams(sections, record, strings, device.params);
+			snapshotPut(record, snapshotIndex(sections, SnapshotPorts));
+			snapshotPut(record, device.ports.count());
+			QListIterator< QList<ParamItem> > port_iter(device.ports);
+			while (port_iter.hasNext()) {
+				QByteArray port;
+				snapshotParams(sections, port, strings, port_iter.next());
+				sections[SnapshotPorts].append(port);
+			}
+			sections[SnapshotDevices].append(record);
+		}
+	}
+
+	// MIDI instrument maps and their entries...
+	QListIterator<MapItem> map_iter(m_instrumentMaps);
+	while (map_iter.hasNext()) {
+		const MapItem& map = map_iter.next();
+		QByteArray& record = sections[SnapshotMaps];
+		snapshotPut(record, quint32(map.iMidiMap));
+		snapshotPut(record, strings.add(map.sName));
+		snapshotPut(record, snapshotIndex(sections, SnapshotInstruments));
+		snapshotPut(record, map.instruments.count());
+		QListIterator<InstrumentItem> instr_iter(map.instruments);
+		while (instr_iter.hasNext()) {
+			const InstrumentItem& instr = instr_iter.next();
+			QByteArray& data = sections[SnapshotInstruments];
+			snapshotPut(data, quint32(instr.iBank));
+			snapshotPut(data, quint32(instr.iProg));
+			snapshotPut(data, strings.add(instr.sEngineName));
+			snapshotPut(data, strings.add(instr.sInstrumentFile));
+			snapshotPut(data, quint32(instr.iInstrumentNr));
+			snapshotPutFloat(data, instr.fVolume);
+			snapshotPut(data, quint32(instr.iLoadMode));
+			snapshotPut(data, strings.add(instr.sName));
+			snapshotPut(data, instr.bNonModal ? SnapshotNonModal : 0);
+		}
+	}
+
+	// Channels, their audio routing and effect sends...
+	QListIterator<ChannelItem> channel_iter(m_channels);
+	while (channel_iter.hasNext()) {
+		const ChannelItem& channel = channel_iter.next();
+		QByteArray record;
+		snapshotPut(record, quint32(channel.iChannelID));
+		snapshotPut(record, strings.add(channel.sAudioDriver));
+		snapshotPut(record, quint32(channel.iAudioDevice));
+		snapshotPut(record, strings.add(channel.sMidiDriver));
+		snapshotPut(record, quint32(channel.iMidiDevice));
+		snapshotPut(record, quint32(channel.iMidiPort));
+		snapshotPut(record, quint32(channel.iMidiChannel));
+		snapshotPut(record, strings.add(channel.sEngineName));
+		snapshotPut(record, strings.add(channel.sInstrumentFile));
+		snapshotPut(record, quint32(channel.iInstrumentNr));
+		snapshotPut(record, quint32(channel.iInstrumentStatus));
+		snapshotPutFloat(record, channel.fVolume);
+		snapshotPut(record, (channel.bMute ? SnapshotMute : 0)
+			| (channel.bSolo ? SnapshotSolo : 0)
+			| (channel.bNonModal ? SnapshotNonModal : 0));
+		snapshotPut(record, quint32(channel.iMidiMap));
+		snapshotPut(record, snapshotIndex(sections, SnapshotRoutes));
+		snapshotPut(record, channel.audioRouting.count());
+		ChannelRoutingMap::ConstIterator route = channel.audioRouting.constBegin();
+		for ( ; route != channel.audioRouting.constEnd(); ++route) {
+			snapshotPut(sections[SnapshotRoutes], quint32(route.key()));
+			snapshotPut(sections[SnapshotRoutes], quint32(route.value()));
+		}
+		snapshotPut(record, snapshotIndex(sections, SnapshotFxSends));
+		snapshotPut(record, channel.fxsends.count());
+		QListIterator<FxSendItem> fxsend_iter(channel.fxsends);
+		while (fxsend_iter.hasNext()) {
+			const FxSendItem& fxsend = fxsend_iter.next();
+			QByteArray& data = sections[SnapshotFxSends];
+			snapshotPut(data, quint32(fxsend.iMidiController));
+			snapshotPut(data, strings.add(fxsend.sName));
+			snapshotPut(data, snapshotIndex(sections, SnapshotRoutes));
+			snapshotPut(data, fxsend.routing.count());
+			snapshotPutFloat(data, fxsend.fLevel);
+			for (int i = 0; i < fxsend.routing.count(); ++i) {
+				snapshotPut(sections[SnapshotRoutes], quint32(i));
+				snapshotPut(sections[SnapshotRoutes], quint32(fxsend.routing.at(i)));
+			}
+		}
+		sections[SnapshotChannels].append(record);
+	}
+
+	// Channel groups and their members...
+	QListIterator<ChannelGroup> group_iter(m_channelGroups);
+	while (group_iter.hasNext()) {
+		const ChannelGroup& group = group_iter.next();
+		QByteArray& record = sections[SnapshotGroups];
+		snapshotPut(record, strings.add(group.name()));
+		snapshotPut(record, snapshotIndex(sections, SnapshotMembers));
+		snapshotPut(record, group.channelIDs().count());
+		QListIterator<int> id_iter(group.channelIDs());
+		while (id_iter.hasNext())
+			snapshotPut(sections[SnapshotMembers], quint32(id_iter.next()));
+	}
+
+	// Now the whole payload...
+	QByteArray payload;
+	snapshotPut(payload, strings.count());
+	snapshotPut(payload, SnapshotSections);
+	for (int iSection = 0; iSection < SnapshotSections; ++iSection)
+		snapshotPut(payload, snapshotIndex(sections, iSection));
+	snapshotPutFloat(payload, m_fVolume);
+	snapshotPut(payload, (m_bReset ? SnapshotReset : 0)
+		| (m_bVolume ? SnapshotVolume : 0));
+	strings.write(payload);
+	for (int iSection = 0; iSection < SnapshotSections; ++iSection)
+		payload.append(sections[iSection]);
+
+	// And the header...
+	QByteArray data(QSAMPLER_SNAPSHOT_MAGIC);
+	uchar aBuffer[2];
+	qToLittleEndian<quint16>(QSAMPLER_SNAPSHOT_VERSION, aBuffer);
+	data.append((const char *) aBuffer, 2);
+	qToLittleEndian<quint16>(bCompress ? QSAMPLER_SNAPSHOT_COMPRESSED : 0, aBuffer);
+	data.append((const char *) aBuffer, 2);
+	snapshotPut(data, payload.size());
+	snapshotPut(data, 0);
+
+	if (bCompress)
+		data.append(qCompress(payload));
+	else
+		data.append(payload);
+
+	return data;
+}
+
+
+// Parse a compact binary snapshot (any thread).
+bool SessionSnapshot::fromBinary ( const QByteArray& data )
+{
+	clear();
+
+	m_iErrors = 0;
+	m_iDirtyCount = 0;
+
+	m_iLine = 0;
+	m_iWarnings = 0;
+	m_iDeadCommands = 0;
+	m_diagnostics.clear();
+
+	m_commands.clear();
+	m_bScript = false;
+
+	if (data.size() < QSAMPLER_SNAPSHOT_HEADER || !isBinary(data))
+		return parseError(QObject::tr("not a session snapshot"));
+
+	const uchar *pHeader = (const uchar *) data.constData();
+	const quint16 iVersion = qFromLittleEndian<quint16>(pHeader + 4);
+	const quint16 iFlags = qFromLittleEndian<quint16>(pHeader + 6);
+	const quint32 iSize = snapshotGet(pHeader, 2);
+	if (iVersion > QSAMPLER_SNAPSHOT_VERSION) {
+		return parseError(
+			QObject::tr("unsupported snapshot version: %1").arg(iVersion));
+	}
+
+	// Uncompressed payloads are used in place...
+	QByteArray payload;
+	if (iFlags & QSAMPLER_SNAPSHOT_COMPRESSED) {
+		payload = qUncompress(pHeader + QSAMPLER_SNAPSHOT_HEADER,
+			data.size() - QSAMPLER_SNAPSHOT_HEADER);
+	} else {
+		payload = QByteArray::fromRawData(
+			data.constData() + QSAMPLER_SNAPSHOT_HEADER,
+			data.size() - QSAMPLER_SNAPSHOT_HEADER);
+	}
+
+	const QString sCorrupt = QObject::tr("corrupt session snapshot");
+	if (quint32(payload.size()) != iSize || iSize < 8 || (iSize & 3))
+		return parseError(sCorrupt);
+
+	// Payload layout: all bounds checked, up front...
+	const uchar *pData = (const uchar *) payload.constData();
+	const quint32 iWords = (iSize >> 2);
+	const quint32 iStrings = snapshotGet(pData, 0);
+	const quint32 iSections = snapshotGet(pData, 1);
+	if (iStrings < 1 || iSections < SnapshotSections
+		|| iSections > iWords || iStrings > iWords)
+		return parseError(sCorrupt);
+
+	quint32 counts[SnapshotSections];
+	for (int iSection = 0; iSection < SnapshotSections; ++iSection)
+		counts[iSection] = snapshotGet(pData, 2 + iSection);
+
+	// Record sizes, as of this version...
+	int recordWords[SnapshotSections];
+	for (int iSection = 0; iSection < SnapshotSections; ++iSection)
+		recordWords[iSection] = g_snapshotRecordWords[iSection];
+	if (iVersion < 2)
+		recordWords[SnapshotInstruments] = 8;
+
+	quint32 iWord = 2 + iSections;
+	if (iWord + 2 + iStrings + 1 > iWords)
+		return parseError(sCorrupt);
+
+	const float fVolume = snapshotGetFloat(pData, iWord++);
+	const quint32 iSessionFlags = snapshotGet(pData, iWord++);
+
+	// The string table...
+	const uchar *pOffsets = pData + (iWord << 2);
+	const quint32 iStringData = snapshotGet(pOffsets, iStrings);
+	iWord += iStrings + 1;
+	if (iStringData > ((iWords - iWord) << 2))
+		return parseError(sCorrupt);
+	const char *pStringData = (const char *) pData + (iWord << 2);
+	QStringList strings;
+	strings.reserve(iStrings);
+	for (quint32 i = 0; i < iStrings; ++i) {
+		const quint32 iOffset = snapshotGet(pOffsets, i);
+		const quint32 iNext = snapshotGet(pOffsets, i + 1);
+		if (iOffset > iNext || iNext > iStringData)
+			return parseError(sCorrupt);
+		strings.append(QString::fromUtf8(pStringData + iOffset, iNext - iOffset));
+	}
+	iWord += (iStringData + 3) >> 2;
+
+	// The sections records...
+	const uchar *apSections[SnapshotSections];
+	for (int iSection = 0; iSection < SnapshotSections; ++iSection) {
+		const quint64 iSectionWords
+			= quint64(counts[iSection]) * recordWords[iSection];
+		if (iSectionWords > iWords - iWord)
+			return parseError(sCorrupt);
+		apSections[iSection] = pData + (iWord << 2);
+		iWord += quint32(iSectionWords);
+	}
+
+	// Record, string and list accessors, all checked...
+	bool bValid = true;
+	#define SNAPSHOT_RECORD(s, i) \
+		(apSections[s] + (((i) * recordWords[s]) << 2))
+	#define SNAPSHOT_STRING(p, w) \
+		(snapshotGet(p, w) < iStrings ? strings.at(snapshotGet(p, w)) \
+			: (bValid = false, QString()))
+	#define SNAPSHOT_RANGE(s, p, w) \
+		(snapshotGet(p, w) <= counts[s] \
+			&& snapshotGet(p, (w) + 1) <= counts[s] - snapshotGet(p, w))
+
+	// Devices (and their ports) parameters...
+	for (quint32 i = 0; bValid && i < counts[SnapshotDevices]; ++i) {
+		const uchar *pRecord = SNAPSHOT_RECORD(SnapshotDevices, i);
+		DeviceItem device;
+		device.iDeviceID = int(snapshotGet(pRecord, 1));
+		device.sTypeName = SNAPSHOT_STRING(pRecord, 2);
+		device.sDriverName = SNAPSHOT_STRING(pRecord, 3);
+		QList<const uchar *> lists;
+		if (!SNAPSHOT_RANGE(SnapshotParams, pRecord, 4)
+			|| !SNAPSHOT_RANGE(SnapshotPorts, pRecord, 6)) {
+			bValid = false;
+			break;
+		}
+		lists.append(pRecord + (4 << 2));
+		const quint32 iFirstPort = snapshotGet(pRecord, 6);
+		const quint32 iPorts = snapshotGet(pRecord, 7);
+		for (quint32 j = 0; j < iPorts; ++j) {
+			const uchar *pPort = SNAPSHOT_RECORD(SnapshotPorts, iFirstPort + j);
+			if (!SNAPSHOT_RANGE(SnapshotParams, pPort, 0)) {
+				bValid = false;
+				break;
+			}
+			lists.append(pPort);
+		}
+		for (int k = 0; bValid && k < lists.count(); ++k) {
+			const uchar *pList = lists.at(k);
+			const quint32 iFirst = snapshotGet(pList, 0);
+			const quint32 iCount = snapshotGet(pList, 1);
+			QList<ParamItem> params;
+			for (quint32 j = 0; j < iCount; ++j) {
+				const uchar *pParam = SNAPSHOT_RECORD(SnapshotParams, iFirst + j);
+				ParamItem param;
+				param.sKey = SNAPSHOT_STRING(pParam, 0);
+				param.sValue = SNAPSHOT_STRING(pParam, 1);
+				param.bFix = (snapshotGet(pParam, 2) & SnapshotFix);
+				params.append(param);
+			}
+			if (k == 0)
+				device.params = params;
+			else
+				device.ports.append(params);
+		}
+		if (snapshotGet(pRecord, 0) == 0)
+			m_audioDevices.append(device);
+		else
+			m_midiDevices.append(device);
+	}
+
+	// MIDI instrument maps and their entries...
+	for (quint32 i = 0; bValid && i < counts[SnapshotMaps]; ++i) {
+		const uchar *pRecord = SNAPSHOT_RECORD(SnapshotMaps, i);
+		if (!SNAPSHOT_RANGE(SnapshotInstruments, pRecord, 2)) {
+			bValid = false;
+			break;
+		}
+		MapItem map;
+		map.iMidiMap = int(snapshotGet(pRecord, 0));
+		map.sName = SNAPSHOT_STRING(pRecord, 1);
+		const quint32 iFirst = snapshotGet(pRecord, 2);
+		const quint32 iCount = snapshotGet(pRecord, 3);
+		map.instruments.reserve(iCount);
+		for (quint32 j = 0; j < iCount; ++j) {
+			const uchar *pInstr = SNAPSHOT_RECORD(SnapshotInstruments, iFirst + j);
+			InstrumentItem instr;
+			instr.iBank = int(snapshotGet(pInstr, 0));
+			instr.iProg = int(snapshotGet(pInstr, 1));
+			instr.sEngineName = SNAPSHOT_STRING(pInstr, 2);
+			instr.sInstrumentFile = SNAPSHOT_STRING(pInstr, 3);
+			instr.iInstrumentNr = int(snapshotGet(pInstr, 4));
+			instr.fVolume = snapshotGetFloat(pInstr, 5);
+			instr.iLoadMode = int(snapshotGet(pInstr, 6));
+			instr.sName = SNAPSHOT_STRING(pInstr, 7);
+			instr.bNonModal = (iVersion > 1
+				&& (snapshotGet(pInstr, 8) & SnapshotNonModal));
+			map.instruments.append(instr);
+		}
+		m_instrumentMaps.append(map);
+	}
+
+	// Channels, their audio routing and effect sends...
+	for (quint32 i = 0; bValid && i < counts[SnapshotChannels]; ++i) {
+		const uchar *pRecord = SNAPSHOT_RECORD(SnapshotChannels, i);
+		if (!SNAPSHOT_RANGE(SnapshotRoutes, pRecord, 14)
+			|| !SNAPSHOT_RANGE(SnapshotFxSends, pRecord, 16)) {
+			bValid = false;
+			break;
+		}
+		ChannelItem channel;
+		channel.iChannelID = int(snapshotGet(pRecord, 0));
+		channel.sAudioDriver = SNAPSHOT_STRING(pRecord, 1);
+		channel.iAudioDevice = int(snapshotGet(pRecord, 2));
+		channel.sMidiDriver = SNAPSHOT_STRING(pRecord, 3);
+		channel.iMidiDevice = int(snapshotGet(pRecord, 4));
+		channel.iMidiPort = int(snapshotGet(pRecord, 5));
+		channel.iMidiChannel = int(snapshotGet(pRecord, 6));
+		channel.sEngineName = SNAPSHOT_STRING(pRecord, 7);
+		channel.sInstrumentFile = SNAPSHOT_STRING(pRecord, 8);
+		channel.iInstrumentNr = int(snapshotGet(pRecord, 9));
+		channel.iInstrumentStatus = int(snapshotGet(pRecord, 10));
+		channel.fVolume = snapshotGetFloat(pRecord, 11);
+		const quint32 iChannelFlags = snapshotGet(pRecord, 12);
+		channel.bMute = (iChannelFlags & SnapshotMute);
+		channel.bSolo = (iChannelFlags & SnapshotSolo);
+		channel.bNonModal = (iVersion < 2 || (iChannelFlags & SnapshotNonModal));
+		channel.iMidiMap = int(snapshotGet(pRecord, 13));
+		const quint32 iFirstRoute = snapshotGet(pRecord, 14);
+		const quint32 iRoutes = snapshotGet(pRecord, 15);
+		for (quint32 j = 0; j < iRoutes; ++j) {
+			const uchar *pRoute = SNAPSHOT_RECORD(SnapshotRoutes, iFirstRoute + j);
+			channel.audioRouting[int(snapshotGet(pRoute, 0))]
+				= int(snapshotGet(pRoute, 1));
+		}
+		const quint32 iFirstFxSend = snapshotGet(pRecord, 16);
+		const quint32 iFxSends = snapshotGet(pRecord, 17);
+		for (quint32 j = 0; bValid && j < iFxSends; ++j) {
+			const uchar *pFxSend = SNAPSHOT_RECORD(SnapshotFxSends, iFirstFxSend + j);
+			if (!SNAPSHOT_RANGE(SnapshotRoutes, pFxSend, 2)) {
+				bValid = false;
+				break;
+			}
+			FxSendItem fxsend;
+			fxsend.iMidiController = int(snapshotGet(pFxSend, 0));
+			fxsend.sName = SNAPSHOT_STRING(pFxSend, 1);
+			fxsend.fLevel = snapshotGetFloat(pFxSend, 4);
+			const quint32 iFirst = snapshotGet(pFxSend, 2);
+			const quint32 iCount = snapshotGet(pFxSend, 3);
+			for (quint32 k = 0; k < iCount; ++k) {
+				const uchar *pRoute = SNAPSHOT_RECORD(SnapshotRoutes, iFirst + k);
+				fxsend.routing.append(int(snapshotGet(pRoute, 1)));
+			}
+			channel.fxsends.append(fxsend);
+		}
+		m_channels.append(channel);
+	}
+
+	// Channel groups and their members...
+	for (quint32 i = 0; bValid && i < counts[SnapshotGroups]; ++i) {
+		const uchar *pRecord = SNAPSHOT_RECORD(SnapshotGroups, i);
+		if (!SNAPSHOT_RANGE(SnapshotMembers, pRecord, 1)) {
+			bValid = false;
+			break;
+		}
+		ChannelGroup group(SNAPSHOT_STRING(pRecord, 0));
+		const quint32 iFirst = snapshotGet(pRecord, 1);
+		const quint32 iCount = snapshotGet(pRecord, 2);
+		for (quint32 j = 0; j < iCount; ++j) {
+			const uchar *pMember = SNAPSHOT_RECORD(SnapshotMembers, iFirst + j);
+			group.addChannel(int(snapshotGet(pMember, 0)));
+		}
+		m_channelGroups.append(group);
+	}
+
+	#undef SNAPSHOT_RECORD
+	#undef SNAPSHOT_STRING
+	#undef SNAPSHOT_RANGE
+
+	if (!bValid) {
+		clear();
+		return parseError(sCorrupt);
+	}
+
+	m_fVolume = fVolume;
+	m_bVolume = (iSessionFlags & SnapshotVolume);
+	m_bReset = (iSessionFlags & SnapshotReset);
+
+	validate();
+
+	return (m_iErrors == 0);
+}
+
+
+// Session script tokenizer (single quoted strings are kept whole).
+static QStringList sessionTokens ( const QString& sLine )
+{
+	QStringList tokens;
+	QString sToken;
+
+	bool bQuote = false;
+	const int iLength = sLine.length();
+	for (int i = 0; i < iLength; ++i) {
+		const QChar ch = sLine.at(i);
+		if (bQuote && ch == '\\' && i < iLength - 1) {
+			sToken += ch;
+			sToken += sLine.at(++i);
+			continue;
+		}
+		if (ch == '\'')
+			bQuote = !bQuote;
+		else
+		if (!bQuote && ch.isSpace()) {
+			if (!sToken.isEmpty())
+				tokens.append(sToken);
+			sToken.clear();
+			continue;
+		}
+		sToken += ch;
+	}
+
+	if (!sToken.isEmpty())
+		tokens.append(sToken);
+
+	return tokens;
+}
+
+
+// Strip the single quotes off a session script token
+// (escape sequences are kept as written, see sessionQuote).
+static QString sessionUnquote ( const QString& sToken )
+{
+	if (sToken.length() > 1
+		&& sToken.startsWith('\'') && sToken.endsWith('\''))
+		return sToken.mid(1, sToken.length() - 2);
+
+	return sToken;
+}
+
+
+// Whether a session script token is a single quoted string.
+static bool sessionQuoted ( const QString& sToken )
+{
+	return sToken.startsWith('\'');
+}
+
+
+// Parse a key='value' session script token.
+static bool sessionParam ( const QString& sToken,
+	SessionSnapshot::ParamItem& param )
+{
+	const int iEqual = sToken.indexOf('=');
+	if (iEqual < 1)
+		return false;
+
+	param.sKey   = sToken.left(iEqual).toUpper();
+	param.sValue = sessionUnquote(sToken.mid(iEqual + 1));
+	param.bFix   = false;
+
+	return true;
+}
+
+
+// Set a parameter value in a list, replacing any former one;
+// returns false if there was one already.
+static bool setParamItem ( QList<SessionSnapshot::ParamItem>& params,
+	const SessionSnapshot::ParamItem& param )
+{
+	QMutableListIterator<SessionSnapshot::ParamItem> iter(params);
+	while (iter.hasNext()) {
+		SessionSnapshot::ParamItem& other = iter.next();
+		if (other.sKey == param.sKey) {
+			other = param;
+			return false;
+		}
+	}
+
+	params.append(param);
+	return true;
+}
+
+
+// Reset to an empty session state.
+void SessionSnapshot::clear (void)
+{
+	m_audioDevices.clear();
+	m_midiDevices.clear();
+	m_instrumentMaps.clear();
+	m_channels.clear();
+	m_channelGroups.clear();
+
+	m_fVolume = 1.0f;
+	m_bVolume = false;
+	m_bReset = false;
+}
+
+
+// Parse one single session script line.
+bool SessionSnapshot::parseLine ( const QString& sLine )
+{
+	// Channel groups are special comments...
+	if (ChannelGroup::isSessionLine(sLine)) {
+		ChannelGroup group;
+		if (!group.fromSessionLine(sLine))
+			return false;
+		m_channelGroups.append(group);
+		return true;
+	}
+
+	// Commented out commands are still meaningful,
+	// as long as they're the ones we do write so...
+	QString sCommand = sLine;
+	const bool bComment = sCommand.startsWith('#');
+	if (bComment)
+		sCommand.remove(0, 1);
+
+	const QStringList& args = sessionTokens(sCommand);
+	const int iArgs = args.count();
+	if (iArgs < 1)
+		return true;
+
+	const QString& sVerb = args.at(0).toUpper();
+	const QString& sNoun = (iArgs > 1 ? args.at(1).toUpper() : QString());
+
+	if (bComment
+		&& !(sVerb == "LOAD" && sNoun == "INSTRUMENT")
+		&& !(sVerb == "SET" && sNoun == "AUDIO_OUTPUT_CHANNEL_PARAMETER")
+		&& !(sVerb == "SET" && sNoun == "MIDI_INPUT_PORT_PARAMETER"))
+		return true;
+
+	// RESET (anything before is dead now)
+	if (sVerb == "RESET" && iArgs == 1) {
+		clear();
+		m_bReset = true;
+		m_slots.clear();
+		m_commands.clear();
+		return true;
+	}
+
+	// CREATE AUDIO_OUTPUT_DEVICE|MIDI_INPUT_DEVICE <driver> [<key>=<value> ...]
+	if (sVerb == "CREATE" && iArgs > 2
+		&& (sNoun == "AUDIO_OUTPUT_DEVICE" || sNoun == "MIDI_INPUT_DEVICE")) {
+		const bool bAudio = (sNoun == "AUDIO_OUTPUT_DEVICE");
+		QList<DeviceItem>& devices = (bAudio ? m_audioDevices : m_midiDevices);
+		DeviceItem device;
+		device.iDeviceID = devices.count();
+		device.sTypeName = (bAudio ? QObject::tr("Audio") : QObject::tr("MIDI"));
+		device.sDriverName = args.at(2);
+		for (int i = 3; i < iArgs; ++i) {
+			// Empty ones were commented out, inline...
+			if (args.at(i) == "#")
+				continue;
+			ParamItem param;
+			if (!sessionParam(args.at(i), param))
+				return false;
+			if (!setParamItem(device.params, param)) {
+				parseWarning(QObject::tr("duplicate device parameter: %1")
+					.arg(param.sKey), m_iLine);
+				++m_iDeadCommands;
+			}
+		}
+		devices.append(device);
+		return true;
+	}
+
+	// SET AUDIO_OUTPUT_CHANNEL_PARAMETER|MIDI_INPUT_PORT_PARAMETER
+	//     <device> <port> <key>=<value>
+	if (sVerb == "SET" && iArgs == 5
+		&& (sNoun == "AUDIO_OUTPUT_CHANNEL_PARAMETER"
+			|| sNoun == "MIDI_INPUT_PORT_PARAMETER")) {
+		DeviceItem *pDevice = deviceItem(
+			sNoun == "AUDIO_OUTPUT_CHANNEL_PARAMETER"
+				? m_audioDevices : m_midiDevices, args.at(2).toInt());
+		if (pDevice == nullptr)
+			return parseError(QObject::tr("unknown device: %1").arg(args.at(2)));
+		const int iPort = args.at(3).toInt();
+		ParamItem param;
+		if (iPort < 0 || !sessionParam(args.at(4), param))
+			return false;
+		// Commented out but not empty, it's a fixed one...
+		param.bFix = (bComment && !param.sValue.isEmpty());
+		if (!bComment) {
+			parseSlot(sVerb + ' ' + sNoun + ' ' + args.at(2) + ' '
+				+ args.at(3) + ' ' + param.sKey, param.sValue);
+		}
+		while (pDevice->ports.count() <= iPort)
+			pDevice->ports.append(QList<ParamItem> ());
+		setParamItem(pDevice->ports[iPort], param);
+		return true;
+	}
+
+	// ADD MIDI_INSTRUMENT_MAP [<name>]
+	if (sVerb == "ADD" && sNoun == "MIDI_INSTRUMENT_MAP" && iArgs < 4) {
+		MapItem map;
+		map.iMidiMap = m_instrumentMaps.count();
+		if (iArgs > 2)
+			map.sName = sessionUnquote(args.at(2));
+		QListIterator<MapItem> iter(m_instrumentMaps);
+		while (iter.hasNext()) {
+			const MapItem& other = iter.next();
+			if (!map.sName.isEmpty() && other.sName == map.sName) {
+				parseWarning(QObject::tr("duplicate MIDI instrument map name: %1")
+					.arg(map.sName), m_iLine);
+				break;
+			}
+		}
+		m_instrumentMaps.append(map);
+		return true;
+	}
+
+	// MAP MIDI_INSTRUMENT [NON_MODAL] <map> <bank> <prog> <engine>
+	//     <file> <nr> <volume> [<load-mode>] [<name>]
+	if (sVerb == "MAP" && sNoun == "MIDI_INSTRUMENT") {
+		int i = 2;
+		const bool bNonModal
+			= (i < iArgs && args.at(i).toUpper() == "NON_MODAL");
+		if (bNonModal)
+			++i;
+		if (iArgs - i < 7)
+			return false;
+		MapItem *pMap = mapItem(args.at(i).toInt());
+		if (pMap == nullptr)
+			return parseError(
+				QObject::tr("unknown MIDI instrument map: %1").arg(args.at(i)));
+		const QString sSlot = sVerb + ' ' + sNoun + ' ' + args.at(i)
+			+ ' ' + args.at(i + 1) + ' ' + args.at(i + 2);
+		const QString sValue = QStringList(args.mid(i + 3)).join(' ');
+		++i;
+		InstrumentItem instr;
+		instr.iBank = args.at(i++).toInt();
+		instr.iProg = args.at(i++).toInt();
+		instr.sEngineName = args.at(i++);
+		instr.sInstrumentFile = sessionUnquote(args.at(i++));
+		instr.iInstrumentNr = args.at(i++).toInt();
+		instr.fVolume = args.at(i++).toFloat();
+		instr.iLoadMode = LSCP_LOAD_DEFAULT;
+		instr.bNonModal = bNonModal;
+		if (i < iArgs && !sessionQuoted(args.at(i))) {
+			const QString& sLoadMode = args.at(i++).toUpper();
+			if (sLoadMode == "PERSISTENT")
+				instr.iLoadMode = LSCP_LOAD_PERSISTENT;
+			else
+			if (sLoadMode == "ON_DEMAND_HOLD")
+				instr.iLoadMode = LSCP_LOAD_ON_DEMAND_HOLD;
+			else
+			if (sLoadMode == "ON_DEMAND")
+				instr.iLoadMode = LSCP_LOAD_ON_DEMAND;
+			else
+				return false;
+		}
+		if (i < iArgs)
+			instr.sName = sessionUnquote(args.at(i++));
+		if (i < iArgs)
+			return false;
+		parseSlot(sSlot, sValue);
+		// Same bank and program replaces the former one...
+		QMutableListIterator<InstrumentItem> iter(pMap->instruments);
+		while (iter.hasNext()) {
+			const InstrumentItem& other = iter.next();
+			if (other.iBank == instr.iBank && other.iProg == instr.iProg)
+				iter.remove();
+		}
+		pMap->instruments.append(instr);
+		return true;
+	}
+
+	// ADD CHANNEL
+	if (sVerb == "ADD" && sNoun == "CHANNEL" && iArgs == 2) {
+		ChannelItem channel;
+		channel.iChannelID = m_channels.count();
+		channel.iAudioDevice = -1;
+		channel.iMidiDevice = -1;
+		channel.iMidiPort = 0;
+		channel.iMidiChannel = 0;
+		channel.iInstrumentNr = 0;
+		channel.iInstrumentStatus = -1;
+		channel.bNonModal = false;
+		channel.fVolume = 1.0f;
+		channel.bMute = false;
+		channel.bSolo = false;
+		channel.iMidiMap = -1;
+		m_channels.append(channel);
+		return true;
+	}
+
+	// LOAD ENGINE <engine> <channel>
+	if (sVerb == "LOAD" && sNoun == "ENGINE" && iArgs == 4) {
+		ChannelItem *pChannel = channelItem(args.at(3).toInt());
+		if (pChannel == nullptr)
+			return parseError(QObject::tr("unknown channel: %1").arg(args.at(3)));
+		parseSlot(sVerb + ' ' + sNoun + ' ' + args.at(3), args.at(2).toUpper());
+		pChannel->sEngineName = args.at(2);
+		return true;
+	}
+
+	// LOAD INSTRUMENT [NON_MODAL] <file> <nr> <channel>
+	if (sVerb == "LOAD" && sNoun == "INSTRUMENT") {
+		int i = 2;
+		const bool bNonModal
+			= (i < iArgs && args.at(i).toUpper() == "NON_MODAL");
+		if (bNonModal)
+			++i;
+		if (iArgs - i != 3)
+			return false;
+		ChannelItem *pChannel = channelItem(args.at(i + 2).toInt());
+		if (pChannel == nullptr)
+			return parseError(QObject::tr("unknown channel: %1").arg(args.at(i + 2)));
+		if (!bComment) {
+			parseSlot(sVerb + ' ' + sNoun + ' ' + args.at(i + 2),
+				args.at(i) + ' ' + args.at(i + 1));
+		}
+		pChannel->sInstrumentFile = sessionUnquote(args.at(i));
+		pChannel->iInstrumentNr = args.at(i + 1).toInt();
+		pChannel->bNonModal = bNonModal;
+		// Commented out when it wasn't fully loaded...
+		pChannel->iInstrumentStatus = (bComment ? 0 : 100);
+		return true;
+	}
+
+	// SET CHANNEL <key> <channel> <args...>
+	if (sVerb == "SET" && sNoun == "CHANNEL" && iArgs > 4) {
+		const QString& sKey = args.at(2).toUpper();
+		ChannelItem *pChannel = channelItem(args.at(3).toInt());
+		if (pChannel == nullptr)
+			return parseError(QObject::tr("unknown channel: %1").arg(args.at(3)));
+		const QString& sValue = args.at(4);
+		// Device and driver type settings do override each other...
+		QString sSlot = sVerb + ' ' + sNoun + ' ';
+		if (sKey == "AUDIO_OUTPUT_TYPE")
+			sSlot += "AUDIO_OUTPUT_DEVICE";
+		else
+		if (sKey == "MIDI_INPUT_TYPE")
+			sSlot += "MIDI_INPUT_DEVICE";
+		else
+			sSlot += sKey;
+		sSlot += ' ' + args.at(3);
+		if (sKey == "AUDIO_OUTPUT_CHANNEL" && iArgs == 6) {
+			parseSlot(sSlot + ' ' + sValue, args.at(5));
+			pChannel->audioRouting[sValue.toInt()] = args.at(5).toInt();
+			return true;
+		}
+		if (iArgs != 5)
+			return false;
+		if (sKey == "AUDIO_OUTPUT_DEVICE") {
+			if (deviceItem(m_audioDevices, sValue.toInt()) == nullptr)
+				return parseError(QObject::tr("unknown audio device: %1").arg(sValue));
+			pChannel->iAudioDevice = sValue.toInt();
+		}
+		else
+		if (sKey == "AUDIO_OUTPUT_TYPE") {
+			pChannel->sAudioDriver = sValue;
+			pChannel->iAudioDevice = -1;
+		}
+		else
+		if (sKey == "MIDI_INPUT_DEVICE") {
+			if (deviceItem(m_midiDevices, sValue.toInt()) == nullptr)
+				return parseError(QObject::tr("unknown MIDI device: %1").arg(sValue));
+			pChannel->iMidiDevice = sValue.toInt();
+		}
+		else
+		if (sKey == "MIDI_INPUT_TYPE") {
+			pChannel->sMidiDriver = sValue;
+			pChannel->iMidiDevice = -1;
+		}
+		else
+		if (sKey == "MIDI_INPUT_PORT")
+			pChannel->iMidiPort = sValue.toInt();
+		else
+		if (sKey == "MIDI_INPUT_CHANNEL") {
+			pChannel->iMidiChannel = (sValue.toUpper() == "ALL"
+				? LSCP_MIDI_CHANNEL_ALL : sValue.toInt());
+		}
+		else
+		if (sKey == "VOLUME")
+			pChannel->fVolume = sValue.toFloat();
+		else
+		if (sKey == "MUTE")
+			pChannel->bMute = (sValue.toInt() > 0);
+		else
+		if (sKey == "SOLO")
+			pChannel->bSolo = (sValue.toInt() > 0);
+		else
+		if (sKey == "MIDI_INSTRUMENT_MAP") {
+			const QString& sMidiMap = sValue.toUpper();
+			if (sMidiMap == "NONE")
+				pChannel->iMidiMap = -1;
+			else
+		#ifdef CONFIG_MIDI_INSTRUMENT
+			if (sMidiMap == "DEFAULT")
+				pChannel->iMidiMap = LSCP_MIDI_MAP_DEFAULT;
+			else
+		#endif
+			if (mapItem(sValue.toInt()) == nullptr)
+				return parseError(
+					QObject::tr("unknown MIDI instrument map: %1").arg(sValue));
+			else
+				pChannel->iMidiMap = sValue.toInt();
+		}
+		else return false;
+		parseSlot(sSlot, sKey + ' ' + sValue.toUpper());
+		return true;
+	}
+
+	// CREATE FX_SEND <channel> <midi-ctrl> [<name>]
+	if (sVerb == "CREATE" && sNoun == "FX_SEND" && iArgs > 3 && iArgs < 6) {
+		ChannelItem *pChannel = channelItem(args.at(2).toInt());
+		if (pChannel == nullptr)
+			return parseError(QObject::tr("unknown channel: %1").arg(args.at(2)));
+		FxSendItem fxsend;
+		fxsend.iMidiController = args.at(3).toInt();
+		if (iArgs > 4)
+			fxsend.sName = sessionUnquote(args.at(4));
+		fxsend.fLevel = 1.0f;
+		pChannel->fxsends.append(fxsend);
+		return true;
+	}
+
+	// SET FX_SEND AUDIO_OUTPUT_CHANNEL <channel> <fxsend> <src> <dst>
+	// SET FX_SEND LEVEL|MIDI_CONTROLLER <channel> <fxsend> <value>
+	if (sVerb == "SET" && sNoun == "FX_SEND" && iArgs > 5) {
+		const QString& sKey = args.at(2).toUpper();
+		ChannelItem *pChannel = channelItem(args.at(3).toInt());
+		if (pChannel == nullptr)
+			return parseError(QObject::tr("unknown channel: %1").arg(args.at(3)));
+		const int iFxSend = args.at(4).toInt();
+		if (iFxSend < 0 || iFxSend >= pChannel->fxsends.count())
+			return parseError(QObject::tr("unknown effect send: %1").arg(args.at(4)));
+		FxSendItem& fxsend = pChannel->fxsends[iFxSend];
+		const QString sSlot = sVerb + ' ' + sNoun + ' ' + sKey
+			+ ' ' + args.at(3) + ' ' + args.at(4);
+		if (sKey == "AUDIO_OUTPUT_CHANNEL" && iArgs == 7) {
+			const int iAudioSrc = args.at(5).toInt();
+			if (iAudioSrc < 0)
+				return false;
+			parseSlot(sSlot + ' ' + args.at(5), args.at(6));
+			while (fxsend.routing.count() <= iAudioSrc)
+				fxsend.routing.append(0);
+			fxsend.routing[iAudioSrc] = args.at(6).toInt();
+		}
+		else
+		if (sKey == "LEVEL" && iArgs == 6) {
+			parseSlot(sSlot, args.at(5));
+			fxsend.fLevel = args.at(5).toFloat();
+		}
+		else
+		if (sKey == "MIDI_CONTROLLER" && iArgs == 6) {
+			parseSlot(sSlot, args.at(5));
+			fxsend.iMidiController = args.at(5).toInt();
+		}
+		else return false;
+		return true;
+	}
+
+	// SET VOLUME <volume>
+	if (sVerb == "SET" && sNoun == "VOLUME" && iArgs == 3) {
+		parseSlot(sVerb + ' ' + sNoun, args.at(2));
+		m_fVolume = args.at(2).toFloat();
+		m_bVolume = true;
+		return true;
+	}
+
+	// Anything else is just beyond us.
+	return false;
+}
+
+
+// Track what's been set by each command, to tell which ones
+// are overridden (or just duplicate) and therefore dead.
+void SessionSnapshot::parseSlot ( const QString& sSlot, const QString& sValue )
+{
+	QHash<QString, QPair<int, QString> >::ConstIterator iter
+		= m_slots.constFind(sSlot);
+	if (iter != m_slots.constEnd()) {
+		if (iter.value().second == sValue) {
+			parseWarning(QObject::tr("%1: duplicate of line %2")
+				.arg(sSlot).arg(iter.value().first), iter.value().first);
+		} else {
+			parseWarning(QObject::tr("%1: overridden by line %2")
+				.arg(sSlot).arg(m_iLine), iter.value().first);
+		}
+		m_commands.remove(iter.value().first);
+		++m_iDeadCommands;
+	}
+
+	m_slots.insert(sSlot, qMakePair(m_iLine, sValue));
+}
+
+
+// Parser diagnostics helpers.
+bool SessionSnapshot::parseError ( const QString& sText )
+{
+	m_diagnostics.append(QString("%1: %2: %3")
+		.arg(m_iLine).arg(QObject::tr("error")).arg(sText));
+	++m_iErrors;
+
+	return false;
+}
+
+void SessionSnapshot::parseWarning ( const QString& sText, int iLine )
+{
+	m_diagnostics.append(QString("%1: %2: %3")
+		.arg(iLine).arg(QObject::tr("warning")).arg(sText));
+	++m_iWarnings;
+}
+
+
+// Whole session sanity checks (no server needed).
+void SessionSnapshot::validate (void)
+{
+	QListIterator<ChannelItem> iter(m_channels);
+	while (iter.hasNext()) {
+		const ChannelItem& channel = iter.next();
+		const QString& sChannel = QString::number(channel.iChannelID);
+		if (channel.iAudioDevice < 0 && channel.sAudioDriver.isEmpty()) {
+			parseWarning(QObject::tr("channel %1: no audio output")
+				.arg(sChannel), 0);
+		}
+		if (channel.iMidiDevice < 0 && channel.sMidiDriver.isEmpty()) {
+			parseWarning(QObject::tr("channel %1: no MIDI input")
+				.arg(sChannel), 0);
+		}
+		if (channel.sEngineName.isEmpty()) {
+			parseWarning(QObject::tr("channel %1: no engine")
+				.arg(sChannel), 0);
+		}
+		if (channel.iInstrumentStatus >= 100
+			&& !QFileInfo(instrumentPath(channel.sInstrumentFile)).exists()) {
+			parseWarning(QObject::tr("channel %1: instrument file not found: %2")
+				.arg(sChannel).arg(channel.sInstrumentFile), 0);
+		}
+	}
+
+	QStringList names;
+	QListIterator<ChannelGroup> group_iter(m_channelGroups);
+	while (group_iter.hasNext()) {
+		const ChannelGroup& group = group_iter.next();
+		if (names.contains(group.name())) {
+			parseWarning(QObject::tr("channel group %1: duplicate name")
+				.arg(group.name()), 0);
+		}
+		names.append(group.name());
+		QListIterator<int> id_iter(group.channelIDs());
+		while (id_iter.hasNext()) {
+			const int iChannelID = id_iter.next();
+			if (channelItem(iChannelID) == nullptr) {
+				parseWarning(QObject::tr("channel group %1: unknown channel: %2")
+					.arg(group.name()).arg(iChannelID), 0);
+			}
+		}
+	}
+}
+
+
+// Parser item lookup helpers.
+SessionSnapshot::DeviceItem *SessionSnapshot::deviceItem (
+	QList<DeviceItem>& devices, int iDeviceID )
+{
+	QMutableListIterator<DeviceItem> iter(devices);
+	while (iter.hasNext()) {
+		DeviceItem& device = iter.next();
+		if (device.iDeviceID == iDeviceID)
+			return &device;
+	}
+
+	return nullptr;
+}
+
+SessionSnapshot::MapItem *SessionSnapshot::mapItem ( int iMidiMap )
+{
+	QMutableListIterator<MapItem> iter(m_instrumentMaps);
+	while (iter.hasNext()) {
+		MapItem& map = iter.next();
+		if (map.iMidiMap == iMidiMap)
+			return &map;
+	}
+
+	return nullptr;
+}
+
+SessionSnapshot::ChannelItem *SessionSnapshot::channelItem ( int iChannelID )
+{
+	QMutableListIterator<ChannelItem> iter(m_channels);
+	while (iter.hasNext()) {
+		ChannelItem& channel = iter.next();
+		if (channel.iChannelID == iChannelID)
+			return &channel;
+	}
+
+	return nullptr;
+}
+
+
+// Accessors.
+const QString& SessionSnapshot::filename (void) const
+{
+	return m_sFilename;
+}
+
+void SessionSnapshot::setFilename ( const QString& sFilename )
+{
+	m_sFilename = sFilename;
+}
+
+int SessionSnapshot::errors (void) const
+{
+	return m_iErrors;
+}
+
+int SessionSnapshot::dirtyCount (void) const
+{
+	return m_iDirtyCount;
+}
+
+
+// Parser diagnostics.
+const QStringList& SessionSnapshot::diagnostics (void) const
+{
+	return m_diagnostics;
+}
+
+int SessionSnapshot::warnings (void) const
+{
+	return m_iWarnings;
+}
+
+int SessionSnapshot::deadCommands (void) const
+{
+	return m_iDeadCommands;
+}
+
+
+// Whether it's a whole session (starting from a RESET).
+bool SessionSnapshot::isReset (void) const
+{
+	return m_bReset;
+}
+
+
+// Whether the parsed script serializes back to the very same
+// live commands, in the same order (when not parsed from a script,
+// there's nothing else but the model itself to go by).
+bool SessionSnapshot::isLossless (void) const
+{
+	if (!m_bScript)
+		return true;
+
+	QStringList commands;
+	QString sScript = toScript();
+	QTextStream ts(&sScript, QIODevice::ReadOnly);
+	while (!ts.atEnd()) {
+		const QString& sLine = ts.readLine().trimmed();
+		if (!sLine.isEmpty() && !sLine.startsWith('#'))
+			commands.append(sessionTokens(sLine).join(' '));
+	}
+
+	return (commands == m_commands.values());
+}
+
+
+// Session state accessors.
+const QList<SessionSnapshot::DeviceItem>& SessionSnapshot::audioDevices (void) const
+{
+	return m_audioDevices;
+}
+
+const QList<SessionSnapshot::DeviceItem>& SessionSnapshot::midiDevices (void) const
+{
+	return m_midiDevices;
+}
+
+const QList<SessionSnapshot::MapItem>& SessionSnapshot::instrumentMaps (void) const
+{
+	return m_instrumentMaps;
+}
+
+const QList<SessionSnapshot::ChannelItem>& SessionSnapshot::channels (void) const
+{
+	return m_channels;
+}
+
+const QList<ChannelGroup>& SessionSnapshot::channelGroups (void) const
+{
+	return m_channelGroups;
+}
+
+float SessionSnapshot::volume (void) const
+{
+	return m_fVolume;
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::SessionWriter -- Session snapshot writer (worker thread).
+//
+
+// Constructor.
+SessionWriter::SessionWriter (
+	const SessionSnapshot& snapshot, QObject *pParent )
+	: QThread(pParent), m_snapshot(snapshot), m_bSaved(false)
+{
+}
+
+
+// Accessors.
+const SessionSnapshot& SessionWriter::snapshot (void) const
+{
+	return m_snapshot;
+}
+
+bool SessionWriter::isSaved (void) const
+{
+	return m_bSaved;
+}
+
+
+// The main thread executive.
+void SessionWriter::run (void)
+{
+	m_bSaved = m_snapshot.save();
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerSessionSnapshot.cpp
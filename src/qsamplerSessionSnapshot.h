@@ -0,0 +1,261 @@
+// qsamplerSessionSnapshot.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerSessionSnapshot_h
+#define __qsamplerSessionSnapshot_h
+
+#include "qsamplerChannel.h"
+#include "qsamplerChannelGroup.h"
+
+#include <QThread>
+#include <QStringList>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+
+
+namespace QSampler {
+
+class Instrument;
+
+//-------------------------------------------------------------------------
+// QSampler::SessionSnapshot -- Sampler session state, as plain data.
+//
+
+class SessionSnapshot
+{
+public:
+
+	// Constructor.
+	SessionSnapshot();
+
+	// Take the whole current session state, in one go (main thread).
+	bool take(const QString& sFilename);
+
+	// Serialize as a LSCP session script (any thread).
+	QString toScript() const;
+
+	// Write it down atomically (temp file + rename; any thread);
+	// as a binary snapshot, if so told by the file suffix.
+	bool save() const;
+
+	// Parse a LSCP session script, as far as we write it (any thread).
+	bool fromScript(const QString& sText);
+
+	// Read it up from a session file, script or binary (any thread).
+	bool load(const QString& sFilename);
+
+	// Compact binary snapshot format (any thread).
+	QByteArray toBinary(bool bCompress = true) const;
+	bool fromBinary(const QByteArray& data);
+
+	// Binary snapshot detection, by file suffix or data magic.
+	static bool isBinaryFile(const QString& sFilename);
+	static bool isBinary(const QByteArray& data);
+
+	// Instrument file path, from the script (LSCP) form to a local one.
+	static QString instrumentPath(const QString& sPath);
+
+	// Accessors.
+	const QString& filename() const;
+	void setFilename(const QString& sFilename);
+	int errors() const;
+	int dirtyCount() const;
+
+	// Parser diagnostics ("<line>: error|warning: <text>").
+	const QStringList& diagnostics() const;
+	int warnings() const;
+
+	// Number of overridden or duplicate commands found by the parser,
+	// all of which get eliminated when serialized back (compiled).
+	int deadCommands() const;
+
+	// Whether it's a whole session (starting from a RESET).
+	bool isReset() const;
+
+	// Whether the parsed script serializes back to the very same
+	// live commands, in the same order; otherwise the original
+	// script should be replayed verbatim instead (compiled).
+	bool isLossless() const;
+
+	// Device (or port) parameter.
+	struct ParamItem
+	{
+		QString sKey;
+		QString sValue;
+		bool    bFix;
+	};
+
+	// Audio or MIDI device.
+	struct DeviceItem
+	{
+		int              iDeviceID;
+		QString          sTypeName;
+		QString          sDriverName;
+		QList<ParamItem> params;
+		QList< QList<ParamItem> > ports;
+	};
+
+	// MIDI instrument map entry.
+	struct InstrumentItem
+	{
+		int     iBank;
+		int     iProg;
+		QString sEngineName;
+		QString sInstrumentFile;
+		int     iInstrumentNr;
+		float   fVolume;
+		int     iLoadMode;
+		QString sName;
+		bool    bNonModal;
+	};
+
+	// MIDI instrument map.
+	struct MapItem
+	{
+		int     iMidiMap;
+		QString sName;
+		QList<InstrumentItem> instruments;
+	};
+
+	// Channel effect send.
+	struct FxSendItem
+	{
+		int        iMidiController;
+		QString    sName;
+		QList<int> routing;
+		float      fLevel;
+	};
+
+	// Sampler channel.
+	struct ChannelItem
+	{
+		int     iChannelID;
+		QString sAudioDriver;
+		int     iAudioDevice;
+		QString sMidiDriver;
+		int     iMidiDevice;
+		int     iMidiPort;
+		int     iMidiChannel;
+		QString sEngineName;
+		QString sInstrumentFile;
+		int     iInstrumentNr;
+		int     iInstrumentStatus;
+		bool    bNonModal;
+		ChannelRoutingMap audioRouting;
+		float   fVolume;
+		bool    bMute;
+		bool    bSolo;
+		int     iMidiMap;
+		QList<FxSendItem> fxsends;
+	};
+
+	// Session state accessors.
+	const QList<DeviceItem>& audioDevices() const;
+	const QList<DeviceItem>& midiDevices() const;
+	const QList<MapItem>& instrumentMaps() const;
+	const QList<ChannelItem>& channels() const;
+	const QList<ChannelGroup>& channelGroups() const;
+	float volume() const;
+
+private:
+
+	// Snapshot helpers.
+	DeviceItem takeDevice(int iDeviceType, int iDeviceID);
+	static InstrumentItem takeInstrument(const Instrument *pInstrument);
+
+	// Parser helpers.
+	void clear();
+	bool parseLine(const QString& sLine);
+	void parseSlot(const QString& sSlot, const QString& sValue);
+	bool parseError(const QString& sText);
+	void parseWarning(const QString& sText, int iLine);
+	void validate();
+
+	DeviceItem *deviceItem(QList<DeviceItem>& devices, int iDeviceID);
+	MapItem *mapItem(int iMidiMap);
+	ChannelItem *channelItem(int iChannelID);
+
+	// Instance variables.
+	QString m_sFilename;
+
+	QList<DeviceItem>    m_audioDevices;
+	QList<DeviceItem>    m_midiDevices;
+	QList<MapItem>       m_instrumentMaps;
+	QList<ChannelItem>   m_channels;
+	QList<ChannelGroup>  m_channelGroups;
+
+	float m_fVolume;
+	bool  m_bVolume;
+	bool  m_bReset;
+
+	int m_iErrors;
+	int m_iDirtyCount;
+
+	// Parser state and diagnostics.
+	int m_iLine;
+	int m_iWarnings;
+	int m_iDeadCommands;
+
+	QStringList m_diagnostics;
+
+	QHash<QString, QPair<int, QString> > m_slots;
+
+	// Live (not dead) commands parsed so far, by line number.
+	QMap<int, QString> m_commands;
+	bool m_bScript;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::SessionWriter -- Session snapshot writer (worker thread).
+//
+
+class SessionWriter : public QThread
+{
+public:
+
+	// Constructor.
+	SessionWriter(const SessionSnapshot& snapshot, QObject *pParent = nullptr);
+
+	// Accessors.
+	const SessionSnapshot& snapshot() const;
+	bool isSaved() const;
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+private:
+
+	// Instance variables.
+	SessionSnapshot m_snapshot;
+	bool m_bSaved;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerSessionSnapshot_h
+
+
+// end of qsamplerSessionSnapshot.h
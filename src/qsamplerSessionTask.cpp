@@ -0,0 +1,171 @@
+// qsamplerSessionTask.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerSessionTask.h"
+
+#include "qsamplerMainForm.h"
+#include "qsamplerChannelGroup.h"
+#include "qsamplerSessionSnapshot.h"
+#include "qsamplerLscpStats.h"
+#include "qsamplerTrace.h"
+
+#include <QFileInfo>
+#include <QFile>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::LoadSessionTask -- Session file loader (one line per step).
+//
+
+// Constructor.
+LoadSessionTask::LoadSessionTask ( const QString& sFilename )
+	: m_sFilename(sFilename), m_bCompiled(false),
+		m_iLine(0), m_iLines(0), m_iErrors(0)
+{
+}
+
+
+// Open the session file, compiled if possible.
+bool LoadSessionTask::open (void)
+{
+	QSAMPLER_TRACE("session", "LoadSessionTask::open");
+
+	QFile file(m_sFilename);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	const QByteArray& data = file.readAll();
+	file.close();
+
+	// Whenever we fully understand it, send it over as compiled,
+	// without any dead (overridden or duplicate) commands, unless
+	// that would lose or reorder anything; binary snapshots can
+	// only be sent over as compiled, of course...
+	SessionSnapshot session;
+	const bool bBinary = SessionSnapshot::isBinary(data);
+	if (bBinary)
+		m_bCompiled = session.fromBinary(data);
+	else {
+		m_sScript = QString::fromUtf8(data);
+		m_bCompiled = (session.fromScript(m_sScript) && session.isLossless());
+	}
+
+	if (m_bCompiled || bBinary) {
+		MainForm *pMainForm = MainForm::getInstance();
+		if (pMainForm) {
+			const QString& sName = QFileInfo(m_sFilename).fileName();
+			QStringListIterator iter(session.diagnostics());
+			while (iter.hasNext()) {
+				pMainForm->appendMessagesColor(
+					sName + ':' + iter.next(), "#996633");
+			}
+			if (session.deadCommands() > 0) {
+				pMainForm->appendMessages(
+					QObject::tr("%1: %2 dead commands eliminated.")
+					.arg(sName).arg(session.deadCommands()));
+			}
+		}
+	}
+
+	if (m_bCompiled)
+		m_sScript = session.toScript();
+	else if (bBinary)
+		return false;
+
+	m_iLines = m_sScript.count('\n') + 1;
+	m_ts.setString(&m_sScript, QIODevice::ReadOnly);
+	return true;
+}
+
+
+// Read and send just one line.
+bool LoadSessionTask::step (void)
+{
+	QSAMPLER_TRACE("session", "LoadSessionTask::step");
+
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr || pMainForm->client() == nullptr)
+		return false;
+
+	if (m_ts.atEnd())
+		return false;
+
+	// Read the line.
+	QString sCommand = m_ts.readLine().trimmed();
+	m_iLine++;
+	// Channel groups are our own special comments...
+	if (ChannelGroup::isSessionLine(sCommand)) {
+		ChannelGroup *pChannelGroup = new ChannelGroup();
+		if (pChannelGroup->fromSessionLine(sCommand))
+			pMainForm->m_channelGroups.append(pChannelGroup);
+		else
+			delete pChannelGroup;
+	}
+	// If not empty, nor a comment, call the server...
+	else if (!sCommand.isEmpty() && sCommand[0] != '#') {
+		// Remember that, no matter what,
+		// all LSCP commands are CR/LF terminated.
+		sCommand += "\r\n";
+		if (LscpStats::query(pMainForm->client(),
+				sCommand.toUtf8().constData()) != LSCP_OK) {
+			// Line numbers only make sense on the original...
+			if (m_bCompiled) {
+				pMainForm->appendMessagesColor(QString("%1: %2")
+					.arg(QFileInfo(m_sFilename).fileName())
+					.arg(sCommand.simplified()), "#996633");
+			} else {
+				pMainForm->appendMessagesColor(QString("%1(%2): %3")
+					.arg(QFileInfo(m_sFilename).fileName()).arg(m_iLine)
+					.arg(sCommand.simplified()), "#996633");
+			}
+			pMainForm->appendMessagesClient("lscp_client_query");
+			m_iErrors++;
+		}
+	}
+
+	return !m_ts.atEnd();
+}
+
+
+// Done (or cancelled).
+void LoadSessionTask::finish (void)
+{
+	QSAMPLER_TRACE("session", "LoadSessionTask::finish");
+
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm)
+		pMainForm->loadSessionDone(m_sFilename, m_iErrors, isCancelled());
+}
+
+
+// Current progress percentage.
+int LoadSessionTask::progress (void) const
+{
+	return (m_iLines > 0 ? (100 * m_iLine) / m_iLines : 0);
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerSessionTask.cpp
@@ -0,0 +1,71 @@
+// qsamplerSessionTask.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerSessionTask_h
+#define __qsamplerSessionTask_h
+
+#include "qsamplerTask.h"
+
+#include <QTextStream>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::LoadSessionTask -- Session file loader (one line per step).
+//
+
+class LoadSessionTask : public Task
+{
+public:
+
+	// Constructor.
+	LoadSessionTask(const QString& sFilename);
+
+	// Open the session file, compiled if possible.
+	bool open();
+
+	// Task interface.
+	bool step();
+	void finish();
+	int progress() const;
+
+private:
+
+	// Instance variables.
+	QString     m_sFilename;
+	QString     m_sScript;
+	QTextStream m_ts;
+
+	bool m_bCompiled;
+
+	int m_iLine;
+	int m_iLines;
+	int m_iErrors;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerSessionTask_h
+
+
+// end of qsamplerSessionTask.h
@@ -0,0 +1,235 @@
+// qsamplerStatistics.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerStatistics.h"
+
+#include "qsamplerLscpStats.h"
+#include "qsamplerMainForm.h"
+
+#include <QTreeWidget>
+#include <QHeaderView>
+#include <QToolButton>
+#include <QLabel>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QFileDialog>
+#include <QFileInfo>
+
+
+namespace QSampler {
+
+// Statistics refresh period (msecs).
+#define QSAMPLER_STATISTICS_MSECS  1000
+
+
+//-------------------------------------------------------------------------
+// QSampler::Statistics -- LSCP statistics dockable window.
+//
+
+// Constructor.
+Statistics::Statistics ( QWidget *pParent )
+	: QDockWidget(pParent)
+{
+	// Surely a name is crucial (e.g.for storing geometry settings)
+	QDockWidget::setObjectName("qsamplerStatistics");
+
+	QWidget *pWidget = new QWidget(this);
+
+	m_pTreeWidget = new QTreeWidget(pWidget);
+	m_pTreeWidget->setRootIsDecorated(false);
+	m_pTreeWidget->setUniformRowHeights(true);
+	m_pTreeWidget->setAlternatingRowColors(true);
+	m_pTreeWidget->setSortingEnabled(true);
+	m_pTreeWidget->setSelectionMode(QAbstractItemView::NoSelection);
+
+	QStringList headers;
+	headers << tr("Command") << tr("Count") << tr("Errors")
+		<< tr("p50 (us)") << tr("p95 (us)") << tr("p99 (us)")
+		<< tr("Max (us)") << tr("Mean (us)")
+		<< tr("Bytes out") << tr("Bytes in");
+	m_pTreeWidget->setHeaderLabels(headers);
+	m_pTreeWidget->sortByColumn(0, Qt::AscendingOrder);
+
+	QHeaderView *pHeader = m_pTreeWidget->header();
+	pHeader->setDefaultAlignment(Qt::AlignLeft);
+	pHeader->setStretchLastSection(false);
+	pHeader->setSectionResizeMode(0, QHeaderView::Stretch);
+	for (int iColumn = 1; iColumn < headers.count(); ++iColumn)
+		pHeader->setSectionResizeMode(iColumn, QHeaderView::ResizeToContents);
+
+	m_pResetButton = new QToolButton(pWidget);
+	m_pResetButton->setText(tr("&Reset"));
+	m_pResetButton->setToolTip(tr("Reset all statistics"));
+
+	m_pExportButton = new QToolButton(pWidget);
+	m_pExportButton->setText(tr("&Export..."));
+	m_pExportButton->setToolTip(tr("Export statistics to CSV file"));
+
+	m_pTotalLabel = new QLabel(pWidget);
+
+	QHBoxLayout *pButtonLayout = new QHBoxLayout();
+	pButtonLayout->setContentsMargins(0, 0, 0, 0);
+	pButtonLayout->addWidget(m_pTotalLabel);
+	pButtonLayout->addStretch();
+	pButtonLayout->addWidget(m_pResetButton);
+	pButtonLayout->addWidget(m_pExportButton);
+
+	QVBoxLayout *pLayout = new QVBoxLayout(pWidget);
+	pLayout->setContentsMargins(2, 2, 2, 2);
+	pLayout->setSpacing(2);
+	pLayout->addWidget(m_pTreeWidget);
+	pLayout->addLayout(pButtonLayout);
+
+	m_timer.setInterval(QSAMPLER_STATISTICS_MSECS);
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(refresh()));
+	QObject::connect(m_pResetButton,
+		SIGNAL(clicked()),
+		SLOT(reset()));
+	QObject::connect(m_pExportButton,
+		SIGNAL(clicked()),
+		SLOT(exportCsv()));
+
+	// Prepare the dockable window stuff.
+	QDockWidget::setWidget(pWidget);
+	QDockWidget::setAllowedAreas(
+		Qt::TopDockWidgetArea | Qt::BottomDockWidgetArea);
+	QDockWidget::setMinimumHeight(120);
+
+	// Finally set the default caption and tooltip.
+	const QString& sCaption = tr("LSCP Statistics");
+	QDockWidget::setWindowTitle(sCaption);
+	QDockWidget::setToolTip(sCaption);
+}
+
+
+// Statistics table refresh.
+void Statistics::refresh (void)
+{
+	const QList<LscpStats::Row>& rows = LscpStats::rows();
+
+	// Keep the current sort order and scroll position...
+	m_pTreeWidget->setUpdatesEnabled(false);
+	m_pTreeWidget->setSortingEnabled(false);
+
+	// Reuse the existing items, as much as possible.
+	while (m_pTreeWidget->topLevelItemCount() > rows.count())
+		delete m_pTreeWidget->topLevelItem(rows.count());
+
+	quint64 iTotalCount = 0;
+	quint64 iTotalErrors = 0;
+
+	int iRow = 0;
+	QListIterator<LscpStats::Row> iter(rows);
+	while (iter.hasNext()) {
+		const LscpStats::Row& row = iter.next();
+		QTreeWidgetItem *pItem = m_pTreeWidget->topLevelItem(iRow);
+		if (pItem == nullptr) {
+			pItem = new QTreeWidgetItem(m_pTreeWidget);
+			for (int iColumn = 1; iColumn < m_pTreeWidget->columnCount(); ++iColumn)
+				pItem->setTextAlignment(iColumn, Qt::AlignRight);
+		}
+		pItem->setText(0, row.sCommand);
+		pItem->setData(1, Qt::DisplayRole, row.iCount);
+		pItem->setData(2, Qt::DisplayRole, row.iErrors);
+		pItem->setData(3, Qt::DisplayRole, row.iP50);
+		pItem->setData(4, Qt::DisplayRole, row.iP95);
+		pItem->setData(5, Qt::DisplayRole, row.iP99);
+		pItem->setData(6, Qt::DisplayRole, row.iMax);
+		pItem->setData(7, Qt::DisplayRole, row.iMean);
+		pItem->setData(8, Qt::DisplayRole, row.iBytesOut);
+		pItem->setData(9, Qt::DisplayRole, row.iBytesIn);
+		iTotalCount += row.iCount;
+		iTotalErrors += row.iErrors;
+		++iRow;
+	}
+
+	m_pTreeWidget->setSortingEnabled(true);
+	m_pTreeWidget->setUpdatesEnabled(true);
+
+	m_pTotalLabel->setText(tr("%1 calls, %2 errors.")
+		.arg(iTotalCount).arg(iTotalErrors));
+}
+
+
+// Start over.
+void Statistics::reset (void)
+{
+	LscpStats::reset();
+
+	refresh();
+}
+
+
+// Export to CSV file.
+void Statistics::exportCsv (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return;
+
+	const QString& sFilename = QFileDialog::getSaveFileName(this,
+		tr("Export LSCP Statistics"), QString(),
+		tr("CSV files") + " (*.csv)");
+	if (sFilename.isEmpty())
+		return;
+
+	QString sCsvFile = sFilename;
+	if (QFileInfo(sCsvFile).suffix().isEmpty())
+		sCsvFile += ".csv";
+
+	if (!LscpStats::saveCsv(sCsvFile)) {
+		pMainForm->appendMessagesError(
+			tr("Could not export LSCP statistics to:\n\n"
+			"\"%1\".\n\nSorry.").arg(sCsvFile));
+		return;
+	}
+
+	pMainForm->appendMessages(
+		tr("LSCP statistics exported to \"%1\".").arg(sCsvFile));
+}
+
+
+// Only refresh while visible.
+void Statistics::showEvent ( QShowEvent *pShowEvent )
+{
+	QDockWidget::showEvent(pShowEvent);
+
+	refresh();
+
+	m_timer.start();
+}
+
+
+void Statistics::hideEvent ( QHideEvent *pHideEvent )
+{
+	m_timer.stop();
+
+	QDockWidget::hideEvent(pHideEvent);
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerStatistics.cpp
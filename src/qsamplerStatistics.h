@@ -0,0 +1,82 @@
+// qsamplerStatistics.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerStatistics_h
+#define __qsamplerStatistics_h
+
+#include <QDockWidget>
+#include <QTimer>
+
+class QTreeWidget;
+class QToolButton;
+class QLabel;
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::Statistics -- LSCP statistics dockable window.
+//
+
+class Statistics : public QDockWidget
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	Statistics(QWidget *pParent);
+
+public slots:
+
+	// Statistics table refresh.
+	void refresh();
+
+	// Start over.
+	void reset();
+
+	// Export to CSV file.
+	void exportCsv();
+
+protected:
+
+	// Only refresh while visible.
+	void showEvent(QShowEvent *pShowEvent);
+	void hideEvent(QHideEvent *pHideEvent);
+
+private:
+
+	// Instance variables.
+	QTreeWidget *m_pTreeWidget;
+	QToolButton *m_pResetButton;
+	QToolButton *m_pExportButton;
+	QLabel      *m_pTotalLabel;
+
+	QTimer m_timer;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerStatistics_h
+
+
+// end of qsamplerStatistics.h
@@ -0,0 +1,203 @@
+// qsamplerTask.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerTask.h"
+#include "qsamplerTrace.h"
+
+#include <QElapsedTimer>
+
+
+namespace QSampler {
+
+// Default time budget per event loop turn (msecs).
+#define QSAMPLER_TASK_BUDGET_MSECS  20
+
+
+//-------------------------------------------------------------------------
+// QSampler::Task -- Cooperative (resumable) task interface.
+//
+
+// Constructor.
+Task::Task (void) : m_bCancelled(false)
+{
+}
+
+
+// Destructor.
+Task::~Task (void)
+{
+}
+
+
+// Called just once, when done or cancelled.
+void Task::finish (void)
+{
+}
+
+
+// Current progress percentage (0-100).
+int Task::progress (void) const
+{
+	return 0;
+}
+
+
+// Cancellation.
+void Task::cancel (void)
+{
+	m_bCancelled = true;
+}
+
+bool Task::isCancelled (void) const
+{
+	return m_bCancelled;
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::TaskScheduler -- Cooperative task runner (main thread).
+//
+
+// Constructor.
+TaskScheduler::TaskScheduler ( QObject *pParent ) : QObject(pParent),
+	m_pCurrent(nullptr), m_iBudget(QSAMPLER_TASK_BUDGET_MSECS)
+{
+	m_timer.setSingleShot(true);
+	m_timer.setInterval(0);
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(runSlot()));
+}
+
+
+// Destructor.
+TaskScheduler::~TaskScheduler (void)
+{
+	cancel();
+}
+
+
+// Time budget per event loop turn (msecs).
+void TaskScheduler::setBudget ( int iBudget )
+{
+	m_iBudget = (iBudget > 0 ? iBudget : 1);
+}
+
+int TaskScheduler::budget (void) const
+{
+	return m_iBudget;
+}
+
+
+// Queue a task, to run on next event loop turns (takes ownership).
+void TaskScheduler::start ( Task *pTask )
+{
+	const bool bBusy = isBusy();
+
+	m_tasks.append(pTask);
+
+	if (!m_timer.isActive())
+		m_timer.start();
+
+	if (!bBusy)
+		emit busyChanged(true);
+}
+
+
+// Cancel all pending tasks.
+void TaskScheduler::cancel (void)
+{
+	if (m_tasks.isEmpty())
+		return;
+
+	// Can't dispose the one currently running a step,
+	// it will be when it gets back here...
+	QMutableListIterator<Task *> iter(m_tasks);
+	while (iter.hasNext()) {
+		Task *pTask = iter.next();
+		pTask->cancel();
+		if (pTask != m_pCurrent) {
+			iter.remove();
+			finishTask(pTask);
+		}
+	}
+
+	if (m_tasks.isEmpty()) {
+		m_timer.stop();
+		emit busyChanged(false);
+	}
+}
+
+
+// Whether there's any task pending.
+bool TaskScheduler::isBusy (void) const
+{
+	return !m_tasks.isEmpty();
+}
+
+
+// Run pending tasks, for one budget worth of time.
+void TaskScheduler::runSlot (void)
+{
+	QSAMPLER_TRACE("task", "TaskScheduler::runSlot");
+
+	// Not re-entrant...
+	if (m_pCurrent)
+		return;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	while (!m_tasks.isEmpty() && timer.elapsed() < m_iBudget) {
+		Task *pTask = m_tasks.first();
+		m_pCurrent = pTask;
+		const bool bMore = (!pTask->isCancelled() && pTask->step());
+		m_pCurrent = nullptr;
+		if (!bMore || pTask->isCancelled()) {
+			m_tasks.removeAll(pTask);
+			finishTask(pTask);
+		}
+	}
+
+	if (m_tasks.isEmpty()) {
+		emit busyChanged(false);
+	} else {
+		emit progress(m_tasks.first()->progress());
+		m_timer.start();
+	}
+}
+
+
+// Finish and dispose a task.
+void TaskScheduler::finishTask ( Task *pTask )
+{
+	emit progress(100);
+
+	pTask->finish();
+	delete pTask;
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerTask.cpp
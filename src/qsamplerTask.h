@@ -0,0 +1,129 @@
+// qsamplerTask.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerTask_h
+#define __qsamplerTask_h
+
+#include <QObject>
+#include <QTimer>
+#include <QList>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::Task -- Cooperative (resumable) task interface.
+//
+
+class Task
+{
+public:
+
+	// Constructor.
+	Task();
+	// Destructor.
+	virtual ~Task();
+
+	// Do one (short) resumable step; return false when done.
+	virtual bool step() = 0;
+
+	// Called just once, when done or cancelled.
+	virtual void finish();
+
+	// Current progress percentage (0-100).
+	virtual int progress() const;
+
+	// Cancellation.
+	void cancel();
+	bool isCancelled() const;
+
+private:
+
+	// Instance variables.
+	bool m_bCancelled;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::TaskScheduler -- Cooperative task runner (main thread).
+//
+
+class TaskScheduler : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	TaskScheduler(QObject *pParent = nullptr);
+	// Destructor.
+	~TaskScheduler();
+
+	// Time budget per event loop turn (msecs).
+	void setBudget(int iBudget);
+	int budget() const;
+
+	// Queue a task, to run on next event loop turns (takes ownership).
+	void start(Task *pTask);
+
+	// Whether there's any task pending.
+	bool isBusy() const;
+
+public slots:
+
+	// Cancel all pending tasks.
+	void cancel();
+
+signals:
+
+	// Current task progress percentage.
+	void progress(int iProgress);
+
+	// Busy state notification.
+	void busyChanged(bool bBusy);
+
+protected slots:
+
+	// Run pending tasks, for one budget worth of time.
+	void runSlot();
+
+protected:
+
+	// Finish and dispose a task.
+	void finishTask(Task *pTask);
+
+private:
+
+	// Instance variables.
+	QList<Task *> m_tasks;
+
+	Task  *m_pCurrent;
+	int    m_iBudget;
+	QTimer m_timer;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerTask_h
+
+
+// end of qsamplerTask.h
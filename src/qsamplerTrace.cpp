@@ -0,0 +1,138 @@
+// qsamplerTrace.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerTrace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QMutex>
+#include <QFile>
+
+
+namespace QSampler {
+
+// Flush to file at least this often (msecs).
+#define QSAMPLER_TRACE_FLUSH_MSECS  1000
+
+
+//-------------------------------------------------------------------------
+// QSampler::Trace -- Trace-event JSON writer (Chrome/Perfetto).
+//
+// The JSON array format is used, one event per line; the closing
+// bracket is optional to both viewers, so a trace cut short by a
+// crash or a kill still opens fine, up to its last flush.
+//
+
+// The global tracing state.
+bool Trace::g_bEnabled = false;
+
+static QMutex        g_traceMutex;
+static QFile         g_traceFile;
+static QElapsedTimer g_traceTimer;
+static qint64        g_iTraceFlush = 0;
+static qint64        g_iTracePid = 0;
+
+// Small sequential thread ids, one per traced thread.
+static QAtomicInt g_iTraceThreads(0);
+static thread_local int g_iTraceTid = 0;
+
+
+// Start tracing into a file.
+bool Trace::open ( const QString& sFilename )
+{
+	QMutexLocker locker(&g_traceMutex);
+
+	if (g_traceFile.isOpen())
+		return false;
+
+	g_traceFile.setFileName(sFilename);
+	if (!g_traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	g_traceTimer.start();
+	g_iTraceFlush = 0;
+	g_iTracePid = QCoreApplication::applicationPid();
+
+	g_traceFile.write(QString("[{\"name\":\"process_name\",\"ph\":\"M\","
+		"\"pid\":%1,\"tid\":0,\"args\":{\"name\":\"%2\"}}")
+		.arg(g_iTracePid).arg(QSAMPLER_TITLE).toUtf8());
+	g_traceFile.flush();
+
+	g_bEnabled = true;
+
+	return true;
+}
+
+
+// Stop tracing, closing the file.
+void Trace::close (void)
+{
+	QMutexLocker locker(&g_traceMutex);
+
+	g_bEnabled = false;
+
+	if (g_traceFile.isOpen()) {
+		g_traceFile.write("\n]\n");
+		g_traceFile.close();
+	}
+}
+
+
+// Current trace time (usecs).
+qint64 Trace::now (void)
+{
+	return g_traceTimer.nsecsElapsed() / 1000;
+}
+
+
+// Write one complete event (span).
+void Trace::complete ( const char *pszCat, const char *pszName,
+	qint64 iStart, qint64 iDuration )
+{
+	if (g_iTraceTid == 0)
+		g_iTraceTid = g_iTraceThreads.fetchAndAddRelaxed(1) + 1;
+
+	const QByteArray& event = QString(",\n{\"name\":\"%1\",\"cat\":\"%2\","
+		"\"ph\":\"X\",\"ts\":%3,\"dur\":%4,\"pid\":%5,\"tid\":%6}")
+		.arg(pszName ? pszName : "?").arg(pszCat)
+		.arg(iStart).arg(iDuration)
+		.arg(g_iTracePid).arg(g_iTraceTid).toUtf8();
+
+	QMutexLocker locker(&g_traceMutex);
+
+	if (!g_traceFile.isOpen())
+		return;
+
+	g_traceFile.write(event);
+
+	const qint64 iNow = now() / 1000;
+	if (iNow - g_iTraceFlush > QSAMPLER_TRACE_FLUSH_MSECS) {
+		g_traceFile.flush();
+		g_iTraceFlush = iNow;
+	}
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerTrace.cpp
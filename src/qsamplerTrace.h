@@ -0,0 +1,106 @@
+// qsamplerTrace.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerTrace_h
+#define __qsamplerTrace_h
+
+#include <QtGlobal>
+
+class QString;
+
+
+// Traced scope, eg. QSAMPLER_TRACE("gui", "timerSlot");
+// names are expected to be static strings.
+#define QSAMPLER_TRACE_VAR2(line)  __qsampler_trace_ ## line
+#define QSAMPLER_TRACE_VAR(line)   QSAMPLER_TRACE_VAR2(line)
+#define QSAMPLER_TRACE(cat, name) \
+	QSampler::TraceSpan QSAMPLER_TRACE_VAR(__LINE__)(cat, name)
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::Trace -- Trace-event JSON writer (Chrome/Perfetto).
+//
+
+class Trace
+{
+public:
+
+	// Start tracing into a file.
+	static bool open(const QString& sFilename);
+
+	// Stop tracing, closing the file.
+	static void close();
+
+	// Whether tracing is on at all.
+	static bool isEnabled() { return g_bEnabled; }
+
+	// Current trace time (usecs).
+	static qint64 now();
+
+	// Write one complete event (span).
+	static void complete(const char *pszCat, const char *pszName,
+		qint64 iStart, qint64 iDuration);
+
+private:
+
+	// The global tracing state.
+	static bool g_bEnabled;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::TraceSpan -- Traced scope (a complete event, when done).
+//
+
+class TraceSpan
+{
+public:
+
+	// Constructor.
+	TraceSpan(const char *pszCat, const char *pszName)
+		: m_pszCat(pszCat), m_pszName(pszName),
+			m_iStart(Trace::isEnabled() ? Trace::now() : -1) {}
+
+	// Destructor.
+	~TraceSpan()
+	{
+		if (m_iStart >= 0 && Trace::isEnabled())
+			Trace::complete(m_pszCat, m_pszName,
+				m_iStart, Trace::now() - m_iStart);
+	}
+
+private:
+
+	// Instance variables.
+	const char *m_pszCat;
+	const char *m_pszName;
+	qint64      m_iStart;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerTrace_h
+
+
+// end of qsamplerTrace.h
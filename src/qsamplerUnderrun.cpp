@@ -0,0 +1,229 @@
+// qsamplerUnderrun.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerUnderrun.h"
+
+#include "qsamplerChannel.h"
+#include "qsamplerOptions.h"
+#include "qsamplerMainForm.h"
+
+#include <QStatusBar>
+#include <QFileInfo>
+
+#include <algorithm>
+
+
+namespace QSampler {
+
+// How long the status bar alert stays on (msecs).
+#define QSAMPLER_UNDERRUN_ALERT_MSECS  10000
+
+
+//-------------------------------------------------------------------------
+// QSampler::UnderrunDetector -- Stream buffer underrun detector.
+//
+
+// Constructor.
+UnderrunDetector::UnderrunDetector (void)
+{
+	m_iEpisodes = 0;
+}
+
+
+// Process a new channel usage sample.
+bool UnderrunDetector::process ( Channel *pChannel,
+	int iStreamCount, int iStreamUsage )
+{
+	if (pChannel == nullptr)
+		return false;
+
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return false;
+
+	Options *pOptions = pMainForm->options();
+	if (pOptions == nullptr || !pOptions->bUnderrunAlert)
+		return false;
+
+	// Fill level is meaningless without any disk streams...
+	if (iStreamCount < 1 || iStreamUsage < 0)
+		return false;
+
+	// Start over whenever the instrument changes...
+	const int iChannelID = pChannel->channelID();
+	const QString& sInstrumentFile = pChannel->instrumentFile();
+	State& state = m_states[iChannelID];
+	if (state.sInstrumentFile != sInstrumentFile) {
+		state.sInstrumentFile = sInstrumentFile;
+		state.bUnderrun = false;
+	}
+
+	const Key key(iChannelID, sInstrumentFile);
+	if (!m_counts.contains(key)) {
+		Count count;
+		count.iEpisodes   = 0;
+		count.iMinUsage   = iStreamUsage;
+		count.iSamples    = 0;
+		count.iLowSamples = 0;
+		m_counts.insert(key, count);
+	}
+
+	Count& count = m_counts[key];
+	++count.iSamples;
+	if (count.iMinUsage > iStreamUsage)
+		count.iMinUsage = iStreamUsage;
+	if (iStreamUsage <= pOptions->iUnderrunLow)
+		++count.iLowSamples;
+
+	// Hysteresis: begin low, end high...
+	if (state.bUnderrun) {
+		if (iStreamUsage >= pOptions->iUnderrunHigh)
+			state.bUnderrun = false;
+		return false;
+	}
+
+	if (iStreamUsage > pOptions->iUnderrunLow)
+		return false;
+
+	state.bUnderrun = true;
+	++count.iEpisodes;
+	++m_iEpisodes;
+
+	// Let it be known...
+	const QString sText = QObject::tr(
+		"Channel %1: stream buffer near underrun (%2%) on \"%3\".")
+		.arg(iChannelID).arg(iStreamUsage)
+		.arg(QFileInfo(sInstrumentFile).fileName());
+	pMainForm->appendMessagesColor(sText, "#cc6600");
+	pMainForm->statusBar()->showMessage(sText, QSAMPLER_UNDERRUN_ALERT_MSECS);
+
+	return true;
+}
+
+
+// Forget the current channel states (eg. on disconnect).
+void UnderrunDetector::reset (void)
+{
+	m_states.clear();
+}
+
+
+// Forget everything, episode counts included.
+void UnderrunDetector::clear (void)
+{
+	m_states.clear();
+	m_counts.clear();
+
+	m_iEpisodes = 0;
+}
+
+
+// Total number of episodes so far.
+int UnderrunDetector::episodes (void) const
+{
+	return m_iEpisodes;
+}
+
+
+// Per instrument file report item.
+struct UnderrunReportItem
+{
+	QString    sInstrumentFile;
+	QList<int> channelIDs;
+	int        iEpisodes;
+	int        iMinUsage;
+	int        iSamples;
+	int        iLowSamples;
+};
+
+static bool underrunReportLessThan (
+	const UnderrunReportItem& item1, const UnderrunReportItem& item2 )
+{
+	if (item1.iEpisodes != item2.iEpisodes)
+		return (item1.iEpisodes > item2.iEpisodes);
+	return (item1.iMinUsage < item2.iMinUsage);
+}
+
+
+// Disk-bound instruments report, worst first.
+QStringList UnderrunDetector::report (void) const
+{
+	// Sum it all up per instrument file...
+	QMap<QString, UnderrunReportItem> items;
+	QMapIterator<Key, Count> iter(m_counts);
+	while (iter.hasNext()) {
+		iter.next();
+		const Count& count = iter.value();
+		if (count.iEpisodes < 1)
+			continue;
+		const QString& sInstrumentFile = iter.key().second;
+		if (!items.contains(sInstrumentFile)) {
+			UnderrunReportItem item;
+			item.sInstrumentFile = sInstrumentFile;
+			item.iEpisodes   = 0;
+			item.iMinUsage   = count.iMinUsage;
+			item.iSamples    = 0;
+			item.iLowSamples = 0;
+			items.insert(sInstrumentFile, item);
+		}
+		UnderrunReportItem& item = items[sInstrumentFile];
+		item.channelIDs.append(iter.key().first);
+		item.iEpisodes   += count.iEpisodes;
+		item.iMinUsage    = qMin(item.iMinUsage, count.iMinUsage);
+		item.iSamples    += count.iSamples;
+		item.iLowSamples += count.iLowSamples;
+	}
+
+	QStringList lines;
+	if (items.isEmpty()) {
+		lines.append(QObject::tr("No stream buffer underruns so far."));
+		return lines;
+	}
+
+	QList<UnderrunReportItem> list = items.values();
+	std::sort(list.begin(), list.end(), underrunReportLessThan);
+
+	lines.append(QObject::tr("Stream buffer underruns, by instrument file:"));
+	QListIterator<UnderrunReportItem> list_iter(list);
+	while (list_iter.hasNext()) {
+		const UnderrunReportItem& item = list_iter.next();
+		QStringList channels;
+		QListIterator<int> channel_iter(item.channelIDs);
+		while (channel_iter.hasNext())
+			channels.append(QString::number(channel_iter.next()));
+		const int iLowPercent = (item.iSamples > 0
+			? (100 * item.iLowSamples) / item.iSamples : 0);
+		lines.append(QObject::tr(
+			"%1: %2 episode(s) on channel(s) %3, min. fill %4%, low %5% of time.")
+			.arg(item.sInstrumentFile).arg(item.iEpisodes)
+			.arg(channels.join(", ")).arg(item.iMinUsage).arg(iLowPercent));
+	}
+	lines.append(QObject::tr("The instruments above are disk-bound; "
+		"consider mapping them with the PERSISTENT load mode."));
+
+	return lines;
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerUnderrun.cpp
@@ -0,0 +1,101 @@
+// qsamplerUnderrun.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerUnderrun_h
+#define __qsamplerUnderrun_h
+
+#include <QStringList>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+
+
+namespace QSampler {
+
+class Channel;
+
+//-------------------------------------------------------------------------
+// QSampler::UnderrunDetector -- Stream buffer underrun detector.
+//
+// Watches the least stream buffer fill of each channel, as refreshed,
+// and counts the near-underrun episodes per channel and instrument file:
+// an episode begins when the fill drops to the low threshold and only
+// ends when it gets back to the high threshold (hysteresis).
+//
+
+class UnderrunDetector
+{
+public:
+
+	// Constructor.
+	UnderrunDetector();
+
+	// Process a new channel usage sample (only ever fed
+	// by the channel's own usage poll, once per refresh);
+	// returns true if a new episode has just begun.
+	bool process(Channel *pChannel, int iStreamCount, int iStreamUsage);
+
+	// Forget the current channel states (eg. on disconnect).
+	void reset();
+
+	// Forget everything, episode counts included.
+	void clear();
+
+	// Total number of episodes so far.
+	int episodes() const;
+
+	// Disk-bound instruments report, worst first.
+	QStringList report() const;
+
+private:
+
+	// Per channel current state.
+	struct State
+	{
+		QString sInstrumentFile;
+		bool    bUnderrun;
+	};
+
+	// Per channel and instrument file counters.
+	struct Count
+	{
+		int iEpisodes;
+		int iMinUsage;
+		int iSamples;
+		int iLowSamples;
+	};
+
+	typedef QPair<int, QString> Key;
+
+	// Instance variables.
+	QHash<int, State> m_states;
+	QMap<Key, Count>  m_counts;
+
+	int m_iEpisodes;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerUnderrun_h
+
+
+// end of qsamplerUnderrun.h
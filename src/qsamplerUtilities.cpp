@@ -24,6 +24,7 @@
 
 #include "qsamplerOptions.h"
 #include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
 
 #include <QRegularExpression>
 
@@ -225,7 +226,7 @@ lscpVersion_t getRemoteLscpVersion (void)
         return result;
 
     lscp_server_info_t* pServerInfo =
-        ::lscp_get_server_info(pMainForm->client());
+        QSAMPLER_LSCP(lscp_get_server_info, pMainForm->client());
     if (pServerInfo && pServerInfo->protocol_version)
         ::sscanf(pServerInfo->protocol_version, "%d.%d",
             &result.major, &result.minor);
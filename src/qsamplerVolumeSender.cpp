@@ -0,0 +1,333 @@
+// qsamplerVolumeSender.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerVolumeSender.h"
+
+#include "qsamplerChannel.h"
+#include "qsamplerMainForm.h"
+#include "qsamplerLscpStats.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+
+namespace QSampler {
+
+// Minimum period between sends (msecs).
+#define QSAMPLER_VOLUME_SEND_MSECS     20
+
+// Idle time after which a gesture is over (msecs).
+#define QSAMPLER_VOLUME_GESTURE_MSECS  300
+
+
+//-------------------------------------------------------------------------
+// QSampler::VolumeSenderThread -- Volume control sender (worker thread).
+//
+
+// Sender connection callback (no events subscribed).
+static lscp_status_t qsampler_volume_callback ( lscp_client_t */*pClient*/,
+	lscp_event_t /*event*/, const char */*pchData*/, int /*cchData*/,
+	void */*pvData*/ )
+{
+	return LSCP_OK;
+}
+
+
+class VolumeSenderThread : public QThread
+{
+public:
+
+	// Constructor.
+	VolumeSenderThread(QObject *pParent = nullptr)
+		: QThread(pParent), m_iPort(0), m_iTimeout(0), m_pClient(nullptr),
+			m_bConnect(false), m_bRunning(false), m_bSending(false),
+			m_iErrors(0) {}
+
+	// Server to connect to, on its very own client connection,
+	// so that nothing of the GUI one is ever shared across threads;
+	// never waits, whatever's pending still goes to the old one.
+	void setServer(const QString& sHost, int iPort, int iTimeout)
+	{
+		QMutexLocker locker(&m_mutex);
+		QMapIterator<int, float> iter(m_pending);
+		while (iter.hasNext()) {
+			iter.next();
+			m_draining.insert(iter.key(), iter.value());
+		}
+		m_pending.clear();
+		m_sHost = sHost;
+		m_iPort = iPort;
+		m_iTimeout = iTimeout;
+		m_bConnect = true;
+		m_cond.wakeAll();
+	}
+
+	// Queue a volume change (latest value wins).
+	void setVolume(int iTarget, float fVolume)
+	{
+		QMutexLocker locker(&m_mutex);
+		m_pending.insert(iTarget, fVolume);
+		m_cond.wakeAll();
+	}
+
+	// Wait for all pending changes to get through.
+	void flush()
+	{
+		QMutexLocker locker(&m_mutex);
+		while (!m_pending.isEmpty() || !m_draining.isEmpty()
+			|| m_bSending || m_bConnect)
+			m_done.wait(&m_mutex);
+	}
+
+	// Errors since last asked.
+	int takeErrors()
+	{
+		QMutexLocker locker(&m_mutex);
+		const int iErrors = m_iErrors;
+		m_iErrors = 0;
+		return iErrors;
+	}
+
+	// Stop and wait for it.
+	void stop()
+	{
+		m_mutex.lock();
+		m_bRunning = false;
+		m_cond.wakeAll();
+		m_mutex.unlock();
+		QThread::wait();
+	}
+
+protected:
+
+	// The main thread executive.
+	void run()
+	{
+		m_mutex.lock();
+		m_bRunning = true;
+		while (m_bRunning) {
+			// Changes due to the old server go through first...
+			if (!m_draining.isEmpty()) {
+				const QMap<int, float> draining = m_draining;
+				m_draining.clear();
+				if (m_pClient)
+					send(draining);
+				continue;
+			}
+			// (Re)connect, out of the lock as it may block...
+			if (m_bConnect) {
+				const QString sHost = m_sHost;
+				const int iPort = m_iPort;
+				const int iTimeout = m_iTimeout;
+				lscp_client_t *pClient = m_pClient;
+				m_pClient = nullptr;
+				m_mutex.unlock();
+				if (pClient)
+					::lscp_client_destroy(pClient);
+				pClient = nullptr;
+				if (!sHost.isEmpty()) {
+					pClient = ::lscp_client_create(
+						sHost.toUtf8().constData(), iPort,
+						qsampler_volume_callback, nullptr);
+					if (pClient)
+						::lscp_client_set_timeout(pClient, iTimeout);
+				}
+				m_mutex.lock();
+				m_pClient = pClient;
+				// Unless asked for yet another one meanwhile...
+				if (m_sHost == sHost && m_iPort == iPort
+					&& m_iTimeout == iTimeout)
+					m_bConnect = false;
+				continue;
+			}
+			// Nowhere to send to? drop them...
+			if (m_pClient == nullptr && !m_pending.isEmpty()) {
+				if (!m_sHost.isEmpty())
+					m_iErrors += m_pending.count();
+				m_pending.clear();
+			}
+			// Wait for something to send...
+			if (m_pending.isEmpty()) {
+				m_done.wakeAll();
+				m_cond.wait(&m_mutex);
+				continue;
+			}
+			// Take all the latest values at once...
+			const QMap<int, float> pending = m_pending;
+			m_pending.clear();
+			send(pending);
+		}
+		if (m_pClient) {
+			::lscp_client_destroy(m_pClient);
+			m_pClient = nullptr;
+		}
+		m_done.wakeAll();
+		m_mutex.unlock();
+	}
+
+private:
+
+	// Send the given values, out of the lock (held on entry).
+	void send(const QMap<int, float>& values)
+	{
+		lscp_client_t *pClient = m_pClient;
+		m_bSending = true;
+		m_mutex.unlock();
+		int iErrors = 0;
+		QMapIterator<int, float> iter(values);
+		while (iter.hasNext()) {
+			iter.next();
+			const int iTarget = iter.key();
+			const float fVolume = iter.value();
+			lscp_status_t ret;
+			if (iTarget < 0)
+				ret = QSAMPLER_LSCP(lscp_set_volume, pClient, fVolume);
+			else
+				ret = QSAMPLER_LSCP(lscp_set_channel_volume, pClient, iTarget, fVolume);
+			if (ret != LSCP_OK)
+				++iErrors;
+		}
+		// Bounded rate...
+		QThread::msleep(QSAMPLER_VOLUME_SEND_MSECS);
+		m_mutex.lock();
+		m_iErrors += iErrors;
+		m_bSending = false;
+	}
+
+	// Instance variables.
+	QString          m_sHost;
+	int              m_iPort;
+	int              m_iTimeout;
+
+	lscp_client_t   *m_pClient;
+
+	bool             m_bConnect;
+	bool             m_bRunning;
+	bool             m_bSending;
+	int              m_iErrors;
+
+	QMap<int, float> m_pending;
+	QMap<int, float> m_draining;
+
+	QMutex           m_mutex;
+	QWaitCondition   m_cond;
+	QWaitCondition   m_done;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::VolumeSender -- Coalescing, rate-limited volume control.
+//
+
+// Constructor.
+VolumeSender::VolumeSender ( QObject *pParent ) : QObject(pParent)
+{
+	m_pThread = new VolumeSenderThread();
+	m_pThread->start();
+
+	m_timer.setSingleShot(true);
+	m_timer.setInterval(QSAMPLER_VOLUME_GESTURE_MSECS);
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(gestureSlot()));
+}
+
+
+// Destructor.
+VolumeSender::~VolumeSender (void)
+{
+	m_pThread->stop();
+	delete m_pThread;
+}
+
+
+// Server to connect to (empty host when disconnected).
+void VolumeSender::setServer ( const QString& sHost, int iPort, int iTimeout )
+{
+	// Pending changes still go to the old one, on the side...
+	m_pThread->setServer(sHost, iPort, iTimeout);
+
+	if (m_timer.isActive()) {
+		m_timer.stop();
+		gestureSlot();
+	}
+}
+
+
+// Queue a volume change, latest value wins.
+void VolumeSender::setVolume ( int iTarget, float fVolume )
+{
+	m_pThread->setVolume(iTarget, fVolume);
+
+	m_gesture.insert(iTarget, fVolume);
+	m_timer.start();
+}
+
+
+// Wait for all pending changes to get through.
+void VolumeSender::flush (void)
+{
+	m_pThread->flush();
+}
+
+
+// Gesture end (no more changes for a while).
+void VolumeSender::gestureSlot (void)
+{
+	MainForm *pMainForm = MainForm::getInstance();
+	if (pMainForm == nullptr)
+		return;
+
+	// Log just the final values...
+	QMapIterator<int, float> iter(m_gesture);
+	while (iter.hasNext()) {
+		iter.next();
+		const int iTarget = iter.key();
+		const QString sText = QObject::tr("Volume: %1.").arg(iter.value());
+		if (iTarget < 0) {
+			pMainForm->appendMessages(sText);
+			continue;
+		}
+		Channel *pChannel = pMainForm->channel(iTarget);
+		if (pChannel)
+			pChannel->appendMessages(sText);
+	}
+
+	const int iErrors = m_pThread->takeErrors();
+	if (iErrors > 0) {
+		pMainForm->appendMessagesColor(
+			QObject::tr("Volume: %1 change(s) failed.").arg(iErrors),
+			"#996666");
+	}
+
+	if (!m_gesture.isEmpty())
+		pMainForm->sessionDirty();
+
+	m_gesture.clear();
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerVolumeSender.cpp
@@ -0,0 +1,86 @@
+// qsamplerVolumeSender.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerVolumeSender_h
+#define __qsamplerVolumeSender_h
+
+#include <QObject>
+#include <QTimer>
+#include <QMap>
+
+
+namespace QSampler {
+
+class VolumeSenderThread;
+
+
+//-------------------------------------------------------------------------
+// QSampler::VolumeSender -- Coalescing, rate-limited volume control.
+//
+
+class VolumeSender : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Global (engine) volume target.
+	enum { GlobalVolume = -1 };
+
+	// Constructor.
+	VolumeSender(QObject *pParent = nullptr);
+	// Destructor.
+	~VolumeSender();
+
+	// Server to connect to, on its own client connection
+	// (empty host when disconnected).
+	void setServer(const QString& sHost, int iPort, int iTimeout);
+
+	// Queue a volume change, latest value wins;
+	// target is a sampler channel id or GlobalVolume.
+	void setVolume(int iTarget, float fVolume);
+
+	// Wait for all pending changes to get through.
+	void flush();
+
+protected slots:
+
+	// Gesture end (no more changes for a while).
+	void gestureSlot();
+
+private:
+
+	// Instance variables.
+	VolumeSenderThread *m_pThread;
+
+	QTimer m_timer;
+
+	// Latest values of the current gesture.
+	QMap<int, float> m_gesture;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerVolumeSender_h
+
+
+// end of qsamplerVolumeSender.h
@@ -15,17 +15,34 @@ HEADERS += config.h \
 	qsamplerOptions.h \
 	qsamplerChannel.h \
 	qsamplerMessages.h \
+	qsamplerStatistics.h \
+	qsamplerMetrics.h \
+	qsamplerUnderrun.h \
+	qsamplerBudgetTuner.h \
 	qsamplerInstrument.h \
 	qsamplerInstrumentList.h \
 	qsamplerDevice.h \
 	qsamplerFxSend.h \
 	qsamplerFxSendsModel.h \
 	qsamplerUtilities.h \
+	qsamplerLscpStats.h \
+	qsamplerTrace.h \
+	qsamplerMidiActivity.h \
+	qsamplerChannelMixer.h \
+	qsamplerChannelLoader.h \
+	qsamplerChannelGroup.h \
+	qsamplerVolumeSender.h \
+	qsamplerTask.h \
+	qsamplerSessionTask.h \
+	qsamplerSessionSnapshot.h \
+	qsamplerSessionDelta.h \
+	qsamplerRecording.h \
 	qsamplerInstrumentForm.h \
 	qsamplerInstrumentListForm.h \
 	qsamplerDeviceForm.h \
 	qsamplerDeviceStatusForm.h \
 	qsamplerChannelStrip.h \
+	qsamplerChannelHistory.h \
 	qsamplerChannelForm.h \
 	qsamplerChannelFxForm.h \
 	qsamplerOptionsForm.h \
@@ -37,17 +54,34 @@ SOURCES += \
 	qsamplerOptions.cpp \
 	qsamplerChannel.cpp \
 	qsamplerMessages.cpp \
+	qsamplerStatistics.cpp \
+	qsamplerMetrics.cpp \
+	qsamplerUnderrun.cpp \
+	qsamplerBudgetTuner.cpp \
 	qsamplerInstrument.cpp \
 	qsamplerInstrumentList.cpp \
 	qsamplerDevice.cpp \
 	qsamplerFxSend.cpp \
 	qsamplerFxSendsModel.cpp \
 	qsamplerUtilities.cpp \
+	qsamplerLscpStats.cpp \
+	qsamplerTrace.cpp \
+	qsamplerMidiActivity.cpp \
+	qsamplerChannelMixer.cpp \
+	qsamplerChannelLoader.cpp \
+	qsamplerChannelGroup.cpp \
+	qsamplerVolumeSender.cpp \
+	qsamplerTask.cpp \
+	qsamplerSessionTask.cpp \
+	qsamplerSessionSnapshot.cpp \
+	qsamplerSessionDelta.cpp \
+	qsamplerRecording.cpp \
 	qsamplerInstrumentForm.cpp \
 	qsamplerInstrumentListForm.cpp \
 	qsamplerDeviceForm.cpp \
 	qsamplerDeviceStatusForm.cpp \
 	qsamplerChannelStrip.cpp \
+	qsamplerChannelHistory.cpp \
 	qsamplerChannelForm.cpp \
 	qsamplerChannelFxForm.cpp \
 	qsamplerOptionsForm.cpp \
@@ -0,0 +1,666 @@
+// qsamplerBench.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerAbout.h"
+#include "qsamplerBench.h"
+
+#include "qsamplerOptions.h"
+#include "qsamplerMainForm.h"
+#include "qsamplerChannel.h"
+#include "qsamplerChannelStrip.h"
+#include "qsamplerDeviceForm.h"
+#include "qsamplerInstrumentList.h"
+#include "qsamplerUtilities.h"
+#include "qsamplerTask.h"
+#include "qsamplerSessionSnapshot.h"
+
+#include <QApplication>
+#include <QSettings>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QFile>
+#include <QtTest>
+
+
+namespace QSampler {
+
+// Number of strings to go through the LSCP codecs, per iteration.
+#define QSAMPLER_BENCH_STRINGS  1000
+
+// Give up waiting on pending tasks after this long (msecs).
+#define QSAMPLER_BENCH_TIMEOUT  600000
+
+
+//-------------------------------------------------------------------------
+// QSampler::BenchMainForm -- Main form, with its hot paths exposed.
+//
+
+class BenchMainForm : public MainForm
+{
+public:
+
+	using MainForm::startClient;
+	using MainForm::stopClient;
+	using MainForm::loadSessionFile;
+	using MainForm::saveSessionFile;
+	using MainForm::updateAllChannelStrips;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::BenchServer -- Mock LSCP server, on its own thread.
+//
+
+// Constructor.
+BenchServer::BenchServer ( const MockServer::Config& config )
+	: m_config(config), m_iPort(-1)
+{
+}
+
+
+// Start and wait for it listening; return the actual port.
+int BenchServer::startServer (void)
+{
+	start();
+
+	m_started.acquire();
+
+	return m_iPort;
+}
+
+
+// The server thread executive.
+void BenchServer::run (void)
+{
+	MockServer server(m_config);
+	if (server.start())
+		m_iPort = server.serverPort();
+
+	m_started.release();
+
+	if (m_iPort > 0)
+		exec();
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::Bench -- Headless benchmark suite (QTest).
+//
+
+// Constructor.
+Bench::Bench ( const MockServer::Config& config,
+	const QString& sJsonFile, const QString& sInstrumentFile )
+	: m_config(config), m_sJsonFile(sJsonFile),
+		m_sInstrumentFile(sInstrumentFile),
+		m_pServer(nullptr), m_pOptions(nullptr), m_pMainForm(nullptr)
+{
+}
+
+
+// Destructor.
+Bench::~Bench (void)
+{
+	cleanupTestCase();
+}
+
+
+// Suite setup: mock server, private settings, main form and client.
+void Bench::initTestCase (void)
+{
+	QVERIFY(m_tempDir.isValid());
+
+	m_pServer = new BenchServer(m_config);
+	const int iPort = m_pServer->startServer();
+	QVERIFY2(iPort > 0, "Could not start the mock LSCP server.");
+
+	// Never touch the user settings...
+	QSettings::setPath(QSettings::NativeFormat,
+		QSettings::UserScope, m_tempDir.path());
+	QSettings::setPath(QSettings::IniFormat,
+		QSettings::UserScope, m_tempDir.path());
+
+	m_pOptions = new Options();
+	m_pOptions->sServerHost = "127.0.0.1";
+	m_pOptions->iServerPort = iPort;
+	m_pOptions->iServerTimeout = QSAMPLER_BENCH_TIMEOUT;
+	m_pOptions->bServerStart = false;
+	m_pOptions->bAutoRefresh = false;
+	m_pOptions->bChannelMixer = false;
+	m_pOptions->bConfirmError = false;
+	m_pOptions->sSessionFile.clear();
+
+	m_pMainForm = new BenchMainForm();
+	m_pMainForm->setup(m_pOptions);
+	m_pMainForm->show();
+
+	QVERIFY2(m_pMainForm->startClient(), "Could not connect to the mock LSCP server.");
+	QVERIFY(waitForTasks(QSAMPLER_BENCH_TIMEOUT));
+
+	// Some tricky strings for the codecs...
+	for (int i = 0; i < QSAMPLER_BENCH_STRINGS; ++i) {
+		m_paths.append(QString("/home/user/Samples/Piano %1/Grand's Ünïcödé #%1.gig").arg(i));
+		m_texts.append(QString("Map '%1': \"Strings\" & Pads\\Layer %1").arg(i));
+	}
+}
+
+
+// Suite teardown.
+void Bench::cleanupTestCase (void)
+{
+	if (m_pMainForm) {
+		m_pMainForm->stopClient();
+		delete m_pMainForm;
+		m_pMainForm = nullptr;
+	}
+
+	if (m_pOptions) {
+		delete m_pOptions;
+		m_pOptions = nullptr;
+	}
+
+	if (m_pServer) {
+		m_pServer->quit();
+		m_pServer->wait();
+		delete m_pServer;
+		m_pServer = nullptr;
+	}
+
+	if (!m_samples.isEmpty()) {
+		saveJson();
+		m_samples.clear();
+	}
+}
+
+
+// LSCP codecs.
+void Bench::lscpEscapePath (void)
+{
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		QStringListIterator iter(m_paths);
+		while (iter.hasNext())
+			qsamplerUtilities::lscpEscapePath(iter.next());
+		sample(timer);
+	}
+}
+
+void Bench::lscpEscapedPathToPosix (void)
+{
+	QStringList paths;
+	QStringListIterator iter(m_paths);
+	while (iter.hasNext())
+		paths.append(qsamplerUtilities::lscpEscapePath(iter.next()));
+
+	QCOMPARE(qsamplerUtilities::lscpEscapedPathToPosix(paths.first()),
+		m_paths.first());
+
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		QStringListIterator path_iter(paths);
+		while (path_iter.hasNext())
+			qsamplerUtilities::lscpEscapedPathToPosix(path_iter.next());
+		sample(timer);
+	}
+}
+
+void Bench::lscpEscapeText (void)
+{
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		QStringListIterator iter(m_texts);
+		while (iter.hasNext())
+			qsamplerUtilities::lscpEscapeText(iter.next());
+		sample(timer);
+	}
+}
+
+void Bench::lscpEscapedTextToRaw (void)
+{
+	QStringList texts;
+	QStringListIterator iter(m_texts);
+	while (iter.hasNext())
+		texts.append(qsamplerUtilities::lscpEscapeText(iter.next()));
+
+	QCOMPARE(qsamplerUtilities::lscpEscapedTextToRaw(texts.first()),
+		m_texts.first());
+
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		QStringListIterator text_iter(texts);
+		while (text_iter.hasNext())
+			qsamplerUtilities::lscpEscapedTextToRaw(text_iter.next());
+		sample(timer);
+	}
+}
+
+
+// Instrument name extraction (a real instrument file may be given,
+// otherwise it's just the fallback path on a non-instrument file).
+void Bench::instrumentName (void)
+{
+	QString sInstrumentFile = m_sInstrumentFile;
+	if (sInstrumentFile.isEmpty()) {
+		sInstrumentFile = m_tempDir.filePath("bench.gig");
+		QFile file(sInstrumentFile);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write("RIFF");
+		file.close();
+	}
+
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		Channel::getInstrumentName(sInstrumentFile, 0, true);
+		sample(timer);
+	}
+}
+
+
+// Channel strips (all of them already there).
+void Bench::updateAllChannelStrips (void)
+{
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		m_pMainForm->updateAllChannelStrips(true);
+		sample(timer);
+	}
+
+	QVERIFY(m_pMainForm->channelStripAt(m_config.iChannels - 1) != nullptr);
+}
+
+void Bench::updateChannelUsage (void)
+{
+	QList<ChannelStrip *> strips;
+	for (int iChannel = 0; iChannel < m_config.iChannels; ++iChannel) {
+		ChannelStrip *pChannelStrip = m_pMainForm->channelStripAt(iChannel);
+		if (pChannelStrip)
+			strips.append(pChannelStrip);
+	}
+
+	QCOMPARE(strips.count(), m_config.iChannels);
+
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		QListIterator<Channel *> channel_iter(m_pMainForm->channels());
+		while (channel_iter.hasNext())
+			channel_iter.next()->updateChannelUsage();
+		QListIterator<ChannelStrip *> iter(strips);
+		while (iter.hasNext())
+			iter.next()->updateChannelUsage();
+		sample(timer);
+	}
+}
+
+
+// Devices and MIDI instrument maps.
+void Bench::refreshDevices (void)
+{
+	DeviceForm form(m_pMainForm);
+
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		form.refreshDevices();
+		sample(timer);
+	}
+}
+
+void Bench::refreshInstruments (void)
+{
+	InstrumentListModel model;
+
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		model.refresh();
+		QVERIFY(waitForTasks(QSAMPLER_BENCH_TIMEOUT));
+		sample(timer);
+	}
+
+	QCOMPARE(model.rowCount(QModelIndex()), m_config.iMapEntries);
+}
+
+
+// Session files.
+void Bench::saveSessionFile (void)
+{
+	const QString& sFilename = m_tempDir.filePath("bench.lscp");
+
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		QVERIFY(m_pMainForm->saveSessionFile(sFilename, false));
+		sample(timer);
+	}
+
+	QVERIFY(QFileInfo(sFilename).size() > 0);
+}
+
+void Bench::loadSessionFile (void)
+{
+	const QString& sFilename = m_tempDir.filePath("bench.lscp");
+	QVERIFY(QFileInfo(sFilename).exists());
+
+	QBENCHMARK {
+		QElapsedTimer timer;
+		timer.start();
+		QVERIFY(m_pMainForm->loadSessionFile(sFilename));
+		QVERIFY(waitForTasks(QSAMPLER_BENCH_TIMEOUT));
+		sample(timer);
+	}
+
+	QVERIFY(m_pMainForm->channelStripAt(m_config.iChannels - 1) != nullptr);
+}
+
+
+// Session script, as written (sans the dated header).
+static QString sessionBody ( const QString& sScript )
+{
+	return sScript.section("\n\n", 1);
+}
+
+// Session script, with quoted and escaped strings, modal and non-modal
+// instrument loading and mapping, in the very order we write it.
+static const char *g_sessionScript =
+	"RESET\n"
+	"\n"
+	"CREATE AUDIO_OUTPUT_DEVICE ALSA ACTIVE='true' CARD='it\\'s\\x20mine'\n"
+	"SET AUDIO_OUTPUT_CHANNEL_PARAMETER 0 0 NAME='left \\'1\\''\n"
+	"\n"
+	"CREATE MIDI_INPUT_DEVICE ALSA ACTIVE='true'\n"
+	"\n"
+	"ADD MIDI_INSTRUMENT_MAP 'Bob\\'s map'\n"
+	"MAP MIDI_INSTRUMENT NON_MODAL 0 0 0 GIG"
+		" '/samples/it\\'s a\\x20piano.gig' 0 1 ON_DEMAND 'Bob\\'s \\\\piano'\n"
+	"MAP MIDI_INSTRUMENT 0 0 1 GIG"
+		" '/samples/strings.gig' 2 0.5 PERSISTENT 'Strings'\n"
+	"\n"
+	"ADD CHANNEL\n"
+	"SET CHANNEL AUDIO_OUTPUT_DEVICE 0 0\n"
+	"SET CHANNEL MIDI_INPUT_DEVICE 0 0\n"
+	"SET CHANNEL MIDI_INPUT_PORT 0 0\n"
+	"SET CHANNEL MIDI_INPUT_CHANNEL 0 ALL\n"
+	"LOAD ENGINE GIG 0\n"
+	"LOAD INSTRUMENT '/samples/it\\'s a\\x20piano.gig' 0 0\n"
+	"SET CHANNEL VOLUME 0 0.5\n"
+	"\n"
+	"ADD CHANNEL\n"
+	"SET CHANNEL AUDIO_OUTPUT_DEVICE 1 0\n"
+	"SET CHANNEL MIDI_INPUT_DEVICE 1 0\n"
+	"SET CHANNEL MIDI_INPUT_PORT 1 0\n"
+	"SET CHANNEL MIDI_INPUT_CHANNEL 1 1\n"
+	"LOAD ENGINE GIG 1\n"
+	"LOAD INSTRUMENT NON_MODAL '/samples/strings.gig' 2 1\n"
+	"SET CHANNEL VOLUME 1 1\n"
+	"SET CHANNEL MUTE 1 1\n";
+
+void Bench::sessionRoundTrip (void)
+{
+	// Parser, writer: nothing lost, nothing reordered...
+	SessionSnapshot session;
+	QVERIFY(session.fromScript(g_sessionScript));
+	QVERIFY(session.isLossless());
+
+	const QString& sScript = session.toScript();
+	QVERIFY(sScript.contains(
+		"CARD='it\\'s\\x20mine'"));
+	QVERIFY(sScript.contains(
+		"NAME='left \\'1\\''"));
+	QVERIFY(sScript.contains(
+		"ADD MIDI_INSTRUMENT_MAP 'Bob\\'s map'"));
+	QVERIFY(sScript.contains(
+		"MAP MIDI_INSTRUMENT NON_MODAL 0 0 0 GIG '/samples/it\\'s a\\x20piano.gig'"));
+	QVERIFY(sScript.contains(
+		"'Bob\\'s \\\\piano'"));
+	QVERIFY(sScript.contains(
+		"MAP MIDI_INSTRUMENT 0 0 1 GIG '/samples/strings.gig'"));
+	QVERIFY(sScript.contains(
+		"LOAD INSTRUMENT '/samples/it\\'s a\\x20piano.gig' 0 0"));
+	QVERIFY(sScript.contains(
+		"LOAD INSTRUMENT NON_MODAL '/samples/strings.gig' 2 1"));
+
+	// Writer, parser, writer: the very same script...
+	SessionSnapshot session2;
+	QVERIFY(session2.fromScript(sScript));
+	QVERIFY(session2.isLossless());
+	QCOMPARE(sessionBody(session2.toScript()), sessionBody(sScript));
+
+	// Escape sequences are kept as written, modal loading too...
+	const SessionSnapshot::ChannelItem& channel = session.channels().first();
+	QCOMPARE(channel.sInstrumentFile, QString("/samples/it\\'s a\\x20piano.gig"));
+	QCOMPARE(SessionSnapshot::instrumentPath(channel.sInstrumentFile),
+		QString("/samples/it's a piano.gig"));
+	QVERIFY(!channel.bNonModal);
+
+	// Reordered commands can't be compiled...
+	QString sReordered(g_sessionScript);
+	sReordered.replace("SET CHANNEL VOLUME 0 0.5\n", QString());
+	sReordered.replace("LOAD ENGINE GIG 0\n",
+		"SET CHANNEL VOLUME 0 0.5\nLOAD ENGINE GIG 0\n");
+	SessionSnapshot session3;
+	QVERIFY(session3.fromScript(sReordered));
+	QVERIFY(!session3.isLossless());
+
+	// Live session, from the mock server: writer, parser, writer...
+	const QString& sFilename = m_tempDir.filePath("live.lscp");
+	SessionSnapshot live;
+	QVERIFY(live.take(sFilename));
+	const QString& sLiveScript = live.toScript();
+	SessionSnapshot session4;
+	QVERIFY(session4.fromScript(sLiveScript));
+	QVERIFY(session4.isLossless());
+	QCOMPARE(sessionBody(session4.toScript()), sessionBody(sLiveScript));
+}
+
+void Bench::sessionConvert (void)
+{
+	SessionSnapshot session;
+	QVERIFY(session.fromScript(g_sessionScript));
+	const QString& sScript = sessionBody(session.toScript());
+
+	// In memory, compressed or not...
+	for (int i = 0; i < 2; ++i) {
+		SessionSnapshot binary;
+		QVERIFY(binary.fromBinary(session.toBinary(i > 0)));
+		QVERIFY(binary.isLossless());
+		QCOMPARE(sessionBody(binary.toScript()), sScript);
+	}
+
+	// And through files: script, binary, script again...
+	const QString& sBinaryFile = m_tempDir.filePath("convert.lss");
+	session.setFilename(sBinaryFile);
+	QVERIFY(session.save());
+
+	SessionSnapshot binary;
+	QVERIFY(binary.load(sBinaryFile));
+	const QString& sScriptFile = m_tempDir.filePath("convert.lscp");
+	binary.setFilename(sScriptFile);
+	QVERIFY(binary.save());
+
+	SessionSnapshot script;
+	QVERIFY(script.load(sScriptFile));
+	QVERIFY(script.isLossless());
+	QCOMPARE(sessionBody(script.toScript()), sScript);
+
+	// Reordered commands can't be converted losslessly...
+	QString sReordered(g_sessionScript);
+	sReordered.replace("SET CHANNEL VOLUME 0 0.5\n", QString());
+	sReordered.replace("LOAD ENGINE GIG 0\n",
+		"SET CHANNEL VOLUME 0 0.5\nLOAD ENGINE GIG 0\n");
+	SessionSnapshot reordered;
+	QVERIFY(reordered.fromScript(sReordered));
+	QVERIFY(!reordered.isLossless());
+}
+
+
+// Wait for all pending (cooperative) tasks to finish.
+bool Bench::waitForTasks ( int iTimeout )
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	TaskScheduler *pTaskScheduler = m_pMainForm->taskScheduler();
+	while (pTaskScheduler->isBusy()) {
+		if (timer.elapsed() > iTimeout)
+			return false;
+		QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+	}
+
+	return true;
+}
+
+
+// Record one benchmark iteration sample.
+void Bench::sample ( const QElapsedTimer& timer )
+{
+	const qint64 iNsecs = timer.nsecsElapsed();
+	const QString sName = QTest::currentTestFunction();
+
+	if (!m_samples.contains(sName)) {
+		Sample& sample = m_samples[sName];
+		sample.iIterations = 0;
+		sample.iTotal = 0;
+		sample.iMin = iNsecs;
+		sample.iMax = iNsecs;
+		m_names.append(sName);
+	}
+
+	Sample& sample = m_samples[sName];
+	++sample.iIterations;
+	sample.iTotal += iNsecs;
+	if (sample.iMin > iNsecs)
+		sample.iMin = iNsecs;
+	if (sample.iMax < iNsecs)
+		sample.iMax = iNsecs;
+}
+
+
+// Benchmark results, as JSON.
+bool Bench::saveJson (void) const
+{
+	QJsonArray results;
+	QStringListIterator iter(m_names);
+	while (iter.hasNext()) {
+		const QString& sName = iter.next();
+		const Sample& sample = m_samples[sName];
+		QJsonObject result;
+		result.insert("name", sName);
+		result.insert("iterations", double(sample.iIterations));
+		result.insert("mean_ns", double(sample.iTotal / sample.iIterations));
+		result.insert("min_ns", double(sample.iMin));
+		result.insert("max_ns", double(sample.iMax));
+		results.append(result);
+	}
+
+	QJsonObject mock;
+	mock.insert("channels", m_config.iChannels);
+	mock.insert("map_entries", m_config.iMapEntries);
+	mock.insert("devices", m_config.iDevices);
+	mock.insert("latency_ms", m_config.iLatency);
+	mock.insert("jitter_ms", m_config.iJitter);
+
+	QJsonObject root;
+	root.insert("benchmark", QString("qsampler_bench"));
+	root.insert("version", QString(CONFIG_BUILD_VERSION));
+	root.insert("qt", QString(qVersion()));
+	root.insert("mock", mock);
+	root.insert("results", results);
+
+	const QByteArray& data = QJsonDocument(root).toJson();
+	if (m_sJsonFile.isEmpty() || m_sJsonFile == "-") {
+		QTextStream(stdout) << QString::fromUtf8(data);
+		return true;
+	}
+
+	QFile file(m_sJsonFile);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	return (file.write(data) == data.size());
+}
+
+} // namespace QSampler
+
+
+//-------------------------------------------------------------------------
+// main - The benchmark program trunk.
+//
+
+int main ( int argc, char **argv )
+{
+	Q_INIT_RESOURCE(qsampler);
+
+	// Headless, unless told otherwise...
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QApplication app(argc, argv);
+
+	// The hot paths, at scale...
+	QSampler::MockServer::Config config;
+	config.iPort = 0;
+	config.iChannels = 256;
+	config.iMapEntries = 16384;
+	config.iDevices = 2;
+	config.iEventPeriod = 0;
+
+	QString sJsonFile = "qsampler_bench.json";
+	QString sInstrumentFile;
+
+	// Our own options go first; all the rest are for QTest...
+	QStringList args;
+	const QStringList& argv_list = app.arguments();
+	args.append(argv_list.first());
+	for (int i = 1; i < argv_list.count(); ++i) {
+		const QString& sArg = argv_list.at(i);
+		const bool bValue = (i < argv_list.count() - 1);
+		if (sArg == "--json" && bValue)
+			sJsonFile = argv_list.at(++i);
+		else if (sArg == "--instrument" && bValue)
+			sInstrumentFile = argv_list.at(++i);
+		else if (sArg == "--channels" && bValue)
+			config.iChannels = argv_list.at(++i).toInt();
+		else if (sArg == "--map-entries" && bValue)
+			config.iMapEntries = argv_list.at(++i).toInt();
+		else if (sArg == "--devices" && bValue)
+			config.iDevices = argv_list.at(++i).toInt();
+		else if (sArg == "--latency" && bValue)
+			config.iLatency = argv_list.at(++i).toInt();
+		else if (sArg == "--jitter" && bValue)
+			config.iJitter = argv_list.at(++i).toInt();
+		else
+			args.append(sArg);
+	}
+
+	QSampler::Bench bench(config, sJsonFile, sInstrumentFile);
+	return QTest::qExec(&bench, args);
+}
+
+
+// end of qsamplerBench.cpp
@@ -0,0 +1,162 @@
+// qsamplerBench.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerBench_h
+#define __qsamplerBench_h
+
+#include "qsamplerMockServer.h"
+
+#include <QThread>
+#include <QSemaphore>
+#include <QTemporaryDir>
+
+
+namespace QSampler {
+
+class Options;
+class BenchMainForm;
+
+
+//-------------------------------------------------------------------------
+// QSampler::BenchServer -- Mock LSCP server, on its own thread.
+//
+
+class BenchServer : public QThread
+{
+public:
+
+	// Constructor.
+	BenchServer(const MockServer::Config& config);
+
+	// Start and wait for it listening; return the actual port.
+	int startServer();
+
+protected:
+
+	// The server thread executive.
+	void run();
+
+private:
+
+	// Instance variables.
+	MockServer::Config m_config;
+
+	QSemaphore m_started;
+	int m_iPort;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::Bench -- Headless benchmark suite (QTest).
+//
+
+class Bench : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	Bench(const MockServer::Config& config,
+		const QString& sJsonFile, const QString& sInstrumentFile);
+
+	// Destructor.
+	~Bench();
+
+private slots:
+
+	// Suite setup and teardown.
+	void initTestCase();
+	void cleanupTestCase();
+
+	// LSCP codecs.
+	void lscpEscapePath();
+	void lscpEscapedPathToPosix();
+	void lscpEscapeText();
+	void lscpEscapedTextToRaw();
+
+	// Instrument name extraction.
+	void instrumentName();
+
+	// Channel strips.
+	void updateAllChannelStrips();
+	void updateChannelUsage();
+
+	// Devices and MIDI instrument maps.
+	void refreshDevices();
+	void refreshInstruments();
+
+	// Session files.
+	void saveSessionFile();
+	void loadSessionFile();
+
+	// Session scripts (writer, parser, writer).
+	void sessionRoundTrip();
+
+	// Session conversion (script, binary, script).
+	void sessionConvert();
+
+private:
+
+	// Wait for all pending (cooperative) tasks to finish.
+	bool waitForTasks(int iTimeout);
+
+	// Record one benchmark iteration sample.
+	void sample(const QElapsedTimer& timer);
+
+	// Benchmark results, as JSON.
+	bool saveJson() const;
+
+	// Benchmark sample statistics.
+	struct Sample
+	{
+		qint64 iIterations;
+		qint64 iTotal;
+		qint64 iMin;
+		qint64 iMax;
+	};
+
+	// Instance variables.
+	MockServer::Config m_config;
+
+	QString m_sJsonFile;
+	QString m_sInstrumentFile;
+
+	QTemporaryDir m_tempDir;
+
+	BenchServer   *m_pServer;
+	Options       *m_pOptions;
+	BenchMainForm *m_pMainForm;
+
+	QStringList m_paths;
+	QStringList m_texts;
+
+	QStringList m_names;
+	QMap<QString, Sample> m_samples;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerBench_h
+
+
+// end of qsamplerBench.h
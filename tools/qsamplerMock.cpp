@@ -0,0 +1,156 @@
+// qsamplerMock.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerMockServer.h"
+
+#include <QCoreApplication>
+#include <QTextStream>
+
+
+//-------------------------------------------------------------------------
+// Command line usage helper.
+//
+
+static void print_usage ( const QString& arg0 )
+{
+	QTextStream out(stderr);
+	out << QObject::tr("Usage: %1 [options]\n\n"
+		"Qsampler Mock LSCP Server - LinuxSampler stand-in for testing.\n\n"
+		"Options:\n\n"
+		"  -p, --port\n\tListen on this TCP port number (default = 8888)\n\n"
+		"  -n, --channels\n\tInitial number of sampler channels (default = 16)\n\n"
+		"  -m, --map-entries\n\tInitial number of MIDI instrument map entries (default = 128)\n\n"
+		"  -d, --devices\n\tInitial number of audio and MIDI devices (default = 1)\n\n"
+		"  -l, --latency\n\tReply latency in msecs (default = 0)\n\n"
+		"  -j, --jitter\n\tReply latency jitter in msecs (default = 0)\n\n"
+		"  -e, --events\n\tPeriodic events period in msecs, 0 = none (default = 1000)\n\n"
+		"  -t, --load-time\n\tInstrument load time in msecs (default = 0)\n\n"
+		"  -s, --seed\n\tPseudo-random generator seed (default = 1)\n\n"
+		"  -?, --help\n\tShow help about command line options\n\n")
+		.arg(arg0);
+}
+
+
+//-------------------------------------------------------------------------
+// Command line arguments parser.
+//
+
+static bool parse_args ( const QStringList& args,
+	QSampler::MockServer::Config& config )
+{
+	QTextStream out(stderr);
+	const QString sEol = "\n\n";
+	const int argc = args.count();
+
+	for (int i = 1; i < argc; ++i) {
+
+		QString sArg = args.at(i);
+		QString sVal;
+		const int iEqual = sArg.indexOf("=");
+		if (iEqual >= 0) {
+			sVal = sArg.right(sArg.length() - iEqual - 1);
+			sArg = sArg.left(iEqual);
+		}
+		else if (i < argc - 1) {
+			sVal = args.at(i + 1);
+			if (sVal[0] == '-')
+				sVal.clear();
+		}
+
+		if (sArg == "-?" || sArg == "--help") {
+			print_usage(args.at(0));
+			return false;
+		}
+
+		int *piValue = nullptr;
+		if (sArg == "-n" || sArg == "--channels")
+			piValue = &config.iChannels;
+		else if (sArg == "-m" || sArg == "--map-entries")
+			piValue = &config.iMapEntries;
+		else if (sArg == "-d" || sArg == "--devices")
+			piValue = &config.iDevices;
+		else if (sArg == "-l" || sArg == "--latency")
+			piValue = &config.iLatency;
+		else if (sArg == "-j" || sArg == "--jitter")
+			piValue = &config.iJitter;
+		else if (sArg == "-e" || sArg == "--events")
+			piValue = &config.iEventPeriod;
+		else if (sArg == "-t" || sArg == "--load-time")
+			piValue = &config.iLoadTime;
+		else if (sArg != "-p" && sArg != "--port"
+			&& sArg != "-s" && sArg != "--seed") {
+			out << QObject::tr("Unknown option: %1").arg(sArg) + sEol;
+			print_usage(args.at(0));
+			return false;
+		}
+
+		bool bOk = false;
+		const int iValue = sVal.toInt(&bOk);
+		if (!bOk || iValue < 0) {
+			out << QObject::tr("Option %1 requires a number.").arg(sArg) + sEol;
+			return false;
+		}
+
+		if (piValue)
+			*piValue = iValue;
+		else if (sArg == "-p" || sArg == "--port")
+			config.iPort = quint16(iValue);
+		else
+			config.iSeed = quint32(iValue);
+
+		if (iEqual < 0)
+			++i;
+	}
+
+	// Alright with argument parsing.
+	return true;
+}
+
+
+//-------------------------------------------------------------------------
+// main - The main program trunk.
+//
+
+int main ( int argc, char **argv )
+{
+	QCoreApplication app(argc, argv);
+
+	QSampler::MockServer::Config config;
+	if (!parse_args(app.arguments(), config))
+		return 1;
+
+	QSampler::MockServer server(config);
+	if (!server.start()) {
+		QTextStream(stderr) << QObject::tr("Could not listen on port %1: %2\n")
+			.arg(config.iPort).arg(server.errorString());
+		return 1;
+	}
+
+	QTextStream(stdout) << QObject::tr("Mock LSCP server listening on port %1 "
+		"(%2 channels, %3 map entries, %4 devices, %5+%6 msecs latency).\n")
+		.arg(config.iPort).arg(config.iChannels).arg(config.iMapEntries)
+		.arg(config.iDevices).arg(config.iLatency).arg(config.iJitter);
+
+	return app.exec();
+}
+
+
+// end of qsamplerMock.cpp
@@ -0,0 +1,1495 @@
+// qsamplerMockServer.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerMockServer.h"
+
+#include <QHostAddress>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// Mock LSCP protocol helpers.
+//
+
+// Reply line terminator.
+#define MOCK_EOL  "\r\n"
+
+// Command tokenizer (quoted strings are kept whole, escapes resolved).
+static QStringList mockTokens ( const QString& sLine )
+{
+	const QByteArray& line = sLine.toUtf8();
+	const int iLength = line.length();
+
+	QStringList tokens;
+	QByteArray token;
+	bool bToken = false;
+	char chQuote = 0;
+
+	for (int i = 0; i < iLength; ++i) {
+		char ch = line.at(i);
+		if (ch == '\\' && i < iLength - 1) {
+			ch = line.at(++i);
+			if (ch == 'n')
+				ch = '\n';
+			else
+			if (ch == 'r')
+				ch = '\r';
+			else
+			if (ch == 't')
+				ch = '\t';
+			else
+			if (ch == 'x' && i < iLength - 2) {
+				ch = char(line.mid(i + 1, 2).toInt(nullptr, 16));
+				i += 2;
+			}
+			token += ch;
+			bToken = true;
+		}
+		else
+		if (chQuote) {
+			if (ch == chQuote)
+				chQuote = 0;
+			else
+				token += ch;
+		}
+		else
+		if (ch == '\'' || ch == '"') {
+			chQuote = ch;
+			bToken = true;
+		}
+		else
+		if (ch == ' ' || ch == '\t') {
+			if (bToken)
+				tokens.append(QString::fromUtf8(token));
+			token.clear();
+			bToken = false;
+		}
+		else {
+			token += ch;
+			bToken = true;
+		}
+	}
+
+	if (bToken)
+		tokens.append(QString::fromUtf8(token));
+
+	return tokens;
+}
+
+
+// Command matcher (case-insensitive keywords; the rest are arguments).
+static bool mockMatch ( const QStringList& tokens,
+	const QString& sCommand, QStringList& args )
+{
+	const QStringList& words = sCommand.split(' ');
+	if (tokens.count() < words.count())
+		return false;
+
+	for (int i = 0; i < words.count(); ++i) {
+		if (tokens.at(i).toUpper() != words.at(i))
+			return false;
+	}
+
+	args = tokens.mid(words.count());
+	return true;
+}
+
+
+// Reply builders.
+static QString mockOk (void)
+{
+	return "OK" MOCK_EOL;
+}
+
+static QString mockOk ( int iIndex )
+{
+	return QString("OK[%1]" MOCK_EOL).arg(iIndex);
+}
+
+static QString mockError ( const QString& sText )
+{
+	return QString("ERR:0:%1" MOCK_EOL).arg(sText);
+}
+
+static QString mockResult ( const QString& sValue )
+{
+	return sValue + MOCK_EOL;
+}
+
+static QString mockField ( const QString& sKey, const QString& sValue )
+{
+	return sKey + ": " + sValue + MOCK_EOL;
+}
+
+static QString mockEnd (void)
+{
+	return "." MOCK_EOL;
+}
+
+static QString mockBool ( bool bValue )
+{
+	return (bValue ? "true" : "false");
+}
+
+static QString mockQuote ( const QString& sText )
+{
+	QString sQuoted(sText);
+	sQuoted.replace('\\', "\\\\");
+	sQuoted.replace('\'', "\\'");
+	return '\'' + sQuoted + '\'';
+}
+
+static QString mockIDs ( const QList<int>& ids )
+{
+	QStringList list;
+	QListIterator<int> iter(ids);
+	while (iter.hasNext())
+		list.append(QString::number(iter.next()));
+	return list.join(',');
+}
+
+
+// Device type names (iType: 0 = audio, 1 = MIDI).
+static const char *g_mockDevice[2] = { "AUDIO_OUTPUT_DEVICE", "MIDI_INPUT_DEVICE" };
+static const char *g_mockDriver[2] = { "AUDIO_OUTPUT_DRIVER", "MIDI_INPUT_DRIVER" };
+static const char *g_mockPort[2]   = { "AUDIO_OUTPUT_CHANNEL", "MIDI_INPUT_PORT" };
+static const char *g_mockPorts[2]  = { "CHANNELS", "PORTS" };
+static const char *g_mockEvent[2]  = { "AUDIO_OUTPUT_DEVICE", "MIDI_INPUT_DEVICE" };
+
+// Available drivers and engines.
+static const char *g_mockDrivers  = "ALSA,JACK";
+static const char *g_mockEngines  = "GIG,SF2,SFZ";
+
+
+//-------------------------------------------------------------------------
+// QSampler::MockConnection -- Mock LSCP server client connection.
+//
+
+// Constructor.
+MockConnection::MockConnection ( MockServer *pServer, QTcpSocket *pSocket )
+	: QObject(pServer), m_pServer(pServer), m_pSocket(pSocket), m_bQuit(false)
+{
+	m_pSocket->setParent(this);
+
+	m_timer.setSingleShot(true);
+
+	QObject::connect(m_pSocket,
+		SIGNAL(readyRead()),
+		SLOT(readyReadSlot()));
+	QObject::connect(m_pSocket,
+		SIGNAL(disconnected()),
+		SLOT(disconnectedSlot()));
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(replySlot()));
+}
+
+
+// Event subscriptions.
+bool MockConnection::isSubscribed ( const QString& sEvent ) const
+{
+	return m_events.contains(sEvent);
+}
+
+void MockConnection::subscribe ( const QString& sEvent )
+{
+	m_events.insert(sEvent);
+}
+
+void MockConnection::unsubscribe ( const QString& sEvent )
+{
+	m_events.remove(sEvent);
+}
+
+
+// Send an event notification, right away.
+void MockConnection::notify ( const QString& sEvent, const QString& sData )
+{
+	if (m_events.contains(sEvent))
+		m_pSocket->write(("NOTIFY:" + sEvent + ':' + sData + MOCK_EOL).toUtf8());
+}
+
+
+// Close after the last reply.
+void MockConnection::quit (void)
+{
+	m_bQuit = true;
+}
+
+
+// Command lines reader: replies are queued, each with its own latency.
+void MockConnection::readyReadSlot (void)
+{
+	m_buffer.append(m_pSocket->readAll());
+
+	const MockServer::Config& config = m_pServer->config();
+
+	int iEol = m_buffer.indexOf('\n');
+	while (iEol >= 0) {
+		const QString& sLine
+			= QString::fromUtf8(m_buffer.left(iEol)).trimmed();
+		m_buffer.remove(0, iEol + 1);
+		if (!sLine.isEmpty() && !sLine.startsWith('#')) {
+			Reply reply;
+			reply.data = m_pServer->command(this, sLine);
+			reply.iDue = m_pServer->elapsed() + config.iLatency;
+			if (config.iJitter > 0)
+				reply.iDue += m_pServer->random(config.iJitter + 1);
+			// Always in order...
+			if (!m_replies.isEmpty() && reply.iDue < m_replies.last().iDue)
+				reply.iDue = m_replies.last().iDue;
+			m_replies.append(reply);
+		}
+		iEol = m_buffer.indexOf('\n');
+	}
+
+	replySlot();
+}
+
+
+// Delayed replies slot.
+void MockConnection::replySlot (void)
+{
+	const qint64 iNow = m_pServer->elapsed();
+	while (!m_replies.isEmpty() && m_replies.first().iDue <= iNow)
+		m_pSocket->write(m_replies.takeFirst().data);
+
+	if (!m_replies.isEmpty())
+		m_timer.start(int(m_replies.first().iDue - iNow));
+	else
+	if (m_bQuit)
+		m_pSocket->disconnectFromHost();
+}
+
+
+// Connection closed.
+void MockConnection::disconnectedSlot (void)
+{
+	m_timer.stop();
+	m_replies.clear();
+
+	emit closed(this);
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::MockServer -- Mock LSCP server (LinuxSampler stand-in).
+//
+
+// Configuration defaults.
+MockServer::Config::Config (void)
+	: iPort(8888), iChannels(16), iMapEntries(128), iDevices(1),
+		iLatency(0), iJitter(0), iEventPeriod(1000), iLoadTime(0), iSeed(1)
+{
+}
+
+
+// Channel defaults.
+MockServer::Channel::Channel (void)
+	: iAudioDevice(-1), iMidiDevice(-1), iMidiPort(0), iMidiChannel(-1),
+		iInstrumentNr(0), iInstrumentStatus(0), iLoadStart(0),
+		fVolume(1.0f), bMute(false), bSolo(false), iMidiMap(-2),
+		iVoices(0), iStreams(0), iFxSendID(0)
+{
+}
+
+
+// Constructor.
+MockServer::MockServer ( const Config& config, QObject *pParent )
+	: QTcpServer(pParent), m_config(config), m_iChannelID(0), m_iMapID(0),
+		m_fVolume(1.0f), m_iMaxVoices(64), m_iMaxStreams(90),
+		m_iTotalVoicesMax(0), m_iRandom(config.iSeed)
+{
+	m_iDeviceID[0] = m_iDeviceID[1] = 0;
+
+	QObject::connect(this,
+		SIGNAL(newConnection()),
+		SLOT(newConnectionSlot()));
+	QObject::connect(&m_eventTimer,
+		SIGNAL(timeout()),
+		SLOT(eventSlot()));
+}
+
+
+// Destructor.
+MockServer::~MockServer (void)
+{
+	m_eventTimer.stop();
+}
+
+
+// Start listening.
+bool MockServer::start (void)
+{
+	if (!listen(QHostAddress::Any, m_config.iPort))
+		return false;
+
+	populate();
+
+	m_elapsed.start();
+
+	if (m_config.iEventPeriod > 0)
+		m_eventTimer.start(m_config.iEventPeriod);
+
+	return true;
+}
+
+
+// Configuration accessor.
+const MockServer::Config& MockServer::config (void) const
+{
+	return m_config;
+}
+
+
+// Elapsed time since start (msecs).
+qint64 MockServer::elapsed (void) const
+{
+	return m_elapsed.elapsed();
+}
+
+
+// Deterministic pseudo-random number in [0, iRange).
+int MockServer::random ( int iRange )
+{
+	m_iRandom = m_iRandom * 1103515245 + 12345;
+	return (iRange > 0 ? int((m_iRandom >> 16) % quint32(iRange)) : 0);
+}
+
+
+// New client connection.
+void MockServer::newConnectionSlot (void)
+{
+	while (hasPendingConnections()) {
+		MockConnection *pConnection
+			= new MockConnection(this, nextPendingConnection());
+		QObject::connect(pConnection,
+			SIGNAL(closed(MockConnection *)),
+			SLOT(closedSlot(MockConnection *)));
+		m_connections.append(pConnection);
+	}
+}
+
+
+// Client connection closed.
+void MockServer::closedSlot ( MockConnection *pConnection )
+{
+	m_connections.removeAll(pConnection);
+	pConnection->deleteLater();
+}
+
+
+// Event notification helper (to all subscribers).
+void MockServer::notify ( const QString& sEvent, const QString& sData )
+{
+	QListIterator<MockConnection *> iter(m_connections);
+	while (iter.hasNext())
+		iter.next()->notify(sEvent, sData);
+}
+
+
+// Periodic events: voice/stream counts, buffer fill, MIDI activity
+// and instrument loading progress.
+void MockServer::eventSlot (void)
+{
+	const qint64 iNow = elapsed();
+	int iTotalVoices  = 0;
+	int iTotalStreams = 0;
+
+	QMutableMapIterator<int, Channel> iter(m_channels);
+	while (iter.hasNext()) {
+		Channel& channel = iter.next().value();
+		const QString& sChannelID = QString::number(iter.key());
+		if (channel.iInstrumentStatus >= 0 && channel.iInstrumentStatus < 100) {
+			const qint64 iLoad = iNow - channel.iLoadStart;
+			channel.iInstrumentStatus = (m_config.iLoadTime > 0
+				&& iLoad < m_config.iLoadTime
+				? int(100 * iLoad / m_config.iLoadTime) : 100);
+			notify("CHANNEL_INFO", sChannelID);
+		}
+		if (channel.iInstrumentStatus < 100 || channel.bMute)
+			channel.iVoices = 0;
+		else
+			channel.iVoices = random(m_iMaxVoices / 4 + 1);
+		channel.iStreams = qMin(channel.iVoices, m_iMaxStreams);
+		iTotalVoices  += channel.iVoices;
+		iTotalStreams += channel.iStreams;
+		notify("VOICE_COUNT", sChannelID + ' ' + QString::number(channel.iVoices));
+		notify("STREAM_COUNT", sChannelID + ' ' + QString::number(channel.iStreams));
+		if (channel.iStreams > 0) {
+			QStringList fill;
+			for (int i = 0; i < channel.iStreams; ++i)
+				fill.append(QString("[%1]%2%").arg(i).arg(random(101)));
+			notify("BUFFER_FILL", sChannelID + ' ' + fill.join(','));
+		}
+		if (channel.iVoices > 0) {
+			notify("CHANNEL_MIDI", sChannelID + " NOTE_ON "
+				+ QString::number(random(128)) + ' '
+				+ QString::number(1 + random(127)));
+		}
+	}
+
+	if (m_iTotalVoicesMax < iTotalVoices)
+		m_iTotalVoicesMax = iTotalVoices;
+	notify("TOTAL_VOICE_COUNT", QString::number(iTotalVoices));
+	notify("TOTAL_STREAM_COUNT", QString::number(iTotalStreams));
+}
+
+
+// Reset the whole sampler state.
+void MockServer::reset (void)
+{
+	m_channels.clear();
+	m_maps.clear();
+	m_devices[0].clear();
+	m_devices[1].clear();
+
+	m_fVolume = 1.0f;
+	m_iTotalVoicesMax = 0;
+
+	notify("CHANNEL_COUNT", "0");
+	notify("MIDI_INSTRUMENT_MAP_COUNT", "0");
+	notify("AUDIO_OUTPUT_DEVICE_COUNT", "0");
+	notify("MIDI_INPUT_DEVICE_COUNT", "0");
+	notify("GLOBAL_INFO", "VOLUME 1");
+}
+
+
+// Initial (configured) sampler state.
+void MockServer::populate (void)
+{
+	for (int i = 0; i < m_config.iDevices; ++i) {
+		createDevice(0, "ALSA", QStringList());
+		createDevice(1, "ALSA", QStringList());
+	}
+
+	if (m_config.iMapEntries > 0) {
+		Map& map = m_maps[m_iMapID++];
+		map.sName = "Mock Map";
+		for (int i = 0; i < m_config.iMapEntries; ++i) {
+			Instrument& instr = map.instruments[i];
+			instr.sName = QString("Mock %1").arg(i);
+			instr.sEngineName = "GIG";
+			instr.sInstrumentFile
+				= QString("/mock/instruments/mock-%1.gig").arg(i / 128);
+			instr.iInstrumentNr = (i % 128);
+			instr.fVolume = 1.0f;
+			instr.sLoadMode = "ON_DEMAND";
+		}
+	}
+
+	const QList<int>& audioDevices = m_devices[0].keys();
+	const QList<int>& midiDevices = m_devices[1].keys();
+	for (int i = 0; i < m_config.iChannels; ++i) {
+		const int iChannelID = m_iChannelID++;
+		Channel& channel = m_channels[iChannelID];
+		channel.sEngineName = "GIG";
+		if (!audioDevices.isEmpty())
+			setAudioDevice(channel, audioDevices.at(i % audioDevices.count()));
+		if (!midiDevices.isEmpty())
+			channel.iMidiDevice = midiDevices.at(i % midiDevices.count());
+		channel.iMidiChannel = (i % 16);
+		channel.sInstrumentFile
+			= QString("/mock/instruments/mock-%1.gig").arg(i / 128);
+		channel.iInstrumentNr = (i % 128);
+		channel.sInstrumentName = QString("Mock %1").arg(i);
+		channel.iInstrumentStatus = 100;
+	}
+}
+
+
+// Reply to one single command line.
+QByteArray MockServer::command ( MockConnection *pConnection, const QString& sLine )
+{
+	const QStringList& tokens = mockTokens(sLine);
+	if (tokens.isEmpty())
+		return QByteArray();
+
+	QStringList args;
+	QString sReply;
+
+	const QString& sVerb = tokens.first().toUpper();
+	if (sVerb == "GET")
+		sReply = commandGet(tokens);
+	else
+	if (sVerb == "LIST")
+		sReply = commandList(tokens);
+	else
+	if (sVerb == "SET")
+		sReply = commandSet(tokens);
+	else
+	if (sVerb == "CREATE")
+		sReply = commandCreate(tokens);
+	else
+	if (sVerb == "DESTROY")
+		sReply = commandDestroy(tokens);
+	else
+	if (sVerb == "ADD" || sVerb == "REMOVE" || sVerb == "LOAD"
+		|| sVerb == "RESET" || sVerb == "EDIT")
+		sReply = commandChannel(tokens);
+	else
+	if (sVerb == "MAP" || sVerb == "UNMAP" || sVerb == "CLEAR")
+		sReply = commandMap(tokens);
+	else
+	if (mockMatch(tokens, "SUBSCRIBE", args) && args.count() == 1) {
+		pConnection->subscribe(args.at(0).toUpper());
+		sReply = mockOk();
+	}
+	else
+	if (mockMatch(tokens, "UNSUBSCRIBE", args) && args.count() == 1) {
+		pConnection->unsubscribe(args.at(0).toUpper());
+		sReply = mockOk();
+	}
+	else
+	if (mockMatch(tokens, "QUIT", args)) {
+		pConnection->quit();
+		return QByteArray();
+	}
+
+	if (sReply.isEmpty())
+		sReply = mockError("Unknown command: " + sLine);
+
+	return sReply.toUtf8();
+}
+
+
+// GET ... commands.
+QString MockServer::commandGet ( const QStringList& tokens )
+{
+	QStringList args;
+
+	if (mockMatch(tokens, "GET SERVER INFO", args)) {
+		return mockField("DESCRIPTION", "Qsampler Mock LSCP Server")
+			+ mockField("VERSION", "1.0.0")
+			+ mockField("PROTOCOL_VERSION", "1.7")
+			+ mockEnd();
+	}
+
+	if (mockMatch(tokens, "GET CHANNELS", args))
+		return mockResult(QString::number(m_channels.count()));
+
+	if (mockMatch(tokens, "GET CHANNEL INFO", args) && args.count() == 1) {
+		Channel *pChannel = channel(args.at(0));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		return mockField("ENGINE_NAME", pChannel->sEngineName.isEmpty()
+				? QString("NONE") : pChannel->sEngineName)
+			+ mockField("VOLUME", QString::number(pChannel->fVolume))
+			+ mockField("AUDIO_OUTPUT_DEVICE", pChannel->iAudioDevice < 0
+				? QString("NONE") : QString::number(pChannel->iAudioDevice))
+			+ mockField("AUDIO_OUTPUT_CHANNELS",
+				QString::number(pChannel->audioRouting.count()))
+			+ mockField("AUDIO_OUTPUT_ROUTING",
+				mockIDs(pChannel->audioRouting))
+			+ mockField("MIDI_INPUT_DEVICE", pChannel->iMidiDevice < 0
+				? QString("NONE") : QString::number(pChannel->iMidiDevice))
+			+ mockField("MIDI_INPUT_PORT", QString::number(pChannel->iMidiPort))
+			+ mockField("MIDI_INPUT_CHANNEL", pChannel->iMidiChannel < 0
+				? QString("ALL") : QString::number(pChannel->iMidiChannel))
+			+ mockField("INSTRUMENT_FILE", pChannel->sInstrumentFile.isEmpty()
+				? QString("NONE") : pChannel->sInstrumentFile)
+			+ mockField("INSTRUMENT_NR", QString::number(pChannel->iInstrumentNr))
+			+ mockField("INSTRUMENT_NAME", pChannel->sInstrumentName.isEmpty()
+				? QString("NONE") : mockQuote(pChannel->sInstrumentName))
+			+ mockField("INSTRUMENT_STATUS",
+				QString::number(pChannel->iInstrumentStatus))
+			+ mockField("MUTE", mockBool(pChannel->bMute))
+			+ mockField("SOLO", mockBool(pChannel->bSolo))
+			+ mockField("MIDI_INSTRUMENT_MAP", pChannel->iMidiMap == -2
+				? QString("DEFAULT") : (pChannel->iMidiMap < 0 ? QString("NONE")
+				: QString::number(pChannel->iMidiMap)))
+			+ mockEnd();
+	}
+
+	if (mockMatch(tokens, "GET CHANNEL VOICE_COUNT", args) && args.count() == 1) {
+		Channel *pChannel = channel(args.at(0));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		return mockResult(QString::number(pChannel->iVoices));
+	}
+
+	if (mockMatch(tokens, "GET CHANNEL STREAM_COUNT", args) && args.count() == 1) {
+		Channel *pChannel = channel(args.at(0));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		return mockResult(QString::number(pChannel->iStreams));
+	}
+
+	if (mockMatch(tokens, "GET CHANNEL BUFFER_FILL", args) && args.count() == 2) {
+		Channel *pChannel = channel(args.at(1));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		if (pChannel->iStreams < 1)
+			return mockResult("NA");
+		const bool bPercentage = (args.at(0).toUpper() == "PERCENTAGE");
+		QStringList fill;
+		for (int i = 0; i < pChannel->iStreams; ++i) {
+			const int iFill = random(101);
+			fill.append(QString("[%1]%2").arg(i)
+				.arg(bPercentage ? QString::number(iFill) + '%'
+					: QString::number(iFill * 1024)));
+		}
+		return mockResult(fill.join(','));
+	}
+
+	if (mockMatch(tokens, "GET AVAILABLE_ENGINES", args))
+		return mockResult(QString::number(
+			QString(g_mockEngines).split(',').count()));
+
+	if (mockMatch(tokens, "GET ENGINE INFO", args) && args.count() == 1) {
+		if (!QString(g_mockEngines).split(',').contains(args.at(0).toUpper()))
+			return mockError("Unknown engine.");
+		return mockField("DESCRIPTION", "Mock " + args.at(0).toUpper() + " Engine")
+			+ mockField("VERSION", "1.0")
+			+ mockEnd();
+	}
+
+	if (mockMatch(tokens, "GET VOLUME", args))
+		return mockResult(QString::number(m_fVolume));
+
+	if (mockMatch(tokens, "GET VOICES", args))
+		return mockResult(QString::number(m_iMaxVoices));
+
+	if (mockMatch(tokens, "GET STREAMS", args))
+		return mockResult(QString::number(m_iMaxStreams));
+
+	if (mockMatch(tokens, "GET TOTAL_VOICE_COUNT", args)) {
+		int iTotalVoices = 0;
+		QMapIterator<int, Channel> iter(m_channels);
+		while (iter.hasNext())
+			iTotalVoices += iter.next().value().iVoices;
+		return mockResult(QString::number(iTotalVoices));
+	}
+
+	if (mockMatch(tokens, "GET TOTAL_STREAM_COUNT", args)) {
+		int iTotalStreams = 0;
+		QMapIterator<int, Channel> iter(m_channels);
+		while (iter.hasNext())
+			iTotalStreams += iter.next().value().iStreams;
+		return mockResult(QString::number(iTotalStreams));
+	}
+
+	if (mockMatch(tokens, "GET TOTAL_VOICE_COUNT_MAX", args))
+		return mockResult(QString::number(m_iTotalVoicesMax));
+
+	// Devices and drivers, audio and MIDI alike...
+	for (int iType = 0; iType < 2; ++iType) {
+		const QString sDevice(g_mockDevice[iType]);
+		const QString sDriver(g_mockDriver[iType]);
+		const QString sPort(g_mockPort[iType]);
+		if (mockMatch(tokens, "GET AVAILABLE_" + sDriver + 'S', args))
+			return mockResult(QString::number(
+				QString(g_mockDrivers).split(',').count()));
+		if (mockMatch(tokens, "GET " + sDriver + " INFO", args)
+			&& args.count() == 1)
+			return driverInfo(iType, args.at(0).toUpper());
+		if (mockMatch(tokens, "GET " + sDriver + "_PARAMETER INFO", args)
+			&& args.count() >= 2)
+			return driverParamInfo(iType, args.at(1).toUpper());
+		if (mockMatch(tokens, "GET " + sDevice + 'S', args))
+			return mockResult(QString::number(m_devices[iType].count()));
+		if (mockMatch(tokens, "GET " + sDevice + " INFO", args)
+			&& args.count() == 1) {
+			const int iDeviceID = args.at(0).toInt();
+			if (!m_devices[iType].contains(iDeviceID))
+				return mockError("Invalid device.");
+			return deviceInfo(iType, m_devices[iType].value(iDeviceID));
+		}
+		if (mockMatch(tokens, "GET " + sPort + " INFO", args)
+			&& args.count() == 2) {
+			const int iDeviceID = args.at(0).toInt();
+			const int iPort = args.at(1).toInt();
+			if (!m_devices[iType].contains(iDeviceID))
+				return mockError("Invalid device.");
+			const Device& device = m_devices[iType][iDeviceID];
+			if (iPort < 0 || iPort >= device.ports.count())
+				return mockError("Invalid port.");
+			QString sInfo;
+			QMapIterator<QString, QString> iter(device.ports.at(iPort));
+			while (iter.hasNext()) {
+				iter.next();
+				sInfo += mockField(iter.key(), iter.value());
+			}
+			return sInfo + mockEnd();
+		}
+		if (mockMatch(tokens, "GET " + sPort + "_PARAMETER INFO", args)
+			&& args.count() == 3)
+			return portParamInfo(iType, args.at(2).toUpper());
+	}
+
+	// MIDI instrument maps...
+	if (mockMatch(tokens, "GET MIDI_INSTRUMENT_MAPS", args))
+		return mockResult(QString::number(m_maps.count()));
+
+	if (mockMatch(tokens, "GET MIDI_INSTRUMENT_MAP INFO", args)
+		&& args.count() == 1) {
+		const int iMap = args.at(0).toInt();
+		if (!m_maps.contains(iMap))
+			return mockError("Invalid MIDI instrument map.");
+		return mockField("NAME", mockQuote(m_maps.value(iMap).sName))
+			+ mockField("DEFAULT", mockBool(iMap == m_maps.firstKey()))
+			+ mockEnd();
+	}
+
+	if (mockMatch(tokens, "GET MIDI_INSTRUMENTS", args) && args.count() == 1) {
+		if (args.at(0).toUpper() == "ALL") {
+			int iInstruments = 0;
+			QMapIterator<int, Map> iter(m_maps);
+			while (iter.hasNext())
+				iInstruments += iter.next().value().instruments.count();
+			return mockResult(QString::number(iInstruments));
+		}
+		const int iMap = args.at(0).toInt();
+		if (!m_maps.contains(iMap))
+			return mockError("Invalid MIDI instrument map.");
+		return mockResult(QString::number(m_maps[iMap].instruments.count()));
+	}
+
+	if (mockMatch(tokens, "GET MIDI_INSTRUMENT INFO", args) && args.count() == 3) {
+		const int iMap = args.at(0).toInt();
+		const int iKey = (args.at(1).toInt() << 7) + args.at(2).toInt();
+		if (!m_maps.contains(iMap) || !m_maps[iMap].instruments.contains(iKey))
+			return mockError("Invalid MIDI instrument map entry.");
+		const Instrument& instr = m_maps[iMap].instruments[iKey];
+		return mockField("NAME", mockQuote(instr.sName))
+			+ mockField("ENGINE_NAME", instr.sEngineName)
+			+ mockField("INSTRUMENT_FILE", instr.sInstrumentFile)
+			+ mockField("INSTRUMENT_NR", QString::number(instr.iInstrumentNr))
+			+ mockField("INSTRUMENT_NAME", mockQuote(instr.sName))
+			+ mockField("LOAD_MODE", instr.sLoadMode)
+			+ mockField("VOLUME", QString::number(instr.fVolume))
+			+ mockEnd();
+	}
+
+	// Effect sends...
+	if (mockMatch(tokens, "GET FX_SENDS", args) && args.count() == 1) {
+		Channel *pChannel = channel(args.at(0));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		return mockResult(QString::number(pChannel->fxsends.count()));
+	}
+
+	if (mockMatch(tokens, "GET FX_SEND INFO", args) && args.count() == 2) {
+		Channel *pChannel = channel(args.at(0));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		const int iFxSend = args.at(1).toInt();
+		if (!pChannel->fxsends.contains(iFxSend))
+			return mockError("Invalid effect send.");
+		const FxSend& fxsend = pChannel->fxsends[iFxSend];
+		return mockField("NAME", mockQuote(fxsend.sName))
+			+ mockField("MIDI_CONTROLLER",
+				QString::number(fxsend.iMidiController))
+			+ mockField("AUDIO_OUTPUT_ROUTING", mockIDs(fxsend.routing))
+			+ mockField("LEVEL", QString::number(fxsend.fLevel))
+			+ mockEnd();
+	}
+
+	return QString();
+}
+
+
+// LIST ... commands.
+QString MockServer::commandList ( const QStringList& tokens )
+{
+	QStringList args;
+
+	if (mockMatch(tokens, "LIST CHANNELS", args))
+		return mockResult(mockIDs(m_channels.keys()));
+
+	if (mockMatch(tokens, "LIST AVAILABLE_ENGINES", args)) {
+		QStringList engines;
+		QStringListIterator iter(QString(g_mockEngines).split(','));
+		while (iter.hasNext())
+			engines.append(mockQuote(iter.next()));
+		return mockResult(engines.join(','));
+	}
+
+	for (int iType = 0; iType < 2; ++iType) {
+		const QString sDevice(g_mockDevice[iType]);
+		const QString sDriver(g_mockDriver[iType]);
+		if (mockMatch(tokens, "LIST AVAILABLE_" + sDriver + 'S', args))
+			return mockResult(g_mockDrivers);
+		if (mockMatch(tokens, "LIST " + sDevice + 'S', args))
+			return mockResult(mockIDs(m_devices[iType].keys()));
+	}
+
+	if (mockMatch(tokens, "LIST MIDI_INSTRUMENT_MAPS", args))
+		return mockResult(mockIDs(m_maps.keys()));
+
+	if (mockMatch(tokens, "LIST MIDI_INSTRUMENTS", args) && args.count() == 1) {
+		const bool bAll = (args.at(0).toUpper() == "ALL");
+		const int iMap = args.at(0).toInt();
+		if (!bAll && !m_maps.contains(iMap))
+			return mockError("Invalid MIDI instrument map.");
+		QStringList list;
+		QMapIterator<int, Map> iter(m_maps);
+		while (iter.hasNext()) {
+			iter.next();
+			if (!bAll && iter.key() != iMap)
+				continue;
+			QMapIterator<int, Instrument> instr_iter(iter.value().instruments);
+			while (instr_iter.hasNext()) {
+				const int iKey = instr_iter.next().key();
+				list.append(QString("{%1,%2,%3}")
+					.arg(iter.key()).arg(iKey >> 7).arg(iKey & 0x7f));
+			}
+		}
+		return mockResult(list.join(','));
+	}
+
+	if (mockMatch(tokens, "LIST FX_SENDS", args) && args.count() == 1) {
+		Channel *pChannel = channel(args.at(0));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		return mockResult(mockIDs(pChannel->fxsends.keys()));
+	}
+
+	return QString();
+}
+
+
+// SET ... commands.
+QString MockServer::commandSet ( const QStringList& tokens )
+{
+	QStringList args;
+
+	if (mockMatch(tokens, "SET CHANNEL", args) && args.count() >= 3) {
+		const QString& sKey = args.at(0).toUpper();
+		const QString& sChannelID = args.at(1);
+		Channel *pChannel = channel(sChannelID);
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		const QString& sValue = args.at(2);
+		if (sKey == "VOLUME")
+			pChannel->fVolume = sValue.toFloat();
+		else
+		if (sKey == "MUTE")
+			pChannel->bMute = (sValue.toInt() > 0);
+		else
+		if (sKey == "SOLO")
+			pChannel->bSolo = (sValue.toInt() > 0);
+		else
+		if (sKey == "AUDIO_OUTPUT_DEVICE") {
+			if (!m_devices[0].contains(sValue.toInt()))
+				return mockError("Invalid device.");
+			setAudioDevice(*pChannel, sValue.toInt());
+		}
+		else
+		if (sKey == "AUDIO_OUTPUT_TYPE") {
+			int iDeviceID = -1;
+			QMapIterator<int, Device> iter(m_devices[0]);
+			while (iter.hasNext() && iDeviceID < 0) {
+				if (iter.next().value().sDriver == sValue.toUpper())
+					iDeviceID = iter.key();
+			}
+			if (iDeviceID < 0)
+				iDeviceID = createDevice(0, sValue.toUpper(), QStringList());
+			setAudioDevice(*pChannel, iDeviceID);
+		}
+		else
+		if (sKey == "AUDIO_OUTPUT_CHANNEL" && args.count() == 4) {
+			const int iAudioChannel = sValue.toInt();
+			if (iAudioChannel < 0 || iAudioChannel >= pChannel->audioRouting.count())
+				return mockError("Invalid audio channel.");
+			pChannel->audioRouting[iAudioChannel] = args.at(3).toInt();
+		}
+		else
+		if (sKey == "MIDI_INPUT_DEVICE") {
+			if (!m_devices[1].contains(sValue.toInt()))
+				return mockError("Invalid device.");
+			pChannel->iMidiDevice = sValue.toInt();
+		}
+		else
+		if (sKey == "MIDI_INPUT_TYPE") {
+			int iDeviceID = -1;
+			QMapIterator<int, Device> iter(m_devices[1]);
+			while (iter.hasNext() && iDeviceID < 0) {
+				if (iter.next().value().sDriver == sValue.toUpper())
+					iDeviceID = iter.key();
+			}
+			if (iDeviceID < 0)
+				iDeviceID = createDevice(1, sValue.toUpper(), QStringList());
+			pChannel->iMidiDevice = iDeviceID;
+		}
+		else
+		if (sKey == "MIDI_INPUT_PORT")
+			pChannel->iMidiPort = sValue.toInt();
+		else
+		if (sKey == "MIDI_INPUT_CHANNEL")
+			pChannel->iMidiChannel = (sValue.toUpper() == "ALL" ? -1 : sValue.toInt());
+		else
+		if (sKey == "MIDI_INSTRUMENT_MAP") {
+			const QString& sMap = sValue.toUpper();
+			if (sMap == "NONE")
+				pChannel->iMidiMap = -1;
+			else
+			if (sMap == "DEFAULT")
+				pChannel->iMidiMap = -2;
+			else
+			if (m_maps.contains(sValue.toInt()))
+				pChannel->iMidiMap = sValue.toInt();
+			else
+				return mockError("Invalid MIDI instrument map.");
+		}
+		else return QString();
+		notify("CHANNEL_INFO", sChannelID);
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "SET FX_SEND", args) && args.count() >= 4) {
+		const QString& sKey = args.at(0).toUpper();
+		const QString& sChannelID = args.at(1);
+		Channel *pChannel = channel(sChannelID);
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		const int iFxSend = args.at(2).toInt();
+		if (!pChannel->fxsends.contains(iFxSend))
+			return mockError("Invalid effect send.");
+		FxSend& fxsend = pChannel->fxsends[iFxSend];
+		if (sKey == "NAME")
+			fxsend.sName = args.at(3);
+		else
+		if (sKey == "MIDI_CONTROLLER")
+			fxsend.iMidiController = args.at(3).toInt();
+		else
+		if (sKey == "LEVEL")
+			fxsend.fLevel = args.at(3).toFloat();
+		else
+		if (sKey == "AUDIO_OUTPUT_CHANNEL" && args.count() == 5) {
+			const int iAudioChannel = args.at(3).toInt();
+			if (iAudioChannel < 0 || iAudioChannel >= fxsend.routing.count())
+				return mockError("Invalid audio channel.");
+			fxsend.routing[iAudioChannel] = args.at(4).toInt();
+		}
+		else return QString();
+		notify("FX_SEND_INFO", sChannelID + ' ' + QString::number(iFxSend));
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "SET VOLUME", args) && args.count() == 1) {
+		m_fVolume = args.at(0).toFloat();
+		notify("GLOBAL_INFO", "VOLUME " + QString::number(m_fVolume));
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "SET VOICES", args) && args.count() == 1) {
+		m_iMaxVoices = qMax(1, args.at(0).toInt());
+		notify("GLOBAL_INFO", "VOICES " + QString::number(m_iMaxVoices));
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "SET STREAMS", args) && args.count() == 1) {
+		m_iMaxStreams = qMax(1, args.at(0).toInt());
+		notify("GLOBAL_INFO", "STREAMS " + QString::number(m_iMaxStreams));
+		return mockOk();
+	}
+
+	// Device and port parameters, audio and MIDI alike...
+	for (int iType = 0; iType < 2; ++iType) {
+		const QString sDevice(g_mockDevice[iType]);
+		const QString sPort(g_mockPort[iType]);
+		if (mockMatch(tokens, "SET " + sDevice + "_PARAMETER", args)
+			&& args.count() >= 2) {
+			const int iDeviceID = args.at(0).toInt();
+			if (!m_devices[iType].contains(iDeviceID))
+				return mockError("Invalid device.");
+			Device& device = m_devices[iType][iDeviceID];
+			const QString& sParam = args.mid(1).join(' ');
+			const int iEqual = sParam.indexOf('=');
+			if (iEqual < 0)
+				return mockError("Invalid parameter.");
+			device.params[sParam.left(iEqual).toUpper()] = sParam.mid(iEqual + 1);
+			resizeDevice(iType, device);
+			notify(QString(g_mockEvent[iType]) + "_INFO", args.at(0));
+			return mockOk();
+		}
+		if (mockMatch(tokens, "SET " + sPort + "_PARAMETER", args)
+			&& args.count() >= 3) {
+			const int iDeviceID = args.at(0).toInt();
+			const int iPort = args.at(1).toInt();
+			if (!m_devices[iType].contains(iDeviceID))
+				return mockError("Invalid device.");
+			Device& device = m_devices[iType][iDeviceID];
+			if (iPort < 0 || iPort >= device.ports.count())
+				return mockError("Invalid port.");
+			const QString& sParam = args.mid(2).join(' ');
+			const int iEqual = sParam.indexOf('=');
+			if (iEqual < 0)
+				return mockError("Invalid parameter.");
+			const QString& sKey = sParam.left(iEqual).toUpper();
+			if (sKey == "IS_MIX_CHANNEL")
+				return mockError("Parameter is read-only.");
+			device.ports[iPort][sKey] = sParam.mid(iEqual + 1);
+			return mockOk();
+		}
+	}
+
+	if (mockMatch(tokens, "SET MIDI_INSTRUMENT_MAP NAME", args)
+		&& args.count() == 2) {
+		const int iMap = args.at(0).toInt();
+		if (!m_maps.contains(iMap))
+			return mockError("Invalid MIDI instrument map.");
+		m_maps[iMap].sName = args.at(1);
+		notify("MIDI_INSTRUMENT_MAP_INFO", args.at(0));
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "SET ECHO", args))
+		return mockOk();
+
+	return QString();
+}
+
+
+// CREATE ... commands.
+QString MockServer::commandCreate ( const QStringList& tokens )
+{
+	QStringList args;
+
+	for (int iType = 0; iType < 2; ++iType) {
+		if (mockMatch(tokens, "CREATE " + QString(g_mockDevice[iType]), args)
+			&& args.count() >= 1) {
+			const QString& sDriver = args.at(0).toUpper();
+			if (!QString(g_mockDrivers).split(',').contains(sDriver))
+				return mockError("Unknown driver.");
+			return mockOk(createDevice(iType, sDriver, args.mid(1)));
+		}
+	}
+
+	if (mockMatch(tokens, "CREATE FX_SEND", args) && args.count() >= 2) {
+		const QString& sChannelID = args.at(0);
+		Channel *pChannel = channel(sChannelID);
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		const int iFxSend = pChannel->iFxSendID++;
+		FxSend& fxsend = pChannel->fxsends[iFxSend];
+		fxsend.iMidiController = args.at(1).toInt();
+		fxsend.sName = (args.count() > 2 ? args.at(2)
+			: QString("FX Send %1").arg(iFxSend));
+		fxsend.fLevel = 0.0f;
+		for (int i = 0; i < pChannel->audioRouting.count(); ++i)
+			fxsend.routing.append(i);
+		notify("FX_SEND_COUNT", sChannelID + ' '
+			+ QString::number(pChannel->fxsends.count()));
+		return mockOk(iFxSend);
+	}
+
+	return QString();
+}
+
+
+// DESTROY ... commands.
+QString MockServer::commandDestroy ( const QStringList& tokens )
+{
+	QStringList args;
+
+	for (int iType = 0; iType < 2; ++iType) {
+		if (mockMatch(tokens, "DESTROY " + QString(g_mockDevice[iType]), args)
+			&& args.count() == 1) {
+			if (!destroyDevice(iType, args.at(0).toInt()))
+				return mockError("Invalid device.");
+			return mockOk();
+		}
+	}
+
+	if (mockMatch(tokens, "DESTROY FX_SEND", args) && args.count() == 2) {
+		const QString& sChannelID = args.at(0);
+		Channel *pChannel = channel(sChannelID);
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		if (pChannel->fxsends.remove(args.at(1).toInt()) < 1)
+			return mockError("Invalid effect send.");
+		notify("FX_SEND_COUNT", sChannelID + ' '
+			+ QString::number(pChannel->fxsends.count()));
+		return mockOk();
+	}
+
+	return QString();
+}
+
+
+// Channel (and sampler) commands.
+QString MockServer::commandChannel ( const QStringList& tokens )
+{
+	QStringList args;
+
+	if (mockMatch(tokens, "ADD CHANNEL", args)) {
+		const int iChannelID = m_iChannelID++;
+		m_channels.insert(iChannelID, Channel());
+		notify("CHANNEL_COUNT", QString::number(m_channels.count()));
+		return mockOk(iChannelID);
+	}
+
+	if (mockMatch(tokens, "REMOVE CHANNEL", args) && args.count() == 1) {
+		if (m_channels.remove(args.at(0).toInt()) < 1)
+			return mockError("Invalid sampler channel.");
+		notify("CHANNEL_COUNT", QString::number(m_channels.count()));
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "LOAD ENGINE", args) && args.count() == 2) {
+		const QString& sEngineName = args.at(0).toUpper();
+		if (!QString(g_mockEngines).split(',').contains(sEngineName))
+			return mockError("Unknown engine.");
+		Channel *pChannel = channel(args.at(1));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		pChannel->sEngineName = sEngineName;
+		notify("CHANNEL_INFO", args.at(1));
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "LOAD INSTRUMENT", args) && args.count() >= 3) {
+		if (args.at(0).toUpper() == "NON_MODAL")
+			args.removeFirst();
+		if (args.count() != 3)
+			return QString();
+		const int iChannelID = args.at(2).toInt();
+		if (!m_channels.contains(iChannelID))
+			return mockError("Invalid sampler channel.");
+		if (m_channels[iChannelID].sEngineName.isEmpty())
+			return mockError("No engine loaded on sampler channel.");
+		loadInstrument(iChannelID, args.at(0), args.at(1).toInt());
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "EDIT CHANNEL INSTRUMENT", args) && args.count() == 1) {
+		if (channel(args.at(0)) == nullptr)
+			return mockError("Invalid sampler channel.");
+		return mockError("No instrument editor available.");
+	}
+
+	if (mockMatch(tokens, "RESET CHANNEL", args) && args.count() == 1) {
+		Channel *pChannel = channel(args.at(0));
+		if (pChannel == nullptr)
+			return mockError("Invalid sampler channel.");
+		pChannel->iVoices = pChannel->iStreams = 0;
+		notify("VOICE_COUNT", args.at(0) + " 0");
+		notify("STREAM_COUNT", args.at(0) + " 0");
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "RESET", args) && args.isEmpty()) {
+		reset();
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "ADD MIDI_INSTRUMENT_MAP", args)) {
+		const int iMap = m_iMapID++;
+		m_maps[iMap].sName = (args.isEmpty()
+			? QString("Map %1").arg(iMap) : args.at(0));
+		notify("MIDI_INSTRUMENT_MAP_COUNT", QString::number(m_maps.count()));
+		return mockOk(iMap);
+	}
+
+	if (mockMatch(tokens, "REMOVE MIDI_INSTRUMENT_MAP", args) && args.count() == 1) {
+		if (args.at(0).toUpper() == "ALL")
+			m_maps.clear();
+		else
+		if (m_maps.remove(args.at(0).toInt()) < 1)
+			return mockError("Invalid MIDI instrument map.");
+		notify("MIDI_INSTRUMENT_MAP_COUNT", QString::number(m_maps.count()));
+		return mockOk();
+	}
+
+	return QString();
+}
+
+
+// MIDI instrument map entry commands.
+QString MockServer::commandMap ( const QStringList& tokens )
+{
+	QStringList args;
+
+	if (mockMatch(tokens, "MAP MIDI_INSTRUMENT", args) && args.count() >= 7) {
+		if (args.at(0).toUpper() == "NON_MODAL")
+			args.removeFirst();
+		if (args.count() < 7)
+			return QString();
+		const int iMap = args.at(0).toInt();
+		if (!m_maps.contains(iMap))
+			return mockError("Invalid MIDI instrument map.");
+		const int iBank = args.at(1).toInt();
+		const int iProg = args.at(2).toInt();
+		if (iBank < 0 || iBank > 16383 || iProg < 0 || iProg > 127)
+			return mockError("Invalid MIDI bank or program.");
+		const int iKey = (iBank << 7) + iProg;
+		Instrument& instr = m_maps[iMap].instruments[iKey];
+		instr.sEngineName = args.at(3).toUpper();
+		instr.sInstrumentFile = args.at(4);
+		instr.iInstrumentNr = args.at(5).toInt();
+		instr.fVolume = args.at(6).toFloat();
+		instr.sLoadMode = "ON_DEMAND";
+		instr.sName.clear();
+		for (int i = 7; i < args.count(); ++i) {
+			const QString& sArg = args.at(i);
+			if (sArg == "ON_DEMAND" || sArg == "ON_DEMAND_HOLD"
+				|| sArg == "PERSISTENT")
+				instr.sLoadMode = sArg;
+			else
+				instr.sName = sArg;
+		}
+		notify("MIDI_INSTRUMENT_COUNT", args.at(0) + ' '
+			+ QString::number(m_maps[iMap].instruments.count()));
+		notify("MIDI_INSTRUMENT_INFO", QString("%1 %2 %3")
+			.arg(iMap).arg(iBank).arg(iProg));
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "UNMAP MIDI_INSTRUMENT", args) && args.count() == 3) {
+		const int iMap = args.at(0).toInt();
+		const int iKey = (args.at(1).toInt() << 7) + args.at(2).toInt();
+		if (!m_maps.contains(iMap) || m_maps[iMap].instruments.remove(iKey) < 1)
+			return mockError("Invalid MIDI instrument map entry.");
+		notify("MIDI_INSTRUMENT_COUNT", args.at(0) + ' '
+			+ QString::number(m_maps[iMap].instruments.count()));
+		return mockOk();
+	}
+
+	if (mockMatch(tokens, "CLEAR MIDI_INSTRUMENTS", args) && args.count() == 1) {
+		QMutableMapIterator<int, Map> iter(m_maps);
+		while (iter.hasNext()) {
+			iter.next();
+			if (args.at(0).toUpper() == "ALL" || iter.key() == args.at(0).toInt()) {
+				iter.value().instruments.clear();
+				notify("MIDI_INSTRUMENT_COUNT",
+					QString::number(iter.key()) + " 0");
+			}
+		}
+		return mockOk();
+	}
+
+	return QString();
+}
+
+
+// Create a new device, with default parameters (but the given ones).
+int MockServer::createDevice ( int iType,
+	const QString& sDriver, const QStringList& params )
+{
+	const int iDeviceID = m_iDeviceID[iType]++;
+	Device& device = m_devices[iType][iDeviceID];
+	device.sDriver = sDriver;
+	device.params["ACTIVE"] = "true";
+	if (iType == 0) {
+		device.params["CHANNELS"] = "2";
+		device.params["SAMPLERATE"] = "44100";
+	}
+	else device.params["PORTS"] = "1";
+
+	QStringListIterator iter(params);
+	while (iter.hasNext()) {
+		const QString& sParam = iter.next();
+		const int iEqual = sParam.indexOf('=');
+		if (iEqual > 0)
+			device.params[sParam.left(iEqual).toUpper()] = sParam.mid(iEqual + 1);
+	}
+
+	resizeDevice(iType, device);
+
+	notify(QString(g_mockEvent[iType]) + "_COUNT",
+		QString::number(m_devices[iType].count()));
+
+	return iDeviceID;
+}
+
+
+// Keep the number of ports (or audio channels) as told.
+void MockServer::resizeDevice ( int iType, Device& device )
+{
+	const int iPorts = qBound(1, device.params.value(g_mockPorts[iType]).toInt(), 64);
+	while (device.ports.count() > iPorts)
+		device.ports.removeLast();
+	while (device.ports.count() < iPorts) {
+		Params params;
+		if (iType == 0) {
+			params["NAME"] = QString("Channel %1").arg(device.ports.count());
+			params["IS_MIX_CHANNEL"] = "false";
+		}
+		else params["NAME"] = QString("Port %1").arg(device.ports.count());
+		device.ports.append(params);
+	}
+}
+
+
+// Destroy a device, detaching channels from it.
+bool MockServer::destroyDevice ( int iType, int iDeviceID )
+{
+	if (m_devices[iType].remove(iDeviceID) < 1)
+		return false;
+
+	QMutableMapIterator<int, Channel> iter(m_channels);
+	while (iter.hasNext()) {
+		Channel& channel = iter.next().value();
+		if (iType == 0 && channel.iAudioDevice == iDeviceID) {
+			channel.iAudioDevice = -1;
+			channel.audioRouting.clear();
+		}
+		else
+		if (iType == 1 && channel.iMidiDevice == iDeviceID)
+			channel.iMidiDevice = -1;
+	}
+
+	notify(QString(g_mockEvent[iType]) + "_COUNT",
+		QString::number(m_devices[iType].count()));
+
+	return true;
+}
+
+
+// Device info reply.
+QString MockServer::deviceInfo ( int /*iType*/, const Device& device ) const
+{
+	QString sInfo = mockField("DRIVER", device.sDriver);
+
+	QMapIterator<QString, QString> iter(device.params);
+	while (iter.hasNext()) {
+		iter.next();
+		sInfo += mockField(iter.key(), iter.value());
+	}
+
+	return sInfo + mockEnd();
+}
+
+
+// Driver info reply.
+QString MockServer::driverInfo ( int iType, const QString& sDriver ) const
+{
+	if (!QString(g_mockDrivers).split(',').contains(sDriver))
+		return mockError("Unknown driver.");
+
+	return mockField("DESCRIPTION", "Mock " + sDriver + " driver")
+		+ mockField("VERSION", "1.0")
+		+ mockField("PARAMETERS", iType == 0
+			? "ACTIVE,CHANNELS,SAMPLERATE" : "ACTIVE,PORTS")
+		+ mockEnd();
+}
+
+
+// Driver parameter info reply.
+QString MockServer::driverParamInfo ( int iType, const QString& sParam ) const
+{
+	if (sParam == "ACTIVE") {
+		return mockField("TYPE", "BOOL")
+			+ mockField("DESCRIPTION", "Enable / disable device")
+			+ mockField("MANDATORY", "false")
+			+ mockField("FIX", "false")
+			+ mockField("MULTIPLICITY", "false")
+			+ mockField("DEFAULT", "true")
+			+ mockEnd();
+	}
+
+	if (sParam == g_mockPorts[iType]) {
+		return mockField("TYPE", "INT")
+			+ mockField("DESCRIPTION", iType == 0
+				? "Number of output channels" : "Number of input ports")
+			+ mockField("MANDATORY", "false")
+			+ mockField("FIX", "false")
+			+ mockField("MULTIPLICITY", "false")
+			+ mockField("DEFAULT", iType == 0 ? "2" : "1")
+			+ mockField("RANGE_MIN", "1")
+			+ mockField("RANGE_MAX", iType == 0 ? "64" : "16")
+			+ mockEnd();
+	}
+
+	if (iType == 0 && sParam == "SAMPLERATE") {
+		return mockField("TYPE", "INT")
+			+ mockField("DESCRIPTION", "Output sample rate")
+			+ mockField("MANDATORY", "false")
+			+ mockField("FIX", "false")
+			+ mockField("MULTIPLICITY", "false")
+			+ mockField("DEFAULT", "44100")
+			+ mockField("POSSIBILITIES", "44100,48000,96000")
+			+ mockEnd();
+	}
+
+	return mockError("Unknown driver parameter.");
+}
+
+
+// Port (or audio channel) parameter info reply.
+QString MockServer::portParamInfo ( int iType, const QString& sParam ) const
+{
+	if (sParam == "NAME") {
+		return mockField("TYPE", "STRING")
+			+ mockField("DESCRIPTION", iType == 0 ? "Channel name" : "Port name")
+			+ mockField("FIX", "false")
+			+ mockField("MULTIPLICITY", "false")
+			+ mockEnd();
+	}
+
+	if (iType == 0 && sParam == "IS_MIX_CHANNEL") {
+		return mockField("TYPE", "BOOL")
+			+ mockField("DESCRIPTION", "Whether this is a mix channel")
+			+ mockField("FIX", "true")
+			+ mockField("MULTIPLICITY", "false")
+			+ mockEnd();
+	}
+
+	return mockError("Unknown port parameter.");
+}
+
+
+// Channel lookup helper.
+MockServer::Channel *MockServer::channel ( const QString& sChannelID )
+{
+	bool bOk = false;
+	const int iChannelID = sChannelID.toInt(&bOk);
+	if (!bOk || !m_channels.contains(iChannelID))
+		return nullptr;
+
+	return &m_channels[iChannelID];
+}
+
+
+// Attach a channel to an audio device, with default routing.
+void MockServer::setAudioDevice ( Channel& channel, int iDeviceID )
+{
+	channel.iAudioDevice = iDeviceID;
+	channel.audioRouting.clear();
+
+	const int iPorts = m_devices[0].value(iDeviceID).ports.count();
+	for (int i = 0; i < 2 && i < iPorts; ++i)
+		channel.audioRouting.append(i);
+}
+
+
+// Start loading an instrument (progress goes on the periodic events).
+void MockServer::loadInstrument ( int iChannelID, const QString& sFile, int iNr )
+{
+	Channel& channel = m_channels[iChannelID];
+	channel.sInstrumentFile = sFile;
+	channel.iInstrumentNr = iNr;
+	channel.sInstrumentName = QString("%1 [%2]")
+		.arg(sFile.section('/', -1)).arg(iNr);
+	channel.iLoadStart = elapsed();
+	channel.iInstrumentStatus
+		= (m_config.iLoadTime > 0 && m_config.iEventPeriod > 0 ? 0 : 100);
+
+	notify("CHANNEL_INFO", QString::number(iChannelID));
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerMockServer.cpp
@@ -0,0 +1,289 @@
+// qsamplerMockServer.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerMockServer_h
+#define __qsamplerMockServer_h
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+#include <QList>
+#include <QMap>
+#include <QSet>
+
+
+namespace QSampler {
+
+class MockServer;
+
+
+//-------------------------------------------------------------------------
+// QSampler::MockConnection -- Mock LSCP server client connection.
+//
+
+class MockConnection : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	MockConnection(MockServer *pServer, QTcpSocket *pSocket);
+
+	// Event subscriptions.
+	bool isSubscribed(const QString& sEvent) const;
+	void subscribe(const QString& sEvent);
+	void unsubscribe(const QString& sEvent);
+
+	// Send an event notification, right away.
+	void notify(const QString& sEvent, const QString& sData);
+
+	// Close after the last reply.
+	void quit();
+
+signals:
+
+	// Connection closed notification.
+	void closed(MockConnection *pConnection);
+
+protected slots:
+
+	// Socket slots.
+	void readyReadSlot();
+	void disconnectedSlot();
+
+	// Delayed replies slot.
+	void replySlot();
+
+private:
+
+	// Delayed reply item.
+	struct Reply
+	{
+		qint64     iDue;
+		QByteArray data;
+	};
+
+	// Instance variables.
+	MockServer *m_pServer;
+	QTcpSocket *m_pSocket;
+
+	QByteArray m_buffer;
+
+	QList<Reply> m_replies;
+	QTimer m_timer;
+
+	QSet<QString> m_events;
+
+	bool m_bQuit;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::MockServer -- Mock LSCP server (LinuxSampler stand-in).
+//
+
+class MockServer : public QTcpServer
+{
+	Q_OBJECT
+
+public:
+
+	// Mock server configuration.
+	struct Config
+	{
+		Config();
+
+		quint16 iPort;        // TCP port to listen on.
+		int     iChannels;    // Initial number of sampler channels.
+		int     iMapEntries;  // Initial number of MIDI instrument map entries.
+		int     iDevices;     // Initial number of audio and MIDI devices.
+		int     iLatency;     // Reply latency (msecs).
+		int     iJitter;      // Reply latency jitter (msecs).
+		int     iEventPeriod; // Periodic events period (msecs; 0 = none).
+		int     iLoadTime;    // Instrument load time (msecs; 0 = instant).
+		quint32 iSeed;        // Pseudo-random generator seed.
+	};
+
+	// Constructor.
+	MockServer(const Config& config, QObject *pParent = nullptr);
+
+	// Destructor.
+	~MockServer();
+
+	// Start listening.
+	bool start();
+
+	// Configuration accessor.
+	const Config& config() const;
+
+	// Reply to one single command line.
+	QByteArray command(MockConnection *pConnection, const QString& sLine);
+
+	// Elapsed time since start (msecs).
+	qint64 elapsed() const;
+
+	// Deterministic pseudo-random number in [0, iRange).
+	int random(int iRange);
+
+protected slots:
+
+	// Server slots.
+	void newConnectionSlot();
+	void closedSlot(MockConnection *pConnection);
+
+	// Periodic events slot.
+	void eventSlot();
+
+protected:
+
+	// Device (or port) parameter values.
+	typedef QMap<QString, QString> Params;
+
+	// Audio output or MIDI input device.
+	struct Device
+	{
+		QString sDriver;
+		Params params;
+		QList<Params> ports;
+	};
+
+	// Channel effect send.
+	struct FxSend
+	{
+		QString    sName;
+		int        iMidiController;
+		QList<int> routing;
+		float      fLevel;
+	};
+
+	// Sampler channel.
+	struct Channel
+	{
+		Channel();
+
+		QString    sEngineName;
+		int        iAudioDevice;
+		QList<int> audioRouting;
+		int        iMidiDevice;
+		int        iMidiPort;
+		int        iMidiChannel;
+		QString    sInstrumentFile;
+		int        iInstrumentNr;
+		QString    sInstrumentName;
+		int        iInstrumentStatus;
+		qint64     iLoadStart;
+		float      fVolume;
+		bool       bMute;
+		bool       bSolo;
+		int        iMidiMap;
+		int        iVoices;
+		int        iStreams;
+		QMap<int, FxSend> fxsends;
+		int        iFxSendID;
+	};
+
+	// MIDI instrument map entry.
+	struct Instrument
+	{
+		QString sName;
+		QString sEngineName;
+		QString sInstrumentFile;
+		int     iInstrumentNr;
+		float   fVolume;
+		QString sLoadMode;
+	};
+
+	// MIDI instrument map (entries keyed by bank * 128 + prog).
+	struct Map
+	{
+		QString sName;
+		QMap<int, Instrument> instruments;
+	};
+
+	// Command handlers, by verb.
+	QString commandGet(const QStringList& tokens);
+	QString commandList(const QStringList& tokens);
+	QString commandSet(const QStringList& tokens);
+	QString commandCreate(const QStringList& tokens);
+	QString commandDestroy(const QStringList& tokens);
+	QString commandChannel(const QStringList& tokens);
+	QString commandMap(const QStringList& tokens);
+
+	// Device helpers (iType: 0 = audio, 1 = MIDI).
+	int createDevice(int iType, const QString& sDriver, const QStringList& params);
+	void resizeDevice(int iType, Device& device);
+	bool destroyDevice(int iType, int iDeviceID);
+
+	QString deviceInfo(int iType, const Device& device) const;
+	QString driverInfo(int iType, const QString& sDriver) const;
+	QString driverParamInfo(int iType, const QString& sParam) const;
+	QString portParamInfo(int iType, const QString& sParam) const;
+
+	// Channel helpers.
+	Channel *channel(const QString& sChannelID);
+	void setAudioDevice(Channel& channel, int iDeviceID);
+	void loadInstrument(int iChannelID, const QString& sFile, int iNr);
+
+	// Event notification helper.
+	void notify(const QString& sEvent, const QString& sData);
+
+	// Reset the whole sampler state.
+	void reset();
+
+	// Initial (configured) sampler state.
+	void populate();
+
+private:
+
+	// Instance variables.
+	Config m_config;
+
+	QList<MockConnection *> m_connections;
+
+	QMap<int, Device>  m_devices[2];
+	QMap<int, Channel> m_channels;
+	QMap<int, Map>     m_maps;
+
+	int m_iDeviceID[2];
+	int m_iChannelID;
+	int m_iMapID;
+
+	float m_fVolume;
+	int   m_iMaxVoices;
+	int   m_iMaxStreams;
+	int   m_iTotalVoicesMax;
+
+	quint32 m_iRandom;
+
+	QElapsedTimer m_elapsed;
+	QTimer m_eventTimer;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerMockServer_h
+
+
+// end of qsamplerMockServer.h
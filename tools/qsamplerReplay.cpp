@@ -0,0 +1,151 @@
+// qsamplerReplay.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerReplayServer.h"
+
+#include <QCoreApplication>
+#include <QTextStream>
+
+
+//-------------------------------------------------------------------------
+// Command line usage helper.
+//
+
+static void print_usage ( const QString& arg0 )
+{
+	QTextStream out(stderr);
+	out << QObject::tr("Usage: %1 [options] recording-file\n\n"
+		"Qsampler LSCP Replayer - plays an LSCP traffic recording back, "
+		"as a fake server.\n\n"
+		"Options:\n\n"
+		"  -p, --port\n\tListen on this TCP port number (default = 8888)\n\n"
+		"  -f, --fast\n\tReply as fast as possible, not keeping the recorded timing\n\n"
+		"  -?, --help\n\tShow help about command line options\n\n")
+		.arg(arg0);
+}
+
+
+//-------------------------------------------------------------------------
+// Command line arguments parser.
+//
+
+static bool parse_args ( const QStringList& args,
+	QSampler::ReplayServer::Config& config, QString& sFilename )
+{
+	QTextStream out(stderr);
+	const QString sEol = "\n\n";
+	const int argc = args.count();
+
+	for (int i = 1; i < argc; ++i) {
+
+		QString sArg = args.at(i);
+		QString sVal;
+		const int iEqual = sArg.indexOf("=");
+		if (iEqual >= 0) {
+			sVal = sArg.right(sArg.length() - iEqual - 1);
+			sArg = sArg.left(iEqual);
+		}
+		else if (i < argc - 1) {
+			sVal = args.at(i + 1);
+			if (sVal[0] == '-')
+				sVal.clear();
+		}
+
+		if (sArg == "-?" || sArg == "--help") {
+			print_usage(args.at(0));
+			return false;
+		}
+		else if (sArg == "-f" || sArg == "--fast") {
+			config.bFast = true;
+		}
+		else if (sArg == "-p" || sArg == "--port") {
+			bool bOk = false;
+			const int iPort = sVal.toInt(&bOk);
+			if (!bOk || iPort < 0) {
+				out << QObject::tr("Option -p requires a number.") + sEol;
+				return false;
+			}
+			config.iPort = quint16(iPort);
+			if (iEqual < 0)
+				++i;
+		}
+		else if (sArg.startsWith('-')) {
+			out << QObject::tr("Unknown option: %1").arg(sArg) + sEol;
+			print_usage(args.at(0));
+			return false;
+		}
+		else sFilename = sArg;
+	}
+
+	if (sFilename.isEmpty()) {
+		print_usage(args.at(0));
+		return false;
+	}
+
+	// Alright with argument parsing.
+	return true;
+}
+
+
+//-------------------------------------------------------------------------
+// main - The main program trunk.
+//
+
+int main ( int argc, char **argv )
+{
+	QCoreApplication app(argc, argv);
+
+	QSampler::ReplayServer::Config config;
+	QString sFilename;
+	if (!parse_args(app.arguments(), config, sFilename))
+		return 1;
+
+	QSampler::Recording recording;
+	if (!recording.load(sFilename)) {
+		QTextStream(stderr) << QObject::tr("Could not load recording: %1\n")
+			.arg(sFilename);
+		return 1;
+	}
+
+	QSampler::ReplayServer server(config, recording);
+	if (!server.start()) {
+		QTextStream(stderr) << QObject::tr("Could not listen on port %1: %2\n")
+			.arg(config.iPort).arg(server.errorString());
+		return 1;
+	}
+
+	const QList<QSampler::Recording::Record>& records = recording.records();
+	const qint64 iDuration = (records.isEmpty() ? 0 : records.last().iTime / 1000);
+
+	QTextStream(stdout) << QObject::tr("Replaying %1 (%2:%3, %4) on port %5, "
+		"%6 connections, %7 bytes sent, %8 bytes received, %9 msecs%10.\n")
+		.arg(sFilename).arg(recording.host()).arg(recording.port())
+		.arg(recording.startTime().toString(Qt::ISODate)).arg(config.iPort)
+		.arg(recording.connections())
+		.arg(recording.bytes(QSampler::Recording::Send))
+		.arg(recording.bytes(QSampler::Recording::Recv))
+		.arg(iDuration).arg(config.bFast ? QObject::tr(", fast") : QString());
+
+	return app.exec();
+}
+
+
+// end of qsamplerReplay.cpp
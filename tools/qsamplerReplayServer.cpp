@@ -0,0 +1,315 @@
+// qsamplerReplayServer.cpp
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qsamplerReplayServer.h"
+
+#include <QHostAddress>
+#include <QTextStream>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::ReplayConnection -- Recorded LSCP connection, played back.
+//
+
+// Constructor.
+ReplayConnection::ReplayConnection ( QTcpSocket *pSocket, int iConn,
+	const QList<Recording::Record>& records, bool bFast )
+	: QObject(pSocket), m_pSocket(pSocket), m_iConn(iConn),
+		m_records(records), m_iRecord(0), m_bFast(bFast),
+		m_bDelayed(false), m_iLastTime(0), m_iDiverged(-1)
+{
+	m_timer.setSingleShot(true);
+	m_timer.setTimerType(Qt::PreciseTimer);
+
+	QObject::connect(&m_timer,
+		SIGNAL(timeout()),
+		SLOT(stepSlot()));
+	QObject::connect(m_pSocket,
+		SIGNAL(readyRead()),
+		SLOT(readyReadSlot()));
+	QObject::connect(m_pSocket,
+		SIGNAL(disconnected()),
+		SLOT(disconnectedSlot()));
+
+	m_elapsed.start();
+
+	// Whatever the server says first...
+	m_timer.start(0);
+
+	// The client may have spoken already...
+	if (m_pSocket->bytesAvailable() > 0)
+		readyReadSlot();
+}
+
+
+// Socket slots.
+void ReplayConnection::readyReadSlot (void)
+{
+	m_received.append(m_pSocket->readAll());
+
+	// Tell whether the client is still on the recorded track...
+	if (m_iDiverged < 0) {
+		const int iCount = qMin(m_received.size(), m_expected.size());
+		for (int i = 0; i < iCount; ++i) {
+			if (m_received.at(i) != m_expected.at(i)) {
+				m_iDiverged = i;
+				QTextStream(stderr) << QObject::tr("Connection %1: "
+					"client diverged from the recording at byte %2.\n")
+					.arg(m_iConn).arg(i);
+				break;
+			}
+		}
+	}
+
+	if (!m_timer.isActive())
+		stepSlot();
+}
+
+
+void ReplayConnection::disconnectedSlot (void)
+{
+	QTextStream(stdout) << QObject::tr("Connection %1: "
+		"%2 of %3 records replayed in %4 msecs.\n")
+		.arg(m_iConn).arg(m_iRecord).arg(m_records.count())
+		.arg(m_elapsed.elapsed());
+
+	m_timer.stop();
+
+	emit closed(this);
+}
+
+
+// Next record slot.
+void ReplayConnection::stepSlot (void)
+{
+	while (m_iRecord < m_records.count()) {
+		const Recording::Record& record = m_records.at(m_iRecord);
+		// What the client is expected to send...
+		if (record.type == Recording::Send) {
+			m_expected.append(record.data);
+			m_iLastTime = record.iTime;
+			++m_iRecord;
+			continue;
+		}
+		// The client must have caught up first...
+		if (m_received.size() < m_expected.size())
+			return;
+		// Keep the recorded gap, if asked to...
+		if (!m_bFast && !m_bDelayed) {
+			const qint64 iDelay = (record.iTime - m_iLastTime) / 1000;
+			if (iDelay > 0) {
+				m_bDelayed = true;
+				m_timer.start(int(iDelay));
+				return;
+			}
+		}
+		m_bDelayed = false;
+		m_iLastTime = record.iTime;
+		++m_iRecord;
+		if (record.type == Recording::Close) {
+			m_pSocket->disconnectFromHost();
+			return;
+		}
+		m_pSocket->write(record.data);
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// QSampler::ReplayServer -- LSCP traffic replayer (fake server).
+//
+
+// Default configuration.
+ReplayServer::Config::Config (void) : iPort(8888), bFast(false)
+{
+}
+
+
+// Constructor.
+ReplayServer::ReplayServer ( const Config& config,
+	const Recording& recording, QObject *pParent )
+	: QTcpServer(pParent), m_config(config)
+{
+	// Split the recording by connection, in order of appearance...
+	QListIterator<Recording::Record> iter(recording.records());
+	while (iter.hasNext()) {
+		const Recording::Record& record = iter.next();
+		if (record.type == Recording::Open) {
+			m_conns.append(record.iConn);
+			continue; // Peer address on the recording side only.
+		}
+		m_records[record.iConn].append(record);
+	}
+
+	// Connections are told apart by what the client says first,
+	// as their order may well vary from one run to the next...
+	QListIterator<int> conn_iter(m_conns);
+	while (conn_iter.hasNext()) {
+		const int iConn = conn_iter.next();
+		m_commands.insert(iConn, firstCommand(m_records.value(iConn)));
+	}
+
+	QObject::connect(this,
+		SIGNAL(newConnection()),
+		SLOT(newConnectionSlot()));
+}
+
+
+// Start listening.
+bool ReplayServer::start (void)
+{
+	return listen(QHostAddress::Any, m_config.iPort);
+}
+
+
+// Configuration accessor.
+const ReplayServer::Config& ReplayServer::config (void) const
+{
+	return m_config;
+}
+
+
+// Server slots.
+void ReplayServer::newConnectionSlot (void)
+{
+	while (hasPendingConnections()) {
+		QTcpSocket *pSocket = nextPendingConnection();
+		if (m_conns.isEmpty()) {
+			pSocket->close();
+			pSocket->deleteLater();
+			continue;
+		}
+		// Wait for its first command line...
+		QObject::connect(pSocket,
+			SIGNAL(readyRead()),
+			SLOT(pendingReadSlot()));
+		QObject::connect(pSocket,
+			SIGNAL(disconnected()),
+			SLOT(pendingClosedSlot()));
+		pendingRead(pSocket);
+	}
+}
+
+
+void ReplayServer::closedSlot ( ReplayConnection *pConnection )
+{
+	// The connection goes away along with its socket.
+	pConnection->parent()->deleteLater();
+}
+
+
+// New connection slots, until told apart.
+void ReplayServer::pendingReadSlot (void)
+{
+	pendingRead(qobject_cast<QTcpSocket *> (sender()));
+}
+
+
+void ReplayServer::pendingClosedSlot (void)
+{
+	// Gone before saying anything.
+	QTcpSocket *pSocket = qobject_cast<QTcpSocket *> (sender());
+	if (pSocket)
+		pSocket->deleteLater();
+}
+
+
+// A new connection is told apart by its first command line.
+void ReplayServer::pendingRead ( QTcpSocket *pSocket )
+{
+	if (pSocket == nullptr || !pSocket->canReadLine())
+		return;
+
+	// Only peek at it, the connection is played back from scratch...
+	const QByteArray& data = pSocket->peek(pSocket->bytesAvailable());
+	const QByteArray& command = data.left(data.indexOf('\n')).trimmed();
+
+	QObject::disconnect(pSocket, nullptr, this, nullptr);
+
+	const int iConn = matchConnection(command);
+	ReplayConnection *pConnection = new ReplayConnection(
+		pSocket, iConn, m_records.value(iConn), m_config.bFast);
+	QObject::connect(pConnection,
+		SIGNAL(closed(ReplayConnection *)),
+		SLOT(closedSlot(ReplayConnection *)));
+}
+
+
+// First command line of a recorded connection (empty if none).
+QByteArray ReplayServer::firstCommand (
+	const QList<Recording::Record>& records )
+{
+	QByteArray data;
+
+	QListIterator<Recording::Record> iter(records);
+	while (iter.hasNext()) {
+		const Recording::Record& record = iter.next();
+		if (record.type != Recording::Send)
+			continue;
+		data.append(record.data);
+		const int iEol = data.indexOf('\n');
+		if (iEol >= 0)
+			return data.left(iEol).trimmed();
+	}
+
+	return data.trimmed();
+}
+
+
+// Pick the recorded connection to play back on a new one: the first
+// unused one starting with the same command, or else just the first
+// unused one; starting all over again when they've all been played.
+int ReplayServer::matchConnection ( const QByteArray& command )
+{
+	if (m_used.count() >= m_conns.count())
+		m_used.clear();
+
+	int iFirst = -1;
+	int iMatch = -1;
+
+	QListIterator<int> iter(m_conns);
+	while (iter.hasNext() && iMatch < 0) {
+		const int iConn = iter.next();
+		if (m_used.contains(iConn))
+			continue;
+		if (iFirst < 0)
+			iFirst = iConn;
+		if (m_commands.value(iConn) == command)
+			iMatch = iConn;
+	}
+
+	if (iMatch < 0) {
+		iMatch = iFirst;
+		QTextStream(stderr) << QObject::tr("Connection %1: "
+			"no recorded one starts with \"%2\", going in order.\n")
+			.arg(iMatch).arg(QString::fromUtf8(command));
+	}
+
+	m_used.append(iMatch);
+	return iMatch;
+}
+
+} // namespace QSampler
+
+
+// end of qsamplerReplayServer.cpp
@@ -0,0 +1,155 @@
+// qsamplerReplayServer.h
+//
+/****************************************************************************
+   Copyright (C) 2004-2020, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qsamplerReplayServer_h
+#define __qsamplerReplayServer_h
+
+#include "qsamplerRecording.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QList>
+#include <QHash>
+
+
+namespace QSampler {
+
+//-------------------------------------------------------------------------
+// QSampler::ReplayConnection -- Recorded LSCP connection, played back.
+//
+
+class ReplayConnection : public QObject
+{
+	Q_OBJECT
+
+public:
+
+	// Constructor.
+	ReplayConnection(QTcpSocket *pSocket, int iConn,
+		const QList<Recording::Record>& records, bool bFast);
+
+signals:
+
+	// Connection closed notification.
+	void closed(ReplayConnection *pConnection);
+
+protected slots:
+
+	// Socket slots.
+	void readyReadSlot();
+	void disconnectedSlot();
+
+	// Next record slot.
+	void stepSlot();
+
+private:
+
+	// Instance variables.
+	QTcpSocket *m_pSocket;
+
+	int m_iConn;
+
+	QList<Recording::Record> m_records;
+	int m_iRecord;
+
+	bool m_bFast;
+	bool m_bDelayed;
+
+	qint64 m_iLastTime;
+
+	QByteArray m_expected;
+	QByteArray m_received;
+	int m_iDiverged;
+
+	QTimer m_timer;
+	QElapsedTimer m_elapsed;
+};
+
+
+//-------------------------------------------------------------------------
+// QSampler::ReplayServer -- LSCP traffic replayer (fake server).
+//
+
+class ReplayServer : public QTcpServer
+{
+	Q_OBJECT
+
+public:
+
+	// Replay server configuration.
+	struct Config
+	{
+		Config();
+
+		quint16 iPort;  // TCP port to listen on.
+		bool    bFast;  // Don't keep the recorded timing.
+	};
+
+	// Constructor.
+	ReplayServer(const Config& config,
+		const Recording& recording, QObject *pParent = nullptr);
+
+	// Start listening.
+	bool start();
+
+	// Configuration accessor.
+	const Config& config() const;
+
+protected slots:
+
+	// Server slots.
+	void newConnectionSlot();
+	void closedSlot(ReplayConnection *pConnection);
+
+	// New connection slots, until told apart.
+	void pendingReadSlot();
+	void pendingClosedSlot();
+
+private:
+
+	// A new connection is told apart by its first command line.
+	void pendingRead(QTcpSocket *pSocket);
+
+	// First command line of a recorded connection (empty if none).
+	static QByteArray firstCommand(const QList<Recording::Record>& records);
+
+	// Pick the recorded connection to play back on a new one.
+	int matchConnection(const QByteArray& command);
+
+	// Instance variables.
+	Config m_config;
+
+	QList<int> m_conns;
+	QHash<int, QList<Recording::Record> > m_records;
+	QHash<int, QByteArray> m_commands;
+
+	QList<int> m_used;
+};
+
+} // namespace QSampler
+
+
+#endif  // __qsamplerReplayServer_h
+
+
+// end of qsamplerReplayServer.h